@@ -10,7 +10,9 @@
 #include "wrapper/spi.hpp"
 #include "wrapper/display.hpp"
 #include "wrapper/i2s.hpp"
+#include "wrapper/i2s-dma.hpp"
 #include "wrapper/audio.hpp"
+#include "dsp/biquad.hpp"
 #include "device/m5stack_cardputer_keyboard.hpp"
 
 namespace wrapper
@@ -62,11 +64,16 @@ I2cBusConfig i2c_bus_config(
 
 // I2S Config (Speaker - NS4168)
 // Note: Speaker uses BCLK=41, SDATA=42, LRCLK=43
+// ~21 ms descriptors, 128 ms queue at the 48 kHz speaker rate. The speaker is
+// mono: a stereo frame would need 4096 bytes per descriptor, over the 4092 limit
+constexpr I2sDmaPlan i2s_dma_plan = I2sDmaPlanFor(48000, 1, 16, 128000, 21333);
+static_assert(i2s_dma_plan.valid && i2s_dma_plan.latency_us == 128000, "DMA queue is not whole descriptors");
+
 I2sBusConfig i2s_bus_cfg(
     I2S_NUM_0,
     I2S_ROLE_MASTER,
-    6,    // dma_desc_num
-    1024, // dma_frame_num
+    i2s_dma_plan.desc_num,  // dma_desc_num
+    i2s_dma_plan.frame_num, // dma_frame_num
     true, // auto_clear_after_cb
     false, // auto_clear_before_cb
     0     // intr_priority
@@ -143,6 +150,8 @@ SpiDisplay display(logger_display, spi_bus);
 I2sBus i2s_bus(logger_i2s);
 Speaker speaker(logger_spk);
 Microphone mic(logger_mic);
+// PDM capture carries a DC offset and handling rumble: 4th-order Butterworth high-pass at 80 Hz
+BiquadFilter<2> mic_filter(ButterworthHighPass<4>(16000, 80));
 
 bool M5StackCardputer::Init()
 {
@@ -152,6 +161,8 @@ bool M5StackCardputer::Init()
   i2s_bus.Init(i2s_bus_cfg);//pass
   i2s_bus.ConfigureTxChannel(i2s_speaker_chan_cfg);//pass
   i2s_bus.ConfigureRxChannel(i2s_mic_chan_cfg);//pass
+  mic.Init(i2s_bus);
+  mic.AddCaptureProcessor(&mic_filter);
 
   // 5. Keyboard Init (Cardputer Matrix)
   KeyboardConfig keyboard_config;
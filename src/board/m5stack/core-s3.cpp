@@ -1,4 +1,3 @@
-#include <tuple>
 
 #include "esp_lcd_ili9341.h"
 #include "esp_lcd_touch_ft5x06.h"
@@ -8,6 +7,7 @@
 #include "wrapper/i2c.hpp"
 #include "wrapper/spi.hpp"
 #include "wrapper/i2s.hpp"
+#include "wrapper/i2s-dma.hpp"
 #include "wrapper/display.hpp"
 #include "wrapper/touch.hpp"
 #include "wrapper/lvgl.hpp"
@@ -18,11 +18,16 @@
 #include "device/ili9341.hpp"
 
 #include "board/m5stack/core-s3.hpp"
+#include "board/m5stack/speaker-eq.hpp"
 
 namespace wrapper
 {
 
-I2sBusConfig bus_config(I2S_NUM_0, I2S_ROLE_MASTER, 6, 240, true, false, 0);
+// 15 ms descriptors, 90 ms queue; the 4-slot TDM capture has the widest frame
+constexpr I2sDmaPlan audio_dma_plan = I2sDmaPlanFor(16000, 4, 16, 90000, 15000);
+static_assert(audio_dma_plan.valid && audio_dma_plan.latency_us == 90000, "DMA queue is not whole descriptors");
+
+I2sBusConfig bus_config(I2S_NUM_0, I2S_ROLE_MASTER, audio_dma_plan.desc_num, audio_dma_plan.frame_num, true, false, 0);
 
 I2sChanStdConfig tx_config(
     // clk_cfg
@@ -220,6 +225,8 @@ Ili9341 ili9341(logger_ili9341, spi_bus);
 LvglPort lvgl_port(logger_lvgl);
 
 AudioCodec audio_codec(logger_audio_codec);
+constexpr auto speaker_eq_sections = EqDesign(M5STACK_CORE_S3_SPEAKER_RATE, M5STACK_CORE_S3_SPEAKER_EQ);
+Equalizer<4> speaker_eq(M5STACK_CORE_S3_SPEAKER_RATE, speaker_eq_sections);
 std::function<esp_err_t()> spk_codec_new_func = []() -> esp_err_t
 {
   aw88298_codec_cfg_t aw88298_cfg = {
@@ -309,11 +316,7 @@ bool M5StackCoreS3::InitDevice(bool power, bool audio, bool display, bool touch)
       // AXP2101
       if (!axp2101.Init(i2c_bus1, axp2101_config)) return false;
       
-      uint8_t data = 0x00;
-      if (!axp2101.ReadReg8(0x90, data, -1)) return false;
-      data |= 0b10110100;
-      std::tuple<uint8_t, uint8_t> axp_cmds[] = {
-          {0x90, data},
+      static constexpr I2cRegWrite axp_cmds[] = {
           {0x99, (uint8_t)(0b11110 - 5)},
           {0x97, (uint8_t)(0b11110 - 2)},
           {0x69, 0b00110101},
@@ -322,16 +325,14 @@ bool M5StackCoreS3::InitDevice(bool power, bool audio, bool display, bool touch)
           {0x94, 33 - 5},
           {0x95, 33 - 5},
       };
-      for (const auto &[reg, value] : axp_cmds)
-      {
-        if (!axp2101.WriteReg8(reg, value, -1)) return false;
-      }
+      if (!axp2101.WriteRegBits(0x90, 0b10110100, 0b10110100, -1)) return false;
+      if (!axp2101.WriteRegSequence(axp_cmds, -1)) return false;
       axp2101.GetLogger().Info("Configured successfully");
 
-      // AW9523
+      // AW9523, auto-increments so this goes out as two bursts
       if (!aw9523.Init(i2c_bus1, aw9523_config)) return false;
       
-      std::tuple<uint8_t, uint8_t> aw_cmds[] = {
+      static constexpr I2cRegWrite aw_cmds[] = {
           {0x02, 0b00000111},
           {0x03, 0b10001111},
           {0x04, 0b00011000},
@@ -340,14 +341,7 @@ bool M5StackCoreS3::InitDevice(bool power, bool audio, bool display, bool touch)
           {0x12, 0b11111111},
           {0x13, 0b11111111},
       };
-      for (const auto &[reg, value] : aw_cmds)
-      {
-        if (!aw9523.WriteReg8(reg, value, -1))
-        {
-          aw9523.GetLogger().Error("Failed to write register 0x%02X", reg);
-          return false;
-        }
-      }
+      if (!aw9523.WriteRegSequence(aw_cmds, -1)) return false;
       aw9523.GetLogger().Info("Configured successfully");
   }
 
@@ -446,4 +440,9 @@ AudioCodec& M5StackCoreS3::GetAudioCodec()
   return audio_codec;
 }
 
+Equalizer<4>& M5StackCoreS3::GetSpeakerEq()
+{
+  return speaker_eq;
+}
+
 } // namespace wrapper
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "wrapper/touch.hpp"
 #include "wrapper/lvgl.hpp"
 #include "wrapper/audio.hpp"
+#include "dsp/equalizer.hpp"
 #include "device/axp2101.hpp"
 #include "device/aw9523.hpp"
 
@@ -47,6 +48,8 @@ public:
   Aw9523& GetGpioExpander();
   LvglPort& GetLvglPort();
   AudioCodec& GetAudioCodec();
+  // Not attached by Init, see board/m5stack/speaker-eq.hpp
+  Equalizer<4>& GetSpeakerEq();
 };
 
 } // namespace wrapper
@@ -6,9 +6,8 @@
 #include <esp_timer.h>
 #include <driver/gpio.h>
 
-#include <map>
-
 #include "board/m5stack/powerhub.hpp"
+#include "wrapper/i2c-reg.hpp"
 
 namespace wrapper {
 
@@ -143,26 +142,11 @@ private:
     };
 };
 
-struct LedRegisterInfo {
-    uint8_t colorStartReg;
-    uint8_t brightnessReg;
-};
-
-struct VARegisterInfo {
-    uint8_t voltageReg;
-    uint8_t currentReg;
-};
-
-static const std::map<LedControl, LedRegisterInfo> ledRegisterMap = {
-    {LedControl::USB_C, {0x60, 0x80}}, {LedControl::USB_A, {0x64, 0x81}},      {LedControl::UART, {0x68, 0x82}},    {LedControl::BUS, {0x6C, 0x83}},
-    {LedControl::I2C, {0x70, 0x84}},   {LedControl::BAT_CHARGE, {0x74, 0x85}}, {LedControl::POWER_L, {0x78, 0x86}}, {LedControl::POWER_R, {0x7C, 0x87}}
-};
-
-static const std::map<VAMonitor, VARegisterInfo> VARegisterMap = {
-    {VAMonitor::BAT, {0x30, 0x32}},       {VAMonitor::CAN_BUS, {0x34, 0x36}},
-    {VAMonitor::RS485_BUS, {0x38, 0x3A}}, {VAMonitor::USB, {0x3C, 0x3E}},
-    {VAMonitor::I2C, {0x40, 0x42}},       {VAMonitor::UART, {0x44, 0x46}}
-};
+// Indexed by the LedControl / VAMonitor value
+using LedColorRegs = I2cRegisterArray<0x60, 8, 4, 3, I2cRegAccess::ReadWrite, I2cEndian::Little>;
+using LedBrightnessRegs = I2cRegisterArray<0x80, 8>;
+using VoltageRegs = I2cRegisterArray<0x30, 6, 4, 2, I2cRegAccess::ReadOnly, I2cEndian::Little>;
+using CurrentRegs = I2cRegisterArray<0x32, 6, 4, 2, I2cRegAccess::ReadOnly, I2cEndian::Little>;
 
 PowerHubI2c::PowerHubI2c(Logger& logger) : I2cDevice(logger) {
 }
@@ -185,12 +169,12 @@ esp_err_t PowerHubI2c::Init(const I2cBus& bus, uint8_t addr) {
 }
 
 esp_err_t PowerHubI2c::SetPowerState(PowerControl device, bool state) {
-    return WriteReg8(REG_POWER_CTR + (uint8_t)device, state ? 1 : 0, -1);
+    return WriteReg8(REG_POWER_CTR + (uint8_t)device, state ? 1 : 0, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::GetPowerState(PowerControl device, bool& state) {
     uint8_t val;
-    esp_err_t err = ReadReg8(REG_POWER_CTR + (uint8_t)device, val, -1);
+    esp_err_t err = ReadReg8(REG_POWER_CTR + (uint8_t)device, val, -1) ? ESP_OK : ESP_FAIL;
     if (err == ESP_OK) {
         state = (val != 0);
     }
@@ -198,12 +182,12 @@ esp_err_t PowerHubI2c::GetPowerState(PowerControl device, bool& state) {
 }
 
 esp_err_t PowerHubI2c::SetUSBMode(USBMode mode) {
-    return WriteReg8(REG_USB_MODE, (uint8_t)mode, -1);
+    return WriteReg8(REG_USB_MODE, (uint8_t)mode, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::GetUSBMode(USBMode& mode) {
     uint8_t val;
-    esp_err_t err = ReadReg8(REG_USB_MODE, val, -1);
+    esp_err_t err = ReadReg8(REG_USB_MODE, val, -1) ? ESP_OK : ESP_FAIL;
     if (err == ESP_OK) {
         mode = (USBMode)val;
     }
@@ -217,12 +201,12 @@ esp_err_t PowerHubI2c::SetBusConfig(const BusConfig& config) {
     data[2] = config.currentLimit;
     data[3] = config.enable;
     data[4] = config.direction;
-    return WriteRegBytes(REG_BUS_CFG, data, -1);
+    return WriteRegBytes(REG_BUS_CFG, data, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::GetBusConfig(BusConfig& config) {
     std::vector<uint8_t> data(5);
-    esp_err_t err = ReadRegBytes(REG_BUS_CFG, data, 5, -1);
+    esp_err_t err = ReadRegBytes(REG_BUS_CFG, data, 5, -1) ? ESP_OK : ESP_FAIL;
     if (err == ESP_OK) {
         config.voltage = (data[1] << 8) | data[0];
         config.currentLimit = data[2];
@@ -233,43 +217,29 @@ esp_err_t PowerHubI2c::GetBusConfig(BusConfig& config) {
 }
 
 esp_err_t PowerHubI2c::GetDeviceVoltage(VAMonitor device, uint16_t& voltage) {
-    if (VARegisterMap.find(device) == VARegisterMap.end()) return ESP_ERR_INVALID_ARG;
-    uint8_t reg = VARegisterMap.at(device).voltageReg;
-    std::vector<uint8_t> data(2);
-    esp_err_t err = ReadRegBytes(reg, data, 2, -1);
-    if (err == ESP_OK) {
-        voltage = (uint16_t)((data[1] << 8) | data[0]);
-    }
-    return err;
+    if (!VoltageRegs::Contains((size_t)device)) return ESP_ERR_INVALID_ARG;
+    return VoltageRegs::Read(*this, (size_t)device, voltage, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::GetDeviceCurrent(VAMonitor device, int16_t& current) {
-    if (VARegisterMap.find(device) == VARegisterMap.end()) return ESP_ERR_INVALID_ARG;
-    uint8_t reg = VARegisterMap.at(device).currentReg;
-    std::vector<uint8_t> data(2);
-    esp_err_t err = ReadRegBytes(reg, data, 2, -1);
-    if (err == ESP_OK) {
-        current = (int16_t)((data[1] << 8) | data[0]);
-    }
-    return err;
+    if (!CurrentRegs::Contains((size_t)device)) return ESP_ERR_INVALID_ARG;
+    uint16_t raw;
+    if (!CurrentRegs::Read(*this, (size_t)device, raw, -1)) return ESP_FAIL;
+    current = (int16_t)raw;
+    return ESP_OK;
 }
 
 esp_err_t PowerHubI2c::GetChargeStatus(uint8_t& status) {
-    return ReadReg8(REG_CHG_STA, status, -1);
+    return ReadReg8(REG_CHG_STA, status, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::GetPowerSupplyStatus(uint8_t& status) {
-    return ReadReg8(REG_PWR_SUP, status, -1);
+    return ReadReg8(REG_PWR_SUP, status, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::SetLEDColor(LedControl device, uint32_t color) {
-    if (ledRegisterMap.find(device) == ledRegisterMap.end()) return ESP_ERR_INVALID_ARG;
-    uint8_t reg = ledRegisterMap.at(device).colorStartReg;
-    std::vector<uint8_t> data(3);
-    data[0] = color & 0xFF;
-    data[1] = (color >> 8) & 0xFF;
-    data[2] = (color >> 16) & 0xFF;
-    return WriteRegBytes(reg, data, -1);
+    if (!LedColorRegs::Contains((size_t)device)) return ESP_ERR_INVALID_ARG;
+    return LedColorRegs::Write(*this, (size_t)device, color & 0xFFFFFF, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::UpdateLedColors(const std::vector<uint32_t>& colors) {
@@ -282,45 +252,39 @@ esp_err_t PowerHubI2c::UpdateLedColors(const std::vector<uint32_t>& colors) {
         data[i * 4 + 3] = 0x00;
     }
     // Assume start from first LED (USB_C)
-    return WriteRegBytes(ledRegisterMap.at(LedControl::USB_C).colorStartReg, data, -1);
+    return WriteRegBytes(LedColorRegs::Addr((size_t)LedControl::USB_C), data, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::GetLEDColor(LedControl device, uint32_t& color) {
-    if (ledRegisterMap.find(device) == ledRegisterMap.end()) return ESP_ERR_INVALID_ARG;
-    uint8_t reg = ledRegisterMap.at(device).colorStartReg;
-    std::vector<uint8_t> data(3);
-    esp_err_t err = ReadRegBytes(reg, data, 3, -1);
-    if (err == ESP_OK) {
-        color = (data[2] << 16) | (data[1] << 8) | data[0];
-    }
-    return err;
+    if (!LedColorRegs::Contains((size_t)device)) return ESP_ERR_INVALID_ARG;
+    return LedColorRegs::Read(*this, (size_t)device, color, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::SetLEDBrightness(LedControl device, uint8_t brightness) {
-    if (ledRegisterMap.find(device) == ledRegisterMap.end()) return ESP_ERR_INVALID_ARG;
-    return WriteReg8(ledRegisterMap.at(device).brightnessReg, brightness, -1);
+    if (!LedBrightnessRegs::Contains((size_t)device)) return ESP_ERR_INVALID_ARG;
+    return LedBrightnessRegs::Write(*this, (size_t)device, brightness, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::GetLEDBrightness(LedControl device, uint8_t& brightness) {
-    if (ledRegisterMap.find(device) == ledRegisterMap.end()) return ESP_ERR_INVALID_ARG;
-    return ReadReg8(ledRegisterMap.at(device).brightnessReg, brightness, -1);
+    if (!LedBrightnessRegs::Contains((size_t)device)) return ESP_ERR_INVALID_ARG;
+    return LedBrightnessRegs::Read(*this, (size_t)device, brightness, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::GetSC8721Config(SC8721Config& config) {
     uint8_t writeData = 1;
-    esp_err_t err = WriteReg8(REG_SC8721_CFG, writeData, -1);
+    esp_err_t err = WriteReg8(REG_SC8721_CFG, writeData, -1) ? ESP_OK : ESP_FAIL;
     if (err != ESP_OK) return err;
 
     const unsigned long timeout = 1000;
     unsigned long startTime = (unsigned long)(esp_timer_get_time() / 1000ULL);
 
     while ((unsigned long)(esp_timer_get_time() / 1000ULL) - startTime <= timeout) {
-        err = ReadReg8(REG_SC8721_CFG, writeData, -1);
+        err = ReadReg8(REG_SC8721_CFG, writeData, -1) ? ESP_OK : ESP_FAIL;
         if (err != ESP_OK) return err;
 
         if (writeData == 0) {
             std::vector<uint8_t> data(10);
-            err = ReadRegBytes(REG_SC8721_CFG + 1, data, 10, -1);
+            err = ReadRegBytes(REG_SC8721_CFG + 1, data, 10, -1) ? ESP_OK : ESP_FAIL;
             if (err == ESP_OK) {
                 config.csoValue = data[0];
                 config.slopeCompensation = data[1];
@@ -342,7 +306,7 @@ bool PowerHubI2c::GetButtonState(ButtonKey key) {
         return gpio_get_level((gpio_num_t)key);
     } else {
         uint8_t data;
-        if (ReadReg8(REG_BUTTON, data, -1) == ESP_OK) {
+        if (ReadReg8(REG_BUTTON, data, -1)) {
             return (data >> (int)key) & 0x01;
         }
         return false;
@@ -350,12 +314,12 @@ bool PowerHubI2c::GetButtonState(ButtonKey key) {
 }
 
 esp_err_t PowerHubI2c::SetWakeUpSource(WakeUpSource source, bool state) {
-    return WriteReg8(REG_WAKEUP + (uint8_t)source, state ? 1 : 0, -1);
+    return WriteReg8(REG_WAKEUP + (uint8_t)source, state ? 1 : 0, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::CheckWakeUpSource(WakeUpSource source, bool& state) {
     uint8_t val;
-    esp_err_t err = ReadReg8(REG_WAKEUP + (uint8_t)source, val, -1);
+    esp_err_t err = ReadReg8(REG_WAKEUP + (uint8_t)source, val, -1) ? ESP_OK : ESP_FAIL;
     if (err == ESP_OK) {
         state = (val != 0);
     }
@@ -372,12 +336,12 @@ esp_err_t PowerHubI2c::SetRTCTime(const RtcTime& time) {
     data[5] = time.year;
     uint8_t wday_map[] = {2, 4, 8, 10, 20, 40, 1}; // Mon -> Sun
     data[6] = (time.wday >= 1 && time.wday <= 7) ? wday_map[time.wday - 1] : 0;
-    return WriteRegBytes(REG_RTC_TIME, data, -1);
+    return WriteRegBytes(REG_RTC_TIME, data, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::GetRTCTime(RtcTime& time) {
     std::vector<uint8_t> data(7);
-    esp_err_t err = ReadRegBytes(REG_RTC_TIME, data, 7, -1);
+    esp_err_t err = ReadRegBytes(REG_RTC_TIME, data, 7, -1) ? ESP_OK : ESP_FAIL;
     if (err == ESP_OK) {
         time.sec = data[0];
         time.min = data[1];
@@ -404,12 +368,12 @@ esp_err_t PowerHubI2c::SetAlarmTime(const AlarmTime& time) {
     data[0] = time.min;
     data[1] = time.hour;
     data[2] = time.day;
-    return WriteRegBytes(REG_RTC_ALARM, data, -1);
+    return WriteRegBytes(REG_RTC_ALARM, data, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::GetAlarmTime(AlarmTime& time) {
     std::vector<uint8_t> data(3);
-    esp_err_t err = ReadRegBytes(REG_RTC_ALARM, data, 3, -1);
+    esp_err_t err = ReadRegBytes(REG_RTC_ALARM, data, 3, -1) ? ESP_OK : ESP_FAIL;
     if (err == ESP_OK) {
         time.min = data[0];
         time.hour = data[1];
@@ -419,12 +383,12 @@ esp_err_t PowerHubI2c::GetAlarmTime(AlarmTime& time) {
 }
 
 esp_err_t PowerHubI2c::SetAlarmState(bool state) {
-    return WriteReg8(REG_RTC_ALARM_CTR, state ? 1 : 0, -1);
+    return WriteReg8(REG_RTC_ALARM_CTR, state ? 1 : 0, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::GetAlarmState(bool& state) {
     uint8_t val;
-    esp_err_t err = ReadReg8(REG_RTC_ALARM_CTR, val, -1);
+    esp_err_t err = ReadReg8(REG_RTC_ALARM_CTR, val, -1) ? ESP_OK : ESP_FAIL;
     if (err == ESP_OK) {
         state = (val != 0);
     }
@@ -432,23 +396,23 @@ esp_err_t PowerHubI2c::GetAlarmState(bool& state) {
 }
 
 esp_err_t PowerHubI2c::PowerOff() {
-    return WriteReg8(REG_POWER_OFF, 1, -1);
+    return WriteReg8(REG_POWER_OFF, 1, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::GetBootloaderVersion(uint8_t& version) {
-    return ReadReg8(REG_BL_VERSION, version, -1);
+    return ReadReg8(REG_BL_VERSION, version, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::GetFirmwareVersion(uint8_t& version) {
-    return ReadReg8(REG_FW_VERSION, version, -1);
+    return ReadReg8(REG_FW_VERSION, version, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::SetI2CAddress(uint8_t newAddr) {
-    return WriteReg8(REG_I2C_ADDR_CFG, newAddr, -1);
+    return WriteReg8(REG_I2C_ADDR_CFG, newAddr, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::GetI2CAddress(uint8_t& addr) {
-    return ReadReg8(REG_I2C_ADDR_CFG, addr, -1);
+    return ReadReg8(REG_I2C_ADDR_CFG, addr, -1) ? ESP_OK : ESP_FAIL;
 }
 
 esp_err_t PowerHubI2c::SaveConfig() {
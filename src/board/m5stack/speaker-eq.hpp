@@ -0,0 +1,33 @@
+#pragma once
+
+#include "dsp/equalizer.hpp"
+
+namespace wrapper
+{
+
+// Speaker tunings for the built-in drivers. The boards build an Equalizer from them but do not attach it:
+// it changes what every app plays, so an app opts in with
+//   board.GetAudioCodec().AddPlaybackProcessor(&board.GetSpeakerEq());
+
+// Starting point for the CoreS3 AW88298 speaker at 16 kHz: keep content below what the small driver can
+// move out, lift its upper bass, tame the upper-mid peak and restore some air. Retune against a
+// measurement of the enclosure
+constexpr double M5STACK_CORE_S3_SPEAKER_RATE = 16000;
+constexpr EqSpec<4> M5STACK_CORE_S3_SPEAKER_EQ{-4.0, {{
+    {EqType::HighPass, 250.0, 0.0, 0.707},
+    {EqType::Peaking, 600.0, 4.0, 1.0},
+    {EqType::Peaking, 2800.0, -3.0, 1.5},
+    {EqType::HighShelf, 5000.0, 3.0, 0.707},
+}}};
+
+// Starting point for the Tab5 ES8388 speaker at 48 kHz: roll off below the driver's range, add some
+// low-mid body, soften presence and lift the top octave. Retune against a measurement of the enclosure
+constexpr double M5STACK_TAB5_SPEAKER_RATE = 48000;
+constexpr EqSpec<4> M5STACK_TAB5_SPEAKER_EQ{-3.0, {{
+    {EqType::HighPass, 150.0, 0.0, 0.707},
+    {EqType::Peaking, 300.0, 3.0, 0.9},
+    {EqType::Peaking, 3500.0, -2.0, 2.0},
+    {EqType::HighShelf, 10000.0, 2.0, 0.707},
+}}};
+
+} // namespace wrapper
@@ -3,6 +3,8 @@
 #include "board/m5stack/tab5.hpp"
 #include "device/ili9881c.hpp"
 #include "device/gt911.hpp"
+#include "wrapper/i2s-dma.hpp"
+#include "board/m5stack/speaker-eq.hpp"
 
 namespace wrapper
 {
@@ -107,11 +109,15 @@ namespace wrapper
       nullptr,
       nullptr);
 
+  // ~5.3 ms descriptors, 32 ms queue, 48 kHz mono
+  constexpr I2sDmaPlan i2s_dma_plan = I2sDmaPlanFor(48000, 1, 16, 32000, 5333);
+  static_assert(i2s_dma_plan.valid && i2s_dma_plan.latency_us == 32000, "DMA queue is not whole descriptors");
+
   I2sBusConfig i2s_bus_cfg(
       I2S_NUM_0,
       I2S_ROLE_MASTER,
-      6,
-      256,
+      i2s_dma_plan.desc_num,
+      i2s_dma_plan.frame_num,
       true,
       false,
       0);
@@ -208,6 +214,8 @@ namespace wrapper
   LvglPort lvgl_port(llvgl);
 
   AudioCodec audio_codec(laudio);
+  constexpr auto speaker_eq_sections = EqDesign(M5STACK_TAB5_SPEAKER_RATE, M5STACK_TAB5_SPEAKER_EQ);
+  Equalizer<4> speaker_eq(M5STACK_TAB5_SPEAKER_RATE, speaker_eq_sections);
   std::function<esp_err_t()> spk_codec_new_func = []() -> esp_err_t
   {
     es8388_codec_cfg_t spk_codec_cfg = {
@@ -430,6 +438,11 @@ namespace wrapper
     return audio_codec;
   }
 
+  Equalizer<4>& M5StackTab5::GetSpeakerEq()
+  {
+    return speaker_eq;
+  }
+
   LvglPort& M5StackTab5::GetLvglPort()
   {
     return lvgl_port;
@@ -8,6 +8,7 @@
 #include "wrapper/touch.hpp"
 #include "wrapper/audio.hpp"
 #include "wrapper/lvgl.hpp"
+#include "dsp/equalizer.hpp"
 #include "device/pi4ioe5v6408.hpp"
 #include "device/ili9881c.hpp"
 #include "device/gt911.hpp"
@@ -45,6 +46,8 @@ namespace wrapper
         Gt911& GetGt911Touch();
         I2sBus& GetI2sBus();
         AudioCodec& GetAudioCodec();
+        // Not attached by Init, see board/m5stack/speaker-eq.hpp
+        Equalizer<4>& GetSpeakerEq();
         LvglPort& GetLvglPort();
 
         void SetDisplayBrightness(int percent);
@@ -5,6 +5,7 @@ namespace wrapper
 
 Aw9523::Aw9523(Logger& logger) : I2cDevice(logger)
 {
+    SetRegAutoIncrement(true);
 }
 
 Aw9523::~Aw9523()
@@ -1,5 +1,6 @@
 #pragma once
 #include "wrapper/i2c.hpp"
+#include "wrapper/i2c-reg.hpp"
 
 namespace wrapper
 {
@@ -10,25 +11,25 @@ public:
     static constexpr uint8_t I2C_ADDR_DEFAULT = 0x75;
     static constexpr uint32_t I2C_SPEED_HZ = 100000;
 
-    static constexpr uint8_t REG_SYS_CTL0 = 0x00;
-    static constexpr uint8_t REG_SYS_CTL1 = 0x01;
-    static constexpr uint8_t REG_SYS_CTL2 = 0x02;
+    using SysCtl0 = I2cRegister<0x00>;
+    using SysCtl1 = I2cRegister<0x01>;
+    using SysCtl2 = I2cRegister<0x02>;
 
-    static constexpr uint8_t REG_CHARGER_CTL0 = 0x20;
-    static constexpr uint8_t REG_CHARGER_CTL1 = 0x21;
-    static constexpr uint8_t REG_CHARGER_CTL2 = 0x22;
-    static constexpr uint8_t REG_CHARGER_CTL3 = 0x23;
+    using ChargerCtl0 = I2cRegister<0x20>;
+    using ChargerCtl1 = I2cRegister<0x21>;
+    using ChargerCtl2 = I2cRegister<0x22>;
+    using ChargerCtl3 = I2cRegister<0x23>;
 
-    static constexpr uint8_t REG_CHG_DIG_CTL0 = 0x24;
+    using ChgDigCtl0 = I2cRegister<0x24>;
 
-    static constexpr uint8_t REG_READ0 = 0x70;
-    static constexpr uint8_t REG_READ0_BIT_CHARGE_EN = 3;  // 充电使能标志
-    
-    static constexpr uint8_t REG_READ1 = 0x71;
-    static constexpr uint8_t REG_READ1_BIT_CHARGE_STATUS = 3;
+    using Read0 = I2cRegister<0x70, 1, I2cRegAccess::ReadOnly>;
+    using Read0ChargeEnable = I2cField<Read0, 3, 1, bool>;  // 充电使能标志
 
-    static constexpr uint8_t REG_READ2 = 0x72;
-    static constexpr uint8_t REG_READ3 = 0x77;
+    using Read1 = I2cRegister<0x71, 1, I2cRegAccess::ReadOnly>;
+    using Read1ChargeStatus = I2cField<Read1, 3, 1, bool>;
+
+    using Read2 = I2cRegister<0x72, 1, I2cRegAccess::ReadOnly>;
+    using Read3 = I2cRegister<0x77, 1, I2cRegAccess::ReadOnly>;
 
     // Charger voltage cutoff settings (REG_CHARGER_CTL0 bits 1:0)
     enum class ChargerVoltage : uint8_t
@@ -39,6 +40,8 @@ public:
         V_4_2_4_305_4_35_4_395 = 0b11
     };
 
+    using ChargerCtl0Voltage = I2cField<ChargerCtl0, 0, 2, ChargerVoltage>;
+
     Ip5306(Logger &logger) : I2cDevice(logger)
     {
     }
@@ -4,13 +4,11 @@ namespace wrapper
 {
 
   bool UnitExtio2::setPwmDutyCycle(uint8_t pin, uint8_t duty) {
-    uint8_t reg = pin + EXTIO2_PWM_DUTY_CYCLE_REG;
-    return WriteReg8(reg, duty, 1000);
+    return PwmDutyRegs::Write(*this, pin, duty, 1000);
   }
 
   bool UnitExtio2::setPwmFrequency(uint8_t pin, uint8_t freq) {
-    uint8_t reg = pin + EXTIO2_PWM_FREQUENCY_REG;
-    return WriteReg8(reg, freq, 1000);
+    return PwmFrequencyRegs::Write(*this, pin, freq, 1000);
   }
 
   bool UnitExtio2::Init(const I2cBus &bus)
@@ -22,7 +20,7 @@ namespace wrapper
   UnitExtio2::Mode UnitExtio2::GetMode(int pin)
   {
     uint8_t mode = 0xFF;
-    if (ReadReg8(REG_MODE_IO(pin), mode, 1000) == true)
+    if (ModeRegs::Read(*this, pin, mode, 1000) == true)
     {
       return static_cast<Mode>(mode);
     }
@@ -32,7 +30,7 @@ namespace wrapper
   bool UnitExtio2::SetMode(int pin, Mode mode)
   {
 
-    bool result = WriteReg8(REG_MODE_IO(pin), static_cast<uint8_t>(mode), 1000);
+    bool result = ModeRegs::Write(*this, pin, static_cast<uint8_t>(mode), 1000);
     GetLogger().Info("SetMode Pin %d: %d. result: %s", pin, static_cast<uint8_t>(mode), result ? "Success" : "Failure");
     return result;
   }
@@ -41,9 +39,9 @@ namespace wrapper
   {
     GetLogger().Info("SetMode All: %d", static_cast<uint8_t>(mode));
     bool success = true;
-    for (int pin = 0; pin < 8; pin++)
+    for (size_t pin = 0; pin < ModeRegs::count; pin++)
     {
-      success = WriteReg8(REG_MODE_IO(pin), static_cast<uint8_t>(mode), 1000) && success;
+      success = ModeRegs::Write(*this, pin, static_cast<uint8_t>(mode), 1000) && success;
     }
     return success;
   }
@@ -51,19 +49,19 @@ namespace wrapper
   bool UnitExtio2::SetDigitalOutput(int pin, bool state)
   {
     GetLogger().Debug("SetDigitalOutput: %d", state ? 1 : 0);
-    return WriteReg8(REG_OUTPUT_CTL_IO(pin), state ? 1 : 0, 1000) == true;
+    return OutputRegs::Write(*this, pin, state ? 1 : 0, 1000) == true;
   }
 
   bool UnitExtio2::SetDigitalOutputs(uint8_t states)
   {
     GetLogger().Debug("SetDigitalOutputs: 0x%02X", states);
-    return WriteReg8(Reg::OUTPUTS_CTL, states, 1000) == true;
+    return Outputs::Write(*this, states, 1000) == true;
   }
 
   int UnitExtio2::GetDigitalInput(int pin)
   {
     uint8_t state = 0;
-    if (ReadReg8(REG_DIGITAL_INPUT_IO(pin), state, 1000) == true)
+    if (DigitalInputRegs::Read(*this, pin, state, 1000) == true)
     {
       GetLogger().Debug("GetDigitalInput Pin %d: %d", pin, state ? 1 : 0);
       return state ? 1 : 0;
@@ -2,6 +2,7 @@
 
 #include "wrapper/logger.hpp"
 #include "wrapper/i2c.hpp"
+#include "wrapper/i2c-reg.hpp"
 #include "wrapper/display.hpp"
 
 namespace wrapper
@@ -12,79 +13,20 @@ class UnitExtio2 : public I2cDevice
 
 
 
-  enum Reg : uint8_t
-  {
-    MODE_BASE = 0x00,
-    MODE_IO0 = 0x00,
-    MODE_IO1,
-    MODE_IO2,
-    MODE_IO3,
-    MODE_IO4,
-    MODE_IO5,
-    MODE_IO6,
-    MODE_IO7,
-
-    OUTPUT_CTL_BASE = 0x10,
-    OUTPUT_CTL_IO0 = 0x10,
-    OUTPUT_CTL_IO1,
-    OUTPUT_CTL_IO2,
-    OUTPUT_CTL_IO3,
-    OUTPUT_CTL_IO4,
-    OUTPUT_CTL_IO5,
-    OUTPUT_CTL_IO6,
-    OUTPUT_CTL_IO7,
-    OUTPUTS_CTL = 0x18,
-
-    DIGITAL_INPUT_BASE = 0x20,
-    DIGITAL_INPUT_IO0 = 0x20,
-    DIGITAL_INPUT_IO1,
-    DIGITAL_INPUT_IO2,
-    DIGITAL_INPUT_IO3,
-    DIGITAL_INPUT_IO4,
-    DIGITAL_INPUT_IO5,
-    DIGITAL_INPUT_IO6,
-    DIGITAL_INPUT_IO7,
-    DIGITAL_INPUTS = 0x28,
-
-    ANALOG_INPUT_8B = 0x30,
-    ANALOG_INPUT_12B = 0x40,
-
-    SERVO_ANGLE_8B = 0x50,
-    SERVO_PULSE_16B = 0x60,
-
-    RGB_24B = 0x70,
-    EXTIO2_PWM_DUTY_CYCLE_REG = 0x90,
-    EXTIO2_PWM_FREQUENCY_REG = 0xA0,
-    FW_VERSION = 0xFE,
-    ADDRESS = 0xFF
-  };
-
-
-
-  constexpr static inline uint8_t REG_MODE_IO(uint8_t pin)
-  {
-    return static_cast<uint8_t>(Reg::MODE_BASE) + pin;
-  }
-
-  constexpr static inline uint8_t REG_OUTPUT_CTL_IO(uint8_t pin)
-  {
-    return static_cast<uint8_t>(Reg::OUTPUT_CTL_BASE) + pin;
-  }
-
-  constexpr static inline uint8_t REG_DIGITAL_INPUT_IO(uint8_t pin)
-  {
-    return static_cast<uint8_t>(Reg::DIGITAL_INPUT_BASE) + pin;
-  }
-
-  constexpr static inline uint8_t REG_ANALOG_INPUT_8B(uint8_t pin)
-  {
-    return static_cast<uint8_t>(Reg::ANALOG_INPUT_8B) + pin;
-  }
-
-  constexpr static inline uint8_t REG_ANALOG_INPUT_12B(uint8_t pin)
-  {
-    return static_cast<uint8_t>(Reg::ANALOG_INPUT_12B) + pin;
-  }
+  using ModeRegs = I2cRegisterArray<0x00, 8>;
+  using OutputRegs = I2cRegisterArray<0x10, 8>;
+  using Outputs = I2cRegister<0x18>;
+  using DigitalInputRegs = I2cRegisterArray<0x20, 8, 1, 1, I2cRegAccess::ReadOnly>;
+  using DigitalInputs = I2cRegister<0x28, 1, I2cRegAccess::ReadOnly>;
+  using AnalogInput8Regs = I2cRegisterArray<0x30, 8, 1, 1, I2cRegAccess::ReadOnly>;
+  using AnalogInput12Regs = I2cRegisterArray<0x40, 8, 2, 2, I2cRegAccess::ReadOnly, I2cEndian::Little>;
+  using ServoAngleRegs = I2cRegisterArray<0x50, 8>;
+  using ServoPulseRegs = I2cRegisterArray<0x60, 8, 2, 2, I2cRegAccess::ReadWrite, I2cEndian::Little>;
+  using RgbRegs = I2cRegisterArray<0x70, 8, 3, 3, I2cRegAccess::ReadWrite, I2cEndian::Big>; // 0xRRGGBB, R first
+  using PwmDutyRegs = I2cRegisterArray<0x90, 8>;
+  using PwmFrequencyRegs = I2cRegisterArray<0xA0, 8>;
+  using FwVersion = I2cRegister<0xFE, 1, I2cRegAccess::ReadOnly>;
+  using Address = I2cRegister<0xFF>;
 
 public:
 
@@ -0,0 +1,146 @@
+#include "dsp/adpcm.hpp"
+
+namespace wrapper
+{
+
+static constexpr int16_t STEP_TABLE[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
+    34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143,
+    157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+    724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024,
+    3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+};
+
+static constexpr int8_t INDEX_TABLE[16] = {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+static void Step(ImaAdpcmState &state, uint8_t code, int32_t step)
+{
+    int32_t diff = step >> 3;
+    if (code & 4) diff += step;
+    if (code & 2) diff += step >> 1;
+    if (code & 1) diff += step >> 2;
+    state.predictor += (code & 8) ? -diff : diff;
+    if (state.predictor > INT16_MAX) state.predictor = INT16_MAX;
+    if (state.predictor < INT16_MIN) state.predictor = INT16_MIN;
+    state.index += INDEX_TABLE[code];
+    if (state.index < 0) state.index = 0;
+    if (state.index > 88) state.index = 88;
+}
+
+uint8_t ImaAdpcm::EncodeSample(ImaAdpcmState &state, int16_t sample)
+{
+    const int32_t step = STEP_TABLE[state.index];
+    int32_t diff = sample - state.predictor;
+    uint8_t code = 0;
+    if (diff < 0) {
+        code = 8;
+        diff = -diff;
+    }
+    // Quantise exactly as the decoder reconstructs, so both stay in sync
+    if (diff >= step) {
+        code |= 4;
+        diff -= step;
+    }
+    if (diff >= step >> 1) {
+        code |= 2;
+        diff -= step >> 1;
+    }
+    if (diff >= step >> 2) code |= 1;
+    Step(state, code, step);
+    return code;
+}
+
+int16_t ImaAdpcm::DecodeSample(ImaAdpcmState &state, uint8_t code)
+{
+    Step(state, code & 0x0F, STEP_TABLE[state.index]);
+    return (int16_t)state.predictor;
+}
+
+// ImaAdpcmEncoder Implementation
+
+bool ImaAdpcmEncoder::Init(size_t channels, size_t frame_samples)
+{
+    if (!ImaAdpcm::IsValidFrame(channels, frame_samples)) return false;
+    channels_ = channels;
+    frame_samples_ = frame_samples;
+    Reset();
+    return true;
+}
+
+void ImaAdpcmEncoder::Reset()
+{
+    for (auto &state : state_) state = ImaAdpcmState();
+}
+
+size_t ImaAdpcmEncoder::Encode(const int16_t *pcm, uint8_t *packet, size_t packet_size)
+{
+    const size_t block_size = ImaAdpcm::BlockSize(channels_, frame_samples_);
+    if (packet_size < block_size) return 0;
+
+    uint8_t *out = packet;
+    for (size_t ch = 0; ch < channels_; ++ch) {
+        // The header carries the first sample verbatim; the step index persists across blocks
+        ImaAdpcmState &state = state_[ch];
+        state.predictor = pcm[ch];
+        *out++ = (uint8_t)(state.predictor & 0xFF);
+        *out++ = (uint8_t)((state.predictor >> 8) & 0xFF);
+        *out++ = (uint8_t)state.index;
+        *out++ = 0;
+    }
+
+    for (size_t frame = 1; frame < frame_samples_; frame += 8) {
+        for (size_t ch = 0; ch < channels_; ++ch) {
+            ImaAdpcmState &state = state_[ch];
+            const int16_t *src = pcm + frame * channels_ + ch;
+            for (size_t i = 0; i < 8; i += 2) {
+                uint8_t lo = ImaAdpcm::EncodeSample(state, src[i * channels_]);
+                uint8_t hi = ImaAdpcm::EncodeSample(state, src[(i + 1) * channels_]);
+                *out++ = (uint8_t)(lo | (hi << 4));
+            }
+        }
+    }
+    return block_size;
+}
+
+// ImaAdpcmDecoder Implementation
+
+bool ImaAdpcmDecoder::Init(size_t channels, size_t frame_samples)
+{
+    if (!ImaAdpcm::IsValidFrame(channels, frame_samples)) return false;
+    channels_ = channels;
+    frame_samples_ = frame_samples;
+    return true;
+}
+
+size_t ImaAdpcmDecoder::Decode(const uint8_t *packet, size_t packet_size, int16_t *pcm, size_t max_frames)
+{
+    // A WAV file may end with a short block, still made of whole 8 sample groups
+    const size_t header_size = 4 * channels_;
+    if (packet_size < header_size || (packet_size - header_size) % header_size != 0 ||
+        packet_size > ImaAdpcm::BlockSize(channels_, frame_samples_)) return 0;
+    const size_t frames = ImaAdpcm::FrameSamples(channels_, packet_size);
+    if (max_frames < frames) return 0;
+
+    ImaAdpcmState state[ImaAdpcm::MAX_CHANNELS];
+    const uint8_t *in = packet;
+    for (size_t ch = 0; ch < channels_; ++ch) {
+        state[ch].predictor = (int16_t)(in[0] | (in[1] << 8));
+        state[ch].index = in[2] > 88 ? 88 : in[2];
+        pcm[ch] = (int16_t)state[ch].predictor;
+        in += 4;
+    }
+
+    for (size_t frame = 1; frame < frames; frame += 8) {
+        for (size_t ch = 0; ch < channels_; ++ch) {
+            int16_t *dst = pcm + frame * channels_ + ch;
+            for (size_t i = 0; i < 8; i += 2, ++in) {
+                dst[i * channels_] = ImaAdpcm::DecodeSample(state[ch], *in & 0x0F);
+                dst[(i + 1) * channels_] = ImaAdpcm::DecodeSample(state[ch], *in >> 4);
+            }
+        }
+    }
+    return frames;
+}
+
+} // namespace wrapper
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "dsp/audio-encoder.hpp"
+
+namespace wrapper
+{
+
+/**
+ * @brief IMA-ADPCM, 4 bits per sample, in the WAV (Microsoft IMA) block layout
+ *
+ * Block: per channel a 4 byte header (first sample int16 LE, step index,
+ * reserved), then 4 byte groups of 8 samples alternating between channels,
+ * low nibble first. (frame_samples - 1) must be a multiple of 8; 505 frames
+ * give the common 256 byte mono block. Blocks are independent, so a lost
+ * packet only drops its own audio.
+ */
+struct ImaAdpcmState
+{
+    int32_t predictor = 0;
+    int32_t index = 0;
+};
+
+class ImaAdpcm
+{
+public:
+    static constexpr size_t MAX_CHANNELS = 2;
+    static constexpr size_t DEFAULT_FRAME_SAMPLES = 505;
+
+    static uint8_t EncodeSample(ImaAdpcmState &state, int16_t sample);
+    static int16_t DecodeSample(ImaAdpcmState &state, uint8_t code);
+
+    static bool IsValidFrame(size_t channels, size_t frame_samples)
+    {
+        return channels >= 1 && channels <= MAX_CHANNELS && frame_samples > 1 && (frame_samples - 1) % 8 == 0;
+    }
+
+    static constexpr size_t BlockSize(size_t channels, size_t frame_samples)
+    {
+        return 4 * channels + (frame_samples - 1) * channels / 2;
+    }
+
+    // WAV nBlockAlign -> frames per block
+    static constexpr size_t FrameSamples(size_t channels, size_t block_size)
+    {
+        return (block_size - 4 * channels) * 2 / channels + 1;
+    }
+};
+
+class ImaAdpcmEncoder : public AudioEncoder
+{
+    size_t channels_ = 1;
+    size_t frame_samples_ = ImaAdpcm::DEFAULT_FRAME_SAMPLES;
+    ImaAdpcmState state_[ImaAdpcm::MAX_CHANNELS];
+
+public:
+    ImaAdpcmEncoder() = default;
+
+    bool Init(size_t channels, size_t frame_samples = ImaAdpcm::DEFAULT_FRAME_SAMPLES);
+
+    const char *GetName() const override { return "ima-adpcm"; }
+    size_t GetChannels() const override { return channels_; }
+    size_t GetFrameSamples() const override { return frame_samples_; }
+    size_t GetMaxPacketSize() const override { return ImaAdpcm::BlockSize(channels_, frame_samples_); }
+
+    size_t Encode(const int16_t *pcm, uint8_t *packet, size_t packet_size) override;
+    void Reset() override;
+};
+
+class ImaAdpcmDecoder : public AudioDecoder
+{
+    size_t channels_ = 1;
+    size_t frame_samples_ = ImaAdpcm::DEFAULT_FRAME_SAMPLES;
+
+public:
+    ImaAdpcmDecoder() = default;
+
+    bool Init(size_t channels, size_t frame_samples = ImaAdpcm::DEFAULT_FRAME_SAMPLES);
+
+    size_t GetChannels() const override { return channels_; }
+    size_t GetFrameSamples() const override { return frame_samples_; }
+
+    size_t Decode(const uint8_t *packet, size_t packet_size, int16_t *pcm, size_t max_frames) override;
+};
+
+} // namespace wrapper
@@ -0,0 +1,190 @@
+#include <cmath>
+#include "dsp/pcm.hpp"
+#include "dsp/aec.hpp"
+
+namespace wrapper
+{
+
+static constexpr size_t CHUNK = 64;
+static constexpr float SCALE = 1.0f / 32768.0f;
+static constexpr float ENERGY_SMOOTHING = 0.1f;
+
+bool Aec::Init(const AecConfig &config)
+{
+    if (config.taps == 0 || config.step <= 0.0f || config.step >= 2.0f) return false;
+    if (!ref_ring_.Init(config.ref_capacity * sizeof(int16_t))) return false;
+    config_ = config;
+    history_len_ = config.taps + config.delay;
+    weights_.assign(config.taps, 0.0f);
+    history_.assign(history_len_ * 2, 0.0f);
+    Reset();
+    return true;
+}
+
+void Aec::Reset()
+{
+    for (float &w : weights_) w = 0.0f;
+    for (float &x : history_) x = 0.0f;
+    history_pos_ = 0;
+    ref_power_ = 0.0f;
+    dtd_countdown_ = 0;
+    mic_energy_ = 0.0f;
+    err_energy_ = 0.0f;
+    double_talk_samples_ = 0;
+    backlog_drops_ = 0;
+}
+
+void Aec::PushReference(float ref)
+{
+    // Sample leaving the tap window vs the one entering it (delay samples back)
+    const float *window = &history_[history_pos_];
+    float leaving = window[0];
+    history_[history_pos_] = ref;
+    history_[history_pos_ + history_len_] = ref;
+    history_pos_ = (history_pos_ + 1) % history_len_;
+    float entering = history_[history_pos_ + config_.taps - 1];
+    ref_power_ += entering * entering - leaving * leaving;
+    if (ref_power_ < 0.0f) ref_power_ = 0.0f;
+}
+
+void Aec::UpdateReferencePower()
+{
+    // Resync the running sum, float drift accumulates over long streams
+    const float *window = &history_[history_pos_];
+    float power = 0.0f;
+    for (size_t j = 0; j < config_.taps; ++j) power += window[j] * window[j];
+    ref_power_ = power;
+}
+
+float Aec::MaxReference() const
+{
+    const float *window = &history_[history_pos_];
+    float max = 0.0f;
+    for (size_t j = 0; j < config_.taps; ++j) {
+        float a = std::fabs(window[j]);
+        if (a > max) max = a;
+    }
+    return max;
+}
+
+float Aec::ProcessSample(float mic, float max_ref)
+{
+    // window[taps - 1 - k] is the reference k samples into the echo tail
+    const float *window = &history_[history_pos_];
+    float *w = weights_.data();
+    const size_t taps = config_.taps;
+
+    float echo = 0.0f;
+    for (size_t j = 0; j < taps; ++j) echo += w[j] * window[j];
+    float error = mic - echo;
+
+    if (max_ref > 0.0f && std::fabs(mic) > config_.dtd_threshold * max_ref) {
+        dtd_countdown_ = config_.dtd_hold;
+    }
+    if (dtd_countdown_ > 0) {
+        --dtd_countdown_;
+        ++double_talk_samples_;
+        return error;
+    }
+
+    // Regularized so silence on the reference does not blow up the step
+    const float regularization = (float)taps * 1e-6f;
+    float g = config_.step * error / (ref_power_ + regularization);
+    for (size_t j = 0; j < taps; ++j) w[j] += g * window[j];
+    return error;
+}
+
+void Aec::ProcessMono(const int16_t *mic, const int16_t *ref, int16_t *out, size_t count)
+{
+    if (weights_.empty()) return;
+    UpdateReferencePower();
+    float max_ref = MaxReference();
+
+    float mic_energy = 0.0f;
+    float err_energy = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        float x = ref[i] * SCALE;
+        float d = mic[i] * SCALE;
+        PushReference(x);
+        if (std::fabs(x) > max_ref) max_ref = std::fabs(x);
+        float e = ProcessSample(d, max_ref);
+        mic_energy += d * d;
+        err_energy += e * e;
+        out[i] = PcmSaturate16((int32_t)lrintf(e * 32768.0f));
+    }
+
+    // ERLE only means something while the far end is playing
+    if (ref_power_ > (float)config_.taps * 1e-6f) {
+        mic_energy_ += ENERGY_SMOOTHING * (mic_energy - mic_energy_);
+        err_energy_ += ENERGY_SMOOTHING * (err_energy - err_energy_);
+    }
+}
+
+float Aec::GetErleDb() const
+{
+    if (mic_energy_ <= 0.0f || err_energy_ <= 0.0f) return 0.0f;
+    return 10.0f * std::log10(mic_energy_ / err_energy_);
+}
+
+void Aec::Observe(const int16_t *data, size_t frames, size_t channels)
+{
+    if (!ref_ring_.IsValid() || channels == 0) return;
+    int16_t mono[CHUNK];
+    while (frames > 0) {
+        size_t n = frames < CHUNK ? frames : CHUNK;
+        if (channels == 1) {
+            ref_ring_.Write(data, n * sizeof(int16_t));
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                int32_t sum = 0;
+                for (size_t ch = 0; ch < channels; ++ch) sum += data[i * channels + ch];
+                mono[i] = (int16_t)(sum / (int32_t)channels);
+            }
+            ref_ring_.Write(mono, n * sizeof(int16_t));
+        }
+        data += n * channels;
+        frames -= n;
+    }
+}
+
+void Aec::Process(int16_t *data, size_t frames, size_t channels)
+{
+    if (!ref_ring_.IsValid() || channels == 0 || config_.mic_channel >= channels) return;
+
+    // Playback ran ahead (e.g. capture was paused): keep the reference aligned
+    size_t backlog = ref_ring_.Available() / sizeof(int16_t);
+    if (backlog > config_.max_backlog + frames) {
+        size_t drop = backlog - config_.max_backlog - frames;
+        while (drop > 0) {
+            RingSpan span = ref_ring_.GetReadSpan();
+            size_t bytes = drop * sizeof(int16_t) < span.size ? drop * sizeof(int16_t) : span.size;
+            ref_ring_.CommitRead(bytes);
+            drop -= bytes / sizeof(int16_t);
+        }
+        ++backlog_drops_;
+    }
+
+    int16_t mic[CHUNK];
+    int16_t ref[CHUNK];
+    while (frames > 0) {
+        size_t n = frames < CHUNK ? frames : CHUNK;
+        for (size_t i = 0; i < n; ++i) mic[i] = data[i * channels + config_.mic_channel];
+
+        // Missing reference means nothing was played: cancel against silence
+        size_t got = ref_ring_.Read(ref, n * sizeof(int16_t)) / sizeof(int16_t);
+        for (size_t i = got; i < n; ++i) ref[i] = 0;
+
+        ProcessMono(mic, ref, mic, n);
+        for (size_t i = 0; i < n; ++i) {
+            if (config_.replace_all_channels) {
+                for (size_t ch = 0; ch < channels; ++ch) data[i * channels + ch] = mic[i];
+            } else {
+                data[i * channels + config_.mic_channel] = mic[i];
+            }
+        }
+        data += n * channels;
+        frames -= n;
+    }
+}
+
+} // namespace wrapper
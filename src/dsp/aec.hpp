@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "dsp/audio-processor.hpp"
+#include "wrapper/ring-buffer.hpp"
+
+namespace wrapper
+{
+
+struct AecConfig
+{
+    size_t taps = 256;            // echo tail, 16 ms at 16 kHz
+    size_t delay = 0;             // bulk delay in samples added before the tail
+    float step = 0.3f;            // NLMS step size, 0 < step < 2
+    float dtd_threshold = 1.0f;   // Geigel: double talk if |mic| > threshold * max|ref| over the tail
+    size_t dtd_hold = 480;        // samples to keep adaptation frozen after double talk
+    size_t ref_capacity = 4096;   // reference ring in samples, rounded up to a power of two
+    size_t max_backlog = 2048;    // reference samples kept ahead of the capture, older are dropped
+    size_t mic_channel = 0;       // capture channel that is cancelled
+    bool replace_all_channels = true; // write the cleaned signal to every channel of the frame
+
+    AecConfig() = default;
+    AecConfig(size_t tail_taps, size_t bulk_delay = 0) : taps(tail_taps), delay(bulk_delay) {}
+};
+
+/**
+ * @brief Time-domain NLMS acoustic echo canceller
+ *
+ * Observe() on the playback path (AudioMonitor) downmixes the speaker output
+ * into a lock-free reference ring; Process() on the capture path
+ * (AudioProcessor) takes one reference sample per captured frame, estimates
+ * the echo through the adaptive FIR and subtracts it. Adaptation is frozen
+ * while a Geigel detector sees near-end speech.
+ *
+ * One playback task and one capture task may run concurrently. All memory
+ * is allocated in Init.
+ */
+class Aec : public AudioProcessor, public AudioMonitor
+{
+    AecConfig config_;
+    std::vector<float> weights_;
+    std::vector<float> history_;  // double stored, window starts at history_pos_
+    size_t history_len_ = 0;      // taps + delay
+    size_t history_pos_ = 0;
+    float ref_power_ = 0.0f;      // sum of squares over the tap window
+    size_t dtd_countdown_ = 0;
+    SpscRingBuffer ref_ring_;
+
+    // One-pole smoothed powers for ERLE, capture task only
+    float mic_energy_ = 0.0f;
+    float err_energy_ = 0.0f;
+    uint32_t double_talk_samples_ = 0;
+    uint32_t backlog_drops_ = 0;
+
+    void PushReference(float ref);
+    float ProcessSample(float mic, float max_ref);
+    float MaxReference() const;
+    void UpdateReferencePower();
+
+public:
+    Aec() = default;
+
+    bool Init(const AecConfig &config);
+    void Reset();
+
+    const AecConfig &GetConfig() const { return config_; }
+
+    // Playback side: queue speaker output as reference
+    void Observe(const int16_t *data, size_t frames, size_t channels) override;
+
+    // Capture side: cancel echo in place
+    void Process(int16_t *data, size_t frames, size_t channels) override;
+
+    /**
+     * @brief Core canceller with an explicit, already aligned reference
+     * @param mic Near-end mono samples
+     * @param ref Far-end mono samples, one per mic sample
+     * @param out Cleaned samples, may alias mic
+     */
+    void ProcessMono(const int16_t *mic, const int16_t *ref, int16_t *out, size_t count);
+
+    // Echo return loss enhancement of the recent signal, 0 when idle
+    float GetErleDb() const;
+    uint32_t GetDoubleTalkSamples() const { return double_talk_samples_; }
+    uint32_t GetReferenceUnderruns() const { return ref_ring_.GetUnderruns(); }
+    uint32_t GetReferenceOverruns() const { return ref_ring_.GetOverruns(); }
+    uint32_t GetBacklogDrops() const { return backlog_drops_; }
+};
+
+} // namespace wrapper
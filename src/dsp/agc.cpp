@@ -0,0 +1,167 @@
+#include <cmath>
+#include "dsp/agc.hpp"
+#include "dsp/pcm.hpp"
+
+namespace wrapper
+{
+
+static constexpr uint32_t UNITY = 1u << Agc::GAIN_Q;
+
+static int32_t DbToQ16(float db)
+{
+    return (int32_t)(powf(10.0f, db / 20.0f) * UNITY + 0.5f);
+}
+
+bool Agc::Init(uint32_t sample_rate, const AgcConfig &config)
+{
+    if (sample_rate == 0 || config.frame_ms == 0 || config.max_gain_db > 40.0f || config.min_gain_db > config.max_gain_db) {
+        return false;
+    }
+    config_ = config;
+    frame_frames_ = sample_rate * config.frame_ms / 1000;
+    if (frame_frames_ == 0) frame_frames_ = 1;
+    attack_coef_ = config.attack_ms > 0 ? 1.0f - expf(-(float)config.frame_ms / config.attack_ms) : 1.0f;
+    release_coef_ = config.release_ms > 0 ? 1.0f - expf(-(float)config.frame_ms / config.release_ms) : 1.0f;
+    gate_hold_frames_ = config.gate_hold_ms / config.frame_ms;
+
+    limit_ = (int32_t)(32768.0f * powf(10.0f, config.limit_dbfs / 20.0f));
+    if (limit_ > INT16_MAX) limit_ = INT16_MAX;
+    if (limit_ < 1) limit_ = 1;
+    size_t lookahead = (size_t)sample_rate * config.lookahead_ms / 1000;
+    window_ = lookahead < 1 ? 1 : (lookahead < MAX_LOOKAHEAD ? lookahead : MAX_LOOKAHEAD);
+    uint32_t release_frames = (uint32_t)((uint64_t)sample_rate * config.limit_release_ms / 1000);
+    limit_release_step_ = release_frames > 0 ? UNITY / release_frames : UNITY;
+    if (limit_release_step_ == 0) limit_release_step_ = 1;
+
+    Reset();
+    return true;
+}
+
+void Agc::Reset()
+{
+    count_ = 0;
+    sum_sq_ = 0;
+    level_db_ = -100.0f;
+    agc_gain_db_ = 0.0f;
+    gate_gain_db_ = 0.0f;
+    quiet_frames_ = 0;
+    gate_open_ = true;
+    gain_q16_ = UNITY;
+    gain_step_ = 0;
+
+    for (auto &frame : delay_) {
+        for (auto &sample : frame) sample = 0;
+    }
+    min_head_ = 0;
+    min_size_ = 0;
+    for (size_t i = 0; i < MAX_LOOKAHEAD; ++i) box_[i] = UNITY;
+    box_sum_ = (uint64_t)UNITY * window_;
+    envelope_ = UNITY;
+    limiter_gain_ = UNITY;
+    position_ = 0;
+    slot_ = 0;
+}
+
+void Agc::EndFrame()
+{
+    float mean_sq = (float)sum_sq_ / (float)(count_ * sum_channels_);
+    level_db_ = mean_sq > 0 ? 10.0f * log10f(mean_sq / (32768.0f * 32768.0f)) : -100.0f;
+    count_ = 0;
+    sum_sq_ = 0;
+
+    bool quiet = level_db_ < config_.gate_dbfs;
+    if (!quiet) {
+        quiet_frames_ = 0;
+        gate_open_ = true;
+    } else if (quiet_frames_ < gate_hold_frames_) {
+        ++quiet_frames_;
+    } else {
+        gate_open_ = false;
+    }
+
+    // Quiet frames leave the gain where it is instead of adapting to the noise
+    if (!quiet) {
+        float desired = config_.target_dbfs - level_db_;
+        if (desired > config_.max_gain_db) desired = config_.max_gain_db;
+        if (desired < config_.min_gain_db) desired = config_.min_gain_db;
+        float coef = desired < agc_gain_db_ ? attack_coef_ : release_coef_;
+        agc_gain_db_ += (desired - agc_gain_db_) * coef;
+    }
+    float gate_target = gate_open_ ? 0.0f : -config_.gate_range_db;
+    gate_gain_db_ += (gate_target - gate_gain_db_) * (gate_open_ ? attack_coef_ : release_coef_);
+
+    // Ramp to the new gain across the next frame
+    int32_t target = DbToQ16(agc_gain_db_ + gate_gain_db_);
+    gain_step_ = (target - gain_q16_) / (int32_t)frame_frames_;
+}
+
+uint32_t Agc::SlidingMin(uint32_t value)
+{
+    // Monotonic queue of (value, position) over the last window_ frames, increasing from the head
+    if (min_size_ > 0 && position_ - min_index_[min_head_] >= window_) {
+        min_head_ = (min_head_ + 1) % MAX_LOOKAHEAD;
+        --min_size_;
+    }
+    while (min_size_ > 0) {
+        size_t back = (min_head_ + min_size_ - 1) % MAX_LOOKAHEAD;
+        if (min_value_[back] < value) break;
+        --min_size_;
+    }
+    size_t tail = (min_head_ + min_size_) % MAX_LOOKAHEAD;
+    min_value_[tail] = value;
+    min_index_[tail] = position_;
+    ++min_size_;
+    return min_value_[min_head_];
+}
+
+void Agc::Process(int16_t *data, size_t frames, size_t channels)
+{
+    size_t used = channels < MAX_CHANNELS ? channels : MAX_CHANNELS;
+    sum_channels_ = used;
+    for (size_t i = 0; i < frames; ++i) {
+        int16_t *frame = data + i * channels;
+
+        // AGC gain and level measurement on the input
+        int32_t peak = 0;
+        int32_t gained[MAX_CHANNELS];
+        for (size_t ch = 0; ch < used; ++ch) {
+            int32_t x = frame[ch];
+            sum_sq_ += (uint64_t)((int64_t)x * x);
+            int32_t v = (int32_t)(((int64_t)x * gain_q16_) >> GAIN_Q);
+            gained[ch] = v;
+            int32_t a = v < 0 ? -v : v;
+            if (a > peak) peak = a;
+        }
+        gain_q16_ += gain_step_;
+        if (++count_ == frame_frames_) EndFrame();
+
+        // Limiter gain needed by this frame, then the look-ahead window
+        uint32_t needed = peak > limit_ ? (uint32_t)(((uint64_t)limit_ << GAIN_Q) / (uint32_t)peak) : UNITY;
+        uint32_t minimum = SlidingMin(needed);
+        uint32_t released = envelope_ + limit_release_step_;
+        envelope_ = minimum < released ? minimum : released;
+        // Every gain in the box was computed with the leaving frame inside its window,
+        // so their average is already low enough for it
+        limiter_gain_ = (uint32_t)(box_sum_ / window_);
+        box_sum_ += envelope_;
+        box_sum_ -= box_[slot_];
+        box_[slot_] = envelope_;
+
+        // Swap the new frame with the one leaving the delay
+        for (size_t ch = 0; ch < used; ++ch) {
+            int32_t delayed = delay_[slot_][ch];
+            delay_[slot_][ch] = gained[ch];
+            frame[ch] = PcmSaturate16((int32_t)(((int64_t)delayed * limiter_gain_) >> GAIN_Q));
+        }
+        // position_ % window_ would jump when the 32 bit counter wraps and window_ is not a power of two
+        if (++slot_ == window_) slot_ = 0;
+        ++position_;
+    }
+}
+
+float Agc::GetLimiterGainDb() const
+{
+    return 20.0f * log10f((float)limiter_gain_ / UNITY);
+}
+
+} // namespace wrapper
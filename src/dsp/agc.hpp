@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "dsp/audio-processor.hpp"
+
+namespace wrapper
+{
+
+struct AgcConfig
+{
+    uint32_t frame_ms = 10;          // level measurement and gain update period
+    float target_dbfs = -18.0f;      // RMS the AGC steers towards (full-scale sine is -3)
+    float max_gain_db = 30.0f;
+    float min_gain_db = -10.0f;
+    float attack_ms = 20.0f;         // gain decrease time constant
+    float release_ms = 800.0f;       // gain increase time constant
+    float gate_dbfs = -55.0f;        // frames below this do not adapt the gain
+    float gate_range_db = 12.0f;     // extra attenuation while the gate is closed, 0 to only freeze
+    uint32_t gate_hold_ms = 200;     // quiet time before the gate closes
+    float limit_dbfs = -1.0f;        // output peak ceiling
+    uint32_t lookahead_ms = 5;       // limiter delay (at least one frame), the whole processor adds this latency
+    uint32_t limit_release_ms = 60;  // limiter recovery from full reduction to unity
+
+    AgcConfig() = default;
+};
+
+/**
+ * @brief Streaming AGC with noise gate and look-ahead peak limiter
+ *
+ * Every frame_ms the RMS of the block (all channels) is compared with the
+ * target; the gain follows with attack/release smoothing and is ramped per
+ * sample over the next frame. While the level stays under the gate the gain
+ * is frozen, so noise is not pulled up between words, and after gate_hold_ms
+ * the output is attenuated by gate_range_db.
+ *
+ * The limiter delays the signal by lookahead_ms. For each frame it takes the
+ * gain that would bring the channel peak under limit_dbfs, runs a sliding
+ * minimum over the look-ahead window, limits recovery to limit_release_ms and
+ * box-averages the result over the window: the gain has fully reached the
+ * needed value when a peak leaves the delay, so the output never exceeds the
+ * ceiling and there is no hard clip.
+ *
+ * All state is fixed size (MAX_CHANNELS, MAX_LOOKAHEAD frames); Process
+ * never allocates.
+ */
+class Agc : public AudioProcessor
+{
+public:
+    static constexpr size_t MAX_CHANNELS = 2;
+    static constexpr size_t MAX_LOOKAHEAD = 256;
+    static constexpr int GAIN_Q = 16;
+
+private:
+    AgcConfig config_;
+    uint32_t frame_frames_ = 0;
+    float attack_coef_ = 1.0f;
+    float release_coef_ = 1.0f;
+    uint32_t gate_hold_frames_ = 0;
+    int32_t limit_ = 0;
+    uint32_t limit_release_step_ = 0;
+
+    // AGC
+    size_t count_ = 0;
+    uint64_t sum_sq_ = 0;
+    size_t sum_channels_ = 1;
+    float level_db_ = -100.0f;
+    float agc_gain_db_ = 0.0f;
+    float gate_gain_db_ = 0.0f;
+    uint32_t quiet_frames_ = 0;
+    bool gate_open_ = true;
+    int32_t gain_q16_ = 1 << GAIN_Q;
+    int32_t gain_step_ = 0;
+
+    // Limiter: delay line, sliding minimum and box average over window_ frames
+    size_t window_ = 1; // look-ahead, also the delay
+    int32_t delay_[MAX_LOOKAHEAD][MAX_CHANNELS] = {};
+    uint32_t min_value_[MAX_LOOKAHEAD] = {};
+    uint32_t min_index_[MAX_LOOKAHEAD] = {};
+    size_t min_head_ = 0;
+    size_t min_size_ = 0;
+    uint32_t box_[MAX_LOOKAHEAD] = {};
+    uint64_t box_sum_ = 0;
+    uint32_t envelope_ = 1u << GAIN_Q;
+    uint32_t limiter_gain_ = 1u << GAIN_Q;
+    uint32_t position_ = 0; // frame counter for the sliding minimum, wraps
+    size_t slot_ = 0;       // delay line and box slot, wraps at window_
+
+    void EndFrame();
+    uint32_t SlidingMin(uint32_t value);
+
+public:
+    Agc() = default;
+
+    bool Init(uint32_t sample_rate, const AgcConfig &config = AgcConfig());
+    void Reset();
+
+    // AudioProcessor: in place, output is delayed by GetLatencyFrames()
+    void Process(int16_t *data, size_t frames, size_t channels) override;
+
+    size_t GetLatencyFrames() const { return window_; }
+    float GetGainDb() const { return agc_gain_db_ + gate_gain_db_; }
+    float GetLevelDb() const { return level_db_; }
+    bool IsGateOpen() const { return gate_open_; }
+    // Current limiter reduction, 0 when idle
+    float GetLimiterGainDb() const;
+};
+
+} // namespace wrapper
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wrapper
+{
+
+/**
+ * @brief Block encoder: a fixed number of interleaved int16 frames in, one
+ * self-contained packet out
+ */
+class AudioEncoder
+{
+public:
+    virtual ~AudioEncoder() = default;
+
+    virtual const char *GetName() const = 0;
+    virtual size_t GetChannels() const = 0;
+    // Frames consumed per packet
+    virtual size_t GetFrameSamples() const = 0;
+    // Upper bound of Encode output
+    virtual size_t GetMaxPacketSize() const = 0;
+
+    /**
+     * @param pcm GetFrameSamples() interleaved frames
+     * @return Packet bytes written, 0 on error
+     */
+    virtual size_t Encode(const int16_t *pcm, uint8_t *packet, size_t packet_size) = 0;
+
+    virtual void Reset() {}
+};
+
+class AudioDecoder
+{
+public:
+    virtual ~AudioDecoder() = default;
+
+    virtual size_t GetChannels() const = 0;
+    virtual size_t GetFrameSamples() const = 0;
+
+    // @return Frames written to pcm, 0 on a malformed packet
+    virtual size_t Decode(const uint8_t *packet, size_t packet_size, int16_t *pcm, size_t max_frames) = 0;
+
+    virtual void Reset() {}
+};
+
+} // namespace wrapper
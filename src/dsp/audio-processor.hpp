@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wrapper
+{
+
+/**
+ * @brief In-place stage on a capture or playback path
+ *
+ * Called with interleaved int16 frames from the audio task, must not block
+ * or allocate.
+ */
+class AudioProcessor
+{
+public:
+    virtual ~AudioProcessor() = default;
+    virtual void Process(int16_t *data, size_t frames, size_t channels) = 0;
+};
+
+/**
+ * @brief Read-only tap on an audio path (e.g. the speaker output feeding an
+ * echo canceller reference)
+ */
+class AudioMonitor
+{
+public:
+    virtual ~AudioMonitor() = default;
+    virtual void Observe(const int16_t *data, size_t frames, size_t channels) = 0;
+};
+
+// Fixed-size list of stages, so attaching never allocates
+template <typename Stage, size_t N = 4>
+class AudioStageList
+{
+    Stage *stages_[N] = {};
+    size_t count_ = 0;
+
+public:
+    static constexpr size_t MAX_STAGES = N;
+
+    bool Add(Stage *stage)
+    {
+        if (stage == nullptr || count_ >= N) return false;
+        stages_[count_++] = stage;
+        return true;
+    }
+
+    bool Remove(Stage *stage)
+    {
+        for (size_t i = 0; i < count_; ++i) {
+            if (stages_[i] != stage) continue;
+            for (size_t j = i + 1; j < count_; ++j) stages_[j - 1] = stages_[j];
+            stages_[--count_] = nullptr;
+            return true;
+        }
+        return false;
+    }
+
+    void Clear() { count_ = 0; }
+    bool Empty() const { return count_ == 0; }
+    size_t Count() const { return count_; }
+    Stage *operator[](size_t index) const { return stages_[index]; }
+};
+
+using AudioProcessorList = AudioStageList<AudioProcessor>;
+using AudioMonitorList = AudioStageList<AudioMonitor>;
+
+inline void RunAudioProcessors(const AudioProcessorList &list, int16_t *data, size_t frames, size_t channels)
+{
+    for (size_t i = 0; i < list.Count(); ++i) list[i]->Process(data, frames, channels);
+}
+
+inline void RunAudioMonitors(const AudioMonitorList &list, const int16_t *data, size_t frames, size_t channels)
+{
+    for (size_t i = 0; i < list.Count(); ++i) list[i]->Observe(data, frames, channels);
+}
+
+} // namespace wrapper
@@ -0,0 +1,63 @@
+#include <cstring>
+#include "dsp/audio-reader.hpp"
+
+namespace wrapper
+{
+
+// MemoryReader Implementation
+
+void MemoryReader::Open(const void *data, size_t size)
+{
+    data_ = static_cast<const uint8_t *>(data);
+    size_ = size;
+    pos_ = 0;
+}
+
+size_t MemoryReader::Read(void *data, size_t size)
+{
+    size_t left = size_ - pos_;
+    if (size > left) size = left;
+    memcpy(data, data_ + pos_, size);
+    pos_ += size;
+    return size;
+}
+
+bool MemoryReader::Rewind()
+{
+    pos_ = 0;
+    return true;
+}
+
+// FileReader Implementation
+
+void FileReader::Open(FILE *file)
+{
+    file_ = file;
+    end_ = false;
+}
+
+size_t FileReader::Read(void *data, size_t size)
+{
+    if (file_ == nullptr) return 0;
+    size_t read = fread(data, 1, size, file_);
+    if (read < size) end_ = true;
+    return read;
+}
+
+bool FileReader::Rewind()
+{
+    if (file_ == nullptr || fseek(file_, 0, SEEK_SET) != 0) return false;
+    end_ = false;
+    return true;
+}
+
+// RingReader Implementation
+
+size_t RingReader::Read(void *data, size_t size)
+{
+    // Partial reads are normal here, do not count them as underruns
+    size_t available = ring_.Available();
+    return ring_.Read(data, size < available ? size : available);
+}
+
+} // namespace wrapper
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "wrapper/ring-buffer.hpp"
+
+namespace wrapper
+{
+
+/**
+ * @brief Byte source for streamed audio (clip in flash, file, network ring)
+ *
+ * Read may return less than asked; 0 with AtEnd() false means "nothing yet".
+ */
+class AudioReader
+{
+public:
+    virtual ~AudioReader() = default;
+    virtual size_t Read(void *data, size_t size) = 0;
+    virtual bool AtEnd() const = 0;
+    // Back to the first byte, false if the source cannot rewind
+    virtual bool Rewind() { return false; }
+};
+
+// Decoded PCM source: interleaved int16 frames
+class PcmSource
+{
+public:
+    virtual ~PcmSource() = default;
+    virtual size_t GetChannels() const = 0;
+    virtual uint32_t GetSampleRate() const = 0;
+    // Frames written, 0 with AtEnd() false means the input is late
+    virtual size_t ReadFrames(int16_t *pcm, size_t max_frames) = 0;
+    virtual bool AtEnd() const = 0;
+};
+
+// Embedded clip (e.g. EMBED_FILES), not copied
+class MemoryReader : public AudioReader
+{
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    size_t pos_ = 0;
+
+public:
+    MemoryReader() = default;
+    MemoryReader(const void *data, size_t size) : data_(static_cast<const uint8_t *>(data)), size_(size) {}
+
+    void Open(const void *data, size_t size);
+    size_t Read(void *data, size_t size) override;
+    bool AtEnd() const override { return pos_ >= size_; }
+    bool Rewind() override;
+};
+
+// stdio file (SPIFFS, FAT, SD card); the caller keeps the FILE open
+class FileReader : public AudioReader
+{
+    FILE *file_ = nullptr;
+    bool end_ = false;
+
+public:
+    FileReader() = default;
+    FileReader(FILE *file) : file_(file) {}
+
+    void Open(FILE *file);
+    size_t Read(void *data, size_t size) override;
+    bool AtEnd() const override { return file_ == nullptr || end_; }
+    bool Rewind() override;
+};
+
+// Consumer side of a ring filled by another task (e.g. a download); the producer calls Finish
+class RingReader : public AudioReader
+{
+    SpscRingBuffer &ring_;
+    std::atomic<bool> finished_{false};
+
+public:
+    RingReader(SpscRingBuffer &ring) : ring_(ring) {}
+
+    // Producer side: no more data will follow
+    void Finish() { finished_ = true; }
+    void Restart() { finished_ = false; }
+
+    size_t Read(void *data, size_t size) override;
+    bool AtEnd() const override { return finished_ && ring_.Available() == 0; }
+};
+
+} // namespace wrapper
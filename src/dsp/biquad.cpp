@@ -0,0 +1,94 @@
+#include <cmath>
+#include "dsp/biquad.hpp"
+#include "dsp/pcm.hpp"
+
+namespace wrapper
+{
+
+template <bool SHIFTED>
+static inline void BiquadLoop(const BiquadCoeffs &coeffs, BiquadState &state, int32_t *data, size_t count)
+{
+    // State in locals so the loop keeps it in registers
+    const int64_t b0 = coeffs.b0, b1 = coeffs.b1, b2 = coeffs.b2, a1 = coeffs.a1, a2 = coeffs.a2;
+    const int64_t b_scale = (int64_t)1 << coeffs.b_shift;
+    int32_t x1 = state.x1, x2 = state.x2, y1 = state.y1, y2 = state.y2;
+    int64_t error1 = state.error, error2 = state.error2;
+    for (size_t i = 0; i < count; ++i) {
+        int32_t x = data[i];
+        int64_t feed = b0 * x + b1 * x1 + b2 * x2;
+        if (SHIFTED) feed *= b_scale;
+        // Second-order error feedback puts a double zero at DC into the truncation noise. Low corner
+        // sections have poles close to z = 1, and a single zero leaves their noise gain in the tens
+        int64_t acc = feed - a1 * y1 - a2 * y2 + 2 * error1 - error2;
+        int32_t y = (int32_t)(acc >> BIQUAD_Q);
+        error2 = error1;
+        error1 = acc - ((int64_t)y << BIQUAD_Q);
+        x2 = x1;
+        x1 = x;
+        y2 = y1;
+        y1 = y;
+        data[i] = y;
+    }
+    state.x1 = x1;
+    state.x2 = x2;
+    state.y1 = y1;
+    state.y2 = y2;
+    state.error = (int32_t)error1;
+    state.error2 = (int32_t)error2;
+}
+
+void BiquadRun(const BiquadCoeffs &coeffs, BiquadState &state, int32_t *data, size_t count)
+{
+    if (coeffs.b_shift == 0) {
+        BiquadLoop<false>(coeffs, state, data, count);
+    } else {
+        BiquadLoop<true>(coeffs, state, data, count);
+    }
+}
+
+double BiquadResponseDb(const BiquadCoeffs &coeffs, double sample_rate, double freq)
+{
+    const double q = (double)(1 << BIQUAD_Q);
+    double w = 2.0 * CONST_PI * freq / sample_rate;
+    double b_scale = (double)(1 << coeffs.b_shift) / q;
+    double b0 = coeffs.b0 * b_scale, b1 = coeffs.b1 * b_scale, b2 = coeffs.b2 * b_scale;
+    double a1 = coeffs.a1 / q, a2 = coeffs.a2 / q;
+    // H(e^jw) with z^-1 = cos w - j sin w
+    double c1 = cos(w), s1 = sin(w), c2 = cos(2 * w), s2 = sin(2 * w);
+    double num_re = b0 + b1 * c1 + b2 * c2, num_im = -(b1 * s1 + b2 * s2);
+    double den_re = 1.0 + a1 * c1 + a2 * c2, den_im = -(a1 * s1 + a2 * s2);
+    double num = num_re * num_re + num_im * num_im;
+    double den = den_re * den_re + den_im * den_im;
+    return 10.0 * log10(num / den);
+}
+
+void DcBlockerRun(int32_t pole_q30, BiquadState &state, int32_t *data, size_t count)
+{
+    const int64_t pole = pole_q30;
+    int32_t x1 = state.x1, y1 = state.y1;
+    int64_t error = state.error;
+    for (size_t i = 0; i < count; ++i) {
+        int32_t x = data[i];
+        int64_t acc = ((int64_t)(x - x1) << BIQUAD_Q) + pole * y1 + error;
+        int32_t y = (int32_t)(acc >> BIQUAD_Q);
+        error = acc - ((int64_t)y << BIQUAD_Q);
+        x1 = x;
+        y1 = y;
+        data[i] = y;
+    }
+    state.x1 = x1;
+    state.y1 = y1;
+    state.error = (int32_t)error;
+}
+
+void BiquadLoadChannel(int32_t *dst, const int16_t *src, size_t frames, size_t channels)
+{
+    for (size_t i = 0; i < frames; ++i) dst[i] = src[i * channels];
+}
+
+void BiquadStoreChannel(int16_t *dst, const int32_t *src, size_t frames, size_t channels)
+{
+    for (size_t i = 0; i < frames; ++i) dst[i * channels] = PcmSaturate16(src[i]);
+}
+
+} // namespace wrapper
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "dsp/audio-processor.hpp"
+#include "dsp/math.hpp"
+
+namespace wrapper
+{
+
+// Biquad coefficients in Q30 with a0 normalised to 1, so |coefficient| < 2. Boosting sections
+// (shelves, peaks) can need larger b: those are stored divided by 2^b_shift
+constexpr int BIQUAD_Q = 30;
+constexpr int BIQUAD_MAX_B_SHIFT = 8;
+
+struct BiquadCoeffs
+{
+    int32_t b0 = 1 << BIQUAD_Q;
+    int32_t b1 = 0;
+    int32_t b2 = 0;
+    int32_t a1 = 0;
+    int32_t a2 = 0;
+    int32_t b_shift = 0;
+};
+
+// Direct form I history, samples kept in int32 between sections
+struct BiquadState
+{
+    int32_t x1 = 0;
+    int32_t x2 = 0;
+    int32_t y1 = 0;
+    int32_t y2 = 0;
+    int32_t error = 0;  // truncation errors fed back into the next samples (noise shaping)
+    int32_t error2 = 0;
+};
+
+constexpr int32_t BiquadToQ30(double x)
+{
+    double scaled = x * (double)(1 << BIQUAD_Q);
+    double rounded = scaled < 0 ? scaled - 0.5 : scaled + 0.5;
+    if (rounded > (double)INT32_MAX) return INT32_MAX;
+    if (rounded < (double)INT32_MIN) return INT32_MIN;
+    return (int32_t)rounded;
+}
+
+constexpr double BiquadAbs(double x)
+{
+    return x < 0 ? -x : x;
+}
+
+constexpr BiquadCoeffs BiquadFromDouble(double b0, double b1, double b2, double a0, double a1, double a2)
+{
+    b0 /= a0;
+    b1 /= a0;
+    b2 /= a0;
+    double largest = BiquadAbs(b0) > BiquadAbs(b1) ? BiquadAbs(b0) : BiquadAbs(b1);
+    if (BiquadAbs(b2) > largest) largest = BiquadAbs(b2);
+    BiquadCoeffs c;
+    double scale = 1.0;
+    while (largest * scale >= 1.999 && c.b_shift < BIQUAD_MAX_B_SHIFT) {
+        scale /= 2.0;
+        ++c.b_shift;
+    }
+    c.b0 = BiquadToQ30(b0 * scale);
+    c.b1 = BiquadToQ30(b1 * scale);
+    c.b2 = BiquadToQ30(b2 * scale);
+    c.a1 = BiquadToQ30(a1 / a0);
+    c.a2 = BiquadToQ30(a2 / a0);
+    return c;
+}
+
+// RBJ cookbook sections, usable in constant expressions
+
+constexpr BiquadCoeffs BiquadHighPass(double sample_rate, double freq, double q = 0.70710678118654752)
+{
+    double w0 = 2.0 * CONST_PI * freq / sample_rate;
+    double cos_w0 = ConstCos(w0);
+    double alpha = ConstSin(w0) / (2.0 * q);
+    return BiquadFromDouble((1.0 + cos_w0) / 2.0, -(1.0 + cos_w0), (1.0 + cos_w0) / 2.0,
+                            1.0 + alpha, -2.0 * cos_w0, 1.0 - alpha);
+}
+
+constexpr BiquadCoeffs BiquadLowPass(double sample_rate, double freq, double q = 0.70710678118654752)
+{
+    double w0 = 2.0 * CONST_PI * freq / sample_rate;
+    double cos_w0 = ConstCos(w0);
+    double alpha = ConstSin(w0) / (2.0 * q);
+    return BiquadFromDouble((1.0 - cos_w0) / 2.0, 1.0 - cos_w0, (1.0 - cos_w0) / 2.0,
+                            1.0 + alpha, -2.0 * cos_w0, 1.0 - alpha);
+}
+
+constexpr BiquadCoeffs BiquadPeaking(double sample_rate, double freq, double gain_db, double q)
+{
+    double a = ConstPow10(gain_db / 40.0);
+    double w0 = 2.0 * CONST_PI * freq / sample_rate;
+    double cos_w0 = ConstCos(w0);
+    double alpha = ConstSin(w0) / (2.0 * q);
+    return BiquadFromDouble(1.0 + alpha * a, -2.0 * cos_w0, 1.0 - alpha * a,
+                            1.0 + alpha / a, -2.0 * cos_w0, 1.0 - alpha / a);
+}
+
+constexpr BiquadCoeffs BiquadLowShelf(double sample_rate, double freq, double gain_db, double q = 0.70710678118654752)
+{
+    double a = ConstPow10(gain_db / 40.0);
+    double w0 = 2.0 * CONST_PI * freq / sample_rate;
+    double cos_w0 = ConstCos(w0);
+    double beta = 2.0 * ConstSqrt(a) * ConstSin(w0) / (2.0 * q);
+    return BiquadFromDouble(a * ((a + 1.0) - (a - 1.0) * cos_w0 + beta), 2.0 * a * ((a - 1.0) - (a + 1.0) * cos_w0),
+                            a * ((a + 1.0) - (a - 1.0) * cos_w0 - beta), (a + 1.0) + (a - 1.0) * cos_w0 + beta,
+                            -2.0 * ((a - 1.0) + (a + 1.0) * cos_w0), (a + 1.0) + (a - 1.0) * cos_w0 - beta);
+}
+
+constexpr BiquadCoeffs BiquadHighShelf(double sample_rate, double freq, double gain_db, double q = 0.70710678118654752)
+{
+    double a = ConstPow10(gain_db / 40.0);
+    double w0 = 2.0 * CONST_PI * freq / sample_rate;
+    double cos_w0 = ConstCos(w0);
+    double beta = 2.0 * ConstSqrt(a) * ConstSin(w0) / (2.0 * q);
+    return BiquadFromDouble(a * ((a + 1.0) + (a - 1.0) * cos_w0 + beta), -2.0 * a * ((a - 1.0) + (a + 1.0) * cos_w0),
+                            a * ((a + 1.0) + (a - 1.0) * cos_w0 - beta), (a + 1.0) - (a - 1.0) * cos_w0 + beta,
+                            2.0 * ((a - 1.0) - (a + 1.0) * cos_w0), (a + 1.0) - (a - 1.0) * cos_w0 - beta);
+}
+
+// First-order sections (bilinear), b2 = a2 = 0
+constexpr BiquadCoeffs BiquadLowPass1(double sample_rate, double freq)
+{
+    double half = CONST_PI * freq / sample_rate;
+    double k = ConstSin(half) / ConstCos(half);
+    return BiquadFromDouble(k, k, 0.0, 1.0 + k, k - 1.0, 0.0);
+}
+
+constexpr BiquadCoeffs BiquadHighPass1(double sample_rate, double freq)
+{
+    double half = CONST_PI * freq / sample_rate;
+    double k = ConstSin(half) / ConstCos(half);
+    return BiquadFromDouble(1.0, -1.0, 0.0, 1.0 + k, k - 1.0, 0.0);
+}
+
+// Butterworth of even ORDER as ORDER / 2 sections with Q = 1 / (2 cos((2k + 1) pi / (2 ORDER)))
+template <size_t ORDER>
+constexpr std::array<BiquadCoeffs, ORDER / 2> ButterworthHighPass(double sample_rate, double freq)
+{
+    static_assert(ORDER >= 2 && ORDER % 2 == 0, "Butterworth order must be even");
+    std::array<BiquadCoeffs, ORDER / 2> sections{};
+    for (size_t k = 0; k < ORDER / 2; ++k) {
+        double q = 1.0 / (2.0 * ConstCos((2.0 * k + 1.0) * CONST_PI / (2.0 * ORDER)));
+        sections[k] = BiquadHighPass(sample_rate, freq, q);
+    }
+    return sections;
+}
+
+template <size_t ORDER>
+constexpr std::array<BiquadCoeffs, ORDER / 2> ButterworthLowPass(double sample_rate, double freq)
+{
+    static_assert(ORDER >= 2 && ORDER % 2 == 0, "Butterworth order must be even");
+    std::array<BiquadCoeffs, ORDER / 2> sections{};
+    for (size_t k = 0; k < ORDER / 2; ++k) {
+        double q = 1.0 / (2.0 * ConstCos((2.0 * k + 1.0) * CONST_PI / (2.0 * ORDER)));
+        sections[k] = BiquadLowPass(sample_rate, freq, q);
+    }
+    return sections;
+}
+
+// One section over a contiguous mono block, in place. Accumulates in int64
+void BiquadRun(const BiquadCoeffs &coeffs, BiquadState &state, int32_t *data, size_t count);
+
+// Magnitude response of the quantised section, for checking a design
+double BiquadResponseDb(const BiquadCoeffs &coeffs, double sample_rate, double freq);
+
+// Pole of the one-pole DC blocker for a -3 dB corner at cutoff_hz, Q30
+constexpr int32_t DcBlockerPole(double sample_rate, double cutoff_hz)
+{
+    return BiquadToQ30(1.0 - 2.0 * CONST_PI * cutoff_hz / sample_rate);
+}
+
+// y = x - x[-1] + pole * y[-1] over a contiguous mono block, in place
+void DcBlockerRun(int32_t pole_q30, BiquadState &state, int32_t *data, size_t count);
+
+// Block helpers shared by the filters: one channel of interleaved int16 to and from int32
+void BiquadLoadChannel(int32_t *dst, const int16_t *src, size_t frames, size_t channels);
+void BiquadStoreChannel(int16_t *dst, const int32_t *src, size_t frames, size_t channels);
+
+/**
+ * @brief Cascade of SECTIONS biquads as an in-place AudioProcessor
+ *
+ * Coefficients are fixed at construction, typically from a constexpr design
+ * (ButterworthHighPass<4>(16000, 80)). Each channel is filtered through all
+ * sections in blocks of BLOCK frames held in int32, so intermediate sections
+ * do not clip and the result saturates once. Channels beyond MAX_CHANNELS
+ * pass through. Never allocates.
+ */
+template <size_t SECTIONS, size_t MAX_CHANNELS = 1, size_t BLOCK = 64>
+class BiquadFilter : public AudioProcessor
+{
+    std::array<BiquadCoeffs, SECTIONS> coeffs_;
+    BiquadState state_[MAX_CHANNELS][SECTIONS] = {};
+
+public:
+    constexpr BiquadFilter(const std::array<BiquadCoeffs, SECTIONS> &coeffs) : coeffs_(coeffs) {}
+
+    const std::array<BiquadCoeffs, SECTIONS> &GetCoeffs() const { return coeffs_; }
+
+    double ResponseDb(double sample_rate, double freq) const
+    {
+        double db = 0.0;
+        for (const auto &coeffs : coeffs_) db += BiquadResponseDb(coeffs, sample_rate, freq);
+        return db;
+    }
+
+    void Reset()
+    {
+        for (auto &channel : state_) {
+            for (auto &state : channel) state = BiquadState{};
+        }
+    }
+
+    void Process(int16_t *data, size_t frames, size_t channels) override
+    {
+        int32_t block[BLOCK];
+        size_t filtered = channels < MAX_CHANNELS ? channels : MAX_CHANNELS;
+        for (size_t done = 0; done < frames; done += BLOCK) {
+            size_t count = frames - done < BLOCK ? frames - done : BLOCK;
+            int16_t *frame = data + done * channels;
+            for (size_t ch = 0; ch < filtered; ++ch) {
+                BiquadLoadChannel(block, frame + ch, count, channels);
+                for (size_t s = 0; s < SECTIONS; ++s) BiquadRun(coeffs_[s], state_[ch][s], block, count);
+                BiquadStoreChannel(frame + ch, block, count, channels);
+            }
+        }
+    }
+};
+
+/**
+ * @brief One-pole DC blocker as an in-place AudioProcessor
+ *
+ * Cheaper than a biquad (one multiply per sample) when only the offset has to
+ * go; the error feedback keeps the output free of a residual DC step.
+ */
+template <size_t MAX_CHANNELS = 1, size_t BLOCK = 64>
+class DcBlocker : public AudioProcessor
+{
+    int32_t pole_q30_;
+    BiquadState state_[MAX_CHANNELS] = {};
+
+public:
+    constexpr DcBlocker(int32_t pole_q30) : pole_q30_(pole_q30) {}
+
+    void Reset()
+    {
+        for (auto &state : state_) state = BiquadState{};
+    }
+
+    void Process(int16_t *data, size_t frames, size_t channels) override
+    {
+        int32_t block[BLOCK];
+        size_t filtered = channels < MAX_CHANNELS ? channels : MAX_CHANNELS;
+        for (size_t done = 0; done < frames; done += BLOCK) {
+            size_t count = frames - done < BLOCK ? frames - done : BLOCK;
+            int16_t *frame = data + done * channels;
+            for (size_t ch = 0; ch < filtered; ++ch) {
+                BiquadLoadChannel(block, frame + ch, count, channels);
+                DcBlockerRun(pole_q30_, state_[ch], block, count);
+                BiquadStoreChannel(frame + ch, block, count, channels);
+            }
+        }
+    }
+};
+
+} // namespace wrapper
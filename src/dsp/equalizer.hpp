@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "dsp/biquad.hpp"
+
+namespace wrapper
+{
+
+enum class EqType : uint8_t
+{
+    Peaking,
+    LowShelf,
+    HighShelf,
+    LowPass,
+    HighPass,
+};
+
+struct EqBand
+{
+    EqType type = EqType::Peaking;
+    double freq = 1000.0;
+    double gain_db = 0.0; // ignored by LowPass/HighPass
+    double q = 0.70710678118654752;
+};
+
+// preamp_db is folded into the first band, keep it at or below minus the largest boost
+template <size_t BANDS>
+struct EqSpec
+{
+    double preamp_db = 0.0;
+    std::array<EqBand, BANDS> bands{};
+};
+
+constexpr BiquadCoeffs EqBandDesign(double sample_rate, const EqBand &band)
+{
+    switch (band.type) {
+    case EqType::LowShelf:
+        return BiquadLowShelf(sample_rate, band.freq, band.gain_db, band.q);
+    case EqType::HighShelf:
+        return BiquadHighShelf(sample_rate, band.freq, band.gain_db, band.q);
+    case EqType::LowPass:
+        return BiquadLowPass(sample_rate, band.freq, band.q);
+    case EqType::HighPass:
+        return BiquadHighPass(sample_rate, band.freq, band.q);
+    case EqType::Peaking:
+    default:
+        return BiquadPeaking(sample_rate, band.freq, band.gain_db, band.q);
+    }
+}
+
+/**
+ * @brief Q30 sections for an EqSpec, evaluated at compile time when the spec is constexpr
+ *
+ *   constexpr auto speaker_eq = EqDesign(16000, EqSpec<2>{-3.0, {{{EqType::HighPass, 200},
+ *                                                                 {EqType::Peaking, 2500, -3.0, 1.5}}}});
+ */
+template <size_t BANDS>
+constexpr std::array<BiquadCoeffs, BANDS> EqDesign(double sample_rate, const EqSpec<BANDS> &spec)
+{
+    std::array<BiquadCoeffs, BANDS> sections{};
+    for (size_t i = 0; i < BANDS; ++i) {
+        const EqBand &band = spec.bands[i];
+        if (i == 0) {
+            // Same design with the b coefficients scaled by the preamp
+            double preamp = ConstPow10(spec.preamp_db / 20.0);
+            BiquadCoeffs unity = EqBandDesign(sample_rate, band);
+            double b_scale = (double)(1 << unity.b_shift) / (double)(1 << BIQUAD_Q);
+            double a_scale = 1.0 / (double)(1 << BIQUAD_Q);
+            sections[i] = BiquadFromDouble(unity.b0 * b_scale * preamp, unity.b1 * b_scale * preamp,
+                                           unity.b2 * b_scale * preamp, 1.0, unity.a1 * a_scale, unity.a2 * a_scale);
+        } else {
+            sections[i] = EqBandDesign(sample_rate, band);
+        }
+    }
+    return sections;
+}
+
+/**
+ * @brief N-band parametric EQ for a playback path (AudioCodec::AddPlaybackProcessor)
+ *
+ * A BiquadFilter over the EqDesign sections that remembers its sample rate,
+ * so the response of the quantised coefficients can be checked against the
+ * design with Response().
+ */
+template <size_t BANDS, size_t MAX_CHANNELS = 2>
+class Equalizer : public BiquadFilter<BANDS, MAX_CHANNELS>
+{
+    double sample_rate_;
+
+public:
+    constexpr Equalizer(double sample_rate, const std::array<BiquadCoeffs, BANDS> &sections)
+        : BiquadFilter<BANDS, MAX_CHANNELS>(sections), sample_rate_(sample_rate) {}
+
+    constexpr Equalizer(double sample_rate, const EqSpec<BANDS> &spec)
+        : Equalizer(sample_rate, EqDesign(sample_rate, spec)) {}
+
+    double GetSampleRate() const { return sample_rate_; }
+
+    // Magnitude in dB at freq
+    double Response(double freq) const { return this->ResponseDb(sample_rate_, freq); }
+};
+
+} // namespace wrapper
@@ -0,0 +1,196 @@
+#include "dsp/math.hpp"
+#include "dsp/fft.hpp"
+
+namespace wrapper
+{
+
+static_assert(IsPowerOfTwo(Fft::MAX_SIZE) && IsPowerOfTwo(Fft::MIN_SIZE), "FFT sizes must be powers of two");
+
+// cos(2 pi i / MAX_SIZE) for i < MAX_SIZE / 2, evaluated by the compiler
+struct FftCosTable
+{
+    float value[Fft::MAX_SIZE / 2];
+    int16_t q15[Fft::MAX_SIZE / 2];
+
+    constexpr FftCosTable() : value(), q15()
+    {
+        for (size_t i = 0; i < Fft::MAX_SIZE / 2; ++i) {
+            double c = ConstCos(2.0 * CONST_PI * (double)i / (double)Fft::MAX_SIZE);
+            value[i] = (float)c;
+            q15[i] = ConstToQ15(c);
+        }
+    }
+};
+
+static constexpr FftCosTable COS_TABLE{};
+
+static_assert(COS_TABLE.q15[0] == 32767 && COS_TABLE.q15[Fft::MAX_SIZE / 4] == 0, "cosine table endpoints");
+
+// Per sample type arithmetic: float, or int32 with Q15 twiddles
+struct FloatOps
+{
+    using Sample = float;
+    using Twiddle = float;
+    static Twiddle Cos(const Fft &fft, size_t k) { return fft.Cos(k); }
+    static Twiddle Sin(const Fft &fft, size_t k) { return fft.Sin(k); }
+    static Sample Mul(Sample a, Twiddle w) { return a * w; }
+    static Sample Half(Sample a) { return a * 0.5f; }
+};
+
+struct FixedOps
+{
+    using Sample = int32_t;
+    using Twiddle = int32_t;
+    static Twiddle Cos(const Fft &fft, size_t k) { return fft.CosQ15(k); }
+    static Twiddle Sin(const Fft &fft, size_t k) { return fft.SinQ15(k); }
+    static Sample Mul(Sample a, Twiddle w) { return (Sample)(((int64_t)a * w + (1 << 14)) >> 15); }
+    static Sample Half(Sample a) { return a >> 1; }
+};
+
+bool Fft::Init(size_t size)
+{
+    if (!IsPowerOfTwo(size) || size < MIN_SIZE || size > MAX_SIZE) return false;
+    size_ = size;
+    stride_ = MAX_SIZE / size;
+    return true;
+}
+
+float Fft::Cos(size_t k) const
+{
+    return COS_TABLE.value[k * stride_];
+}
+
+float Fft::Sin(size_t k) const
+{
+    // sin(a) = cos(a - pi / 2), cos is even
+    size_t quarter = size_ / 4;
+    return COS_TABLE.value[(k >= quarter ? k - quarter : quarter - k) * stride_];
+}
+
+int16_t Fft::CosQ15(size_t k) const
+{
+    return COS_TABLE.q15[k * stride_];
+}
+
+int16_t Fft::SinQ15(size_t k) const
+{
+    size_t quarter = size_ / 4;
+    return COS_TABLE.q15[(k >= quarter ? k - quarter : quarter - k) * stride_];
+}
+
+void Fft::WindowHann(const int16_t *in, size_t stride, size_t count, float *out) const
+{
+    const size_t half = size_ / 2;
+    if (count > size_) count = size_;
+    for (size_t n = 0; n < count; ++n, in += stride) {
+        // n = N/2 lands outside the table: cos(pi) = -1
+        float c = n == half ? -1.0f : Cos(n < half ? n : size_ - n);
+        out[n] = *in * (0.5f - 0.5f * c);
+    }
+    for (size_t n = count; n < size_; ++n) out[n] = 0.0f;
+}
+
+void Fft::WindowHann(const int16_t *in, size_t stride, size_t count, int32_t *out) const
+{
+    const size_t half = size_ / 2;
+    if (count > size_) count = size_;
+    for (size_t n = 0; n < count; ++n, in += stride) {
+        if (n == half) {
+            out[n] = *in;
+            continue;
+        }
+        int32_t w = (32768 - CosQ15(n < half ? n : size_ - n)) >> 1;
+        out[n] = (*in * w + (1 << 14)) >> 15;
+    }
+    for (size_t n = count; n < size_; ++n) out[n] = 0;
+}
+
+template <typename Ops>
+static void ComplexForward(const Fft &fft, typename Ops::Sample *data, size_t points)
+{
+    using Sample = typename Ops::Sample;
+    using Twiddle = typename Ops::Twiddle;
+
+    // Bit-reversal permutation of complex pairs
+    for (size_t i = 1, j = 0; i < points; ++i) {
+        size_t bit = points >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j |= bit;
+        if (i < j) {
+            Sample re = data[2 * i], im = data[2 * i + 1];
+            data[2 * i] = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = re;
+            data[2 * j + 1] = im;
+        }
+    }
+
+    // Twiddles of the N-point real FFT: W_len^j = W_N^(j * N / len)
+    const size_t size = fft.GetSize();
+    for (size_t len = 2; len <= points; len <<= 1) {
+        const size_t half = len / 2;
+        const size_t step = size / len;
+        for (size_t j = 0; j < half; ++j) {
+            const Twiddle wr = Ops::Cos(fft, j * step);
+            const Twiddle wi = Ops::Sin(fft, j * step); // W = wr - i wi
+            for (size_t i = j; i < points; i += len) {
+                Sample *a = data + 2 * i;
+                Sample *b = data + 2 * (i + half);
+                Sample vr = Ops::Mul(b[0], wr) + Ops::Mul(b[1], wi);
+                Sample vi = Ops::Mul(b[1], wr) - Ops::Mul(b[0], wi);
+                b[0] = a[0] - vr;
+                b[1] = a[1] - vi;
+                a[0] += vr;
+                a[1] += vi;
+            }
+        }
+    }
+}
+
+template <typename Ops>
+static void RealForwardImpl(const Fft &fft, typename Ops::Sample *data)
+{
+    using Sample = typename Ops::Sample;
+    const size_t points = fft.GetSize() / 2;
+
+    ComplexForward<Ops>(fft, data, points);
+
+    // X[0] and X[N/2] are real
+    Sample z0r = data[0], z0i = data[1];
+    data[0] = z0r + z0i;
+    data[1] = z0r - z0i;
+
+    // X[k] = E + (-sin - i cos)(2 pi k / N) * O with E/O = (Z[k] +- conj(Z[M-k])) / 2
+    for (size_t k = 1; k <= points / 2; ++k) {
+        Sample *a = data + 2 * k;
+        Sample *b = data + 2 * (points - k);
+        Sample er = Ops::Half(a[0] + b[0]);
+        Sample ei = Ops::Half(a[1] - b[1]);
+        Sample orr = Ops::Half(a[0] - b[0]);
+        Sample oi = Ops::Half(a[1] + b[1]);
+        auto c = Ops::Cos(fft, k);
+        auto s = Ops::Sin(fft, k);
+        // (-s - i c)(orr + i oi) = (-s orr + c oi) + i (-s oi - c orr)
+        Sample tr = Ops::Mul(oi, c) - Ops::Mul(orr, s);
+        Sample ti = -Ops::Mul(oi, s) - Ops::Mul(orr, c);
+        // Same terms give X[M-k] = conj(E - T), T being the twiddled O
+        a[0] = er + tr;
+        a[1] = ei + ti;
+        if (b != a) {
+            b[0] = er - tr;
+            b[1] = ti - ei;
+        }
+    }
+}
+
+void Fft::RealForward(float *data) const
+{
+    RealForwardImpl<FloatOps>(*this, data);
+}
+
+void Fft::RealForward(int32_t *data) const
+{
+    RealForwardImpl<FixedOps>(*this, data);
+}
+
+} // namespace wrapper
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wrapper
+{
+
+/**
+ * @brief In-place radix-2 real FFT, float and fixed point
+ *
+ * The N-point real transform runs as an N/2-point complex FFT on the packed
+ * even/odd samples followed by a split step. Twiddles come from one cosine
+ * table for MAX_SIZE built at compile time (flash, no init cost); smaller
+ * sizes read it with a stride. Nothing is allocated.
+ *
+ * Output layout (N reals in, N reals out):
+ *   data[0] = Re X[0], data[1] = Re X[N/2]
+ *   data[2k], data[2k+1] = Re X[k], Im X[k] for 0 < k < N/2
+ */
+class Fft
+{
+    size_t size_ = 0;
+    size_t stride_ = 0; // table step per N-point twiddle index
+
+public:
+    static constexpr size_t MIN_SIZE = 16;
+    static constexpr size_t MAX_SIZE = 4096;
+
+    Fft() = default;
+
+    // size must be a power of two in [MIN_SIZE, MAX_SIZE]
+    bool Init(size_t size);
+    size_t GetSize() const { return size_; }
+
+    // cos/sin(2 pi k / N) for 0 <= k < N/2
+    float Cos(size_t k) const;
+    float Sin(size_t k) const;
+    int16_t CosQ15(size_t k) const;
+    int16_t SinQ15(size_t k) const;
+
+    // Hann window of length N applied to a strided int16 input (e.g. one channel
+    // of a frame), zero padded after count samples
+    void WindowHann(const int16_t *in, size_t stride, size_t count, float *out) const;
+    void WindowHann(const int16_t *in, size_t stride, size_t count, int32_t *out) const;
+
+    void RealForward(float *data) const;
+
+    // Integer input within int16 range, unscaled result (|X| < 2^27 at N = 4096)
+    void RealForward(int32_t *data) const;
+};
+
+} // namespace wrapper
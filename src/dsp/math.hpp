@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wrapper
+{
+
+// Compile-time math for lookup tables (twiddles, windows, oscillators)
+
+constexpr double CONST_PI = 3.14159265358979323846;
+
+// Reduces to [-pi, pi] then sums the Taylor series, accurate to ~1e-15
+constexpr double ConstSin(double x)
+{
+    const double two_pi = 2.0 * CONST_PI;
+    long turns = (long)(x / two_pi);
+    x -= (double)turns * two_pi;
+    if (x > CONST_PI) x -= two_pi;
+    if (x < -CONST_PI) x += two_pi;
+    // sin(pi - x) = sin(x) keeps the series argument within pi / 2
+    if (x > CONST_PI / 2) x = CONST_PI - x;
+    if (x < -CONST_PI / 2) x = -CONST_PI - x;
+
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 12; ++n) {
+        term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double ConstCos(double x)
+{
+    return ConstSin(x + CONST_PI / 2);
+}
+
+// exp(x) = exp(x / 2^n)^(2^n), the series only sees |x| <= 0.5
+constexpr double ConstExp(double x)
+{
+    int halvings = 0;
+    while (x > 0.5 || x < -0.5) {
+        x /= 2.0;
+        ++halvings;
+    }
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 20; ++n) {
+        term *= x / n;
+        sum += term;
+    }
+    while (halvings-- > 0) sum *= sum;
+    return sum;
+}
+
+constexpr double ConstPow10(double x)
+{
+    return ConstExp(x * 2.30258509299404568402);
+}
+
+// Newton iteration, x >= 0
+constexpr double ConstSqrt(double x)
+{
+    if (x <= 0.0) return 0.0;
+    double root = x > 1.0 ? x : 1.0;
+    for (int n = 0; n < 64; ++n) {
+        double next = 0.5 * (root + x / root);
+        if (next == root) break;
+        root = next;
+    }
+    return root;
+}
+
+constexpr int16_t ConstToQ15(double x)
+{
+    double scaled = x * 32768.0;
+    long rounded = (long)(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+    return (int16_t)(rounded > 32767 ? 32767 : (rounded < -32768 ? -32768 : rounded));
+}
+
+constexpr bool IsPowerOfTwo(size_t n)
+{
+    return n != 0 && (n & (n - 1)) == 0;
+}
+
+constexpr unsigned Log2Exact(size_t n)
+{
+    unsigned bits = 0;
+    while (n > 1) {
+        n >>= 1;
+        ++bits;
+    }
+    return bits;
+}
+
+} // namespace wrapper
@@ -0,0 +1,143 @@
+#include <cstring>
+#include <new>
+#include "dsp/mix-bus.hpp"
+
+namespace wrapper
+{
+
+int MixBus::AddStream(size_t ring_size, uint8_t priority, float gain)
+{
+    if (IsValid() || stream_count_ >= MAX_STREAMS) return INVALID_STREAM;
+    Stream &stream = streams_[stream_count_];
+    stream.ring_size = ring_size;
+    stream.priority = priority;
+    stream.gain_q15 = PcmGainToQ15(gain);
+    return (int)stream_count_++;
+}
+
+bool MixBus::Init(const MixBusConfig &config)
+{
+    Deinit();
+    if (config.channels == 0 || config.block_frames == 0) return false;
+    config_ = config;
+    const size_t samples = config.block_frames * config.channels;
+    mix_ = new (std::nothrow) int32_t[samples];
+    block_ = new (std::nothrow) int16_t[samples];
+    if (mix_ == nullptr || block_ == nullptr) {
+        Deinit();
+        return false;
+    }
+    for (size_t i = 0; i < stream_count_; ++i) {
+        // At least one block so a full block can always be queued
+        size_t ring_size = streams_[i].ring_size;
+        if (ring_size < samples * sizeof(int16_t)) ring_size = samples * sizeof(int16_t);
+        if (!streams_[i].ring.Init(ring_size)) {
+            Deinit();
+            return false;
+        }
+        streams_[i].duck_q15 = PCM_Q15_UNITY;
+        streams_[i].active = false;
+    }
+    return true;
+}
+
+void MixBus::Deinit()
+{
+    for (size_t i = 0; i < stream_count_; ++i) {
+        streams_[i].ring.Deinit();
+    }
+    delete[] mix_;
+    mix_ = nullptr;
+    delete[] block_;
+    block_ = nullptr;
+}
+
+size_t MixBus::Write(int id, const void *data, size_t size)
+{
+    if (!IsValidStream(id) || !streams_[id].ring.IsValid()) return 0;
+    return streams_[id].ring.Write(data, size);
+}
+
+bool MixBus::SetStreamGain(int id, float gain)
+{
+    if (!IsValidStream(id)) return false;
+    streams_[id].gain_q15 = PcmGainToQ15(gain);
+    return true;
+}
+
+bool MixBus::GetStreamStats(int id, StreamStats &stats) const
+{
+    if (!IsValidStream(id)) return false;
+    const SpscRingBuffer &ring = streams_[id].ring;
+    stats.overruns = ring.GetOverruns();
+    stats.underruns = ring.GetUnderruns();
+    stats.queued_bytes = ring.IsValid() ? ring.Available() : 0;
+    return true;
+}
+
+void MixBus::GetPending(bool &full, bool &partial) const
+{
+    const size_t block_bytes = GetBlockBytes();
+    full = false;
+    partial = false;
+    for (size_t i = 0; i < stream_count_; ++i) {
+        size_t available = streams_[i].ring.Available();
+        full |= available >= block_bytes;
+        partial |= available > 0;
+    }
+}
+
+size_t MixBus::MixBlock(int16_t *out)
+{
+    const size_t frame_bytes = config_.channels * sizeof(int16_t);
+    const size_t block_bytes = GetBlockBytes();
+    const int32_t duck_target = PcmGainToQ15(config_.duck_gain);
+    const size_t ramp_blocks = config_.ramp_blocks > 0 ? config_.ramp_blocks : 1;
+    int32_t duck_step = (PCM_Q15_UNITY - duck_target) / (int32_t)ramp_blocks;
+    if (duck_step < 1) duck_step = 1;
+
+    // Highest priority that has data decides who is ducked
+    size_t available[MAX_STREAMS];
+    int top_priority = -1;
+    for (size_t i = 0; i < stream_count_; ++i) {
+        available[i] = streams_[i].ring.Available() / frame_bytes * frame_bytes;
+        if (available[i] > 0 && (int)streams_[i].priority > top_priority) {
+            top_priority = streams_[i].priority;
+        }
+    }
+
+    memset(mix_, 0, config_.block_frames * config_.channels * sizeof(int32_t));
+    size_t mixed = 0;
+    for (size_t i = 0; i < stream_count_; ++i) {
+        Stream &stream = streams_[i];
+        int32_t target = (int)stream.priority < top_priority ? duck_target : PCM_Q15_UNITY;
+        int32_t duck_start = stream.duck_q15;
+        if (duck_start > target) {
+            stream.duck_q15 = duck_start - duck_step > target ? duck_start - duck_step : target;
+        } else if (duck_start < target) {
+            stream.duck_q15 = duck_start + duck_step < target ? duck_start + duck_step : target;
+        }
+
+        if (available[i] == 0) {
+            // Ran dry while playing: the rest of its sound is lost or late
+            if (stream.active) stream.ring.MarkUnderrun();
+            stream.active = false;
+            continue;
+        }
+
+        size_t bytes = available[i] < block_bytes ? available[i] : block_bytes;
+        stream.ring.Read(block_, bytes);
+        if (bytes < block_bytes && stream.active) stream.ring.MarkUnderrun();
+        stream.active = bytes == block_bytes;
+
+        const int32_t gain = stream.gain_q15.load(std::memory_order_relaxed);
+        PcmMixAccumulateRamp(mix_, block_, bytes / frame_bytes, config_.channels,
+                             (gain * duck_start) >> 15, (gain * stream.duck_q15) >> 15);
+        ++mixed;
+    }
+
+    PcmSaturateBlock(out, mix_, config_.block_frames * config_.channels);
+    return mixed;
+}
+
+} // namespace wrapper
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "dsp/pcm.hpp"
+#include "wrapper/ring-buffer.hpp"
+
+namespace wrapper
+{
+
+struct MixBusConfig
+{
+    size_t channels = 2;         // interleaved channels of every stream and of the output
+    size_t block_frames = 256;   // frames per mixed block
+    float duck_gain = 0.25f;     // gain of streams below the highest active priority
+    size_t ramp_blocks = 4;      // blocks to move between unducked and ducked gain
+};
+
+/**
+ * @brief The mixing half of AudioMixer: stream rings, priority ducking and
+ * the int32 sum, without a task or an output device.
+ *
+ * Every stream has its own lock-free ring (one producer each), a gain and a
+ * priority. While a stream of higher priority has data, lower priority
+ * streams are ramped down to duck_gain. MixBlock pulls a block from every
+ * stream with data, accumulates in int32 and saturates once to int16.
+ *
+ * Streams are added before Init; Init allocates everything, MixBlock never
+ * allocates. Write may run concurrently with MixBlock, nothing else may.
+ */
+class MixBus
+{
+public:
+    static constexpr size_t MAX_STREAMS = 4;
+    static constexpr int INVALID_STREAM = -1;
+
+    struct StreamStats
+    {
+        uint32_t overruns = 0;   // producer writes dropped, ring full
+        uint32_t underruns = 0;  // stream ran dry mid-block, padded with silence
+        size_t queued_bytes = 0;
+    };
+
+private:
+    struct Stream
+    {
+        SpscRingBuffer ring;
+        size_t ring_size = 0;
+        uint8_t priority = 0;
+        std::atomic<int32_t> gain_q15{PCM_Q15_UNITY};
+        int32_t duck_q15 = PCM_Q15_UNITY; // current ducking gain, mixing side only
+        bool active = false;              // had data in the previous block
+    };
+
+    MixBusConfig config_;
+    Stream streams_[MAX_STREAMS];
+    size_t stream_count_ = 0;
+    int32_t *mix_ = nullptr;    // int32 accumulator, block_frames * channels
+    int16_t *block_ = nullptr;  // stream read scratch
+
+public:
+    MixBus() = default;
+    ~MixBus() { Deinit(); }
+
+    MixBus(const MixBus &) = delete;
+    MixBus &operator=(const MixBus &) = delete;
+
+    // Ring bytes are rounded up to a power of two and to at least one block, gain is 0.0 - 2.0
+    int AddStream(size_t ring_size, uint8_t priority = 0, float gain = 1.0f);
+    size_t GetStreamCount() const { return stream_count_; }
+    bool IsValidStream(int id) const { return id >= 0 && (size_t)id < stream_count_; }
+
+    bool Init(const MixBusConfig &config);
+    void Deinit();
+    bool IsValid() const { return mix_ != nullptr; }
+
+    size_t GetBlockBytes() const { return config_.block_frames * config_.channels * sizeof(int16_t); }
+
+    // Non-blocking, returns the number of bytes queued. One producer per stream
+    size_t Write(int id, const void *data, size_t size);
+
+    bool SetStreamGain(int id, float gain);
+    bool GetStreamStats(int id, StreamStats &stats) const;
+
+    // Whether any stream holds a full block, and whether any holds data at all
+    void GetPending(bool &full, bool &partial) const;
+
+    // One block of block_frames * channels samples into out.
+    // Returns the number of streams that contributed, 0 means out is silence
+    size_t MixBlock(int16_t *out);
+};
+
+} // namespace wrapper
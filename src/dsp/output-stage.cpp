@@ -0,0 +1,213 @@
+#include <cmath>
+#include "dsp/output-stage.hpp"
+#include "dsp/pcm.hpp"
+
+namespace wrapper
+{
+
+static constexpr int32_t UNITY = 1 << OutputStage::GAIN_Q;
+
+static int32_t DbToQ16(float db)
+{
+    return (int32_t)(powf(10.0f, db / 20.0f) * UNITY + 0.5f);
+}
+
+bool OutputStage::Init(uint32_t sample_rate, const OutputStageConfig &config)
+{
+    if (sample_rate == 0 || config.max_volume_db > 24.0f || config.min_volume_db >= config.max_volume_db ||
+        config.loudness_treble_hz * 2 >= sample_rate) {
+        return false;
+    }
+    config_ = config;
+    float block_ms = BLOCK * 1000.0f / sample_rate;
+    float smoothing = config.smoothing_ms > 0 ? 1.0f - expf(-block_ms / config.smoothing_ms) : 1.0f;
+    smoothing_q16_ = (int32_t)(smoothing * UNITY + 0.5f);
+    if (smoothing_q16_ < 1) smoothing_q16_ = 1;
+    release_coef_ = config.limit_release_ms > 0 ? 1.0f - expf(-block_ms / config.limit_release_ms) : 1.0f;
+    bass_coeffs_ = BiquadLowPass1(sample_rate, config.loudness_bass_hz);
+    treble_coeffs_ = BiquadHighPass1(sample_rate, config.loudness_treble_hz);
+
+    volume_db_ = config.volume_db;
+    mute_ = false;
+    loudness_ = config.loudness;
+    SetVolumeDb(config.volume_db);
+    Reset();
+    return true;
+}
+
+void OutputStage::Reset()
+{
+    // Start at the targets, a reset is not a volume change to smooth
+    gain_ = target_gain_.load(std::memory_order_relaxed);
+    bass_ = target_bass_.load(std::memory_order_relaxed);
+    treble_ = target_treble_.load(std::memory_order_relaxed);
+    for (size_t ch = 0; ch < MAX_CHANNELS; ++ch) {
+        bass_state_[ch] = BiquadState{};
+        treble_state_[ch] = BiquadState{};
+    }
+    limiter_gain_ = UNITY;
+}
+
+void OutputStage::UpdateTargets()
+{
+    float volume_db = volume_db_.load(std::memory_order_relaxed);
+    bool loudness = loudness_.load(std::memory_order_relaxed);
+    bool silent = mute_.load(std::memory_order_relaxed) || volume_db <= config_.min_volume_db;
+    target_gain_.store(silent ? 0 : DbToQ16(volume_db), std::memory_order_relaxed);
+
+    float attenuation = volume_db < 0 ? -volume_db : 0.0f;
+    float bass_db = loudness ? 0.3f * attenuation : 0.0f;
+    float treble_db = loudness ? 0.1f * attenuation : 0.0f;
+    if (bass_db > config_.loudness_max_db) bass_db = config_.loudness_max_db;
+    if (treble_db > config_.loudness_max_db) treble_db = config_.loudness_max_db;
+    target_bass_.store(DbToQ16(bass_db) - UNITY, std::memory_order_relaxed);
+    target_treble_.store(DbToQ16(treble_db) - UNITY, std::memory_order_relaxed);
+}
+
+void OutputStage::SetVolumeDb(float db)
+{
+    if (db > config_.max_volume_db) db = config_.max_volume_db;
+    if (db < config_.min_volume_db) db = config_.min_volume_db;
+    volume_db_ = db;
+    UpdateTargets();
+}
+
+void OutputStage::SetVolumePercent(float percent)
+{
+    if (percent > 100.0f) percent = 100.0f;
+    if (percent <= 0.0f) {
+        SetVolumeDb(config_.min_volume_db);
+        return;
+    }
+    // Linear in dB across the range, so equal steps sound equal
+    SetVolumeDb(config_.min_volume_db * (1.0f - percent / 100.0f));
+}
+
+void OutputStage::SetMute(bool mute)
+{
+    mute_ = mute;
+    UpdateTargets();
+}
+
+void OutputStage::SetLoudness(bool enable)
+{
+    loudness_ = enable;
+    UpdateTargets();
+}
+
+float OutputStage::GetLimiterGainDb() const
+{
+    return 20.0f * log10f((float)limiter_gain_ / UNITY);
+}
+
+int32_t OutputStage::LimiterGain(int32_t peak) const
+{
+    if (peak <= 0) return UNITY;
+    float peak_db = 20.0f * log10f(peak / 32768.0f);
+    float over = peak_db - config_.limit_dbfs;
+    float half_knee = config_.knee_db / 2;
+    float reduction;
+    if (over <= -half_knee) {
+        return UNITY;
+    } else if (over < half_knee) {
+        // Quadratic knee: slope goes from 1 to 0 across the knee and meets the ceiling at its top
+        float into = over + half_knee;
+        reduction = -into * into / (2 * config_.knee_db);
+    } else {
+        reduction = -over;
+    }
+    // Round down: a gain rounded up lets the peak out past the ceiling
+    return (int32_t)(powf(10.0f, reduction / 20.0f) * UNITY);
+}
+
+static inline int32_t Smooth(int32_t value, int32_t target, int32_t coef_q16)
+{
+    int32_t step = (int32_t)(((int64_t)(target - value) * coef_q16) >> OutputStage::GAIN_Q);
+    // The one-pole never lands exactly: once the step rounds to nothing, creep the last few units in.
+    // Snapping instead would be a step of up to 1 / coef units
+    if (step == 0 && target > value) step = 1;
+    return value + step;
+}
+
+void OutputStage::ProcessBlock(int16_t *data, size_t frames, size_t channels, int32_t gain_target,
+                               int32_t bass_target, int32_t treble_target)
+{
+    int32_t block[MAX_CHANNELS][BLOCK];
+    int32_t shelf[BLOCK];
+    size_t used = channels < MAX_CHANNELS ? channels : MAX_CHANNELS;
+
+    // The coefficients are per BLOCK frames: a short block moves the ramps a shorter way, so the slope per
+    // sample does not depend on how the caller splits its buffers
+    int32_t smoothing = (int32_t)((int64_t)smoothing_q16_ * (int32_t)frames / (int32_t)BLOCK);
+    if (smoothing < 1) smoothing = 1;
+    int32_t gain_start = gain_;
+    gain_ = Smooth(gain_, gain_target, smoothing);
+    // Ramp steps carry 16 fraction bits, or the truncated remainder jumps at the next block edge
+    int64_t gain_step = ((int64_t)(gain_ - gain_start) << GAIN_Q) / (int64_t)frames;
+    bass_ = Smooth(bass_, bass_target, smoothing);
+    treble_ = Smooth(treble_, treble_target, smoothing);
+
+    int32_t peak = 0;
+    for (size_t ch = 0; ch < used; ++ch) {
+        int32_t *x = block[ch];
+        BiquadLoadChannel(x, data + ch, frames, channels);
+
+        // Shelves run while loudness lifts or their lift is still fading out
+        if (bass_target != 0 || treble_target != 0 || bass_ != 0 || treble_ != 0) {
+            for (size_t i = 0; i < frames; ++i) shelf[i] = x[i];
+            BiquadRun(bass_coeffs_, bass_state_[ch], shelf, frames);
+            for (size_t i = 0; i < frames; ++i) x[i] += (int32_t)(((int64_t)shelf[i] * bass_) >> GAIN_Q);
+            for (size_t i = 0; i < frames; ++i) shelf[i] = data[ch + i * channels];
+            BiquadRun(treble_coeffs_, treble_state_[ch], shelf, frames);
+            for (size_t i = 0; i < frames; ++i) x[i] += (int32_t)(((int64_t)shelf[i] * treble_) >> GAIN_Q);
+        }
+
+        int64_t gain = (int64_t)gain_start << GAIN_Q;
+        for (size_t i = 0; i < frames; ++i) {
+            x[i] = (int32_t)(((int64_t)x[i] * (int32_t)(gain >> GAIN_Q)) >> GAIN_Q);
+            gain += gain_step;
+            int32_t a = x[i] < 0 ? -x[i] : x[i];
+            if (a > peak) peak = a;
+        }
+    }
+
+    // Reduce at once, recover smoothly; either way the block ends at or below what its peak needs
+    int32_t needed = LimiterGain(peak);
+    int32_t limit_start = limiter_gain_;
+    int32_t limit_end;
+    if (needed <= limiter_gain_) {
+        limit_start = needed;
+        limit_end = needed;
+    } else {
+        int32_t step = (int32_t)((needed - limiter_gain_) * release_coef_ * frames / BLOCK);
+        // Like Smooth: keep creeping once the step truncates to nothing, or recovery stalls short of unity
+        limit_end = limiter_gain_ + (step > 0 ? step : 1);
+    }
+    limiter_gain_ = limit_end;
+    int64_t limit_step = ((int64_t)(limit_end - limit_start) << GAIN_Q) / (int64_t)frames;
+
+    for (size_t ch = 0; ch < used; ++ch) {
+        int32_t *x = block[ch];
+        if (limit_start != UNITY || limit_end != UNITY) {
+            int64_t gain = (int64_t)limit_start << GAIN_Q;
+            for (size_t i = 0; i < frames; ++i) {
+                x[i] = (int32_t)(((int64_t)x[i] * (int32_t)(gain >> GAIN_Q)) >> GAIN_Q);
+                gain += limit_step;
+            }
+        }
+        BiquadStoreChannel(data + ch, x, frames, channels);
+    }
+}
+
+void OutputStage::Process(int16_t *data, size_t frames, size_t channels)
+{
+    int32_t gain_target = target_gain_.load(std::memory_order_relaxed);
+    int32_t bass_target = target_bass_.load(std::memory_order_relaxed);
+    int32_t treble_target = target_treble_.load(std::memory_order_relaxed);
+    for (size_t done = 0; done < frames; done += BLOCK) {
+        size_t count = frames - done < BLOCK ? frames - done : BLOCK;
+        ProcessBlock(data + done * channels, count, channels, gain_target, bass_target, treble_target);
+    }
+}
+
+} // namespace wrapper
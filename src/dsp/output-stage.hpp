@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "dsp/audio-processor.hpp"
+#include "dsp/biquad.hpp"
+
+namespace wrapper
+{
+
+struct OutputStageConfig
+{
+    float volume_db = 0.0f;
+    float max_volume_db = 6.0f;
+    float min_volume_db = -60.0f;    // at or below this the output is silent
+    float smoothing_ms = 30.0f;      // volume change time constant
+    float limit_dbfs = -1.0f;        // output peak ceiling
+    float knee_db = 6.0f;            // soft knee width centred on the ceiling, 0 for a hard knee
+    float limit_release_ms = 150.0f;
+    bool loudness = false;           // equal-loudness bass/treble lift at low volume
+    float loudness_bass_hz = 150.0f;
+    float loudness_treble_hz = 6000.0f;
+    float loudness_max_db = 12.0f;
+
+    OutputStageConfig() = default;
+};
+
+/**
+ * @brief Volume, loudness compensation and soft-knee limiter for a playback path
+ *
+ * Volume is set in dB and applied as a Q16 gain that follows the target with
+ * a one-pole smoothing, ramped per sample, so changes do not zipper. With
+ * loudness enabled, lowering the volume lifts the bass (0.3 dB per dB of
+ * attenuation) and treble (0.1 dB per dB) through first-order shelves built as
+ * x + g * lowpass(x) / x + g * highpass(x).
+ *
+ * The limiter works on blocks of BLOCK frames: the block peak goes through a
+ * soft-knee gain curve with an infinite ratio above the knee, so the output
+ * never passes limit_dbfs. Gain reduction applies at once, recovery is
+ * smoothed over limit_release_ms. Everything up to the limiter runs in int32,
+ * so volume above 0 dB or the loudness lift cannot wrap.
+ *
+ * Setters may be called from another task while Process runs: the audio path
+ * only reads the atomic gain and shelf targets. Never allocates.
+ */
+class OutputStage : public AudioProcessor
+{
+public:
+    static constexpr size_t MAX_CHANNELS = 2;
+    static constexpr size_t BLOCK = 32;
+    static constexpr int GAIN_Q = 16;
+
+private:
+    OutputStageConfig config_;
+    // Setter state, never read by Process
+    std::atomic<float> volume_db_{0.0f};
+    std::atomic<bool> mute_{false};
+    std::atomic<bool> loudness_{false};
+
+    // Targets written by the setters, read once per Process call
+    std::atomic<int32_t> target_gain_{1 << GAIN_Q};
+    std::atomic<int32_t> target_bass_{0};
+    std::atomic<int32_t> target_treble_{0};
+
+    int32_t smoothing_q16_ = 1 << GAIN_Q;     // per block
+    float release_coef_ = 1.0f;               // per block
+    int32_t gain_ = 1 << GAIN_Q;
+    int32_t bass_ = 0;                        // shelf lift minus one, Q16
+    int32_t treble_ = 0;
+    BiquadCoeffs bass_coeffs_;
+    BiquadCoeffs treble_coeffs_;
+    BiquadState bass_state_[MAX_CHANNELS] = {};
+    BiquadState treble_state_[MAX_CHANNELS] = {};
+    int32_t limiter_gain_ = 1 << GAIN_Q;
+
+    void UpdateTargets();
+    int32_t LimiterGain(int32_t peak) const;
+    void ProcessBlock(int16_t *data, size_t frames, size_t channels, int32_t gain_target,
+                      int32_t bass_target, int32_t treble_target);
+
+public:
+    OutputStage() = default;
+
+    bool Init(uint32_t sample_rate, const OutputStageConfig &config = OutputStageConfig());
+    void Reset();
+
+    // Clamped to [min_volume_db, max_volume_db]
+    void SetVolumeDb(float db);
+    float GetVolumeDb() const { return volume_db_; }
+    // 0..100 on a dB taper (100 is 0 dB, 0 is silence)
+    void SetVolumePercent(float percent);
+
+    void SetMute(bool mute);
+    bool IsMuted() const { return mute_; }
+
+    void SetLoudness(bool enable);
+    bool IsLoudness() const { return loudness_; }
+
+    // Reduction of the last block, 0 when the limiter is idle
+    float GetLimiterGainDb() const;
+
+    void Process(int16_t *data, size_t frames, size_t channels) override;
+};
+
+} // namespace wrapper
@@ -0,0 +1,150 @@
+#include <cstring>
+#include "dsp/pcm.hpp"
+
+namespace wrapper
+{
+
+#if WRAPPER_PCM_SIMD
+typedef int16_t PcmV8i16 __attribute__((vector_size(16)));
+typedef int32_t PcmV8i32 __attribute__((vector_size(32)));
+#endif
+
+// Past PCM_Q15_GAIN_MAX, int16 * gain no longer fits the int32 accumulator
+static int32_t ClampGain(int32_t gain_q15)
+{
+    if (gain_q15 < 0) return 0;
+    if (gain_q15 > PCM_Q15_GAIN_MAX) return PCM_Q15_GAIN_MAX;
+    return gain_q15;
+}
+
+void PcmApplyGainScalar(int16_t *dst, const int16_t *src, size_t count, int32_t gain_q15)
+{
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = PcmSaturate16((src[i] * gain_q15 + (1 << 14)) >> 15);
+    }
+}
+
+void PcmApplyGain(int16_t *dst, const int16_t *src, size_t count, int32_t gain_q15)
+{
+    if (gain_q15 == PCM_Q15_UNITY) {
+        if (dst != src) memmove(dst, src, count * sizeof(int16_t));
+        return;
+    }
+    if (gain_q15 <= 0) {
+        PcmMute(dst, count);
+        return;
+    }
+    if (gain_q15 > PCM_Q15_GAIN_MAX) gain_q15 = PCM_Q15_GAIN_MAX;
+
+    size_t i = 0;
+#if WRAPPER_PCM_SIMD
+    const PcmV8i32 max = {INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX, INT16_MAX};
+    const PcmV8i32 min = {INT16_MIN, INT16_MIN, INT16_MIN, INT16_MIN, INT16_MIN, INT16_MIN, INT16_MIN, INT16_MIN};
+    for (; i + 8 <= count; i += 8) {
+        PcmV8i16 x;
+        memcpy(&x, src + i, sizeof(x));
+        PcmV8i32 w = __builtin_convertvector(x, PcmV8i32);
+        w = (w * gain_q15 + (1 << 14)) >> 15;
+        w = w > max ? max : w;
+        w = w < min ? min : w;
+        x = __builtin_convertvector(w, PcmV8i16);
+        memcpy(dst + i, &x, sizeof(x));
+    }
+#else
+    // Unrolled by 4 so Xtensa/RISC-V cores can keep the MAC pipeline busy
+    for (; i + 4 <= count; i += 4) {
+        int32_t s0 = src[i + 0] * gain_q15;
+        int32_t s1 = src[i + 1] * gain_q15;
+        int32_t s2 = src[i + 2] * gain_q15;
+        int32_t s3 = src[i + 3] * gain_q15;
+        dst[i + 0] = PcmSaturate16((s0 + (1 << 14)) >> 15);
+        dst[i + 1] = PcmSaturate16((s1 + (1 << 14)) >> 15);
+        dst[i + 2] = PcmSaturate16((s2 + (1 << 14)) >> 15);
+        dst[i + 3] = PcmSaturate16((s3 + (1 << 14)) >> 15);
+    }
+#endif
+    PcmApplyGainScalar(dst + i, src + i, count - i, gain_q15);
+}
+
+void PcmMute(int16_t *dst, size_t count)
+{
+    memset(dst, 0, count * sizeof(int16_t));
+}
+
+void PcmMixAccumulate(int32_t *acc, const int16_t *src, size_t count, int32_t gain_q15)
+{
+    gain_q15 = ClampGain(gain_q15);
+    if (gain_q15 == 0) return;
+    if (gain_q15 == PCM_Q15_UNITY) {
+        for (size_t i = 0; i < count; ++i) acc[i] += src[i];
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        acc[i] += (src[i] * gain_q15 + (1 << 14)) >> 15;
+    }
+}
+
+void PcmMixAccumulateRamp(int32_t *acc, const int16_t *src, size_t frames, size_t channels,
+                          int32_t gain_start_q15, int32_t gain_end_q15)
+{
+    gain_start_q15 = ClampGain(gain_start_q15);
+    gain_end_q15 = ClampGain(gain_end_q15);
+    if (gain_start_q15 == gain_end_q15 || frames == 0) {
+        PcmMixAccumulate(acc, src, frames * channels, gain_start_q15);
+        return;
+    }
+    // Per-frame gain step in Q15.16 so short blocks still ramp smoothly
+    int64_t gain = (int64_t)gain_start_q15 << 16;
+    int64_t step = (((int64_t)gain_end_q15 - gain_start_q15) << 16) / (int64_t)frames;
+    for (size_t f = 0; f < frames; ++f, gain += step) {
+        int32_t g = (int32_t)(gain >> 16);
+        for (size_t ch = 0; ch < channels; ++ch, ++acc, ++src) {
+            *acc += (*src * g + (1 << 14)) >> 15;
+        }
+    }
+}
+
+void PcmSaturateBlock(int16_t *dst, const int32_t *src, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = PcmSaturate16(src[i]);
+    }
+}
+
+void PcmStereoToMono(int16_t *dst, const int16_t *src, size_t frames)
+{
+    // Forward order is safe in place: dst[i] only reads src[2i], src[2i+1]
+    for (size_t i = 0; i < frames; ++i) {
+        dst[i] = (int16_t)((src[2 * i] + src[2 * i + 1] + 1) >> 1);
+    }
+}
+
+void PcmMonoToStereo(int16_t *dst, const int16_t *src, size_t frames)
+{
+    // Backwards so that the in-place expansion never overwrites unread input
+    for (size_t i = frames; i > 0; --i) {
+        int16_t sample = src[i - 1];
+        dst[2 * (i - 1)] = sample;
+        dst[2 * (i - 1) + 1] = sample;
+    }
+}
+
+void PcmExtractChannel(int16_t *dst, const int16_t *src, size_t frames, size_t channels, size_t channel)
+{
+    if (channel >= channels) return;
+    const int16_t *p = src + channel;
+    for (size_t i = 0; i < frames; ++i, p += channels) {
+        dst[i] = *p;
+    }
+}
+
+void PcmSwapStereo(int16_t *data, size_t frames)
+{
+    for (size_t i = 0; i < frames; ++i) {
+        int16_t left = data[2 * i];
+        data[2 * i] = data[2 * i + 1];
+        data[2 * i + 1] = left;
+    }
+}
+
+} // namespace wrapper
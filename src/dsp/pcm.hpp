@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Vector path: GCC vector extensions, enabled where the target has a native
+// SIMD unit the compiler can lower them to. Define WRAPPER_PCM_SIMD=0/1 to force.
+#ifndef WRAPPER_PCM_SIMD
+#if defined(__GNUC__) && (defined(__SSE2__) || defined(__ARM_NEON) || defined(__riscv_vector))
+#define WRAPPER_PCM_SIMD 1
+#else
+#define WRAPPER_PCM_SIMD 0
+#endif
+#endif
+
+namespace wrapper
+{
+
+// Q15 gain: 32768 is unity, 65535 (~+6 dB) is the ceiling so that
+// int16 * gain always fits in an int32 accumulator.
+constexpr int32_t PCM_Q15_UNITY = 1 << 15;
+constexpr int32_t PCM_Q15_GAIN_MAX = 0xFFFF;
+
+inline int32_t PcmGainToQ15(float gain)
+{
+    if (!(gain > 0.0f)) return 0;
+    float q15 = gain * PCM_Q15_UNITY + 0.5f;
+    if (q15 > PCM_Q15_GAIN_MAX) return PCM_Q15_GAIN_MAX;
+    return (int32_t)q15;
+}
+
+inline int16_t PcmSaturate16(int32_t value)
+{
+    if (value > INT16_MAX) return INT16_MAX;
+    if (value < INT16_MIN) return INT16_MIN;
+    return (int16_t)value;
+}
+
+/**
+ * @brief dst[i] = sat16(round(src[i] * gain_q15 / 32768)), dst may equal src.
+ * Uses the vector path when WRAPPER_PCM_SIMD is set; both paths are bit-exact.
+ */
+void PcmApplyGain(int16_t *dst, const int16_t *src, size_t count, int32_t gain_q15);
+
+// Reference implementation, always scalar
+void PcmApplyGainScalar(int16_t *dst, const int16_t *src, size_t count, int32_t gain_q15);
+
+void PcmMute(int16_t *dst, size_t count);
+
+// Mixing: accumulate several int16 sources into an int32 bus, then saturate once
+
+// acc[i] += round(src[i] * gain_q15 / 32768), gain clamped to [0, PCM_Q15_GAIN_MAX] like PcmApplyGain
+void PcmMixAccumulate(int32_t *acc, const int16_t *src, size_t count, int32_t gain_q15);
+
+// Same with the gain ramped linearly from gain_start to gain_end across the frames
+void PcmMixAccumulateRamp(int32_t *acc, const int16_t *src, size_t frames, size_t channels,
+                          int32_t gain_start_q15, int32_t gain_end_q15);
+
+// dst[i] = sat16(src[i])
+void PcmSaturateBlock(int16_t *dst, const int32_t *src, size_t count);
+
+// Interleaved stereo -> mono (rounded average), dst may equal src
+void PcmStereoToMono(int16_t *dst, const int16_t *src, size_t frames);
+
+// Mono -> interleaved stereo, dst may equal src (needs 2 * frames samples)
+void PcmMonoToStereo(int16_t *dst, const int16_t *src, size_t frames);
+
+// Copies one channel out of an interleaved buffer, dst may equal src
+void PcmExtractChannel(int16_t *dst, const int16_t *src, size_t frames, size_t channels, size_t channel);
+
+// Swaps left/right of interleaved stereo in place
+void PcmSwapStereo(int16_t *data, size_t frames);
+
+} // namespace wrapper
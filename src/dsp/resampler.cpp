@@ -0,0 +1,143 @@
+#include <cmath>
+#include <cstring>
+#include "dsp/pcm.hpp"
+#include "dsp/resampler.hpp"
+
+namespace wrapper
+{
+
+static constexpr uint64_t FRAC_ONE = 1ULL << 32;
+static constexpr unsigned PHASE_BITS = 7; // log2(Resampler::PHASES)
+static constexpr double KAISER_BETA = 7.0;
+
+static_assert((1u << PHASE_BITS) == Resampler::PHASES, "PHASE_BITS must match PHASES");
+
+// Zeroth order modified Bessel function of the first kind, for the Kaiser window
+static double BesselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+bool Resampler::Init(uint32_t in_rate, uint32_t out_rate, size_t channels)
+{
+    if (in_rate == 0 || out_rate == 0 || channels == 0 || channels > MAX_CHANNELS) {
+        return false;
+    }
+    in_rate_ = in_rate;
+    out_rate_ = out_rate;
+    channels_ = channels;
+    // Rounded up: a truncated step lets exact ratios (48/16 kHz) emit a spare frame per call
+    step_ = (((uint64_t)in_rate << 32) + out_rate - 1) / out_rate;
+
+    // Cutoff relative to the input Nyquist, lowered when downsampling
+    double cutoff = 0.95 * (out_rate < in_rate ? (double)out_rate / in_rate : 1.0);
+    const double half = TAPS / 2.0;
+    const double i0_beta = BesselI0(KAISER_BETA);
+
+    coeffs_.assign((PHASES + 1) * TAPS, 0);
+    for (size_t p = 0; p <= PHASES; ++p) {
+        double taps[TAPS];
+        double sum = 0.0;
+        double frac = (double)p / PHASES;
+        for (size_t j = 0; j < TAPS; ++j) {
+            // Distance of tap j from the interpolation point, which lies between taps TAPS/2-1 and TAPS/2
+            double t = (double)j - (half - 1.0) - frac;
+            double x = cutoff * t;
+            double sinc = (x == 0.0) ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+            double r = t / half;
+            double window = (r * r < 1.0) ? BesselI0(KAISER_BETA * std::sqrt(1.0 - r * r)) / i0_beta : 0.0;
+            taps[j] = cutoff * sinc * window;
+            sum += taps[j];
+        }
+        for (size_t j = 0; j < TAPS; ++j) {
+            // Unity DC gain per phase, Q15
+            long q15 = std::lround(taps[j] / sum * 32768.0);
+            if (q15 > INT16_MAX) q15 = INT16_MAX;
+            if (q15 < INT16_MIN) q15 = INT16_MIN;
+            coeffs_[p * TAPS + j] = (int16_t)q15;
+        }
+    }
+
+    Reset();
+    return true;
+}
+
+void Resampler::Reset()
+{
+    memset(history_, 0, sizeof(history_));
+    history_pos_ = 0;
+    frac_ = 0;
+}
+
+size_t Resampler::GetMaxOutputFrames(size_t in_frames) const
+{
+    if (in_rate_ == 0) return 0;
+    // The position carried over from the previous call is worth up to one more input frame
+    return (size_t)(((uint64_t)(in_frames + 1) * out_rate_ + in_rate_ - 1) / in_rate_);
+}
+
+void Resampler::Push(const int16_t *frame)
+{
+    // Each sample is stored twice so the newest TAPS samples are always contiguous
+    for (size_t ch = 0; ch < channels_; ++ch) {
+        history_[ch][history_pos_] = frame[ch];
+        history_[ch][history_pos_ + TAPS] = frame[ch];
+    }
+    history_pos_ = (history_pos_ + 1) % TAPS;
+}
+
+size_t Resampler::Process(const int16_t *in, size_t in_frames, size_t &consumed, int16_t *out, size_t out_frames)
+{
+    consumed = 0;
+    size_t produced = 0;
+
+    if (IsPassthrough()) {
+        size_t frames = in_frames < out_frames ? in_frames : out_frames;
+        memcpy(out, in, frames * channels_ * sizeof(int16_t));
+        consumed = frames;
+        return frames;
+    }
+
+    for (;;) {
+        // Input the next frame does not need is taken even when out is full,
+        // so out sized by GetMaxOutputFrames always consumes the whole call
+        while (frac_ >= FRAC_ONE) {
+            if (consumed == in_frames) return produced;
+            Push(in + consumed * channels_);
+            ++consumed;
+            frac_ -= FRAC_ONE;
+        }
+        if (produced == out_frames) return produced;
+
+        // Interpolate the sub-filter for this fractional position
+        const uint32_t phase = (uint32_t)(frac_ >> (32 - PHASE_BITS));
+        const int32_t mix = (int32_t)((frac_ >> (32 - PHASE_BITS - 16)) & 0xFFFF);
+        const int16_t *h0 = &coeffs_[phase * TAPS];
+        const int16_t *h1 = h0 + TAPS;
+        int32_t h[TAPS];
+        for (size_t j = 0; j < TAPS; ++j) {
+            h[j] = h0[j] + (((h1[j] - h0[j]) * mix) >> 16);
+        }
+
+        for (size_t ch = 0; ch < channels_; ++ch) {
+            const int16_t *window = &history_[ch][history_pos_];
+            int32_t acc = 0;
+            for (size_t j = 0; j < TAPS; ++j) {
+                acc += window[j] * h[j];
+            }
+            out[produced * channels_ + ch] = PcmSaturate16((acc + (1 << 14)) >> 15);
+        }
+
+        ++produced;
+        frac_ += step_;
+    }
+}
+
+} // namespace wrapper
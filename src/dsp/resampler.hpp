@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace wrapper
+{
+
+/**
+ * @brief Streaming polyphase sample-rate converter for interleaved int16 PCM
+ *
+ * Windowed-sinc (Kaiser) prototype split into PHASES sub-filters of TAPS
+ * coefficients, Q15. The output position advances by in_rate/out_rate in
+ * 32.32 fixed point, so any ratio works; the fractional phase is linearly
+ * interpolated between adjacent sub-filters. When downsampling the cutoff
+ * follows the output Nyquist to suppress aliasing.
+ *
+ * All memory is allocated in Init; Process never allocates.
+ */
+class Resampler
+{
+public:
+    static constexpr size_t TAPS = 16;
+    static constexpr size_t PHASES = 128;
+    static constexpr size_t MAX_CHANNELS = 2;
+
+    Resampler() = default;
+
+    bool Init(uint32_t in_rate, uint32_t out_rate, size_t channels);
+    void Reset();
+
+    bool IsPassthrough() const { return in_rate_ == out_rate_; }
+    uint32_t GetInputRate() const { return in_rate_; }
+    uint32_t GetOutputRate() const { return out_rate_; }
+    size_t GetChannels() const { return channels_; }
+
+    // Upper bound of output frames produced for in_frames input frames
+    size_t GetMaxOutputFrames(size_t in_frames) const;
+
+    /**
+     * @brief Converts as much as fits
+     * @param in Interleaved input frames
+     * @param in_frames Number of input frames
+     * @param consumed [out] Input frames used, the rest must be passed again
+     * @param out Interleaved output frames
+     * @param out_frames Capacity of out in frames
+     * @return Output frames produced
+     */
+    size_t Process(const int16_t *in, size_t in_frames, size_t &consumed, int16_t *out, size_t out_frames);
+
+private:
+    uint32_t in_rate_ = 0;
+    uint32_t out_rate_ = 0;
+    size_t channels_ = 1;
+    uint64_t step_ = 0;  // input frames per output frame, 32.32
+    uint64_t frac_ = 0;  // position between history_[TAPS-2] and history_[TAPS-1], 0.32
+    std::vector<int16_t> coeffs_; // (PHASES + 1) x TAPS, Q15
+    int16_t history_[MAX_CHANNELS][TAPS * 2] = {};
+    size_t history_pos_ = 0;
+
+    void Push(const int16_t *frame);
+};
+
+/**
+ * @brief Puts a Resampler in front of any sink with Write(const void *, size_t)
+ * (Speaker, SpeakerCodec, AudioCodec).
+ *
+ * Converts through a fixed internal block so the sink sees bounded writes.
+ */
+template <typename Sink, size_t BLOCK_FRAMES = 256>
+class ResampledWriter
+{
+    Sink &sink_;
+    Resampler resampler_;
+    int16_t block_[BLOCK_FRAMES * Resampler::MAX_CHANNELS];
+
+public:
+    ResampledWriter(Sink &sink) : sink_(sink) {}
+
+    bool Init(uint32_t in_rate, uint32_t out_rate, size_t channels)
+    {
+        return resampler_.Init(in_rate, out_rate, channels);
+    }
+
+    Resampler &GetResampler() { return resampler_; }
+
+    bool Write(const int16_t *data, size_t frames)
+    {
+        const size_t channels = resampler_.GetChannels();
+        if (resampler_.IsPassthrough()) {
+            return sink_.Write(data, frames * channels * sizeof(int16_t));
+        }
+        while (frames > 0) {
+            size_t consumed = 0;
+            size_t produced = resampler_.Process(data, frames, consumed, block_, BLOCK_FRAMES);
+            if (produced > 0 && !sink_.Write(block_, produced * channels * sizeof(int16_t))) {
+                return false;
+            }
+            data += consumed * channels;
+            frames -= consumed;
+        }
+        return true;
+    }
+
+    bool Write(const void *data, size_t size)
+    {
+        return Write(static_cast<const int16_t *>(data), size / (resampler_.GetChannels() * sizeof(int16_t)));
+    }
+};
+
+} // namespace wrapper
@@ -0,0 +1,311 @@
+#include <cmath>
+#include "dsp/math.hpp"
+#include "dsp/signal-generator.hpp"
+
+namespace wrapper
+{
+
+static constexpr size_t SINE_BITS = 9;
+static constexpr size_t SINE_SIZE = 1 << SINE_BITS;
+
+// One full period plus a guard entry for the interpolation, evaluated by the compiler
+struct DdsSineTable
+{
+    int16_t q15[SINE_SIZE + 1];
+
+    constexpr DdsSineTable() : q15()
+    {
+        for (size_t i = 0; i <= SINE_SIZE; ++i) {
+            q15[i] = ConstToQ15(ConstSin(2.0 * CONST_PI * (double)i / (double)SINE_SIZE));
+        }
+    }
+};
+
+static constexpr DdsSineTable SINE_TABLE{};
+
+static_assert(SINE_TABLE.q15[0] == 0 && SINE_TABLE.q15[SINE_SIZE / 4] == 32767 && SINE_TABLE.q15[SINE_SIZE] == 0,
+              "sine table endpoints");
+
+uint32_t DdsPhaseStep(float freq_hz, uint32_t sample_rate)
+{
+    if (sample_rate == 0 || freq_hz <= 0) return 0;
+    double step = (double)freq_hz / sample_rate * 4294967296.0;
+    return step >= 2147483648.0 ? 0x80000000u : (uint32_t)step;
+}
+
+int16_t DdsSine(uint32_t phase)
+{
+    // Top bits pick the entry, the next 16 bits interpolate towards the following one
+    uint32_t index = phase >> (32 - SINE_BITS);
+    int32_t frac = (int32_t)((phase >> (16 - SINE_BITS)) & 0xFFFF);
+    int32_t a = SINE_TABLE.q15[index];
+    int32_t b = SINE_TABLE.q15[index + 1];
+    return (int16_t)(a + (((b - a) * frac) >> 16));
+}
+
+static inline int16_t Scale(int32_t sample, int32_t amplitude_q15)
+{
+    return (int16_t)((sample * amplitude_q15) >> 15);
+}
+
+// SignalGenerator Implementation
+
+bool SignalGenerator::Setup(uint32_t sample_rate, float amplitude)
+{
+    if (sample_rate == 0) return false;
+    sample_rate_ = sample_rate;
+    SetAmplitude(amplitude);
+    remaining_ = ENDLESS;
+    return true;
+}
+
+void SignalGenerator::SetAmplitude(float amplitude)
+{
+    if (amplitude < 0) amplitude = 0;
+    if (amplitude > 1) amplitude = 1;
+    amplitude_q15_ = (int32_t)(amplitude * 32768.0f + 0.5f);
+}
+
+void SignalGenerator::SetDuration(uint32_t ms)
+{
+    remaining_ = (size_t)((uint64_t)sample_rate_ * ms / 1000);
+}
+
+size_t SignalGenerator::ReadFrames(int16_t *pcm, size_t max_frames)
+{
+    size_t frames = max_frames < remaining_ ? max_frames : remaining_;
+    if (frames == 0) return 0;
+    Render(pcm, frames);
+    if (remaining_ != ENDLESS) remaining_ -= frames;
+
+    // Widen in place, backwards so that no unread mono sample is overwritten
+    if (channels_ > 1) {
+        for (size_t i = frames; i > 0; --i) {
+            int16_t sample = pcm[i - 1];
+            int16_t *frame = pcm + (i - 1) * channels_;
+            for (size_t ch = 0; ch < channels_; ++ch) frame[ch] = sample;
+        }
+    }
+    return frames;
+}
+
+// SineGenerator Implementation
+
+bool SineGenerator::Init(uint32_t sample_rate, float freq_hz, float amplitude)
+{
+    if (!Setup(sample_rate, amplitude)) return false;
+    phase_ = 0;
+    SetFrequency(freq_hz);
+    return true;
+}
+
+void SineGenerator::Render(int16_t *mono, size_t frames)
+{
+    uint32_t phase = phase_;
+    for (size_t i = 0; i < frames; ++i) {
+        mono[i] = Scale(DdsSine(phase), amplitude_q15_);
+        phase += step_;
+    }
+    phase_ = phase;
+}
+
+// SweepGenerator Implementation
+
+bool SweepGenerator::Init(uint32_t sample_rate, float start_hz, float end_hz, uint32_t duration_ms,
+                          float amplitude, bool exponential)
+{
+    if (start_hz <= 0 || end_hz <= 0 || duration_ms == 0 || !Setup(sample_rate, amplitude)) return false;
+    step_start_ = (float)DdsPhaseStep(start_hz, sample_rate);
+    float step_end = (float)DdsPhaseStep(end_hz, sample_rate);
+    exponential_ = exponential;
+    total_frames_ = (size_t)((uint64_t)sample_rate * duration_ms / 1000);
+    if (total_frames_ == 0) total_frames_ = 1;
+    log_ratio_ = logf(step_end / step_start_) / (float)total_frames_;
+    step_delta_ = (step_end - step_start_) / (float)total_frames_;
+    Restart();
+    return true;
+}
+
+void SweepGenerator::Restart()
+{
+    phase_ = 0;
+    elapsed_ = 0;
+    remaining_ = total_frames_;
+}
+
+void SweepGenerator::Render(int16_t *mono, size_t frames)
+{
+    // Exact step at the block start, so float rounding cannot drift across a long sweep
+    float step;
+    float scale = 1;
+    float delta = 0;
+    if (exponential_) {
+        step = step_start_ * expf(log_ratio_ * (float)elapsed_);
+        scale = expf(log_ratio_);
+    } else {
+        step = step_start_ + step_delta_ * (float)elapsed_;
+        delta = step_delta_;
+    }
+
+    uint32_t phase = phase_;
+    for (size_t i = 0; i < frames; ++i) {
+        mono[i] = Scale(DdsSine(phase), amplitude_q15_);
+        phase += (uint32_t)step;
+        step = step * scale + delta;
+    }
+    phase_ = phase;
+    elapsed_ += frames;
+}
+
+// NoiseGenerator Implementation
+
+bool NoiseGenerator::Init(uint32_t sample_rate, NoiseColor color, float amplitude, uint32_t seed)
+{
+    if (!Setup(sample_rate, amplitude)) return false;
+    color_ = color;
+    state_ = seed == 0 ? 1 : seed;
+    counter_ = 0;
+    sum_ = 0;
+    for (auto &row : rows_) {
+        row = (int32_t)(int16_t)(NextRandom() >> 16) >> 4;
+        sum_ += row;
+    }
+    return true;
+}
+
+uint32_t NoiseGenerator::NextRandom()
+{
+    // xorshift32
+    uint32_t x = state_;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state_ = x;
+    return x;
+}
+
+void NoiseGenerator::Render(int16_t *mono, size_t frames)
+{
+    if (color_ == NoiseColor::White) {
+        for (size_t i = 0; i < frames; ++i) {
+            mono[i] = Scale((int16_t)(NextRandom() >> 16), amplitude_q15_);
+        }
+        return;
+    }
+
+    // Row k is refreshed every 2^(k+1) samples, so the rows together fall off at 3 dB/octave
+    for (size_t i = 0; i < frames; ++i) {
+        uint32_t random = NextRandom();
+        size_t row = (size_t)__builtin_ctz(++counter_ | (1u << (PINK_ROWS - 1)));
+        int32_t value = (int32_t)(int16_t)(random >> 16) >> 4;
+        sum_ += value - rows_[row];
+        rows_[row] = value;
+        // 16 rows of +-2048 plus one white term of +-2048
+        int32_t sample = (sum_ + ((int32_t)(int16_t)random >> 4)) * 15 / 16;
+        mono[i] = PcmSaturate16(Scale(sample, amplitude_q15_));
+    }
+}
+
+// DtmfGenerator Implementation
+
+static bool DtmfFrequencies(char digit, float &low, float &high)
+{
+    static const char KEYS[] = "123A456B789C*0#D";
+    static const float LOW[4] = {697, 770, 852, 941};
+    static const float HIGH[4] = {1209, 1336, 1477, 1633};
+    for (size_t i = 0; i < 16; ++i) {
+        if (KEYS[i] == digit) {
+            low = LOW[i / 4];
+            high = HIGH[i % 4];
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DtmfGenerator::Init(uint32_t sample_rate, const char *digits, uint32_t tone_ms, uint32_t gap_ms, float amplitude)
+{
+    if (digits == nullptr || tone_ms == 0 || !Setup(sample_rate, amplitude)) return false;
+    digits_ = digits;
+    tone_frames_ = (size_t)((uint64_t)sample_rate * tone_ms / 1000);
+    gap_frames_ = (size_t)((uint64_t)sample_rate * gap_ms / 1000);
+    size_t count = 0;
+    while (digits[count] != '\0') ++count;
+    remaining_ = count * (tone_frames_ + gap_frames_);
+    position_ = 0;
+    StartDigit();
+    return true;
+}
+
+void DtmfGenerator::StartDigit()
+{
+    float low = 0;
+    float high = 0;
+    // Pauses and unknown characters are silent slots
+    if (*digits_ == '\0' || !DtmfFrequencies(*digits_, low, high)) low = high = 0;
+    low_step_ = DdsPhaseStep(low, sample_rate_);
+    high_step_ = DdsPhaseStep(high, sample_rate_);
+    low_phase_ = 0;
+    high_phase_ = 0;
+}
+
+void DtmfGenerator::Render(int16_t *mono, size_t frames)
+{
+    const size_t slot = tone_frames_ + gap_frames_;
+    // Each tone at half the amplitude so the pair never clips
+    const int32_t amplitude = amplitude_q15_ >> 1;
+    for (size_t i = 0; i < frames; ++i) {
+        if (position_ < tone_frames_ && low_step_ != 0) {
+            mono[i] = (int16_t)(Scale(DdsSine(low_phase_), amplitude) + Scale(DdsSine(high_phase_), amplitude));
+            low_phase_ += low_step_;
+            high_phase_ += high_step_;
+        } else {
+            mono[i] = 0;
+        }
+        if (++position_ == slot) {
+            position_ = 0;
+            ++digits_;
+            StartDigit();
+        }
+    }
+}
+
+// ClickGenerator Implementation
+
+bool ClickGenerator::Init(uint32_t sample_rate, uint32_t bpm, size_t beats_per_bar, uint32_t click_ms, float amplitude)
+{
+    if (bpm == 0 || !Setup(sample_rate, amplitude)) return false;
+    beat_frames_ = (size_t)((uint64_t)sample_rate * 60 / bpm);
+    click_frames_ = (size_t)((uint64_t)sample_rate * click_ms / 1000);
+    if (click_frames_ == 0) click_frames_ = 1;
+    if (click_frames_ > beat_frames_) click_frames_ = beat_frames_;
+    beats_per_bar_ = beats_per_bar == 0 ? 1 : beats_per_bar;
+    envelope_step_ = ((uint32_t)amplitude_q15_ << 16) / click_frames_;
+    position_ = 0;
+    beat_ = 0;
+    phase_ = 0;
+    step_ = DdsPhaseStep(1000, sample_rate);
+    accent_step_ = DdsPhaseStep(1600, sample_rate);
+    return true;
+}
+
+void ClickGenerator::Render(int16_t *mono, size_t frames)
+{
+    for (size_t i = 0; i < frames; ++i) {
+        if (position_ < click_frames_) {
+            // Linear decay from full amplitude to silence over the click
+            int32_t envelope = (int32_t)(((uint32_t)(click_frames_ - position_) * envelope_step_) >> 16);
+            mono[i] = Scale(DdsSine(phase_), envelope);
+            phase_ += beat_ == 0 ? accent_step_ : step_;
+        } else {
+            mono[i] = 0;
+        }
+        if (++position_ == beat_frames_) {
+            position_ = 0;
+            phase_ = 0;
+            beat_ = beat_ + 1 == beats_per_bar_ ? 0 : beat_ + 1;
+        }
+    }
+}
+
+} // namespace wrapper
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "dsp/audio-reader.hpp"
+#include "dsp/pcm.hpp"
+
+namespace wrapper
+{
+
+// 32-bit DDS phase step for freq_hz at sample_rate (one turn = 2^32)
+uint32_t DdsPhaseStep(float freq_hz, uint32_t sample_rate);
+
+// Q15 sine of a 32-bit phase: 512 entry table in flash, linearly interpolated (error within 2 LSB)
+int16_t DdsSine(uint32_t phase);
+
+/**
+ * @brief Base for block generators: renders mono, fans out to every channel
+ *
+ * Generators are PcmSources, so they stream straight into an AudioPlayer, or
+ * fill any caller block through ReadFrames. Nothing is allocated; a generator
+ * runs forever unless SetDuration (or its own pattern) ends it.
+ */
+class SignalGenerator : public PcmSource
+{
+public:
+    static constexpr size_t ENDLESS = SIZE_MAX;
+
+    size_t GetChannels() const override { return channels_; }
+    uint32_t GetSampleRate() const override { return sample_rate_; }
+    size_t ReadFrames(int16_t *pcm, size_t max_frames) override;
+    bool AtEnd() const override { return remaining_ == 0; }
+
+    void SetChannels(size_t channels) { channels_ = channels == 0 ? 1 : channels; }
+    // Peak level, 0..1
+    void SetAmplitude(float amplitude);
+    void SetDuration(uint32_t ms);
+    void SetFrames(size_t frames) { remaining_ = frames; }
+
+protected:
+    uint32_t sample_rate_ = 0;
+    size_t channels_ = 1;
+    int32_t amplitude_q15_ = 0;
+    size_t remaining_ = ENDLESS;
+
+    bool Setup(uint32_t sample_rate, float amplitude);
+    virtual void Render(int16_t *mono, size_t frames) = 0;
+};
+
+class SineGenerator : public SignalGenerator
+{
+    uint32_t phase_ = 0;
+    uint32_t step_ = 0;
+
+public:
+    bool Init(uint32_t sample_rate, float freq_hz, float amplitude = 0.5f);
+    void SetFrequency(float freq_hz) { step_ = DdsPhaseStep(freq_hz, sample_rate_); }
+
+protected:
+    void Render(int16_t *mono, size_t frames) override;
+};
+
+// Sine sweep from start_hz to end_hz over duration_ms, exponential or linear, then ends
+class SweepGenerator : public SignalGenerator
+{
+    uint32_t phase_ = 0;
+    float step_start_ = 0;  // phase step at start_hz
+    float log_ratio_ = 0;   // exponential: log of the per sample step factor
+    float step_delta_ = 0;  // linear: per sample step increment
+    size_t total_frames_ = 0;
+    size_t elapsed_ = 0;
+    bool exponential_ = true;
+
+public:
+    bool Init(uint32_t sample_rate, float start_hz, float end_hz, uint32_t duration_ms,
+              float amplitude = 0.5f, bool exponential = true);
+    void Restart();
+
+protected:
+    void Render(int16_t *mono, size_t frames) override;
+};
+
+enum class NoiseColor
+{
+    White,
+    Pink, // -3 dB/octave, Voss-McCartney with 16 rows
+};
+
+class NoiseGenerator : public SignalGenerator
+{
+    static constexpr size_t PINK_ROWS = 16;
+
+    NoiseColor color_ = NoiseColor::White;
+    uint32_t state_ = 1;
+    uint32_t counter_ = 0;
+    int32_t rows_[PINK_ROWS] = {};
+    int32_t sum_ = 0;
+
+    uint32_t NextRandom();
+
+public:
+    bool Init(uint32_t sample_rate, NoiseColor color, float amplitude = 0.25f, uint32_t seed = 0x2545F491);
+
+protected:
+    void Render(int16_t *mono, size_t frames) override;
+};
+
+// Plays a string of DTMF digits (0-9, *, #, A-D; ',' is a pause), then ends
+class DtmfGenerator : public SignalGenerator
+{
+    const char *digits_ = "";
+    size_t tone_frames_ = 0;
+    size_t gap_frames_ = 0;
+    size_t position_ = 0;   // frames into the current digit slot
+    uint32_t low_phase_ = 0;
+    uint32_t high_phase_ = 0;
+    uint32_t low_step_ = 0;
+    uint32_t high_step_ = 0;
+
+    void StartDigit();
+
+public:
+    // digits is not copied and must stay valid until the sequence ends
+    bool Init(uint32_t sample_rate, const char *digits, uint32_t tone_ms = 100, uint32_t gap_ms = 50,
+              float amplitude = 0.5f);
+
+protected:
+    void Render(int16_t *mono, size_t frames) override;
+};
+
+// Metronome: a short decaying sine burst per beat, higher pitched on the first beat of a bar
+class ClickGenerator : public SignalGenerator
+{
+    size_t beat_frames_ = 0;
+    size_t click_frames_ = 0;
+    size_t beats_per_bar_ = 4;
+    size_t position_ = 0;  // frames into the current beat
+    size_t beat_ = 0;
+    uint32_t phase_ = 0;
+    uint32_t step_ = 0;
+    uint32_t accent_step_ = 0;
+    uint32_t envelope_step_ = 0; // Q15 amplitude << 16 per frame of decay
+
+public:
+    bool Init(uint32_t sample_rate, uint32_t bpm, size_t beats_per_bar = 4, uint32_t click_ms = 15,
+              float amplitude = 0.5f);
+
+protected:
+    void Render(int16_t *mono, size_t frames) override;
+};
+
+} // namespace wrapper
@@ -0,0 +1,122 @@
+#include <cmath>
+#include "dsp/spectrum.hpp"
+
+namespace wrapper
+{
+
+static constexpr float FLOOR_DB = -120.0f;
+static constexpr float HANN_ENBW = 1.5f; // equivalent noise bandwidth in bins
+
+static float PowerToDb(float power)
+{
+    return power > 1e-12f ? 10.0f * std::log10(power) : FLOOR_DB;
+}
+
+bool Spectrum::Init(uint32_t sample_rate, size_t size, bool fixed_point)
+{
+    if (sample_rate == 0 || !fft_.Init(size)) return false;
+    sample_rate_ = sample_rate;
+    fixed_point_ = fixed_point;
+    if (fixed_point) {
+        work_q_.assign(size, 0);
+        work_f_.clear();
+    } else {
+        work_f_.assign(size, 0.0f);
+        work_q_.clear();
+    }
+    magnitudes_.assign(size / 2 + 1, 0.0f);
+
+    // Octave bands 63 Hz .. Nyquist
+    float edges[MAX_BANDS + 1];
+    size_t count = 0;
+    edges[0] = 44.0f;
+    for (float centre = 63.0f; count < MAX_BANDS && centre * 1.414f <= sample_rate / 2.0f; centre *= 2.0f) {
+        edges[++count] = centre * 1.414f;
+    }
+    return SetBands(edges, count);
+}
+
+bool Spectrum::SetBands(const float *edges_hz, size_t count)
+{
+    if (count > MAX_BANDS) return false;
+    for (size_t i = 0; i < count; ++i) {
+        if (edges_hz[i + 1] <= edges_hz[i]) return false;
+    }
+    for (size_t i = 0; i <= count; ++i) band_edges_hz_[i] = edges_hz[i];
+    band_count_ = count;
+    return true;
+}
+
+void Spectrum::Analyze(const int16_t *samples, size_t stride, size_t count)
+{
+    const size_t size = fft_.GetSize();
+    const size_t bins = size / 2 + 1;
+    if (size == 0) return;
+
+    // Latest size samples when more are given
+    if (count > size) {
+        samples += (count - size) * stride;
+        count = size;
+    }
+
+    uint64_t sum_sq = 0;
+    for (size_t n = 0; n < count; ++n) {
+        int32_t x = samples[n * stride];
+        sum_sq += (uint32_t)(x * x);
+    }
+    float rms = count ? std::sqrt((float)sum_sq / count) : 0.0f;
+    rms_db_ = rms > 0.0f ? 20.0f * std::log10(rms / 32768.0f) : FLOOR_DB;
+
+    // Full-scale sine: |X| = 32768 * N / 2 * 0.5 (Hann coherent gain)
+    const float scale = 1.0f / (8192.0f * size);
+    float *mag = magnitudes_.data();
+    if (fixed_point_) {
+        int32_t *work = work_q_.data();
+        fft_.WindowHann(samples, stride, count, work);
+        fft_.RealForward(work);
+        mag[0] = std::fabs((float)work[0]) * scale * 0.5f;
+        mag[bins - 1] = std::fabs((float)work[1]) * scale * 0.5f;
+        for (size_t k = 1; k < bins - 1; ++k) {
+            float re = (float)work[2 * k];
+            float im = (float)work[2 * k + 1];
+            mag[k] = std::sqrt(re * re + im * im) * scale;
+        }
+    } else {
+        float *work = work_f_.data();
+        fft_.WindowHann(samples, stride, count, work);
+        fft_.RealForward(work);
+        mag[0] = std::fabs(work[0]) * scale * 0.5f;
+        mag[bins - 1] = std::fabs(work[1]) * scale * 0.5f;
+        for (size_t k = 1; k < bins - 1; ++k) {
+            float re = work[2 * k];
+            float im = work[2 * k + 1];
+            mag[k] = std::sqrt(re * re + im * im) * scale;
+        }
+    }
+
+    // Peak, refined by a parabola through the neighbouring log magnitudes
+    size_t peak = 1;
+    for (size_t k = 2; k < bins - 1; ++k) {
+        if (mag[k] > mag[peak]) peak = k;
+    }
+    float offset = 0.0f;
+    float a = PowerToDb(mag[peak - 1] * mag[peak - 1]);
+    float b = PowerToDb(mag[peak] * mag[peak]);
+    float c = PowerToDb(mag[peak + 1] * mag[peak + 1]);
+    float denom = a - 2.0f * b + c;
+    if (denom < 0.0f) offset = 0.5f * (a - c) / denom;
+    peak_hz_ = ((float)peak + offset) * sample_rate_ / size;
+    peak_db_ = b - 0.25f * (a - c) * offset;
+
+    const float bin_hz = (float)sample_rate_ / size;
+    for (size_t band = 0; band < band_count_; ++band) {
+        size_t lo = (size_t)std::ceil(band_edges_hz_[band] / bin_hz);
+        size_t hi = (size_t)std::ceil(band_edges_hz_[band + 1] / bin_hz);
+        if (hi > bins) hi = bins;
+        float power = 0.0f;
+        for (size_t k = lo; k < hi; ++k) power += mag[k] * mag[k];
+        band_db_[band] = PowerToDb(power / HANN_ENBW);
+    }
+}
+
+} // namespace wrapper
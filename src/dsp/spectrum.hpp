@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "dsp/fft.hpp"
+
+namespace wrapper
+{
+
+/**
+ * @brief Hann-windowed magnitude spectrum with peak and band energies
+ *
+ * Magnitudes are normalised so a full-scale sine reads 1.0 (0 dBFS) in its
+ * bin. Buffers are allocated in Init; Analyze never allocates.
+ */
+class Spectrum
+{
+public:
+    static constexpr size_t MAX_BANDS = 16;
+
+private:
+    Fft fft_;
+    uint32_t sample_rate_ = 0;
+    bool fixed_point_ = false;
+    std::vector<float> work_f_;
+    std::vector<int32_t> work_q_;
+    std::vector<float> magnitudes_; // N/2 + 1 bins
+    float band_edges_hz_[MAX_BANDS + 1] = {};
+    size_t band_count_ = 0;
+    float band_db_[MAX_BANDS] = {};
+    float peak_hz_ = 0.0f;
+    float peak_db_ = -120.0f;
+    float rms_db_ = -120.0f;
+
+public:
+    Spectrum() = default;
+
+    /**
+     * @param size FFT size, power of two in [Fft::MIN_SIZE, Fft::MAX_SIZE]
+     * @param fixed_point int32/Q15 transform instead of float
+     */
+    bool Init(uint32_t sample_rate, size_t size, bool fixed_point = false);
+
+    // count + 1 ascending edges in Hz; defaults to octave bands from 63 Hz
+    bool SetBands(const float *edges_hz, size_t count);
+
+    /**
+     * @brief Analyses one block
+     * @param samples First sample of the analysed channel
+     * @param stride Distance between consecutive samples (channel count)
+     * @param count Available samples, zero padded up to the FFT size
+     */
+    void Analyze(const int16_t *samples, size_t stride, size_t count);
+
+    size_t GetSize() const { return fft_.GetSize(); }
+    uint32_t GetSampleRate() const { return sample_rate_; }
+    bool IsFixedPoint() const { return fixed_point_; }
+    size_t GetBinCount() const { return magnitudes_.size(); }
+    float GetBinHz(size_t bin) const { return (float)bin * sample_rate_ / fft_.GetSize(); }
+    const float *GetMagnitudes() const { return magnitudes_.data(); }
+
+    float GetPeakHz() const { return peak_hz_; }
+    float GetPeakDb() const { return peak_db_; }
+    float GetRmsDb() const { return rms_db_; }
+    size_t GetBandCount() const { return band_count_; }
+    float GetBandDb(size_t band) const { return band < band_count_ ? band_db_[band] : -120.0f; }
+};
+
+} // namespace wrapper
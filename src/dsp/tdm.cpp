@@ -0,0 +1,166 @@
+#include <cstring>
+#include "dsp/tdm.hpp"
+
+namespace wrapper
+{
+
+#if WRAPPER_PCM_SIMD
+typedef int16_t TdmV8i16 __attribute__((vector_size(16)));
+
+#if defined(__clang__)
+#define TDM_SHUFFLE(a, b, ...) __builtin_shufflevector(a, b, __VA_ARGS__)
+#else
+typedef int16_t TdmV8Mask __attribute__((vector_size(16)));
+#define TDM_SHUFFLE(a, b, ...) __builtin_shuffle(a, b, TdmV8Mask{__VA_ARGS__})
+#endif
+
+static inline TdmV8i16 TdmLoad(const int16_t *src)
+{
+    TdmV8i16 v;
+    memcpy(&v, src, sizeof(v));
+    return v;
+}
+
+static inline void TdmStore(int16_t *dst, TdmV8i16 v)
+{
+    memcpy(dst, &v, sizeof(v));
+}
+
+// 8 frames per iteration, returns frames done
+static size_t Deinterleave2Simd(const int16_t *in, size_t frames, int16_t *p0, int16_t *p1)
+{
+    size_t f = 0;
+    for (; f + 8 <= frames; f += 8, in += 16) {
+        TdmV8i16 a = TdmLoad(in);
+        TdmV8i16 b = TdmLoad(in + 8);
+        TdmStore(p0 + f, TDM_SHUFFLE(a, b, 0, 2, 4, 6, 8, 10, 12, 14));
+        TdmStore(p1 + f, TDM_SHUFFLE(a, b, 1, 3, 5, 7, 9, 11, 13, 15));
+    }
+    return f;
+}
+
+static size_t Deinterleave4Simd(const int16_t *in, size_t frames, int16_t *const *planes)
+{
+    size_t f = 0;
+    for (; f + 8 <= frames; f += 8, in += 32) {
+        TdmV8i16 a = TdmLoad(in);
+        TdmV8i16 b = TdmLoad(in + 8);
+        TdmV8i16 c = TdmLoad(in + 16);
+        TdmV8i16 d = TdmLoad(in + 24);
+        // Even/odd split twice: channel pairs first, then channels
+        TdmV8i16 ab_even = TDM_SHUFFLE(a, b, 0, 2, 4, 6, 8, 10, 12, 14); // ch0 ch2 ...
+        TdmV8i16 ab_odd = TDM_SHUFFLE(a, b, 1, 3, 5, 7, 9, 11, 13, 15);  // ch1 ch3 ...
+        TdmV8i16 cd_even = TDM_SHUFFLE(c, d, 0, 2, 4, 6, 8, 10, 12, 14);
+        TdmV8i16 cd_odd = TDM_SHUFFLE(c, d, 1, 3, 5, 7, 9, 11, 13, 15);
+        TdmStore(planes[0] + f, TDM_SHUFFLE(ab_even, cd_even, 0, 2, 4, 6, 8, 10, 12, 14));
+        TdmStore(planes[2] + f, TDM_SHUFFLE(ab_even, cd_even, 1, 3, 5, 7, 9, 11, 13, 15));
+        TdmStore(planes[1] + f, TDM_SHUFFLE(ab_odd, cd_odd, 0, 2, 4, 6, 8, 10, 12, 14));
+        TdmStore(planes[3] + f, TDM_SHUFFLE(ab_odd, cd_odd, 1, 3, 5, 7, 9, 11, 13, 15));
+    }
+    return f;
+}
+#endif
+
+void TdmDeinterleave(const int16_t *in, size_t frames, size_t channels, int16_t *const *planes)
+{
+    size_t f = 0;
+    // Fixed channel counts let the compiler keep the plane pointers in registers
+    if (channels == 2) {
+        int16_t *p0 = planes[0];
+        int16_t *p1 = planes[1];
+#if WRAPPER_PCM_SIMD
+        f = Deinterleave2Simd(in, frames, p0, p1);
+#endif
+        for (; f < frames; ++f) {
+            p0[f] = in[2 * f];
+            p1[f] = in[2 * f + 1];
+        }
+        return;
+    }
+    if (channels == 4) {
+#if WRAPPER_PCM_SIMD
+        f = Deinterleave4Simd(in, frames, planes);
+#endif
+        int16_t *p0 = planes[0];
+        int16_t *p1 = planes[1];
+        int16_t *p2 = planes[2];
+        int16_t *p3 = planes[3];
+        for (; f < frames; ++f) {
+            const int16_t *frame = in + 4 * f;
+            p0[f] = frame[0];
+            p1[f] = frame[1];
+            p2[f] = frame[2];
+            p3[f] = frame[3];
+        }
+        return;
+    }
+    for (size_t ch = 0; ch < channels; ++ch) {
+        int16_t *plane = planes[ch];
+        const int16_t *src = in + ch;
+        for (f = 0; f < frames; ++f, src += channels) plane[f] = *src;
+    }
+}
+
+void TdmInterleave(const int16_t *const *planes, size_t frames, size_t channels, int16_t *out)
+{
+    if (channels == 2) {
+        const int16_t *p0 = planes[0];
+        const int16_t *p1 = planes[1];
+        for (size_t f = 0; f < frames; ++f) {
+            out[2 * f] = p0[f];
+            out[2 * f + 1] = p1[f];
+        }
+        return;
+    }
+    for (size_t ch = 0; ch < channels; ++ch) {
+        const int16_t *plane = planes[ch];
+        int16_t *dst = out + ch;
+        for (size_t f = 0; f < frames; ++f, dst += channels) *dst = plane[f];
+    }
+}
+
+bool TdmRoute::Init(uint32_t slot_mask, const uint8_t *slots, size_t count)
+{
+    in_channels = TdmSlotCount(slot_mask);
+    out_channels = 0;
+    if (count == 0 || count > MAX_CHANNELS) return false;
+    for (size_t i = 0; i < count; ++i) {
+        int index = TdmSlotIndex(slot_mask, slots[i]);
+        if (index < 0) return false;
+        map[i] = (uint8_t)index;
+    }
+    out_channels = count;
+    return true;
+}
+
+void TdmRoute::Apply(const int16_t *in, size_t frames, int16_t *out) const
+{
+    if (out_channels == 2) {
+        const size_t a = map[0];
+        const size_t b = map[1];
+        for (size_t f = 0; f < frames; ++f, in += in_channels, out += 2) {
+            // Load both first: out may alias the frame being read
+            int16_t x = in[a];
+            int16_t y = in[b];
+            out[0] = x;
+            out[1] = y;
+        }
+        return;
+    }
+    int16_t frame[MAX_CHANNELS];
+    for (size_t f = 0; f < frames; ++f, in += in_channels, out += out_channels) {
+        for (size_t ch = 0; ch < out_channels; ++ch) frame[ch] = in[map[ch]];
+        for (size_t ch = 0; ch < out_channels; ++ch) out[ch] = frame[ch];
+    }
+}
+
+void TdmRoute::Apply(const int16_t *in, size_t frames, int16_t *const *planes) const
+{
+    for (size_t ch = 0; ch < out_channels; ++ch) {
+        int16_t *plane = planes[ch];
+        const int16_t *src = in + map[ch];
+        for (size_t f = 0; f < frames; ++f, src += in_channels) plane[f] = *src;
+    }
+}
+
+} // namespace wrapper
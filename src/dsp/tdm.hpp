@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "dsp/pcm.hpp"
+
+namespace wrapper
+{
+
+// The RX DMA frame holds one sample per enabled slot, in ascending slot order
+
+constexpr size_t TdmSlotCount(uint32_t slot_mask)
+{
+    size_t count = 0;
+    for (; slot_mask != 0; slot_mask &= slot_mask - 1) ++count;
+    return count;
+}
+
+// Position of a slot inside the frame, -1 if the slot is not captured
+constexpr int TdmSlotIndex(uint32_t slot_mask, uint32_t slot)
+{
+    if (slot >= 32 || (slot_mask & (1u << slot)) == 0) return -1;
+    return (int)TdmSlotCount(slot_mask & ((1u << slot) - 1));
+}
+
+/**
+ * @brief Splits interleaved frames into one planar buffer per channel
+ * @param planes channels pointers to frames samples each
+ */
+void TdmDeinterleave(const int16_t *in, size_t frames, size_t channels, int16_t *const *planes);
+
+// Inverse of TdmDeinterleave, e.g. for TDM TX
+void TdmInterleave(const int16_t *const *planes, size_t frames, size_t channels, int16_t *out);
+
+/**
+ * @brief Channel subset of a TDM frame, e.g. mic1 + echo reference out of 4 slots
+ *
+ * Built once from the slot mask of the RX channel config and the wanted
+ * slots; Apply then copies just those channels, interleaved or planar.
+ */
+struct TdmRoute
+{
+    static constexpr size_t MAX_CHANNELS = 16;
+
+    size_t in_channels = 0;
+    size_t out_channels = 0;
+    uint8_t map[MAX_CHANNELS] = {}; // frame position of each output channel
+
+    /**
+     * @param slot_mask Slots captured by the RX channel (I2sBus::GetRxSlotMask)
+     * @param slots Wanted slot numbers, in output order
+     * @return false if a slot is not in the mask
+     */
+    bool Init(uint32_t slot_mask, const uint8_t *slots, size_t count);
+
+    // Interleaved out_channels frames, out may alias in when out_channels <= in_channels
+    void Apply(const int16_t *in, size_t frames, int16_t *out) const;
+
+    // One plane per output channel
+    void Apply(const int16_t *in, size_t frames, int16_t *const *planes) const;
+};
+
+} // namespace wrapper
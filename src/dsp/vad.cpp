@@ -0,0 +1,184 @@
+#include <cmath>
+#include "dsp/vad.hpp"
+
+namespace wrapper
+{
+
+// Centre frequencies of the flatness bands, all below 8 kHz / 2
+static constexpr float BAND_HZ[Vad::BANDS] = {300, 500, 800, 1200, 1700, 2300, 3000, 3700};
+static constexpr float DB_PER_LOG2 = 3.0103f;
+
+// log2(x) in Q8, log2(1 + f) approximated by f + 0.34 f (1 - f)
+static int32_t Log2Q8(uint64_t x)
+{
+    if (x == 0) return 0;
+    int n = 63 - __builtin_clzll(x);
+    uint32_t f = n >= 8 ? (uint32_t)(x >> (n - 8)) & 0xFF : (uint32_t)(x << (8 - n)) & 0xFF;
+    return (n << 8) + (int32_t)(f + ((f * (256 - f) * 88) >> 16));
+}
+
+static int32_t DbToLog2Q8(float db)
+{
+    return (int32_t)lrintf(db / DB_PER_LOG2 * 256.0f);
+}
+
+bool Vad::Init(uint32_t sample_rate, const VadConfig &config)
+{
+    if (sample_rate == 0 || config.frame_ms == 0) return false;
+    config_ = config;
+    frame_samples_ = sample_rate * config.frame_ms / 1000;
+    if (frame_samples_ == 0) return false;
+    speech_q8_ = DbToLog2Q8(config.speech_db);
+    strong_q8_ = DbToLog2Q8(config.strong_db);
+    flatness_q8_ = (int32_t)lrintf(config.flatness_max * 256.0f);
+    zcr_max_ = (uint32_t)(config.zcr_max * frame_samples_);
+    for (size_t b = 0; b < BANDS; ++b) {
+        float w = 2.0f * (float)M_PI * BAND_HZ[b] / sample_rate;
+        coeffs_q14_[b] = (int32_t)lrintf(2.0f * cosf(w) * 16384.0f);
+    }
+    Reset();
+    return true;
+}
+
+void Vad::Reset()
+{
+    count_ = 0;
+    sum_sq_ = 0;
+    crossings_ = 0;
+    last_negative_ = false;
+    for (size_t b = 0; b < BANDS; ++b) s1_[b] = s2_[b] = 0;
+    floor_valid_ = false;
+    floor_q8_ = 0;
+    energy_q8_ = 0;
+    last_flatness_q8_ = 0;
+    last_crossings_ = 0;
+    run_ = 0;
+    speech_ = false;
+    frames_ = 0;
+    speech_frames_ = 0;
+}
+
+void Vad::Analyze(const int16_t *data, size_t count)
+{
+    if (frame_samples_ == 0) return;
+    for (size_t i = 0; i < count; ++i) {
+        int32_t x = data[i];
+        sum_sq_ += (uint32_t)(x * x);
+        bool negative = x < 0;
+        crossings_ += negative != last_negative_;
+        last_negative_ = negative;
+        if (config_.use_flatness) {
+            for (size_t b = 0; b < BANDS; ++b) {
+                int64_t s = x + ((coeffs_q14_[b] * s1_[b]) >> 14) - s2_[b];
+                s2_[b] = s1_[b];
+                s1_[b] = s;
+            }
+        }
+        if (++count_ == frame_samples_) EndFrame();
+    }
+}
+
+void Vad::Process(int16_t *data, size_t frames, size_t channels)
+{
+    if (channels == 1) {
+        Analyze(data, frames);
+        return;
+    }
+    if (config_.channel >= channels) return;
+    int16_t mono[64];
+    while (frames > 0) {
+        size_t n = frames < 64 ? frames : 64;
+        for (size_t i = 0; i < n; ++i) mono[i] = data[i * channels + config_.channel];
+        Analyze(mono, n);
+        data += n * channels;
+        frames -= n;
+    }
+}
+
+bool Vad::IsSpeechFrame() const
+{
+    int32_t above = energy_q8_ - floor_q8_;
+    if (above < speech_q8_) return false;
+    if (above >= strong_q8_) return true;
+    if (last_crossings_ > zcr_max_) return false;
+    if (config_.use_flatness && last_flatness_q8_ > flatness_q8_) return false;
+    return true;
+}
+
+void Vad::EndFrame()
+{
+    // Mean square energy, floored at 1 LSB so digital silence stays finite
+    uint64_t mean_sq = sum_sq_ / frame_samples_;
+    energy_q8_ = Log2Q8(mean_sq > 0 ? mean_sq : 1);
+    last_crossings_ = crossings_;
+
+    if (config_.use_flatness) {
+        int32_t log_sum = 0;
+        uint64_t power_sum = 0;
+        for (size_t b = 0; b < BANDS; ++b) {
+            // |X|^2 = s1^2 + s2^2 - coeff * s1 * s2, scaled down to stay within 64 bits
+            int64_t s1 = s1_[b] >> 4;
+            int64_t s2 = s2_[b] >> 4;
+            int64_t power = s1 * s1 + s2 * s2 - ((coeffs_q14_[b] * s1 >> 14) * s2);
+            uint64_t p = power > 0 ? (uint64_t)power : 1;
+            log_sum += Log2Q8(p);
+            power_sum += p / BANDS;
+            s1_[b] = s2_[b] = 0;
+        }
+        last_flatness_q8_ = log_sum / (int32_t)BANDS - Log2Q8(power_sum > 0 ? power_sum : 1);
+    }
+
+    if (!floor_valid_) {
+        floor_q8_ = energy_q8_;
+        floor_valid_ = true;
+    }
+
+    bool speech_frame = IsSpeechFrame();
+    ++frames_;
+    if (speech_frame) ++speech_frames_;
+
+    // Floor follows dips quickly and rises slowly in silence; while speech is
+    // active only a slow creep, so a step in background noise cannot lock the
+    // detector on but pauses between syllables do not lift the floor
+    int32_t diff = energy_q8_ - floor_q8_;
+    if (diff < 0) {
+        floor_q8_ += diff / 4 - 1;
+    } else if (!speech_ && !speech_frame) {
+        floor_q8_ += diff / 64 + 1;
+    } else {
+        floor_q8_ += 1;
+    }
+
+    if (speech_frame != speech_) {
+        ++run_;
+        uint32_t needed = speech_ ? config_.hangover_frames : config_.onset_frames;
+        if (run_ >= needed) {
+            speech_ = speech_frame;
+            run_ = 0;
+            if (callback_) callback_(speech_ ? VadEvent::SpeechStart : VadEvent::SpeechStop);
+        }
+    } else {
+        run_ = 0;
+    }
+
+    count_ = 0;
+    sum_sq_ = 0;
+    crossings_ = 0;
+}
+
+float Vad::GetEnergyDb() const
+{
+    return energy_q8_ * DB_PER_LOG2 / 256.0f;
+}
+
+float Vad::GetNoiseFloorDb() const
+{
+    return floor_q8_ * DB_PER_LOG2 / 256.0f;
+}
+
+float Vad::GetZeroCrossingRate() const
+{
+    return frame_samples_ ? (float)last_crossings_ / frame_samples_ : 0.0f;
+}
+
+} // namespace wrapper
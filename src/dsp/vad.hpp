@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "dsp/audio-processor.hpp"
+
+namespace wrapper
+{
+
+enum class VadEvent
+{
+    SpeechStart,
+    SpeechStop,
+};
+
+using VadCallback = std::function<void(VadEvent event)>;
+
+struct VadConfig
+{
+    uint32_t frame_ms = 10;
+    float speech_db = 9.0f;        // energy above the noise floor that counts as speech
+    float strong_db = 20.0f;       // above this the ZCR/flatness checks are skipped
+    float zcr_max = 0.30f;         // zero crossings per sample, higher is treated as noise
+    bool use_flatness = false;     // Goertzel spectral flatness over 8 speech bands
+    float flatness_max = -1.0f;    // log2 of geometric / arithmetic mean, voiced speech is well below 0
+    uint32_t onset_frames = 3;     // speech frames before SpeechStart
+    uint32_t hangover_frames = 30; // silent frames before SpeechStop
+    size_t channel = 0;            // analysed channel of interleaved input
+
+    VadConfig() = default;
+};
+
+/**
+ * @brief Fixed-point voice activity detector
+ *
+ * Per frame: mean-square energy in log2 Q8, zero-crossing rate and optionally
+ * the spectral flatness of 8 Goertzel bands. The energy is compared against an
+ * adaptive noise floor (fast down, slow up); onset and hangover counters turn
+ * frame decisions into SpeechStart/SpeechStop events.
+ *
+ * Used as an AudioProcessor the data passes through unchanged.
+ */
+class Vad : public AudioProcessor
+{
+public:
+    static constexpr size_t BANDS = 8;
+
+private:
+    VadConfig config_;
+    VadCallback callback_;
+    size_t frame_samples_ = 0;
+    int32_t speech_q8_ = 0;
+    int32_t strong_q8_ = 0;
+    int32_t flatness_q8_ = 0;
+    uint32_t zcr_max_ = 0;
+
+    // Running frame
+    size_t count_ = 0;
+    uint64_t sum_sq_ = 0;
+    uint32_t crossings_ = 0;
+    bool last_negative_ = false;
+    int32_t coeffs_q14_[BANDS] = {};
+    int64_t s1_[BANDS] = {};
+    int64_t s2_[BANDS] = {};
+
+    // Decision state
+    bool floor_valid_ = false;
+    int32_t floor_q8_ = 0;
+    int32_t energy_q8_ = 0;
+    int32_t last_flatness_q8_ = 0;
+    uint32_t last_crossings_ = 0;
+    uint32_t run_ = 0; // consecutive frames against the current state
+    bool speech_ = false;
+    uint32_t frames_ = 0;
+    uint32_t speech_frames_ = 0;
+
+    void EndFrame();
+    bool IsSpeechFrame() const;
+
+public:
+    Vad() = default;
+
+    bool Init(uint32_t sample_rate, const VadConfig &config = VadConfig());
+    void Reset();
+
+    void SetCallback(VadCallback callback) { callback_ = callback; }
+
+    // Mono samples
+    void Analyze(const int16_t *data, size_t count);
+
+    // AudioProcessor: analyses config.channel, leaves data untouched
+    void Process(int16_t *data, size_t frames, size_t channels) override;
+
+    bool IsSpeech() const { return speech_; }
+    size_t GetFrameSamples() const { return frame_samples_; }
+    uint32_t GetFrames() const { return frames_; }
+    uint32_t GetSpeechFrames() const { return speech_frames_; }
+
+    // Last frame, for tuning
+    float GetEnergyDb() const;
+    float GetNoiseFloorDb() const;
+    float GetZeroCrossingRate() const;
+    float GetFlatness() const { return last_flatness_q8_ / 256.0f; }
+};
+
+} // namespace wrapper
+
+#if __has_include("freertos/event_groups.h")
+#include "wrapper/freertos.hpp"
+
+namespace wrapper
+{
+
+// Keeps speech_bit set while speech is active and idle_bit while it is not
+inline VadCallback VadEventGroupCallback(EventGroup &group, EventBits_t speech_bit, EventBits_t idle_bit = 0)
+{
+    return [&group, speech_bit, idle_bit](VadEvent event) {
+        if (event == VadEvent::SpeechStart) {
+            if (idle_bit) group.ClearBits(idle_bit);
+            group.SetBits(speech_bit);
+        } else {
+            group.ClearBits(speech_bit);
+            if (idle_bit) group.SetBits(idle_bit);
+        }
+    };
+}
+
+} // namespace wrapper
+#endif // __has_include("freertos/event_groups.h")
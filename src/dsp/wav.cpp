@@ -0,0 +1,224 @@
+#include <cstring>
+#include <new>
+#include "dsp/wav.hpp"
+
+namespace wrapper
+{
+
+static uint16_t ReadLe16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t ReadLe32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+bool WavDecoder::ReadExact(void *data, size_t size)
+{
+    uint8_t *dst = static_cast<uint8_t *>(data);
+    while (size > 0) {
+        size_t read = reader_->Read(dst, size);
+        if (read == 0) return false;
+        dst += read;
+        size -= read;
+    }
+    return true;
+}
+
+bool WavDecoder::Skip(uint32_t size)
+{
+    uint8_t scratch[64];
+    while (size > 0) {
+        uint32_t chunk = size < sizeof(scratch) ? size : sizeof(scratch);
+        if (!ReadExact(scratch, chunk)) return false;
+        size -= chunk;
+    }
+    return true;
+}
+
+bool WavDecoder::ParseFormat(const uint8_t *chunk, uint32_t size)
+{
+    if (size < 16) return false;
+    uint16_t tag = ReadLe16(chunk);
+    info_.channels = ReadLe16(chunk + 2);
+    info_.sample_rate = ReadLe32(chunk + 4);
+    info_.block_align = ReadLe16(chunk + 12);
+    info_.bits_per_sample = ReadLe16(chunk + 14);
+    // WAVEFORMATEXTENSIBLE: the real tag is the first two bytes of the sub-format GUID
+    if (tag == (uint16_t)WavFormat::Extensible) {
+        if (size < 40) return false;
+        tag = ReadLe16(chunk + 24);
+    }
+    if (info_.channels == 0 || info_.channels > ImaAdpcm::MAX_CHANNELS || info_.sample_rate == 0) return false;
+
+    if (tag == (uint16_t)WavFormat::Pcm) {
+        info_.format = WavFormat::Pcm;
+        info_.samples_per_block = 1;
+        return info_.bits_per_sample == 16 && info_.block_align == 2 * info_.channels;
+    }
+    if (tag == (uint16_t)WavFormat::ImaAdpcm) {
+        info_.format = WavFormat::ImaAdpcm;
+        if (info_.bits_per_sample != 4 || info_.block_align > MAX_BLOCK_SIZE ||
+            info_.block_align < 4 * info_.channels) return false;
+        // nSamplesPerBlock is redundant and not always filled in, derive it from the block size
+        size_t frames = ImaAdpcm::FrameSamples(info_.channels, info_.block_align);
+        if (ImaAdpcm::BlockSize(info_.channels, frames) != info_.block_align) return false;
+        info_.samples_per_block = (uint16_t)frames;
+        return adpcm_.Init(info_.channels, frames);
+    }
+    return false;
+}
+
+bool WavDecoder::Open(AudioReader &reader)
+{
+    Close();
+    reader_ = &reader;
+    info_ = WavInfo{};
+
+    uint8_t header[12];
+    if (!ReadExact(header, sizeof(header)) || memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+        Close();
+        return false;
+    }
+
+    bool have_format = false;
+    while (true) {
+        uint8_t chunk[8];
+        if (!ReadExact(chunk, sizeof(chunk))) {
+            Close();
+            return false;
+        }
+        uint32_t size = ReadLe32(chunk + 4);
+
+        if (memcmp(chunk, "data", 4) == 0) {
+            if (!have_format) {
+                Close();
+                return false;
+            }
+            // Streamed writers leave the size at 0 or 0xFFFFFFFF
+            sized_ = size != 0 && size != 0xFFFFFFFF;
+            info_.data_size = sized_ ? size : 0;
+            data_left_ = info_.data_size;
+            break;
+        }
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t format[40] = {};
+            uint32_t keep = size < sizeof(format) ? size : sizeof(format);
+            if (!ReadExact(format, keep) || !Skip(size - keep + (size & 1)) || !ParseFormat(format, size)) {
+                Close();
+                return false;
+            }
+            have_format = true;
+            continue;
+        }
+        // LIST, fact, cue, ...: chunks are padded to an even size
+        if (!Skip(size + (size & 1))) {
+            Close();
+            return false;
+        }
+    }
+
+    block_ = new (std::nothrow) uint8_t[info_.block_align];
+    if (info_.format == WavFormat::ImaAdpcm) {
+        decoded_ = new (std::nothrow) int16_t[(size_t)info_.samples_per_block * info_.channels];
+    }
+    if (block_ == nullptr || (info_.format == WavFormat::ImaAdpcm && decoded_ == nullptr)) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void WavDecoder::Close()
+{
+    delete[] block_;
+    block_ = nullptr;
+    delete[] decoded_;
+    decoded_ = nullptr;
+    reader_ = nullptr;
+    block_fill_ = 0;
+    decoded_pos_ = 0;
+    decoded_frames_ = 0;
+    data_left_ = 0;
+    sized_ = false;
+}
+
+size_t WavDecoder::ReadData(void *data, size_t size)
+{
+    if (sized_ && size > data_left_) size = data_left_;
+    if (size == 0) return 0;
+    size_t read = reader_->Read(data, size);
+    if (sized_) data_left_ -= (uint32_t)read;
+    return read;
+}
+
+bool WavDecoder::DataEnded() const
+{
+    // A truncated file ends with the reader, before data_left_ reaches 0
+    return (sized_ && data_left_ == 0) || reader_->AtEnd();
+}
+
+bool WavDecoder::AtEnd() const
+{
+    if (reader_ == nullptr) return true;
+    return decoded_pos_ >= decoded_frames_ && block_fill_ == 0 && DataEnded();
+}
+
+size_t WavDecoder::ReadFrames(int16_t *pcm, size_t max_frames)
+{
+    if (reader_ == nullptr || max_frames == 0) return 0;
+    return info_.format == WavFormat::Pcm ? ReadPcm(pcm, max_frames) : ReadAdpcm(pcm, max_frames);
+}
+
+size_t WavDecoder::ReadPcm(int16_t *pcm, size_t max_frames)
+{
+    // Samples are little-endian on disk and in memory, so they are read in place
+    const size_t frame_bytes = info_.block_align;
+    uint8_t *out = reinterpret_cast<uint8_t *>(pcm);
+
+    memcpy(out, block_, block_fill_);
+    size_t total = block_fill_ + ReadData(out + block_fill_, max_frames * frame_bytes - block_fill_);
+    size_t frames = total / frame_bytes;
+
+    // Keep a partial frame for the next call, unless no more bytes will complete it
+    block_fill_ = total - frames * frame_bytes;
+    memcpy(block_, out + frames * frame_bytes, block_fill_);
+    if (block_fill_ > 0 && DataEnded()) block_fill_ = 0;
+    return frames;
+}
+
+size_t WavDecoder::ReadAdpcm(int16_t *pcm, size_t max_frames)
+{
+    const size_t channels = info_.channels;
+    const size_t header_size = 4 * channels;
+    size_t done = 0;
+
+    while (done < max_frames) {
+        if (decoded_pos_ < decoded_frames_) {
+            size_t count = decoded_frames_ - decoded_pos_;
+            if (count > max_frames - done) count = max_frames - done;
+            memcpy(pcm + done * channels, decoded_ + decoded_pos_ * channels, count * channels * sizeof(int16_t));
+            decoded_pos_ += count;
+            done += count;
+            continue;
+        }
+
+        block_fill_ += ReadData(block_ + block_fill_, info_.block_align - block_fill_);
+        size_t size = block_fill_;
+        if (size < info_.block_align) {
+            // Wait for the rest of the block unless this is the short last one
+            if (!DataEnded()) break;
+            // Whole 8 sample groups only, a torn group at the end is dropped
+            size = size < header_size ? 0 : size - (size - header_size) % header_size;
+        }
+        block_fill_ = 0;
+        decoded_pos_ = 0;
+        decoded_frames_ = size == 0 ? 0 : adpcm_.Decode(block_, size, decoded_, info_.samples_per_block);
+        if (decoded_frames_ == 0) break;
+    }
+    return done;
+}
+
+} // namespace wrapper
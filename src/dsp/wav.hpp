@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "dsp/audio-reader.hpp"
+#include "dsp/adpcm.hpp"
+
+namespace wrapper
+{
+
+enum class WavFormat : uint16_t
+{
+    Pcm = 0x0001,
+    ImaAdpcm = 0x0011,
+    Extensible = 0xFFFE,
+};
+
+struct WavInfo
+{
+    WavFormat format = WavFormat::Pcm; // Extensible is resolved to its sub-format
+    uint16_t channels = 0;
+    uint32_t sample_rate = 0;
+    uint16_t block_align = 0;          // bytes per frame (PCM) or per ADPCM block
+    uint16_t bits_per_sample = 0;
+    uint16_t samples_per_block = 1;    // frames per ADPCM block, 1 for PCM
+    uint32_t data_size = 0;            // 0 if unknown (streamed header), read until the reader ends
+};
+
+/**
+ * @brief Streaming WAV decoder: 16-bit PCM or IMA-ADPCM, mono or stereo
+ *
+ * Open parses the RIFF header (unknown chunks are skipped) and allocates one
+ * encoded block plus one decoded block; nothing else is allocated, so memory
+ * stays constant whatever the clip length. ReadFrames never blocks: with a
+ * RingReader it returns what has arrived so far and keeps partial blocks for
+ * the next call. Open itself needs the whole header to be readable, so a ring
+ * producer should buffer a little before the decoder is opened.
+ */
+class WavDecoder : public PcmSource
+{
+public:
+    static constexpr size_t MAX_BLOCK_SIZE = 4096;
+
+    WavDecoder() = default;
+    ~WavDecoder() { Close(); }
+
+    WavDecoder(const WavDecoder &) = delete;
+    WavDecoder &operator=(const WavDecoder &) = delete;
+
+    bool Open(AudioReader &reader);
+    void Close();
+    bool IsOpen() const { return reader_ != nullptr; }
+    const WavInfo &GetInfo() const { return info_; }
+
+    size_t GetChannels() const override { return info_.channels; }
+    uint32_t GetSampleRate() const override { return info_.sample_rate; }
+    size_t ReadFrames(int16_t *pcm, size_t max_frames) override;
+    bool AtEnd() const override;
+
+private:
+    AudioReader *reader_ = nullptr;
+    WavInfo info_;
+    ImaAdpcmDecoder adpcm_;
+    uint8_t *block_ = nullptr;    // encoded block, or the tail of a partial PCM frame
+    size_t block_fill_ = 0;
+    int16_t *decoded_ = nullptr;  // ADPCM only
+    size_t decoded_pos_ = 0;
+    size_t decoded_frames_ = 0;
+    uint32_t data_left_ = 0;
+    bool sized_ = false;          // data_left_ is meaningful
+
+    bool ReadExact(void *data, size_t size);
+    bool Skip(uint32_t size);
+    bool ParseFormat(const uint8_t *chunk, uint32_t size);
+    size_t ReadData(void *data, size_t size);
+    bool DataEnded() const;
+    size_t ReadPcm(int16_t *pcm, size_t max_frames);
+    size_t ReadAdpcm(int16_t *pcm, size_t max_frames);
+};
+
+} // namespace wrapper
@@ -0,0 +1,193 @@
+#include <esp_attr.h>
+#include <esp_timer.h>
+#include "wrapper/audio-clock.hpp"
+
+namespace wrapper
+{
+
+// Sequence lock: odd while a writer is inside, readers retry until they see the same even value twice
+
+static inline void SeqBegin(std::atomic<uint32_t> &seq)
+{
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+static inline void SeqEnd(std::atomic<uint32_t> &seq)
+{
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+template <typename Copy>
+static inline void SeqRead(const std::atomic<uint32_t> &seq, Copy copy)
+{
+    uint32_t before;
+    uint32_t after;
+    do {
+        before = seq.load(std::memory_order_acquire);
+        copy();
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = seq.load(std::memory_order_relaxed);
+    } while ((before & 1) != 0 || before != after);
+}
+
+bool AudioClock::Start(I2sBus &i2s_bus, const AudioClockConfig &config)
+{
+    sample_rate_hz_ = i2s_bus.GetTxSampleRate();
+    desc_frames_ = i2s_bus.GetDmaFrameNum();
+    queue_frames_ = i2s_bus.GetDmaDescNum() * desc_frames_;
+    if (sample_rate_hz_ == 0 || queue_frames_ == 0) {
+        logger_.Error("I2S TX is not configured");
+        return false;
+    }
+    config_ = config;
+    dma_frames_ = 0;
+    dma_time_us_ = 0;
+    written_ = 0;
+    offset_ = 0;
+    last_block_ = AudioBlockTime{};
+    anchor_frames_ = 0;
+    anchor_us_ = 0;
+    drift_valid_ = false;
+    rate_hz_ = (float)sample_rate_hz_;
+    drift_ppm_ = 0;
+
+    dma_events_ = false;
+    if (config_.use_dma_events) {
+        i2s_event_callbacks_t callbacks = {};
+        callbacks.on_sent = OnSent;
+        // Chained behind the bus counters; fails once the channel is running
+        dma_events_ = i2s_bus.EnableEventCallbacks(&callbacks, nullptr, this);
+        if (!dma_events_) logger_.Warning("No DMA timestamps, estimating from write completion");
+    }
+    logger_.Info("Audio clock at %u Hz, DMA queue %u frames", (unsigned)sample_rate_hz_, (unsigned)queue_frames_);
+    return true;
+}
+
+bool IRAM_ATTR AudioClock::OnSent(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx)
+{
+    auto *self = static_cast<AudioClock *>(user_ctx);
+    SeqBegin(self->dma_seq_);
+    self->dma_frames_ += self->desc_frames_;
+    self->dma_time_us_ = esp_timer_get_time();
+    SeqEnd(self->dma_seq_);
+    return false;
+}
+
+bool AudioClock::ReadDmaPosition(uint64_t &frames, int64_t &time_us) const
+{
+    SeqRead(dma_seq_, [&] {
+        frames = dma_frames_;
+        time_us = dma_time_us_;
+    });
+    return time_us != 0;
+}
+
+int64_t AudioClock::Presentation(uint64_t dma_frame, uint64_t dma_frames, int64_t dma_time_us) const
+{
+    int64_t distance = (int64_t)(dma_frame - dma_frames);
+    return dma_time_us + (int64_t)((double)distance * 1e6 / rate_hz_.load(std::memory_order_relaxed)) +
+           config_.output_latency_us;
+}
+
+void AudioClock::UpdateDrift(uint64_t frames, int64_t time_us)
+{
+    if (anchor_us_ == 0) {
+        anchor_frames_ = frames;
+        anchor_us_ = time_us;
+        return;
+    }
+    int64_t elapsed_us = time_us - anchor_us_;
+    if (elapsed_us < (int64_t)config_.drift_window_ms * 1000) return;
+
+    double rate = (double)(frames - anchor_frames_) * 1e6 / (double)elapsed_us;
+    float ppm = (float)((rate / sample_rate_hz_ - 1.0) * 1e6);
+    // First window taken as is, then smoothed over ~4 windows
+    float previous = drift_ppm_.load(std::memory_order_relaxed);
+    float smoothed = drift_valid_ ? previous + (ppm - previous) / 4 : ppm;
+    drift_valid_ = true;
+    drift_ppm_.store(smoothed, std::memory_order_relaxed);
+    rate_hz_.store((float)(sample_rate_hz_ * (1.0 + smoothed * 1e-6)), std::memory_order_relaxed);
+    anchor_frames_ = frames;
+    anchor_us_ = time_us;
+}
+
+AudioBlockTime AudioClock::OnWrite(uint32_t frames, int64_t enqueue_us)
+{
+    int64_t now = esp_timer_get_time();
+    uint64_t dma_frames = 0;
+    int64_t dma_time_us = 0;
+
+    AudioBlockTime block;
+    block.frame = written_;
+    block.frames = frames;
+    block.enqueue_us = enqueue_us;
+
+    uint64_t offset = offset_;
+    if (dma_events_) {
+        ReadDmaPosition(dma_frames, dma_time_us);
+        // The DMA played past the stream: the queue ran dry and this block starts after the current descriptor
+        if (block.frame + offset < dma_frames) offset = dma_frames + desc_frames_ - block.frame;
+    } else {
+        // A blocking write returns once its last frame is queued, so the queue is full
+        uint64_t end = block.frame + offset + frames;
+        dma_frames = end > queue_frames_ ? end - queue_frames_ : 0;
+        dma_time_us = now;
+        SeqBegin(dma_seq_);
+        dma_frames_ = dma_frames;
+        dma_time_us_ = dma_time_us;
+        SeqEnd(dma_seq_);
+    }
+    if (dma_time_us == 0) dma_time_us = now; // before the first descriptor has finished
+    block.presentation_us = Presentation(block.frame + offset, dma_frames, dma_time_us);
+
+    SeqBegin(write_seq_);
+    written_ += frames;
+    offset_ = offset;
+    last_block_ = block;
+    SeqEnd(write_seq_);
+
+    // Write completion jitters and cannot see underruns, so drift needs DMA timestamps
+    if (dma_events_ && dma_frames > 0) UpdateDrift(dma_frames, dma_time_us);
+    return block;
+}
+
+AudioBlockTime AudioClock::GetLastBlock() const
+{
+    AudioBlockTime block;
+    SeqRead(write_seq_, [&] { block = last_block_; });
+    return block;
+}
+
+uint64_t AudioClock::GetFramesWritten() const
+{
+    uint64_t written = 0;
+    SeqRead(write_seq_, [&] { written = written_; });
+    return written;
+}
+
+int64_t AudioClock::GetPresentationTime(uint64_t frame) const
+{
+    uint64_t offset = 0;
+    SeqRead(write_seq_, [&] { offset = offset_; });
+    uint64_t dma_frames = 0;
+    int64_t dma_time_us = 0;
+    if (!ReadDmaPosition(dma_frames, dma_time_us)) dma_time_us = esp_timer_get_time();
+    return Presentation(frame + offset, dma_frames, dma_time_us);
+}
+
+uint64_t AudioClock::GetFrameAt(int64_t time_us) const
+{
+    uint64_t offset = 0;
+    SeqRead(write_seq_, [&] { offset = offset_; });
+    uint64_t dma_frames = 0;
+    int64_t dma_time_us = 0;
+    if (!ReadDmaPosition(dma_frames, dma_time_us)) return 0;
+
+    double ahead = (double)(time_us - dma_time_us - (int64_t)config_.output_latency_us) * 1e-6 *
+                   rate_hz_.load(std::memory_order_relaxed);
+    int64_t dma_frame = (int64_t)dma_frames + (int64_t)ahead;
+    return dma_frame > (int64_t)offset ? (uint64_t)(dma_frame - (int64_t)offset) : 0;
+}
+
+} // namespace wrapper
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "wrapper/logger.hpp"
+#include "wrapper/i2s.hpp"
+
+namespace wrapper
+{
+
+struct AudioClockConfig
+{
+    bool use_dma_events = true;     // timestamp every TX descriptor in the I2S ISR
+    uint32_t output_latency_us = 0; // codec/DAC group delay added to every presentation time
+    uint32_t drift_window_ms = 10000;
+};
+
+// Timing of one written block, frame indices count from Start
+struct AudioBlockTime
+{
+    uint64_t frame = 0;          // first frame of the block
+    uint32_t frames = 0;
+    int64_t enqueue_us = 0;      // esp_timer time the write was issued
+    int64_t presentation_us = 0; // estimated esp_timer time the first frame reaches the output
+};
+
+/**
+ * @brief Maps written TX frames to esp_timer time, for A/V sync and scheduling
+ *
+ * With DMA events the I2S ISR stamps every finished descriptor, so the play
+ * position is known to within the ISR latency: a frame plays at the last
+ * stamp plus its distance from the play position at the measured rate. After
+ * an underrun the stream is re-anchored at the play position (error up to one
+ * descriptor). Without events (e.g. the channel was already enabled) a
+ * returned blocking write is taken to mean the DMA queue is full.
+ *
+ * The measured rate also gives the drift of the I2S clock against esp_timer,
+ * e.g. to trim a Resampler when audio must follow another clock.
+ */
+class AudioClock
+{
+    Logger &logger_;
+    AudioClockConfig config_;
+    uint32_t sample_rate_hz_ = 0;
+    uint32_t desc_frames_ = 0;
+    uint32_t queue_frames_ = 0;
+    bool dma_events_ = false;
+
+    // Play position, written by the ISR under a sequence lock
+    std::atomic<uint32_t> dma_seq_{0};
+    uint64_t dma_frames_ = 0;
+    int64_t dma_time_us_ = 0;
+
+    // Stream position, written by the writer task under a sequence lock
+    std::atomic<uint32_t> write_seq_{0};
+    uint64_t written_ = 0;
+    uint64_t offset_ = 0;        // silence the DMA inserted before the stream (underruns)
+    AudioBlockTime last_block_;
+
+    // Drift, owned by the writer task
+    uint64_t anchor_frames_ = 0;
+    int64_t anchor_us_ = 0;
+    bool drift_valid_ = false;
+    std::atomic<float> rate_hz_{0};
+    std::atomic<float> drift_ppm_{0};
+
+    static bool OnSent(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx);
+    bool ReadDmaPosition(uint64_t &frames, int64_t &time_us) const;
+    void UpdateDrift(uint64_t frames, int64_t time_us);
+    int64_t Presentation(uint64_t dma_frame, uint64_t dma_frames, int64_t dma_time_us) const;
+
+public:
+    AudioClock(Logger &logger) : logger_(logger) {}
+
+    AudioClock(const AudioClock &) = delete;
+    AudioClock &operator=(const AudioClock &) = delete;
+
+    Logger &GetLogger() const { return logger_; }
+
+    // Call after I2sBus::Init and TX configuration, before the TX channel is enabled.
+    // Registers the bus event callbacks, replacing user callbacks passed there before
+    bool Start(I2sBus &i2s_bus, const AudioClockConfig &config = AudioClockConfig());
+    bool HasDmaTimestamps() const { return dma_events_; }
+
+    // Writer side: the block of frames whose blocking write started at enqueue_us has just returned
+    AudioBlockTime OnWrite(uint32_t frames, int64_t enqueue_us);
+
+    AudioBlockTime GetLastBlock() const;
+    uint64_t GetFramesWritten() const;
+    // Estimated esp_timer time a stream frame reaches the output
+    int64_t GetPresentationTime(uint64_t frame) const;
+    // Stream frame that will be playing at time_us (frames not written yet extrapolate)
+    uint64_t GetFrameAt(int64_t time_us) const;
+
+    // Measured I2S rate in esp_timer terms, the nominal rate until the first drift window
+    // closes or without DMA timestamps
+    float GetMeasuredRate() const { return rate_hz_.load(std::memory_order_relaxed); }
+    float GetDriftPpm() const { return drift_ppm_.load(std::memory_order_relaxed); }
+};
+
+} // namespace wrapper
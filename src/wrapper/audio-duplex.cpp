@@ -0,0 +1,202 @@
+#include <cstring>
+#include <esp_timer.h>
+#include "wrapper/audio-duplex.hpp"
+
+namespace wrapper
+{
+
+static void UpdateMax(std::atomic<uint32_t> &max, uint32_t value)
+{
+    if (value > max.load(std::memory_order_relaxed)) max.store(value, std::memory_order_relaxed);
+}
+
+// 0 means no sample yet
+static void UpdateMin(std::atomic<uint32_t> &min, uint32_t value)
+{
+    uint32_t current = min.load(std::memory_order_relaxed);
+    if (current == 0 || value < current) min.store(value, std::memory_order_relaxed);
+}
+
+AudioDuplex::~AudioDuplex()
+{
+    Stop();
+}
+
+bool AudioDuplex::Start(AudioCodec &codec, const AudioDuplexConfig &config, AudioDuplexCallback callback)
+{
+    if (running_) {
+        logger_.Warning("Already running");
+        return false;
+    }
+    const uint32_t sample_rate = codec.GetI2sBus().GetRxSampleRate();
+    if (sample_rate == 0) {
+        logger_.Error("I2S RX sample rate is 0");
+        return false;
+    }
+    if (config.channels != AudioCodec::CHANNELS || config.block_frames == 0) {
+        logger_.Error("Invalid block format (%u frames, %u channels, codec has %u)", (unsigned)config.block_frames,
+                      (unsigned)config.channels, (unsigned)AudioCodec::CHANNELS);
+        return false;
+    }
+    block_ = new (std::nothrow) int16_t[config.block_frames * config.channels];
+    if (block_ == nullptr) {
+        logger_.Error("Failed to allocate duplex block");
+        return false;
+    }
+
+    codec_ = &codec;
+    config_ = config;
+    callback_ = callback;
+    block_period_us_ = (uint32_t)((uint64_t)config_.block_frames * 1000000 / sample_rate);
+    ResetStats();
+    should_stop_ = false;
+    running_ = true;
+
+    BaseType_t ret = xTaskCreatePinnedToCore(
+        TaskWrapper, config_.name, config_.stack_size, this, config_.priority, &task_handle_, config_.core_id);
+    if (ret != pdPASS) {
+        logger_.Error("Failed to create duplex task");
+        running_ = false;
+        task_handle_ = nullptr;
+        delete[] block_;
+        block_ = nullptr;
+        return false;
+    }
+    logger_.Info("Duplex started (%u frames x %u channels, period %u us, nominal latency %u us)",
+                 (unsigned)config_.block_frames, (unsigned)config_.channels, (unsigned)block_period_us_,
+                 (unsigned)(block_period_us_ * (1 + config_.prime_blocks)));
+    return true;
+}
+
+void AudioDuplex::Stop()
+{
+    if (task_handle_ == nullptr) return;
+    should_stop_ = true;
+    if (xTaskGetCurrentTaskHandle() != task_handle_) {
+        // The loop exits after at most one blocking read + write
+        const int max_retries = 100;
+        for (int i = 0; i < max_retries && running_; ++i) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+    if (running_) {
+        logger_.Error("Duplex task did not stop, keeping its block alive");
+        return;
+    }
+    task_handle_ = nullptr;
+    delete[] block_;
+    block_ = nullptr;
+}
+
+void AudioDuplex::GetStats(AudioDuplexStats &stats) const
+{
+    stats.blocks = blocks_.load(std::memory_order_relaxed);
+    stats.read_errors = read_errors_.load(std::memory_order_relaxed);
+    stats.write_errors = write_errors_.load(std::memory_order_relaxed);
+    stats.xruns = codec_ != nullptr ? CountQueueOverflows() - xrun_base_.load(std::memory_order_relaxed) : 0;
+    stats.deadline_misses = deadline_misses_.load(std::memory_order_relaxed);
+    stats.block_period_us = block_period_us_;
+    stats.last_cycle_us = last_cycle_us_.load(std::memory_order_relaxed);
+    stats.max_cycle_us = max_cycle_us_.load(std::memory_order_relaxed);
+    stats.last_process_us = last_process_us_.load(std::memory_order_relaxed);
+    stats.max_process_us = max_process_us_.load(std::memory_order_relaxed);
+    stats.nominal_latency_us = block_period_us_ * (uint32_t)(1 + config_.prime_blocks);
+    stats.last_latency_us = last_latency_us_.load(std::memory_order_relaxed);
+    stats.min_latency_us = min_latency_us_.load(std::memory_order_relaxed);
+    stats.max_latency_us = max_latency_us_.load(std::memory_order_relaxed);
+}
+
+void AudioDuplex::ResetStats()
+{
+    blocks_ = 0;
+    read_errors_ = 0;
+    write_errors_ = 0;
+    xrun_base_ = codec_ != nullptr ? CountQueueOverflows() : 0;
+    deadline_misses_ = 0;
+    last_cycle_us_ = 0;
+    max_cycle_us_ = 0;
+    last_process_us_ = 0;
+    max_process_us_ = 0;
+    last_latency_us_ = 0;
+    min_latency_us_ = 0;
+    max_latency_us_ = 0;
+}
+
+uint32_t AudioDuplex::CountQueueOverflows() const
+{
+    I2sChannelStats tx;
+    I2sChannelStats rx;
+    codec_->GetI2sBus().GetTxStats(tx);
+    codec_->GetI2sBus().GetRxStats(rx);
+    return tx.queue_overflows + rx.queue_overflows;
+}
+
+void AudioDuplex::RecordLatency(int64_t capture_us, uint64_t frame)
+{
+    AudioClock *clock = codec_->GetAudioClock();
+    int64_t latency_us = clock->GetPresentationTime(frame) - capture_us;
+    if (latency_us <= 0) return;
+    last_latency_us_.store((uint32_t)latency_us, std::memory_order_relaxed);
+    UpdateMin(min_latency_us_, (uint32_t)latency_us);
+    UpdateMax(max_latency_us_, (uint32_t)latency_us);
+}
+
+void AudioDuplex::TaskWrapper(void *param)
+{
+    auto *self = static_cast<AudioDuplex *>(param);
+    self->Run();
+    vTaskDelete(nullptr);
+}
+
+void AudioDuplex::Run()
+{
+    const size_t samples = config_.block_frames * config_.channels;
+    const size_t block_bytes = samples * sizeof(int16_t);
+
+    // Fixed playback lead: after this every read is paired with one write
+    PcmMute(block_, samples);
+    for (size_t i = 0; i < config_.prime_blocks && !should_stop_; ++i) {
+        if (!codec_->Write(block_, block_bytes)) write_errors_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    AudioClock *clock = codec_->GetAudioClock();
+    int64_t cycle_start = esp_timer_get_time();
+    while (!should_stop_) {
+        bool captured = codec_->Read(block_, block_bytes);
+        // The read returns once the block's last frame is in, its first frame is one period older
+        int64_t capture_us = esp_timer_get_time() - block_period_us_;
+        if (!captured) {
+            // Keep the lockstep: play silence for the lost block
+            read_errors_.fetch_add(1, std::memory_order_relaxed);
+            PcmMute(block_, samples);
+        }
+
+        int64_t process_start = esp_timer_get_time();
+        if (callback_) callback_(block_, config_.block_frames, config_.channels);
+        uint32_t process_us = (uint32_t)(esp_timer_get_time() - process_start);
+
+        uint64_t frame = clock != nullptr ? clock->GetFramesWritten() : 0;
+        if (!codec_->Write(block_, block_bytes)) {
+            write_errors_.fetch_add(1, std::memory_order_relaxed);
+        } else if (clock != nullptr && captured) {
+            RecordLatency(capture_us, frame);
+        }
+
+        // Read blocks until the capture DMA has a block, so a healthy cycle takes one period
+        int64_t now = esp_timer_get_time();
+        uint32_t cycle_us = (uint32_t)(now - cycle_start);
+        cycle_start = now;
+
+        if (cycle_us > block_period_us_ + block_period_us_ / 2) {
+            deadline_misses_.fetch_add(1, std::memory_order_relaxed);
+        }
+        last_cycle_us_.store(cycle_us, std::memory_order_relaxed);
+        last_process_us_.store(process_us, std::memory_order_relaxed);
+        UpdateMax(max_cycle_us_, cycle_us);
+        UpdateMax(max_process_us_, process_us);
+        blocks_.fetch_add(1, std::memory_order_relaxed);
+    }
+    running_ = false;
+}
+
+} // namespace wrapper
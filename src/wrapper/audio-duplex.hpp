@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "wrapper/logger.hpp"
+#include "wrapper/audio.hpp"
+
+namespace wrapper
+{
+
+struct AudioDuplexConfig
+{
+    const char *name = "AudioDuplex";
+    uint32_t stack_size = 4096;
+    UBaseType_t priority = 12;
+    BaseType_t core_id = tskNO_AFFINITY;
+    size_t channels = 2;       // must equal AudioCodec::CHANNELS
+    size_t block_frames = 160; // 10 ms at 16 kHz
+    size_t prime_blocks = 2;   // silence written ahead so the speaker never starves
+};
+
+// Processes one block in place: interleaved int16, frames x channels
+using AudioDuplexCallback = std::function<void(int16_t *block, size_t frames, size_t channels)>;
+
+struct AudioDuplexStats
+{
+    uint32_t blocks = 0;
+    uint32_t read_errors = 0;
+    uint32_t write_errors = 0;
+    uint32_t xruns = 0;           // I2S TX + RX queue overflows, needs DMA event callbacks on the bus
+    uint32_t deadline_misses = 0; // cycles longer than 1.5 block periods
+    uint32_t block_period_us = 0;
+    uint32_t last_cycle_us = 0;   // read + process + write
+    uint32_t max_cycle_us = 0;
+    uint32_t last_process_us = 0; // callback only
+    uint32_t max_process_us = 0;
+    uint32_t nominal_latency_us = 0; // capture block + primed blocks as configured, DMA queues excluded
+    // Measured mic to speaker latency, needs an AudioClock on the codec (0 otherwise):
+    // from the capture of a block's first frame to its presentation at the output
+    uint32_t last_latency_us = 0;
+    uint32_t min_latency_us = 0;
+    uint32_t max_latency_us = 0;
+};
+
+/**
+ * @brief Full-duplex loop over AudioCodec: read a mic block, process it,
+ * write the speaker block, all in one task so capture and playback stay in
+ * lockstep on the shared I2S clock.
+ *
+ * The speaker is primed with prime_blocks of silence, after which every
+ * captured block is answered by exactly one played block, so the loop
+ * latency stays constant. The block buffer is allocated in Start.
+ *
+ * With an AudioClock set on the codec the latency is measured every cycle:
+ * the block's first frame was captured one block period before its Read
+ * returned, and the clock gives the time it reaches the output. Frames that
+ * already waited in the RX DMA queue are older than that, so a capture
+ * backlog reads low; once it outgrows the queue it is counted as an xrun.
+ */
+class AudioDuplex
+{
+    Logger &logger_;
+    AudioCodec *codec_ = nullptr;
+    AudioDuplexConfig config_;
+    AudioDuplexCallback callback_;
+    int16_t *block_ = nullptr;
+    TaskHandle_t task_handle_ = nullptr;
+    std::atomic<bool> should_stop_{false};
+    std::atomic<bool> running_{false};
+
+    std::atomic<uint32_t> blocks_{0};
+    std::atomic<uint32_t> read_errors_{0};
+    std::atomic<uint32_t> write_errors_{0};
+    std::atomic<uint32_t> xrun_base_{0}; // bus overflow count at the last reset
+    std::atomic<uint32_t> deadline_misses_{0};
+    std::atomic<uint32_t> last_cycle_us_{0};
+    std::atomic<uint32_t> max_cycle_us_{0};
+    std::atomic<uint32_t> last_process_us_{0};
+    std::atomic<uint32_t> max_process_us_{0};
+    std::atomic<uint32_t> last_latency_us_{0};
+    std::atomic<uint32_t> min_latency_us_{0};
+    std::atomic<uint32_t> max_latency_us_{0};
+    uint32_t block_period_us_ = 0;
+
+    static void TaskWrapper(void *param);
+    void Run();
+    uint32_t CountQueueOverflows() const;
+    void RecordLatency(int64_t capture_us, uint64_t frame);
+
+public:
+    AudioDuplex(Logger &logger) : logger_(logger) {}
+    ~AudioDuplex();
+
+    AudioDuplex(const AudioDuplex &) = delete;
+    AudioDuplex &operator=(const AudioDuplex &) = delete;
+
+    Logger &GetLogger() const { return logger_; }
+
+    // An empty callback gives a plain loopback
+    bool Start(AudioCodec &codec, const AudioDuplexConfig &config, AudioDuplexCallback callback = nullptr);
+    void Stop();
+    bool IsRunning() const { return running_; }
+
+    void GetStats(AudioDuplexStats &stats) const;
+    void ResetStats();
+};
+
+} // namespace wrapper
@@ -0,0 +1,182 @@
+#include <esp_timer.h>
+#include "wrapper/audio-encode-pipeline.hpp"
+
+namespace wrapper
+{
+
+AudioEncodePipeline::~AudioEncodePipeline()
+{
+    Stop();
+}
+
+void AudioEncodePipeline::Release()
+{
+    delete[] pcm_;
+    pcm_ = nullptr;
+    delete[] packet_;
+    packet_ = nullptr;
+    ring_.Deinit();
+}
+
+bool AudioEncodePipeline::Start(AudioCodec &codec, AudioEncoder &encoder, const AudioEncodeConfig &config)
+{
+    if (running_) {
+        logger_.Warning("Already running");
+        return false;
+    }
+    const size_t channels = encoder.GetChannels();
+    if (channels != 1 && channels != config.capture_channels) {
+        logger_.Error("%s encoder has %u channels, capture has %u", encoder.GetName(),
+                      (unsigned)channels, (unsigned)config.capture_channels);
+        return false;
+    }
+    if (config.channel >= config.capture_channels) {
+        logger_.Error("Invalid capture channel %u", (unsigned)config.channel);
+        return false;
+    }
+    const size_t max_packet = encoder.GetMaxPacketSize();
+    if (max_packet > UINT16_MAX || sizeof(AudioPacketHeader) + max_packet > config.ring_size) {
+        logger_.Error("Packet size %u does not fit the ring", (unsigned)max_packet);
+        return false;
+    }
+
+    pcm_ = new (std::nothrow) int16_t[encoder.GetFrameSamples() * config.capture_channels];
+    packet_ = new (std::nothrow) uint8_t[max_packet];
+    if (pcm_ == nullptr || packet_ == nullptr || !ring_.Init(config.ring_size)) {
+        logger_.Error("Failed to allocate encode buffers");
+        Release();
+        return false;
+    }
+
+    codec_ = &codec;
+    encoder_ = &encoder;
+    config_ = config;
+    sequence_ = 0;
+    packets_ = 0;
+    dropped_ = 0;
+    read_errors_ = 0;
+    last_encode_us_ = 0;
+    max_encode_us_ = 0;
+    avg_encode_us_ = 0;
+    pcm_bytes_ = 0;
+    packet_bytes_ = 0;
+    encoder_->Reset();
+    should_stop_ = false;
+    running_ = true;
+
+    BaseType_t ret = xTaskCreatePinnedToCore(
+        TaskWrapper, config_.name, config_.stack_size, this, config_.priority, &task_handle_, config_.core_id);
+    if (ret != pdPASS) {
+        logger_.Error("Failed to create encode task");
+        running_ = false;
+        task_handle_ = nullptr;
+        Release();
+        return false;
+    }
+    logger_.Info("Encoding %s: %u frames x %u channels -> %u byte packets", encoder_->GetName(),
+                 (unsigned)encoder_->GetFrameSamples(), (unsigned)channels, (unsigned)max_packet);
+    return true;
+}
+
+void AudioEncodePipeline::Stop()
+{
+    if (task_handle_ == nullptr) return;
+    should_stop_ = true;
+    if (xTaskGetCurrentTaskHandle() != task_handle_) {
+        const int max_retries = 100;
+        for (int i = 0; i < max_retries && running_; ++i) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+    if (running_) {
+        logger_.Error("Encode task did not stop, keeping its buffers alive");
+        return;
+    }
+    task_handle_ = nullptr;
+    Release();
+}
+
+size_t AudioEncodePipeline::ReadPacket(uint8_t *payload, size_t max_size, uint16_t *sequence)
+{
+    if (!ring_.IsValid()) return 0;
+    AudioPacketHeader header;
+    if (ring_.Peek(&header, sizeof(header)) < sizeof(header)) return 0;
+    // The payload is committed right after the header, wait until both are in
+    if (ring_.Available() < sizeof(header) + header.size) return 0;
+
+    ring_.CommitRead(sizeof(header));
+    if (header.size > max_size) {
+        logger_.Warning("Packet of %u bytes does not fit %u, discarded", (unsigned)header.size, (unsigned)max_size);
+        while (header.size > 0) {
+            RingSpan span = ring_.GetReadSpan();
+            size_t skip = span.size < header.size ? span.size : header.size;
+            ring_.CommitRead(skip);
+            header.size -= (uint16_t)skip;
+        }
+        return 0;
+    }
+    ring_.Read(payload, header.size);
+    if (sequence != nullptr) *sequence = header.sequence;
+    return header.size;
+}
+
+void AudioEncodePipeline::GetStats(AudioEncodeStats &stats) const
+{
+    stats.packets = packets_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.read_errors = read_errors_.load(std::memory_order_relaxed);
+    stats.last_encode_us = last_encode_us_.load(std::memory_order_relaxed);
+    stats.max_encode_us = max_encode_us_.load(std::memory_order_relaxed);
+    stats.avg_encode_us = avg_encode_us_.load(std::memory_order_relaxed);
+    stats.pcm_bytes = pcm_bytes_.load(std::memory_order_relaxed);
+    stats.packet_bytes = packet_bytes_.load(std::memory_order_relaxed);
+}
+
+void AudioEncodePipeline::TaskWrapper(void *param)
+{
+    auto *self = static_cast<AudioEncodePipeline *>(param);
+    self->Run();
+    vTaskDelete(nullptr);
+}
+
+void AudioEncodePipeline::Run()
+{
+    const size_t frames = encoder_->GetFrameSamples();
+    const size_t read_bytes = frames * config_.capture_channels * sizeof(int16_t);
+    const bool extract = encoder_->GetChannels() == 1 && config_.capture_channels > 1;
+
+    while (!should_stop_) {
+        if (!codec_->Read(pcm_, read_bytes)) {
+            read_errors_.fetch_add(1, std::memory_order_relaxed);
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
+        if (extract) PcmExtractChannel(pcm_, pcm_, frames, config_.capture_channels, config_.channel);
+
+        int64_t start = esp_timer_get_time();
+        size_t size = encoder_->Encode(pcm_, packet_, encoder_->GetMaxPacketSize());
+        uint32_t encode_us = (uint32_t)(esp_timer_get_time() - start);
+
+        last_encode_us_.store(encode_us, std::memory_order_relaxed);
+        if (encode_us > max_encode_us_.load(std::memory_order_relaxed)) max_encode_us_.store(encode_us, std::memory_order_relaxed);
+        uint32_t avg = avg_encode_us_.load(std::memory_order_relaxed);
+        avg_encode_us_.store(packets_ == 0 ? encode_us : avg + ((int32_t)(encode_us - avg) >> 4), std::memory_order_relaxed);
+        pcm_bytes_.fetch_add(frames * encoder_->GetChannels() * sizeof(int16_t), std::memory_order_relaxed);
+
+        AudioPacketHeader header{(uint16_t)size, sequence_++};
+        if (size == 0) continue;
+        // Whole packets only: never queue a header whose payload would not fit
+        if (ring_.Free() < sizeof(header) + size) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            ring_.MarkOverrun();
+            continue;
+        }
+        ring_.Write(&header, sizeof(header));
+        ring_.Write(packet_, size);
+        packets_.fetch_add(1, std::memory_order_relaxed);
+        packet_bytes_.fetch_add(sizeof(header) + size, std::memory_order_relaxed);
+    }
+    running_ = false;
+}
+
+} // namespace wrapper
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "wrapper/logger.hpp"
+#include "wrapper/audio.hpp"
+#include "wrapper/ring-buffer.hpp"
+#include "dsp/audio-encoder.hpp"
+
+namespace wrapper
+{
+
+struct AudioEncodeConfig
+{
+    const char *name = "AudioEncode";
+    uint32_t stack_size = 4096;
+    UBaseType_t priority = 8;
+    BaseType_t core_id = tskNO_AFFINITY;
+    size_t capture_channels = 2; // as opened by MicrophoneCodec/AudioCodec
+    size_t channel = 0;          // captured channel fed to a mono encoder
+    size_t ring_size = 8192;     // packet ring bytes, rounded up to a power of two
+};
+
+// Precedes every packet in the ring
+struct AudioPacketHeader
+{
+    uint16_t size;     // payload bytes
+    uint16_t sequence; // wraps, gaps mean packets were dropped
+};
+
+struct AudioEncodeStats
+{
+    uint32_t packets = 0;
+    uint32_t dropped = 0;        // ring full, packet discarded
+    uint32_t read_errors = 0;
+    uint32_t last_encode_us = 0;
+    uint32_t max_encode_us = 0;
+    uint32_t avg_encode_us = 0;  // moving average over ~16 packets
+    uint32_t pcm_bytes = 0;      // wraps
+    uint32_t packet_bytes = 0;   // wraps
+};
+
+/**
+ * @brief Capture -> encode -> packet ring, on its own task
+ *
+ * Reads one encoder frame per AudioCodec::Read, encodes it and queues it as
+ * [AudioPacketHeader][payload] in a lock-free ring that a single consumer
+ * (e.g. the uplink) drains with ReadPacket. Buffers are allocated in Start.
+ */
+class AudioEncodePipeline
+{
+    Logger &logger_;
+    AudioCodec *codec_ = nullptr;
+    AudioEncoder *encoder_ = nullptr;
+    AudioEncodeConfig config_;
+    SpscRingBuffer ring_;
+    int16_t *pcm_ = nullptr;
+    uint8_t *packet_ = nullptr;
+    uint16_t sequence_ = 0;
+    TaskHandle_t task_handle_ = nullptr;
+    std::atomic<bool> should_stop_{false};
+    std::atomic<bool> running_{false};
+
+    std::atomic<uint32_t> packets_{0};
+    std::atomic<uint32_t> dropped_{0};
+    std::atomic<uint32_t> read_errors_{0};
+    std::atomic<uint32_t> last_encode_us_{0};
+    std::atomic<uint32_t> max_encode_us_{0};
+    std::atomic<uint32_t> avg_encode_us_{0};
+    std::atomic<uint32_t> pcm_bytes_{0};
+    std::atomic<uint32_t> packet_bytes_{0};
+
+    static void TaskWrapper(void *param);
+    void Run();
+    void Release();
+
+public:
+    AudioEncodePipeline(Logger &logger) : logger_(logger) {}
+    ~AudioEncodePipeline();
+
+    AudioEncodePipeline(const AudioEncodePipeline &) = delete;
+    AudioEncodePipeline &operator=(const AudioEncodePipeline &) = delete;
+
+    Logger &GetLogger() const { return logger_; }
+
+    // encoder channels must be 1 or capture_channels
+    bool Start(AudioCodec &codec, AudioEncoder &encoder, const AudioEncodeConfig &config);
+    void Stop();
+    bool IsRunning() const { return running_; }
+
+    /**
+     * @brief Pops one packet, non-blocking, single consumer
+     * @return Payload bytes, 0 if no complete packet is queued or it did not fit (it is then discarded)
+     */
+    size_t ReadPacket(uint8_t *payload, size_t max_size, uint16_t *sequence = nullptr);
+
+    size_t GetQueuedBytes() const { return ring_.Available(); }
+    void GetStats(AudioEncodeStats &stats) const;
+};
+
+} // namespace wrapper
@@ -0,0 +1,154 @@
+#include <new>
+#include "wrapper/audio-mixer.hpp"
+
+namespace wrapper
+{
+
+AudioMixer::~AudioMixer()
+{
+    Stop();
+    Release();
+}
+
+int AudioMixer::AddStream(size_t ring_size, uint8_t priority, float gain)
+{
+    if (running_) {
+        logger_.Error("Streams can only be added while stopped");
+        return INVALID_STREAM;
+    }
+    int id = bus_.AddStream(ring_size, priority, gain);
+    if (id == INVALID_STREAM) {
+        logger_.Error("Too many streams (max %u)", (unsigned)MAX_STREAMS);
+    }
+    return id;
+}
+
+void AudioMixer::Release()
+{
+    bus_.Deinit();
+    delete[] block_;
+    block_ = nullptr;
+}
+
+bool AudioMixer::Start(AudioCodec &codec, const AudioMixerConfig &config)
+{
+    if (running_) {
+        logger_.Warning("Already running");
+        return false;
+    }
+    if (bus_.GetStreamCount() == 0) {
+        logger_.Error("No streams added");
+        return false;
+    }
+    // The codec takes interleaved stereo, any other layout would be played at the wrong speed
+    if (config.channels != AudioCodec::CHANNELS || config.block_frames == 0) {
+        logger_.Error("Invalid block format (%u frames, %u channels, codec has %u)", (unsigned)config.block_frames,
+                      (unsigned)config.channels, (unsigned)AudioCodec::CHANNELS);
+        return false;
+    }
+
+    MixBusConfig bus_config;
+    bus_config.channels = config.channels;
+    bus_config.block_frames = config.block_frames;
+    bus_config.duck_gain = config.duck_gain;
+    bus_config.ramp_blocks = config.ramp_blocks;
+    block_ = new (std::nothrow) int16_t[config.block_frames * config.channels];
+    if (block_ == nullptr || !bus_.Init(bus_config)) {
+        logger_.Error("Failed to allocate mixer buffers");
+        Release();
+        return false;
+    }
+
+    codec_ = &codec;
+    config_ = config;
+    should_stop_ = false;
+    blocks_written_ = 0;
+
+    BaseType_t ret = xTaskCreatePinnedToCore(
+        TaskWrapper, config_.name, config_.stack_size, this, config_.priority, &task_handle_, config_.core_id);
+    if (ret != pdPASS) {
+        logger_.Error("Failed to create mixer task");
+        task_handle_ = nullptr;
+        Release();
+        return false;
+    }
+    // Writers are let in from here on, task_handle_ is valid for their notifications
+    running_ = true;
+    logger_.Info("Mixer started (%u streams, %u frames x %u channels per block)",
+                 (unsigned)bus_.GetStreamCount(), (unsigned)config_.block_frames, (unsigned)config_.channels);
+    return true;
+}
+
+void AudioMixer::Stop()
+{
+    if (task_handle_ == nullptr) return;
+    should_stop_ = true;
+    xTaskNotifyGive(task_handle_);
+    if (xTaskGetCurrentTaskHandle() != task_handle_) {
+        const int max_retries = 100;
+        for (int i = 0; i < max_retries && running_; ++i) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+    if (running_) {
+        logger_.Error("Mixer task did not stop, keeping its buffers alive");
+        return;
+    }
+    task_handle_ = nullptr;
+    Release();
+}
+
+size_t AudioMixer::Write(int id, const void *data, size_t size)
+{
+    // Registered before should_stop_ is read, so the task either waits for us or we see it stopping
+    writers_.fetch_add(1);
+    size_t written = 0;
+    if (running_ && !should_stop_) {
+        written = bus_.Write(id, data, size);
+        if (written > 0) xTaskNotifyGive(task_handle_);
+    }
+    writers_.fetch_sub(1);
+    return written;
+}
+
+bool AudioMixer::SetStreamGain(int id, float gain)
+{
+    if (!bus_.SetStreamGain(id, gain)) {
+        logger_.Error("Invalid stream id %d", id);
+        return false;
+    }
+    return true;
+}
+
+void AudioMixer::TaskWrapper(void *param)
+{
+    auto *self = static_cast<AudioMixer *>(param);
+    self->Run();
+    vTaskDelete(nullptr);
+}
+
+void AudioMixer::Run()
+{
+    const size_t block_bytes = bus_.GetBlockBytes();
+    while (!should_stop_) {
+        bool full = false;
+        bool partial = false;
+        bus_.GetPending(full, partial);
+
+        // Wait for a full block; flush a partial tail only once producers went quiet
+        if (!full) {
+            if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(config_.idle_wait_ms)) > 0 || !partial) continue;
+        }
+
+        if (bus_.MixBlock(block_) == 0) continue;
+        // Blocks until the DMA has room, which paces the mixer at the output rate
+        if (codec_->Write(block_, block_bytes)) {
+            blocks_written_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    // Writers may still be in a ring or about to notify this task
+    while (writers_ > 0) vTaskDelay(pdMS_TO_TICKS(1));
+    running_ = false;
+}
+
+} // namespace wrapper
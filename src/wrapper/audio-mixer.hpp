@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "dsp/mix-bus.hpp"
+#include "wrapper/logger.hpp"
+#include "wrapper/audio.hpp"
+
+namespace wrapper
+{
+
+struct AudioMixerConfig
+{
+    const char *name = "AudioMixer";
+    uint32_t stack_size = 4096;
+    UBaseType_t priority = 10;
+    BaseType_t core_id = tskNO_AFFINITY;
+    size_t channels = 2;         // interleaved channels of every stream and of the output
+    size_t block_frames = 256;   // frames per codec write
+    float duck_gain = 0.25f;     // gain of streams below the highest active priority
+    size_t ramp_blocks = 4;      // blocks to move between unducked and ducked gain
+    uint32_t idle_wait_ms = 20;  // wait when no stream has data
+};
+
+/**
+ * @brief Software mixer: N input streams summed into one AudioCodec::Write
+ *
+ * A MixBus holds the streams (one lock-free ring and producer task each,
+ * a gain and a priority) and does the ducking and summation; this class
+ * adds the task that mixes a block whenever one is queued and writes it to
+ * the codec (e.g. music under TTS under UI beeps).
+ *
+ * Streams are added before Start; all buffers are allocated there, mixing
+ * never allocates. Stop waits for Write calls in progress before the rings
+ * are freed.
+ */
+class AudioMixer
+{
+public:
+    static constexpr size_t MAX_STREAMS = MixBus::MAX_STREAMS;
+    static constexpr int INVALID_STREAM = MixBus::INVALID_STREAM;
+
+    using StreamStats = MixBus::StreamStats;
+
+private:
+    Logger &logger_;
+    AudioMixerConfig config_;
+    MixBus bus_;
+    int16_t *block_ = nullptr; // output block
+    AudioCodec *codec_ = nullptr;
+    TaskHandle_t task_handle_ = nullptr;
+    std::atomic<bool> should_stop_{false};
+    std::atomic<bool> running_{false};
+    std::atomic<uint32_t> writers_{0}; // inside Write, the mixer task outlives them
+    std::atomic<uint32_t> blocks_written_{0};
+
+    static void TaskWrapper(void *param);
+    void Run();
+    void Release();
+
+public:
+    AudioMixer(Logger &logger) : logger_(logger) {}
+    ~AudioMixer();
+
+    AudioMixer(const AudioMixer &) = delete;
+    AudioMixer &operator=(const AudioMixer &) = delete;
+
+    Logger &GetLogger() const { return logger_; }
+
+    /**
+     * @brief Registers an input stream, only while stopped
+     * @param ring_size Ring bytes, rounded up to a power of two
+     * @param priority Higher values duck lower ones
+     * @param gain Linear stream gain, 0.0 - 2.0
+     * @return Stream id, or INVALID_STREAM
+     */
+    int AddStream(size_t ring_size, uint8_t priority = 0, float gain = 1.0f);
+
+    // config.channels must match AudioCodec::CHANNELS
+    bool Start(AudioCodec &codec, const AudioMixerConfig &config);
+    void Stop();
+    bool IsRunning() const { return running_; }
+
+    // Non-blocking, returns the number of bytes queued. One producer per stream
+    size_t Write(int id, const void *data, size_t size);
+
+    bool SetStreamGain(int id, float gain);
+    bool GetStreamStats(int id, StreamStats &stats) const { return bus_.GetStreamStats(id, stats); }
+    uint32_t GetBlocksWritten() const { return blocks_written_; }
+};
+
+} // namespace wrapper
@@ -0,0 +1,221 @@
+#include <esp_timer.h>
+#include "wrapper/audio-player.hpp"
+
+namespace wrapper
+{
+
+AudioPlayer::~AudioPlayer()
+{
+    Stop();
+}
+
+void AudioPlayer::Release()
+{
+    for (auto &block : blocks_) {
+        delete[] block;
+        block = nullptr;
+    }
+}
+
+bool AudioPlayer::Play(AudioCodec &codec, PcmSource &source, const AudioPlayerConfig &config)
+{
+    if (IsPlaying()) {
+        logger_.Warning("Already playing");
+        return false;
+    }
+    // Reap the tasks and buffers of a clip that finished on its own
+    Stop();
+
+    const size_t source_channels = source.GetChannels();
+    if (config.block_frames == 0 || (source_channels != config.channels && !(source_channels == 1 && config.channels == 2))) {
+        logger_.Error("Cannot play %u channels on %u (block %u frames)", (unsigned)source_channels,
+                      (unsigned)config.channels, (unsigned)config.block_frames);
+        return false;
+    }
+    const uint32_t sample_rate = codec.GetI2sBus().GetTxSampleRate();
+    if (source.GetSampleRate() != sample_rate) {
+        logger_.Warning("Source is %u Hz, I2S TX runs at %u Hz", (unsigned)source.GetSampleRate(), (unsigned)sample_rate);
+    }
+
+    for (auto &block : blocks_) {
+        block = new (std::nothrow) int16_t[config.block_frames * config.channels];
+        if (block == nullptr) {
+            logger_.Error("Failed to allocate playback blocks");
+            Release();
+            return false;
+        }
+    }
+
+    codec_ = &codec;
+    source_ = &source;
+    config_ = config;
+    block_frames_[0] = 0;
+    block_frames_[1] = 0;
+    blocks_written_ = 0;
+    frames_written_ = 0;
+    underruns_ = 0;
+    source_stalls_ = 0;
+    write_errors_ = 0;
+    last_decode_us_ = 0;
+    max_decode_us_ = 0;
+    should_stop_ = false;
+    source_done_ = false;
+    writing_ = true;
+    decoding_ = true;
+
+    // The writer first: the decoder notifies it as soon as the first block is ready
+    BaseType_t ret = xTaskCreatePinnedToCore(
+        WriteTaskWrapper, config_.name, config_.stack_size, this, config_.priority, &write_task_, config_.core_id);
+    if (ret != pdPASS) {
+        logger_.Error("Failed to create playback task");
+        writing_ = false;
+        decoding_ = false;
+        write_task_ = nullptr;
+        Release();
+        return false;
+    }
+    ret = xTaskCreatePinnedToCore(DecodeTaskWrapper, config_.decode_name, config_.decode_stack_size, this,
+                                  config_.decode_priority, &decode_task_, config_.core_id);
+    if (ret != pdPASS) {
+        logger_.Error("Failed to create decode task");
+        decode_task_ = nullptr;
+        decoding_ = false;
+        Stop();
+        return false;
+    }
+    logger_.Info("Playing %u Hz x %u channels in %u frame blocks", (unsigned)source.GetSampleRate(),
+                 (unsigned)source_channels, (unsigned)config_.block_frames);
+    return true;
+}
+
+void AudioPlayer::Stop()
+{
+    if (write_task_ == nullptr && decode_task_ == nullptr) return;
+    should_stop_ = true;
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    if (self != write_task_ && self != decode_task_) {
+        // Each loop wakes at least every 10 ms, the writer after one blocking write
+        const int max_retries = 100;
+        for (int i = 0; i < max_retries && IsPlaying(); ++i) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+    if (IsPlaying()) {
+        logger_.Error("Playback tasks did not stop, keeping their blocks alive");
+        return;
+    }
+    write_task_ = nullptr;
+    decode_task_ = nullptr;
+    Release();
+}
+
+void AudioPlayer::GetStats(AudioPlayerStats &stats) const
+{
+    stats.blocks = blocks_written_.load(std::memory_order_relaxed);
+    stats.frames = frames_written_.load(std::memory_order_relaxed);
+    stats.underruns = underruns_.load(std::memory_order_relaxed);
+    stats.source_stalls = source_stalls_.load(std::memory_order_relaxed);
+    stats.write_errors = write_errors_.load(std::memory_order_relaxed);
+    stats.last_decode_us = last_decode_us_.load(std::memory_order_relaxed);
+    stats.max_decode_us = max_decode_us_.load(std::memory_order_relaxed);
+}
+
+void AudioPlayer::WriteTaskWrapper(void *param)
+{
+    auto *self = static_cast<AudioPlayer *>(param);
+    self->WriteLoop();
+    vTaskDelete(nullptr);
+}
+
+void AudioPlayer::DecodeTaskWrapper(void *param)
+{
+    auto *self = static_cast<AudioPlayer *>(param);
+    self->DecodeLoop();
+    // The writer may still notify this task, so it deletes it rather than the task itself
+    for (;;) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+size_t AudioPlayer::DecodeBlock(int16_t *block)
+{
+    const size_t source_channels = source_->GetChannels();
+    uint32_t decode_us = 0;
+    size_t frames = 0;
+
+    while (frames < config_.block_frames && !should_stop_) {
+        int64_t start = esp_timer_get_time();
+        size_t read = source_->ReadFrames(block + frames * source_channels, config_.block_frames - frames);
+        decode_us += (uint32_t)(esp_timer_get_time() - start);
+        frames += read;
+        if (read > 0) continue;
+        if (source_->AtEnd()) break;
+        // Late input: hand over what we have rather than let the writer starve
+        source_stalls_.fetch_add(1, std::memory_order_relaxed);
+        if (frames > 0) break;
+        vTaskDelay(1);
+    }
+
+    if (source_channels == 1 && config_.channels == 2) PcmMonoToStereo(block, block, frames);
+    last_decode_us_.store(decode_us, std::memory_order_relaxed);
+    if (decode_us > max_decode_us_.load(std::memory_order_relaxed)) max_decode_us_.store(decode_us, std::memory_order_relaxed);
+    return frames;
+}
+
+void AudioPlayer::DecodeLoop()
+{
+    size_t index = 0;
+    while (!should_stop_) {
+        if (block_frames_[index].load(std::memory_order_acquire) != 0) {
+            // Both blocks are full, wait for the writer to hand one back
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+            continue;
+        }
+        size_t frames = DecodeBlock(blocks_[index]);
+        if (frames > 0) {
+            block_frames_[index].store(frames, std::memory_order_release);
+            xTaskNotifyGive(write_task_);
+            index ^= 1;
+        }
+        if (source_->AtEnd()) break;
+    }
+    source_done_.store(true, std::memory_order_release);
+    xTaskNotifyGive(write_task_);
+    decoding_ = false;
+}
+
+void AudioPlayer::WriteLoop()
+{
+    const size_t frame_bytes = config_.channels * sizeof(int16_t);
+    size_t index = 0;
+    bool waiting = false;
+
+    while (!should_stop_) {
+        // source_done_ before the count: the decoder publishes its last block before setting it
+        bool done = source_done_.load(std::memory_order_acquire);
+        size_t frames = block_frames_[index].load(std::memory_order_acquire);
+        if (frames == 0) {
+            if (done) break;
+            if (!waiting && blocks_written_.load(std::memory_order_relaxed) > 0) {
+                underruns_.fetch_add(1, std::memory_order_relaxed);
+            }
+            waiting = true;
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+            continue;
+        }
+        waiting = false;
+
+        if (!codec_->Write(blocks_[index], frames * frame_bytes)) write_errors_.fetch_add(1, std::memory_order_relaxed);
+        blocks_written_.fetch_add(1, std::memory_order_relaxed);
+        frames_written_.fetch_add(frames, std::memory_order_relaxed);
+
+        block_frames_[index].store(0, std::memory_order_release);
+        xTaskNotifyGive(decode_task_);
+        index ^= 1;
+    }
+
+    // The decoder notifies this task until it is done, and is parked from then on
+    while (decoding_) vTaskDelay(1);
+    if (decode_task_ != nullptr) vTaskDelete(decode_task_);
+    writing_ = false;
+}
+
+} // namespace wrapper
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "wrapper/logger.hpp"
+#include "wrapper/audio.hpp"
+#include "dsp/audio-reader.hpp"
+#include "dsp/pcm.hpp"
+
+namespace wrapper
+{
+
+struct AudioPlayerConfig
+{
+    const char *name = "AudioPlayer";
+    uint32_t stack_size = 4096;
+    UBaseType_t priority = 10;       // writer, blocks in AudioCodec::Write
+    BaseType_t core_id = tskNO_AFFINITY;
+    const char *decode_name = "AudioDecode";
+    uint32_t decode_stack_size = 4096;
+    UBaseType_t decode_priority = 9; // below the writer so a slow decode never delays a write
+    size_t channels = 2;             // as opened by SpeakerCodec/AudioCodec
+    size_t block_frames = 512;
+};
+
+struct AudioPlayerStats
+{
+    uint32_t blocks = 0;          // written to the codec
+    uint32_t frames = 0;
+    uint32_t underruns = 0;       // writer found no decoded block
+    uint32_t source_stalls = 0;   // source had no data yet (e.g. a ring not refilled in time)
+    uint32_t write_errors = 0;
+    uint32_t last_decode_us = 0;  // one block
+    uint32_t max_decode_us = 0;
+};
+
+/**
+ * @brief Streams a PcmSource (e.g. a WavDecoder) to AudioCodec::Write
+ *
+ * Two PCM blocks are allocated in Play and swapped between a decode task and
+ * a writer task, so the next block is decoded while the current one is being
+ * written. Mono sources are duplicated to the codec's stereo frame. Playback
+ * stops by itself when the source ends; the source must outlive it. The writer
+ * outlives the decoder and deletes it, so neither notifies a deleted task.
+ */
+class AudioPlayer
+{
+    Logger &logger_;
+    AudioCodec *codec_ = nullptr;
+    PcmSource *source_ = nullptr;
+    AudioPlayerConfig config_;
+    int16_t *blocks_[2] = {nullptr, nullptr};
+    std::atomic<size_t> block_frames_[2];  // decoded frames per block, 0 = free for the decoder
+    TaskHandle_t write_task_ = nullptr;
+    TaskHandle_t decode_task_ = nullptr;
+    std::atomic<bool> should_stop_{false};
+    std::atomic<bool> source_done_{false};
+    std::atomic<bool> writing_{false};
+    std::atomic<bool> decoding_{false};
+
+    std::atomic<uint32_t> blocks_written_{0};
+    std::atomic<uint32_t> frames_written_{0};
+    std::atomic<uint32_t> underruns_{0};
+    std::atomic<uint32_t> source_stalls_{0};
+    std::atomic<uint32_t> write_errors_{0};
+    std::atomic<uint32_t> last_decode_us_{0};
+    std::atomic<uint32_t> max_decode_us_{0};
+
+    static void WriteTaskWrapper(void *param);
+    static void DecodeTaskWrapper(void *param);
+    void WriteLoop();
+    void DecodeLoop();
+    size_t DecodeBlock(int16_t *block);
+    void Release();
+
+public:
+    AudioPlayer(Logger &logger) : logger_(logger) {}
+    ~AudioPlayer();
+
+    AudioPlayer(const AudioPlayer &) = delete;
+    AudioPlayer &operator=(const AudioPlayer &) = delete;
+
+    Logger &GetLogger() const { return logger_; }
+
+    bool Play(AudioCodec &codec, PcmSource &source, const AudioPlayerConfig &config = AudioPlayerConfig());
+    void Stop();
+    bool IsPlaying() const { return writing_ || decoding_; }
+
+    void GetStats(AudioPlayerStats &stats) const;
+};
+
+} // namespace wrapper
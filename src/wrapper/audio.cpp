@@ -1,8 +1,13 @@
-#include <cmath>
+#include <cstring>
+#include <esp_timer.h>
 #include "wrapper/audio.hpp"
+#include "dsp/signal-generator.hpp"
 
 namespace wrapper {
 
+static constexpr uint8_t CODEC_CHANNELS = AudioCodec::CHANNELS;
+static constexpr size_t CODEC_FRAME_BYTES = CODEC_CHANNELS * sizeof(int16_t);
+
 // Speaker Implementation
 Speaker::Speaker(Logger& logger) : logger_(logger) {}
 Speaker::~Speaker() {}
@@ -10,6 +15,7 @@ Speaker::~Speaker() {}
 bool Speaker::Init(I2sBus& i2s_bus) {
     i2s_bus_ = &i2s_bus;
     volume_ = 1.0f;
+    gain_q15_ = PCM_Q15_UNITY;
     mute_ = false;
     return true;
 }
@@ -20,8 +26,9 @@ bool Speaker::Deinit() {
 
 bool Speaker::SetSoftVolume(float volume) {
     if (volume < 0.0f) volume = 0.0f;
-    // if (volume > 1.0f) volume = 1.0f; // Allow gain > 1.0?
+    // Gain > 1.0 is allowed up to the Q15 ceiling, the output saturates
     volume_ = volume;
+    gain_q15_ = PcmGainToQ15(volume);
     return true;
 }
 
@@ -67,36 +74,55 @@ bool Speaker::IsEnabled(bool &enable) {
     return true;
 }
 
+bool Speaker::WriteChunk(const void *data, size_t size) {
+    size_t written = 0;
+    if (!i2s_bus_->Write(data, size, written)) return false;
+    if (written != size) {
+        logger_.Warning("Short write: %u/%u bytes", (unsigned)written, (unsigned)size);
+        return false;
+    }
+    return true;
+}
+
 bool Speaker::Write(const void *data, size_t size) {
     if (i2s_bus_ == nullptr) return false;
-    
-    // Software Volume / Mute Processing
-    if (mute_ || volume_ == 0.0f) {
-        // Write zeros
-        std::vector<uint8_t> zeros(size, 0);
-        size_t written = 0;
-        return i2s_bus_->Write(zeros.data(), size, written);
-    }
-
-    if (volume_ != 1.0f) {
-        // Assume 16-bit PCM
-        // We need to copy data to modify it
-        // This is expensive for large buffers.
-        // If data is const, we must copy.
-        // TODO: Optimize buffer management.
-        std::vector<int16_t> buffer;
-        buffer.resize(size / 2);
-        memcpy(buffer.data(), data, size);
-        
-        for (auto& sample : buffer) {
-            sample = (int16_t)(sample * volume_);
+    // 16-bit PCM only
+    if (size % sizeof(int16_t) != 0) {
+        logger_.Error("Write size %u is not a multiple of 16-bit samples", (unsigned)size);
+        return false;
+    }
+
+    if (!mute_ && gain_q15_ == PCM_Q15_UNITY && playback_processors_.Empty()) {
+        return WriteChunk(data, size);
+    }
+
+    const uint8_t *src = static_cast<const uint8_t *>(data);
+    size_t remaining = size / sizeof(int16_t);
+
+    if (mute_ || gain_q15_ == 0) {
+        PcmMute(scratch_, SCRATCH_SAMPLES);
+        while (remaining > 0) {
+            size_t count = remaining < SCRATCH_SAMPLES ? remaining : SCRATCH_SAMPLES;
+            if (!WriteChunk(scratch_, count * sizeof(int16_t))) return false;
+            remaining -= count;
         }
-        size_t written = 0;
-        return i2s_bus_->Write(buffer.data(), size, written);
+        return true;
     }
 
-    size_t written = 0;
-    return i2s_bus_->Write(data, size, written);
+    // Copy through the scratch buffer: the caller's data is const and may be unaligned.
+    // Chunks hold whole frames so processors see complete interleaved frames
+    size_t channels = i2s_bus_->GetTxSlotCount() > 0 ? i2s_bus_->GetTxSlotCount() : 1;
+    size_t chunk = SCRATCH_SAMPLES - SCRATCH_SAMPLES % channels;
+    while (remaining > 0) {
+        size_t count = remaining < chunk ? remaining : chunk;
+        memcpy(scratch_, src, count * sizeof(int16_t));
+        if (gain_q15_ != PCM_Q15_UNITY) PcmApplyGain(scratch_, scratch_, count, gain_q15_);
+        RunAudioProcessors(playback_processors_, scratch_, count / channels, channels);
+        if (!WriteChunk(scratch_, count * sizeof(int16_t))) return false;
+        src += count * sizeof(int16_t);
+        remaining -= count;
+    }
+    return true;
 }
 
 // Microphone Implementation
@@ -106,6 +132,7 @@ Microphone::~Microphone() {}
 bool Microphone::Init(I2sBus& i2s_bus) {
     i2s_bus_ = &i2s_bus;
     volume_ = 1.0f;
+    gain_q15_ = PCM_Q15_UNITY;
     mute_ = false;
     return true;
 }
@@ -117,6 +144,7 @@ bool Microphone::Deinit() {
 bool Microphone::SetSoftVolume(float volume) {
     if (volume < 0.0f) volume = 0.0f;
     volume_ = volume;
+    gain_q15_ = PcmGainToQ15(volume);
     return true;
 }
 
@@ -146,19 +174,20 @@ bool Microphone::Read(void *data, size_t size) {
     size_t read = 0;
     bool ret = i2s_bus_->Read(data, size, read);
     
-    if (ret && (mute_ || volume_ != 1.0f)) {
-         // Apply software processing
-         // Assuming 16-bit
-         int16_t* buffer = (int16_t*)data;
-         size_t num_samples = read / 2;
-         
-         if (mute_ || volume_ == 0.0f) {
-             memset(data, 0, read);
-         } else {
-             for (size_t i = 0; i < num_samples; ++i) {
-                 buffer[i] = (int16_t)(buffer[i] * volume_);
-             }
-         }
+    if (ret && (mute_ || gain_q15_ != PCM_Q15_UNITY)) {
+        // Assuming 16-bit samples in a sample-aligned caller buffer
+        int16_t* buffer = static_cast<int16_t*>(data);
+        size_t num_samples = read / sizeof(int16_t);
+
+        if (mute_) {
+            PcmMute(buffer, num_samples);
+        } else {
+            PcmApplyGain(buffer, buffer, num_samples, gain_q15_);
+        }
+    }
+    if (ret && !capture_processors_.Empty()) {
+        size_t channels = i2s_bus_->GetRxSlotCount() > 0 ? i2s_bus_->GetRxSlotCount() : 1;
+        RunAudioProcessors(capture_processors_, static_cast<int16_t*>(data), read / (channels * sizeof(int16_t)), channels);
     }
     return ret;
 }
@@ -227,7 +256,7 @@ bool SpeakerCodec::Enable() {
     if (!i2s_bus_) return false;
     esp_codec_dev_sample_info_t fs = {
         .bits_per_sample = 16,
-        .channel = 2,
+        .channel = CODEC_CHANNELS,
         .channel_mask = 0,
         .sample_rate = i2s_bus_->GetTxSampleRate(),
         .mclk_multiple = 0,
@@ -250,8 +279,23 @@ bool SpeakerCodec::IsEnabled(bool &enable) {
     enable = spk_enabled_;
     return true;
 }
+bool SpeakerCodec::WriteChunk(const void *data, size_t size) {
+    if (esp_codec_dev_write(spk_codec_dev_handle_, (void*)data, size) != ESP_OK) return false;
+    RunAudioMonitors(playback_monitors_, static_cast<const int16_t*>(data), size / CODEC_FRAME_BYTES, CODEC_CHANNELS);
+    return true;
+}
 bool SpeakerCodec::Write(const void *data, size_t size) {
-    return esp_codec_dev_write(spk_codec_dev_handle_, (void*)data, size) == ESP_OK;
+    if (playback_processors_.Empty()) return WriteChunk(data, size);
+    const uint8_t *src = static_cast<const uint8_t *>(data);
+    while (size > 0) {
+        size_t chunk = size < sizeof(scratch_) ? size : sizeof(scratch_);
+        memcpy(scratch_, src, chunk);
+        RunAudioProcessors(playback_processors_, scratch_, chunk / CODEC_FRAME_BYTES, CODEC_CHANNELS);
+        if (!WriteChunk(scratch_, chunk)) return false;
+        src += chunk;
+        size -= chunk;
+    }
+    return true;
 }
 
 // MicrophoneCodec Implementation
@@ -315,7 +359,7 @@ bool MicrophoneCodec::Enable() {
     if (!i2s_bus_) return false;
     esp_codec_dev_sample_info_t fs = {
         .bits_per_sample = 16,
-        .channel = 2,
+        .channel = CODEC_CHANNELS,
         .channel_mask = 0,
         .sample_rate = i2s_bus_->GetRxSampleRate(),
         .mclk_multiple = 0,
@@ -339,7 +383,9 @@ bool MicrophoneCodec::IsEnabled(bool &enable) {
     return true;
 }
 bool MicrophoneCodec::Read(void *data, size_t size) {
-    return esp_codec_dev_read(mic_codec_dev_handle_, data, size) == ESP_OK;
+    if (esp_codec_dev_read(mic_codec_dev_handle_, data, size) != ESP_OK) return false;
+    RunAudioProcessors(capture_processors_, static_cast<int16_t*>(data), size / CODEC_FRAME_BYTES, CODEC_CHANNELS);
+    return true;
 }
 
 AudioCodec::AudioCodec(Logger& logger) : logger_(logger)
@@ -507,44 +553,29 @@ bool AudioCodec::TestSpeaker()
 
     logger_.Info("Starting speaker test: 1kHz sine wave");
 
-    // Generate 1 second of 1kHz sine wave at 48kHz sample rate, 16-bit, stereo
     const int sample_rate = i2s_bus_->GetTxSampleRate();
     if (sample_rate == 0) {
         logger_.Error("I2S TX sample rate is 0");
         return false;
     }
 
-    const int duration_sec = 1;
-    const int frequency = 1000;
-    const int amplitude = 10000;
-    const int num_samples = sample_rate * duration_sec;
-    const int num_channels = 2;
-    
-    // Allocate buffer for 1 second of audio
-    // 16-bit (2 bytes) * 2 channels * num_samples
-    size_t buffer_size = num_samples * num_channels * sizeof(int16_t);
-    int16_t* buffer = (int16_t*)malloc(buffer_size);
-    if (buffer == nullptr) {
-        logger_.Error("Failed to allocate memory for speaker test");
-        return false;
-    }
+    // 1 s of 1 kHz at ~-10 dBFS, rendered in small blocks so nothing is allocated
+    SineGenerator sine;
+    sine.Init(sample_rate, 1000, 10000 / 32768.0f);
+    sine.SetChannels(CODEC_CHANNELS);
+    sine.SetDuration(1000);
 
-    // Generate sine wave
-    for (int i = 0; i < num_samples; ++i) {
-        int16_t sample = (int16_t)(amplitude * sin(2 * M_PI * frequency * i / sample_rate));
-        buffer[i * 2] = sample;     // Left channel
-        buffer[i * 2 + 1] = sample; // Right channel
+    int16_t block[128 * CODEC_CHANNELS];
+    esp_err_t ret = ESP_OK;
+    while (!sine.AtEnd() && ret == ESP_OK) {
+        size_t frames = sine.ReadFrames(block, 128);
+        ret = esp_codec_dev_write(spk_codec_dev_handle_, block, frames * CODEC_FRAME_BYTES);
     }
-
-    // Write to codec
-    esp_err_t ret = esp_codec_dev_write(spk_codec_dev_handle_, buffer, buffer_size);
     if (ret != ESP_OK) {
         logger_.Error("Failed to write to speaker codec: %s", esp_err_to_name(ret));
     } else {
         logger_.Info("Speaker test completed");
     }
-
-    free(buffer);
     return (ret == ESP_OK);
 }
 
@@ -622,7 +653,7 @@ bool AudioCodec::EnableSpeaker(bool enable)
         }
         esp_codec_dev_sample_info_t fs = {
             .bits_per_sample = 16,
-            .channel = 2,
+            .channel = CODEC_CHANNELS,
             .channel_mask = 0,
             .sample_rate = i2s_bus_->GetTxSampleRate(),
             .mclk_multiple = 0,
@@ -661,7 +692,7 @@ bool AudioCodec::EnableMicrophone(bool enable)
         }
         esp_codec_dev_sample_info_t fs = {
             .bits_per_sample = 16,
-            .channel = 2,
+            .channel = CODEC_CHANNELS,
             .channel_mask = 0,
             .sample_rate = i2s_bus_->GetRxSampleRate(),
             .mclk_multiple = 0,
@@ -686,13 +717,31 @@ bool AudioCodec::IsMicrophoneEnabled(bool &enable)
     return true;
 }
 
-bool AudioCodec::Write(const void *data, size_t size)
+bool AudioCodec::WriteChunk(const void *data, size_t size)
 {
+    int64_t enqueue_us = clock_ != nullptr ? esp_timer_get_time() : 0;
     esp_err_t ret = esp_codec_dev_write(spk_codec_dev_handle_, (void*)data, size);
     if (ret != ESP_OK) {
         logger_.Error("Failed to write audio data: %s", esp_err_to_name(ret));
         return false;
     }
+    if (clock_ != nullptr) clock_->OnWrite((uint32_t)(size / CODEC_FRAME_BYTES), enqueue_us);
+    RunAudioMonitors(playback_monitors_, static_cast<const int16_t*>(data), size / CODEC_FRAME_BYTES, CODEC_CHANNELS);
+    return true;
+}
+
+bool AudioCodec::Write(const void *data, size_t size)
+{
+    if (playback_processors_.Empty()) return WriteChunk(data, size);
+    const uint8_t *src = static_cast<const uint8_t *>(data);
+    while (size > 0) {
+        size_t chunk = size < sizeof(scratch_) ? size : sizeof(scratch_);
+        memcpy(scratch_, src, chunk);
+        RunAudioProcessors(playback_processors_, scratch_, chunk / CODEC_FRAME_BYTES, CODEC_CHANNELS);
+        if (!WriteChunk(scratch_, chunk)) return false;
+        src += chunk;
+        size -= chunk;
+    }
     return true;
 }
 
@@ -703,6 +752,7 @@ bool AudioCodec::Read(void *data, size_t size)
         logger_.Error("Failed to read audio data: %s", esp_err_to_name(ret));
         return false;
     }
+    RunAudioProcessors(capture_processors_, static_cast<int16_t*>(data), size / CODEC_FRAME_BYTES, CODEC_CHANNELS);
     return true;
 }
 
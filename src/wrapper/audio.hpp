@@ -6,16 +6,27 @@
 #include "wrapper/logger.hpp"
 #include "wrapper/i2c.hpp"
 #include "wrapper/i2s.hpp"
+#include "dsp/pcm.hpp"
+#include "dsp/audio-processor.hpp"
+#include "wrapper/audio-clock.hpp"
 
 namespace wrapper
 {
   class Speaker // no codec
   {
+      // persistent scratch for gain/mute so Write never touches the heap
+      static constexpr size_t SCRATCH_SAMPLES = 256;
+
       Logger &logger_;
       I2sBus *i2s_bus_ = nullptr; 
 
       float volume_ = 0.0f;
+      int32_t gain_q15_ = PCM_Q15_UNITY;
       bool mute_ = false;
+      int16_t scratch_[SCRATCH_SAMPLES];
+      AudioProcessorList playback_processors_;
+
+      bool WriteChunk(const void *data, size_t size);
 
     public:
       Speaker(Logger &logger);
@@ -39,6 +50,11 @@ namespace wrapper
 
       bool Write(const void *data, size_t size);
 
+      // Runs on a copy of every block written (after the soft volume), frames follow the TX slot layout
+      // (e.g. OutputStage). Attach while idle
+      bool AddPlaybackProcessor(AudioProcessor *processor) { return playback_processors_.Add(processor); }
+      bool RemovePlaybackProcessor(AudioProcessor *processor) { return playback_processors_.Remove(processor); }
+
       template<typename T>
       bool Write(const std::vector<T>& data)
       {
@@ -52,7 +68,9 @@ namespace wrapper
       I2sBus *i2s_bus_ = nullptr;
 
       float volume_ = 0.0f;
+      int32_t gain_q15_ = PCM_Q15_UNITY;
       bool mute_ = false;
+      AudioProcessorList capture_processors_;
 
   public:
       Microphone(Logger &logger);
@@ -76,6 +94,10 @@ namespace wrapper
 
       bool Read(void *data, size_t size);
 
+      // Runs in place on every block read (after gain), frames follow the RX slot layout. Attach while idle
+      bool AddCaptureProcessor(AudioProcessor *processor) { return capture_processors_.Add(processor); }
+      bool RemoveCaptureProcessor(AudioProcessor *processor) { return capture_processors_.Remove(processor); }
+
       template<typename T>
       bool Read(std::vector<T>& data, size_t count)
       {
@@ -86,6 +108,9 @@ namespace wrapper
 
   class SpeakerCodec
   {
+    // playback processors run on a copy of the caller's block, in chunks of this size
+    static constexpr size_t SCRATCH_SAMPLES = 256;
+
     Logger &logger_;
     I2sBus *i2s_bus_ = nullptr;
     const audio_codec_data_if_t *i2s_data_if_ = nullptr;
@@ -95,6 +120,11 @@ namespace wrapper
     const audio_codec_if_t *spk_codec_if_ = nullptr;
     esp_codec_dev_handle_t spk_codec_dev_handle_ = nullptr;
     bool spk_enabled_ = false;
+    AudioProcessorList playback_processors_;
+    AudioMonitorList playback_monitors_;
+    int16_t scratch_[SCRATCH_SAMPLES];
+
+    bool WriteChunk(const void *data, size_t size);
 
   public:
     SpeakerCodec(Logger &logger);
@@ -127,6 +157,13 @@ namespace wrapper
 
     bool Write(const void *data, size_t size);
 
+    // Processors run on a copy of every block written (e.g. OutputStage), monitors then see the
+    // result, e.g. as echo canceller reference. Attach while idle
+    bool AddPlaybackProcessor(AudioProcessor *processor) { return playback_processors_.Add(processor); }
+    bool RemovePlaybackProcessor(AudioProcessor *processor) { return playback_processors_.Remove(processor); }
+    bool AddPlaybackMonitor(AudioMonitor *monitor) { return playback_monitors_.Add(monitor); }
+    bool RemovePlaybackMonitor(AudioMonitor *monitor) { return playback_monitors_.Remove(monitor); }
+
     template<typename T>
     bool Write(std::vector<T>& data)
     {
@@ -145,6 +182,7 @@ namespace wrapper
     const audio_codec_if_t *mic_codec_if_ = nullptr;
     esp_codec_dev_handle_t mic_codec_dev_handle_ = nullptr;
     bool mic_enabled_ = false;
+    AudioProcessorList capture_processors_;
 
   public:
     MicrophoneCodec(Logger &logger);
@@ -177,6 +215,10 @@ namespace wrapper
 
     bool Read(void *data, size_t size);
 
+    // Runs in place on every block read, in the order added. Attach while idle
+    bool AddCaptureProcessor(AudioProcessor *processor) { return capture_processors_.Add(processor); }
+    bool RemoveCaptureProcessor(AudioProcessor *processor) { return capture_processors_.Remove(processor); }
+
     template<typename T>
     bool Read(std::vector<T>& data, size_t count)
     {
@@ -187,6 +229,9 @@ namespace wrapper
 
   class AudioCodec
   {
+    // playback processors run on a copy of the caller's block, in chunks of this size
+    static constexpr size_t SCRATCH_SAMPLES = 256;
+
     //common
     Logger &logger_;
     I2sBus *i2s_bus_ = nullptr;
@@ -202,8 +247,19 @@ namespace wrapper
     const audio_codec_if_t *mic_audio_codec_if_ = nullptr;
     esp_codec_dev_handle_t mic_codec_dev_handle_ = nullptr;  
     bool mic_enabled_ = false;
+    //processing
+    AudioProcessorList capture_processors_;
+    AudioProcessorList playback_processors_;
+    AudioMonitorList playback_monitors_;
+    AudioClock *clock_ = nullptr;
+    int16_t scratch_[SCRATCH_SAMPLES];
+
+    bool WriteChunk(const void *data, size_t size);
 
   public:
+    // Every codec device is opened as interleaved 16 bit stereo
+    static constexpr size_t CHANNELS = 2;
+
     AudioCodec(Logger &logger);
     ~AudioCodec();
 
@@ -247,6 +303,21 @@ namespace wrapper
     bool Write(const void *data, size_t size);
     bool Read(void *data, size_t size);
 
+    // Capture processors run in place on every block read; playback processors
+    // run on a copy of every block written (e.g. OutputStage) and playback
+    // monitors see the result (e.g. Aec is a capture processor and a monitor).
+    // Attach while idle
+    bool AddCaptureProcessor(AudioProcessor *processor) { return capture_processors_.Add(processor); }
+    bool RemoveCaptureProcessor(AudioProcessor *processor) { return capture_processors_.Remove(processor); }
+    bool AddPlaybackProcessor(AudioProcessor *processor) { return playback_processors_.Add(processor); }
+    bool RemovePlaybackProcessor(AudioProcessor *processor) { return playback_processors_.Remove(processor); }
+    bool AddPlaybackMonitor(AudioMonitor *monitor) { return playback_monitors_.Add(monitor); }
+    bool RemovePlaybackMonitor(AudioMonitor *monitor) { return playback_monitors_.Remove(monitor); }
+
+    // Every successful Write is reported to the clock, nullptr detaches
+    void SetAudioClock(AudioClock *clock) { clock_ = clock; }
+    AudioClock *GetAudioClock() const { return clock_; }
+
     template<typename T>
     bool Write(const std::vector<T>& data)
     {
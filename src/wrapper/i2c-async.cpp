@@ -0,0 +1,419 @@
+#include <new>
+#include <esp_timer.h>
+#include "wrapper/i2c-async.hpp"
+
+namespace wrapper
+{
+
+// --- I2cTransaction ---
+
+void I2cTransaction::Write(I2cDevice &dev, const uint8_t *data, size_t length)
+{
+    device = &dev;
+    write_data = data;
+    write_length = length;
+    read_data = nullptr;
+    read_length = 0;
+}
+
+void I2cTransaction::Read(I2cDevice &dev, uint8_t *data, size_t length)
+{
+    device = &dev;
+    write_data = nullptr;
+    write_length = 0;
+    read_data = data;
+    read_length = length;
+}
+
+void I2cTransaction::WriteRead(I2cDevice &dev, const uint8_t *write, size_t write_len, uint8_t *read, size_t read_len)
+{
+    device = &dev;
+    write_data = write;
+    write_length = write_len;
+    read_data = read;
+    read_length = read_len;
+}
+
+void I2cTransaction::ReadReg(I2cDevice &dev, uint8_t reg_addr, uint8_t *data, size_t length)
+{
+    inline_data[0] = reg_addr;
+    WriteRead(dev, nullptr, 1, data, length);
+}
+
+void I2cTransaction::WriteReg8(I2cDevice &dev, uint8_t reg_addr, uint8_t value)
+{
+    inline_data[0] = reg_addr;
+    inline_data[1] = value;
+    Write(dev, nullptr, 2);
+}
+
+// --- I2cAsync ---
+
+I2cAsync::~I2cAsync()
+{
+    Stop();
+}
+
+void I2cAsync::Release()
+{
+    delete[] pending_;
+    pending_ = nullptr;
+    pending_count_ = 0;
+    if (slots_ != nullptr) vSemaphoreDelete(slots_);
+    slots_ = nullptr;
+    if (lock_ != nullptr) vSemaphoreDelete(lock_);
+    lock_ = nullptr;
+}
+
+bool I2cAsync::SetDeviceClass(const I2cDevice &device, I2cPriority priority, uint32_t deadline_us)
+{
+    if (task_ != nullptr) {
+        logger_.Error("Set device classes before Start");
+        return false;
+    }
+    if (priority == I2cPriority::FromDevice) {
+        logger_.Error("A device needs a concrete class");
+        return false;
+    }
+    for (auto &entry : device_classes_) {
+        if (entry.device == nullptr || entry.device == &device) {
+            entry.device = &device;
+            entry.class_index = static_cast<uint8_t>(priority);
+            entry.deadline_us = deadline_us;
+            return true;
+        }
+    }
+    logger_.Error("No room for more than %u device classes", (unsigned)MAX_DEVICE_CLASSES);
+    return false;
+}
+
+bool I2cAsync::Start(const I2cAsyncConfig &config)
+{
+    if (task_ != nullptr) {
+        logger_.Warning("Already running");
+        return false;
+    }
+    if (config.queue_depth == 0) {
+        logger_.Error("Queue depth must be at least 1");
+        return false;
+    }
+    config_ = config;
+    pending_ = new (std::nothrow) I2cTransaction *[config_.queue_depth];
+    lock_ = xSemaphoreCreateMutex();
+    slots_ = xSemaphoreCreateCounting(config_.queue_depth, config_.queue_depth);
+    if (pending_ == nullptr || lock_ == nullptr || slots_ == nullptr) {
+        logger_.Error("Failed to allocate queue");
+        Release();
+        return false;
+    }
+    pending_count_ = 0;
+    seq_ = 0;
+    for (auto &seq : served_seq_) seq = 0;
+    should_stop_ = false;
+    running_ = true;
+    BaseType_t ret = xTaskCreatePinnedToCore(TaskWrapper, config_.name, config_.stack_size, this, config_.priority,
+                                             &task_, config_.core_id);
+    if (ret != pdPASS) {
+        logger_.Error("Failed to create worker task");
+        running_ = false;
+        task_ = nullptr;
+        Release();
+        return false;
+    }
+    logger_.Info("Started (queue depth %u)", (unsigned)config_.queue_depth);
+    return true;
+}
+
+void I2cAsync::Stop()
+{
+    if (task_ == nullptr) return;
+    should_stop_ = true;
+    xTaskNotifyGive(task_);
+    // The worker checks should_stop_ at least every 10 ms and after each transfer.
+    // Submitters see should_stop_ under lock_ and back out, the worker's drain frees
+    // the slots any of them are blocked on
+    const int max_retries = 100;
+    for (int i = 0; i < max_retries && (running_ || submitters_ > 0); ++i) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    if (running_ || submitters_ > 0) {
+        logger_.Error("Worker or submitters did not leave, keeping the queue alive");
+        return;
+    }
+    Release();
+    task_ = nullptr;
+    logger_.Info("Stopped");
+}
+
+bool I2cAsync::Submit(I2cTransaction &transaction, int wait_ms)
+{
+    // Registered before should_stop_ is read, so Stop either sees us or we see it
+    submitters_.fetch_add(1);
+    bool ok = Enqueue(transaction, wait_ms);
+    submitters_.fetch_sub(1);
+    return ok;
+}
+
+bool I2cAsync::Enqueue(I2cTransaction &transaction, int wait_ms)
+{
+    if (!running_ || should_stop_) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (!transaction.IsDone()) {
+        logger_.Error("Transaction already in flight");
+        return false;
+    }
+    if (transaction.device == nullptr || transaction.device->GetHandle() == nullptr ||
+        (transaction.write_length == 0 && transaction.read_length == 0) ||
+        (transaction.write_data == nullptr && transaction.write_length > I2cTransaction::INLINE_SIZE)) {
+        logger_.Error("Invalid transaction");
+        return false;
+    }
+
+    TickType_t ticks = wait_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(wait_ms);
+    if (xSemaphoreTake(slots_, ticks) != pdTRUE) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Resolve the class once, the scheduler only compares numbers
+    size_t slot = MAX_DEVICE_CLASSES;
+    for (size_t i = 0; i < MAX_DEVICE_CLASSES && device_classes_[i].device != nullptr; ++i) {
+        if (device_classes_[i].device == transaction.device) {
+            slot = i;
+            break;
+        }
+    }
+    uint8_t class_index = static_cast<uint8_t>(I2cPriority::Normal);
+    uint32_t deadline_us = transaction.deadline_us;
+    if (slot < MAX_DEVICE_CLASSES) {
+        class_index = device_classes_[slot].class_index;
+        if (deadline_us == 0) deadline_us = device_classes_[slot].deadline_us;
+    }
+    if (transaction.priority != I2cPriority::FromDevice) class_index = static_cast<uint8_t>(transaction.priority);
+
+    transaction.result = ESP_OK;
+    transaction.queue_us = 0;
+    transaction.transfer_us = 0;
+    // Drop a signal left over from a previous run that nobody waited for
+    xSemaphoreTake(transaction.done_signal, 0);
+    transaction.submit_us = esp_timer_get_time();
+    transaction.deadline_at = deadline_us > 0 ? transaction.submit_us + deadline_us : 0;
+    transaction.class_index = class_index;
+    transaction.device_slot = (uint8_t)slot;
+    transaction.done.store(false, std::memory_order_relaxed);
+
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    // Stop may have begun after the check above; once the worker has drained, nothing may be added
+    if (should_stop_) {
+        xSemaphoreGive(lock_);
+        xSemaphoreGive(slots_);
+        transaction.done.store(true, std::memory_order_relaxed);
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    pending_[pending_count_++] = &transaction;
+    uint32_t depth = pending_count_;
+    // Under lock_: the worker drains under it before exiting, so it is still alive
+    xTaskNotifyGive(task_);
+    xSemaphoreGive(lock_);
+
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    if (depth > max_queue_depth_.load(std::memory_order_relaxed)) {
+        max_queue_depth_.store(depth, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool I2cAsync::Wait(I2cTransaction &transaction, int timeout_ms)
+{
+    if (!transaction.IsDone() && transaction.callback != nullptr) {
+        logger_.Error("Transaction completes through its callback, cannot wait on it");
+        return false;
+    }
+    if (transaction.IsDone()) return transaction.result == ESP_OK;
+    TickType_t ticks = timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    if (timeout_ms > 0 && ticks == 0) ticks = 1;
+    if (xSemaphoreTake(transaction.done_signal, ticks) != pdTRUE) return false;
+    // Given right before done is set, with the worker's scheduler suspended
+    while (!transaction.IsDone()) taskYIELD();
+    return transaction.result == ESP_OK;
+}
+
+void I2cAsync::GetStats(I2cAsyncStats &stats) const
+{
+    stats.submitted = submitted_.load(std::memory_order_relaxed);
+    stats.completed = completed_.load(std::memory_order_relaxed);
+    stats.failed = failed_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    stats.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+    stats.last_queue_us = last_queue_us_.load(std::memory_order_relaxed);
+    stats.max_queue_us = max_queue_us_.load(std::memory_order_relaxed);
+    stats.last_transfer_us = last_transfer_us_.load(std::memory_order_relaxed);
+    stats.max_transfer_us = max_transfer_us_.load(std::memory_order_relaxed);
+    stats.total_queue_us = total_queue_us_.load(std::memory_order_relaxed);
+    stats.total_transfer_us = total_transfer_us_.load(std::memory_order_relaxed);
+    stats.queue_depth = 0;
+    if (lock_ == nullptr) {
+        for (size_t i = 0; i < I2C_PRIORITY_CLASSES; ++i) stats.classes[i] = class_stats_[i];
+        return;
+    }
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    stats.queue_depth = pending_count_;
+    for (size_t i = 0; i < I2C_PRIORITY_CLASSES; ++i) stats.classes[i] = class_stats_[i];
+    xSemaphoreGive(lock_);
+}
+
+void I2cAsync::ResetStats()
+{
+    submitted_ = 0;
+    completed_ = 0;
+    failed_ = 0;
+    rejected_ = 0;
+    max_queue_depth_ = 0;
+    last_queue_us_ = 0;
+    max_queue_us_ = 0;
+    last_transfer_us_ = 0;
+    max_transfer_us_ = 0;
+    total_queue_us_ = 0;
+    total_transfer_us_ = 0;
+    if (lock_ != nullptr) xSemaphoreTake(lock_, portMAX_DELAY);
+    for (auto &entry : class_stats_) entry = I2cClassStats();
+    if (lock_ != nullptr) xSemaphoreGive(lock_);
+}
+
+void I2cAsync::TaskWrapper(void *param)
+{
+    auto *self = static_cast<I2cAsync *>(param);
+    self->WorkerLoop();
+    vTaskDelete(nullptr);
+}
+
+void I2cAsync::WorkerLoop()
+{
+    while (!should_stop_) {
+        bool promoted = false;
+        I2cTransaction *transaction = PickNext(promoted);
+        if (transaction == nullptr) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+            continue;
+        }
+        Execute(*transaction, promoted);
+    }
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    size_t count = pending_count_;
+    pending_count_ = 0;
+    xSemaphoreGive(lock_);
+    for (size_t i = 0; i < count; ++i) {
+        Complete(*pending_[i], ESP_ERR_INVALID_STATE);
+        xSemaphoreGive(slots_);
+    }
+    running_ = false;
+}
+
+I2cTransaction *I2cAsync::PickNext(bool &promoted)
+{
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    if (pending_count_ == 0) {
+        xSemaphoreGive(lock_);
+        return nullptr;
+    }
+
+    // Smallest (tier, order, submit_us) wins; tier 0 is due deadlines, then 1 + aged class
+    const int64_t now = esp_timer_get_time();
+    size_t best = 0;
+    uint32_t best_tier = UINT32_MAX;
+    int64_t best_order = 0;
+    for (size_t i = 0; i < pending_count_; ++i) {
+        const I2cTransaction &candidate = *pending_[i];
+        uint32_t tier;
+        int64_t order;
+        if (candidate.deadline_at != 0 && candidate.deadline_at - now <= (int64_t)config_.deadline_slack_us) {
+            tier = 0;
+            order = candidate.deadline_at;
+        } else {
+            uint32_t aged = config_.aging_us > 0 ? (uint32_t)((now - candidate.submit_us) / config_.aging_us) : 0;
+            tier = 1 + (aged < candidate.class_index ? candidate.class_index - aged : 0);
+            order = served_seq_[candidate.device_slot];
+        }
+        if (tier < best_tier || (tier == best_tier && (order < best_order ||
+            (order == best_order && candidate.submit_us < pending_[best]->submit_us)))) {
+            best = i;
+            best_tier = tier;
+            best_order = order;
+        }
+    }
+
+    I2cTransaction *transaction = pending_[best];
+    pending_[best] = pending_[--pending_count_];
+    served_seq_[transaction->device_slot] = ++seq_;
+    promoted = best_tier != 0 && best_tier < 1u + transaction->class_index;
+    xSemaphoreGive(lock_);
+    xSemaphoreGive(slots_);
+    return transaction;
+}
+
+void I2cAsync::Execute(I2cTransaction &transaction, bool promoted)
+{
+    int64_t start = esp_timer_get_time();
+    transaction.queue_us = (uint32_t)(start - transaction.submit_us);
+    if (promoted) {
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        class_stats_[transaction.class_index].promoted++;
+        xSemaphoreGive(lock_);
+    }
+
+    i2c_master_dev_handle_t handle = transaction.device->GetHandle();
+    const uint8_t *write = transaction.write_data != nullptr ? transaction.write_data : transaction.inline_data;
+    esp_err_t ret;
+    if (handle == nullptr) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else if (transaction.write_length > 0 && transaction.read_length > 0) {
+        ret = i2c_master_transmit_receive(handle, write, transaction.write_length, transaction.read_data,
+                                          transaction.read_length, transaction.timeout_ms);
+    } else if (transaction.write_length > 0) {
+        ret = i2c_master_transmit(handle, write, transaction.write_length, transaction.timeout_ms);
+    } else {
+        ret = i2c_master_receive(handle, transaction.read_data, transaction.read_length, transaction.timeout_ms);
+    }
+    transaction.transfer_us = (uint32_t)(esp_timer_get_time() - start);
+    Complete(transaction, ret);
+}
+
+void I2cAsync::Complete(I2cTransaction &transaction, esp_err_t result)
+{
+    transaction.result = result;
+    completed_.fetch_add(1, std::memory_order_relaxed);
+    if (result != ESP_OK) failed_.fetch_add(1, std::memory_order_relaxed);
+
+    last_queue_us_.store(transaction.queue_us, std::memory_order_relaxed);
+    if (transaction.queue_us > max_queue_us_.load(std::memory_order_relaxed)) {
+        max_queue_us_.store(transaction.queue_us, std::memory_order_relaxed);
+    }
+    last_transfer_us_.store(transaction.transfer_us, std::memory_order_relaxed);
+    if (transaction.transfer_us > max_transfer_us_.load(std::memory_order_relaxed)) {
+        max_transfer_us_.store(transaction.transfer_us, std::memory_order_relaxed);
+    }
+    total_queue_us_.fetch_add(transaction.queue_us, std::memory_order_relaxed);
+    total_transfer_us_.fetch_add(transaction.transfer_us, std::memory_order_relaxed);
+
+    xSemaphoreTake(lock_, portMAX_DELAY);
+    I2cClassStats &class_stats = class_stats_[transaction.class_index];
+    class_stats.completed++;
+    class_stats.last_wait_us = transaction.queue_us;
+    if (transaction.queue_us > class_stats.max_wait_us) class_stats.max_wait_us = transaction.queue_us;
+    class_stats.total_wait_us += transaction.queue_us;
+    if (transaction.deadline_at != 0 && esp_timer_get_time() > transaction.deadline_at) class_stats.deadline_misses++;
+    xSemaphoreGive(lock_);
+
+    if (transaction.callback != nullptr) transaction.callback(transaction, transaction.callback_arg);
+    // The owner may reuse or free the transaction as soon as it sees done, so that is the last touch.
+    // No switch on this core in between, so a waiter woken by the signal spins at most a few instructions
+    vTaskSuspendAll();
+    if (transaction.callback == nullptr) xSemaphoreGive(transaction.done_signal);
+    transaction.done.store(true, std::memory_order_release);
+    xTaskResumeAll();
+}
+
+} // namespace wrapper
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include "wrapper/i2c.hpp"
+#include "wrapper/logger.hpp"
+
+namespace wrapper
+{
+
+struct I2cTransaction;
+
+// Scheduling class of a transaction, lower runs first
+enum class I2cPriority : uint8_t
+{
+    Realtime,   // touch, sensors read every frame
+    High,
+    Normal,
+    Background, // codec setup, bulk register dumps
+    FromDevice, // use the class set with I2cAsync::SetDeviceClass, Normal if none
+};
+
+static constexpr size_t I2C_PRIORITY_CLASSES = 4;
+
+// Runs on the I2cAsync worker task, keep it short. IsDone() turns true after it returns, check result instead
+using I2cCallback = void (*)(I2cTransaction &transaction, void *arg);
+
+/**
+ * @brief One queued transfer, owned by the caller until it is done
+ *
+ * Fill it with one of the helpers, Submit it, then either Wait on it or
+ * handle it in the callback. The buffers must stay valid until then.
+ * Transfers go straight to the bus and bypass the register shadow of the
+ * device. Completion is signalled on a binary semaphore inside the
+ * transaction, so waiting never touches the task notifications other loops
+ * rely on. Once IsDone() is true the worker no longer touches it.
+ */
+struct I2cTransaction
+{
+    static constexpr size_t INLINE_SIZE = 4;
+
+    I2cDevice *device = nullptr;
+    const uint8_t *write_data = nullptr; // nullptr: use inline_data
+    size_t write_length = 0;
+    uint8_t *read_data = nullptr;
+    size_t read_length = 0;
+    int timeout_ms = 100;
+    I2cCallback callback = nullptr;
+    void *callback_arg = nullptr;
+    I2cPriority priority = I2cPriority::FromDevice;
+    uint32_t deadline_us = 0; // from submit, 0 for the device default (none if unset)
+
+    // Results, valid once IsDone()
+    esp_err_t result = ESP_OK;
+    uint32_t queue_us = 0;    // submit to start of transfer
+    uint32_t transfer_us = 0;
+
+    uint8_t inline_data[INLINE_SIZE] = {};
+    std::atomic<bool> done{true};
+    StaticSemaphore_t done_signal_buffer;
+    SemaphoreHandle_t done_signal = nullptr;
+    int64_t submit_us = 0;
+    int64_t deadline_at = 0;
+    uint8_t class_index = 0;
+    uint8_t device_slot = 0;
+
+    I2cTransaction() : done_signal(xSemaphoreCreateBinaryStatic(&done_signal_buffer)) {}
+    ~I2cTransaction() { vSemaphoreDelete(done_signal); }
+    I2cTransaction(const I2cTransaction &) = delete;
+    I2cTransaction &operator=(const I2cTransaction &) = delete;
+
+    bool IsDone() const { return done.load(std::memory_order_acquire); }
+    bool IsOk() const { return IsDone() && result == ESP_OK; }
+
+    void Write(I2cDevice &dev, const uint8_t *data, size_t length);
+    void Read(I2cDevice &dev, uint8_t *data, size_t length);
+    void WriteRead(I2cDevice &dev, const uint8_t *write, size_t write_len, uint8_t *read, size_t read_len);
+    void ReadReg(I2cDevice &dev, uint8_t reg_addr, uint8_t *data, size_t length);
+    void WriteReg8(I2cDevice &dev, uint8_t reg_addr, uint8_t value);
+    void SetCallback(I2cCallback cb, void *arg)
+    {
+        callback = cb;
+        callback_arg = arg;
+    }
+};
+
+struct I2cAsyncConfig
+{
+    const char *name = "I2cAsync";
+    uint32_t stack_size = 3072;
+    UBaseType_t priority = 12;   // above the UI so queued reads keep flowing while it draws
+    BaseType_t core_id = tskNO_AFFINITY;
+    size_t queue_depth = 16;
+    uint32_t aging_us = 20000;         // a waiting transaction moves up one class per period
+    uint32_t deadline_slack_us = 2000; // run a deadline transaction ahead of everything this close to it
+};
+
+struct I2cClassStats
+{
+    uint32_t completed = 0;
+    uint32_t promoted = 0;        // served early by aging, i.e. would have starved
+    uint32_t deadline_misses = 0; // finished after their deadline
+    uint32_t last_wait_us = 0;
+    uint32_t max_wait_us = 0;
+    uint64_t total_wait_us = 0;
+};
+
+struct I2cAsyncStats
+{
+    uint32_t submitted = 0;
+    uint32_t completed = 0;        // including failed
+    uint32_t failed = 0;
+    uint32_t rejected = 0;         // queue full or not running
+    uint32_t queue_depth = 0;      // waiting right now
+    uint32_t max_queue_depth = 0;
+    uint32_t last_queue_us = 0;
+    uint32_t max_queue_us = 0;
+    uint32_t last_transfer_us = 0;
+    uint32_t max_transfer_us = 0;
+    uint64_t total_queue_us = 0;
+    uint64_t total_transfer_us = 0;
+    I2cClassStats classes[I2C_PRIORITY_CLASSES];
+};
+
+/**
+ * @brief Worker task and bounded scheduler that run I2C transfers for one bus
+ *
+ * Submit never blocks on the bus, so a UI task can queue the touch, PMIC and
+ * IO expander reads of a frame and collect them later:
+ *
+ *   I2cTransaction touch, battery;
+ *   touch.ReadReg(ft5x06, 0x02, touch_buf, 5);
+ *   battery.ReadReg(axp2101, 0xA4, &percent, 1);
+ *   async.Submit(touch);
+ *   async.Submit(battery);
+ *   ... draw ...
+ *   if (async.Wait(touch, 20)) { ... }
+ *
+ * Each time the bus is free the worker picks, in order:
+ *  1. the transaction with the earliest deadline, among those within
+ *     deadline_slack_us of it;
+ *  2. the lowest class, where waiting aging_us lifts a transaction one class
+ *     so Background traffic cannot starve;
+ *  3. within a class, the least recently served device, then submit order.
+ *
+ * A transfer is never preempted, so a deadline only holds if the transfers
+ * ahead of it are short. Only traffic submitted here is scheduled; drivers
+ * that talk to i2c_master directly still share the bus unarbitrated.
+ */
+class I2cAsync
+{
+public:
+    static constexpr size_t MAX_DEVICE_CLASSES = 8;
+
+private:
+    struct DeviceClass
+    {
+        const I2cDevice *device = nullptr;
+        uint8_t class_index = 0;
+        uint32_t deadline_us = 0;
+    };
+
+    Logger &logger_;
+    I2cAsyncConfig config_;
+    SemaphoreHandle_t lock_ = nullptr;
+    SemaphoreHandle_t slots_ = nullptr;
+    I2cTransaction **pending_ = nullptr;
+    size_t pending_count_ = 0;
+    TaskHandle_t task_ = nullptr;
+    std::atomic<bool> should_stop_{false};
+    std::atomic<bool> running_{false};
+    std::atomic<uint32_t> submitters_{0}; // inside Submit, Stop waits for them before Release
+
+    // Slot MAX_DEVICE_CLASSES is shared by devices without a class
+    DeviceClass device_classes_[MAX_DEVICE_CLASSES];
+    uint32_t served_seq_[MAX_DEVICE_CLASSES + 1] = {};
+    uint32_t seq_ = 0;
+
+    std::atomic<uint32_t> submitted_{0};
+    std::atomic<uint32_t> completed_{0};
+    std::atomic<uint32_t> failed_{0};
+    std::atomic<uint32_t> rejected_{0};
+    std::atomic<uint32_t> max_queue_depth_{0};
+    std::atomic<uint32_t> last_queue_us_{0};
+    std::atomic<uint32_t> max_queue_us_{0};
+    std::atomic<uint32_t> last_transfer_us_{0};
+    std::atomic<uint32_t> max_transfer_us_{0};
+    std::atomic<uint64_t> total_queue_us_{0};
+    std::atomic<uint64_t> total_transfer_us_{0};
+    I2cClassStats class_stats_[I2C_PRIORITY_CLASSES]; // worker only, copied under lock_
+
+    static void TaskWrapper(void *param);
+    void WorkerLoop();
+    bool Enqueue(I2cTransaction &transaction, int wait_ms);
+    I2cTransaction *PickNext(bool &promoted);
+    void Execute(I2cTransaction &transaction, bool promoted);
+    void Complete(I2cTransaction &transaction, esp_err_t result);
+    void Release();
+
+public:
+    I2cAsync(Logger &logger) : logger_(logger) {}
+    ~I2cAsync();
+
+    I2cAsync(const I2cAsync &) = delete;
+    I2cAsync &operator=(const I2cAsync &) = delete;
+
+    Logger &GetLogger() const { return logger_; }
+
+    bool Start(const I2cAsyncConfig &config = I2cAsyncConfig());
+    // Queued transactions complete with ESP_ERR_INVALID_STATE
+    void Stop();
+    bool IsRunning() const { return running_; }
+
+    // Default class and deadline for transactions of a device, call before Start
+    bool SetDeviceClass(const I2cDevice &device, I2cPriority priority, uint32_t deadline_us = 0);
+
+    // wait_ms bounds the wait for a queue slot, 0 fails at once when full
+    bool Submit(I2cTransaction &transaction, int wait_ms = 0);
+    // Any task, for transactions without a callback; one waiter at a time
+    bool Wait(I2cTransaction &transaction, int timeout_ms);
+
+    void GetStats(I2cAsyncStats &stats) const;
+    void ResetStats();
+};
+
+} // namespace wrapper
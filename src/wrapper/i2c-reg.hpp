@@ -0,0 +1,270 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "wrapper/i2c.hpp"
+
+namespace wrapper
+{
+
+enum class I2cRegAccess : uint8_t
+{
+    ReadWrite,
+    ReadOnly,
+    WriteOnly,
+};
+
+enum class I2cEndian : uint8_t
+{
+    Big,    // most significant byte at the register address
+    Little,
+};
+
+template <size_t WIDTH>
+using I2cRegValue = std::conditional_t<WIDTH == 1, uint8_t, std::conditional_t<WIDTH == 2, uint16_t, uint32_t>>;
+
+/**
+ * @brief Bus access for a WIDTH byte register at a runtime address
+ *
+ * One byte registers go through ReadReg8/WriteReg8/WriteRegBits, so they use
+ * the register shadow when the device has one. Wider registers are a single
+ * burst and invalidate the shadow of the bytes they write.
+ */
+template <size_t WIDTH, I2cEndian ENDIAN>
+struct I2cRegIo
+{
+    static_assert(WIDTH >= 1 && WIDTH <= 4, "registers are 1 to 4 bytes");
+    using value_type = I2cRegValue<WIDTH>;
+
+    // Address of the byte that holds bits [8 * index, 8 * index + 7]
+    static constexpr uint8_t ByteAddr(uint8_t addr, size_t index)
+    {
+        return (uint8_t)(ENDIAN == I2cEndian::Big ? addr + WIDTH - 1 - index : addr + index);
+    }
+
+    static constexpr value_type Decode(const uint8_t *bytes)
+    {
+        value_type value = 0;
+        for (size_t i = 0; i < WIDTH; ++i) {
+            size_t index = ENDIAN == I2cEndian::Big ? WIDTH - 1 - i : i;
+            value |= (value_type)((value_type)bytes[i] << (8 * index));
+        }
+        return value;
+    }
+
+    static constexpr void Encode(value_type value, uint8_t *bytes)
+    {
+        for (size_t i = 0; i < WIDTH; ++i) {
+            size_t index = ENDIAN == I2cEndian::Big ? WIDTH - 1 - i : i;
+            bytes[i] = (uint8_t)(value >> (8 * index));
+        }
+    }
+
+    static bool Read(I2cDevice &dev, uint8_t addr, value_type &value, int timeout_ms)
+    {
+        if constexpr (WIDTH == 1) {
+            return dev.ReadReg8(addr, value, timeout_ms);
+        } else {
+            uint8_t bytes[WIDTH];
+            if (!dev.WriteReadBytes(&addr, 1, bytes, WIDTH, timeout_ms)) return false;
+            value = Decode(bytes);
+            return true;
+        }
+    }
+
+    static bool Write(I2cDevice &dev, uint8_t addr, value_type value, int timeout_ms)
+    {
+        if constexpr (WIDTH == 1) {
+            return dev.WriteReg8(addr, value, timeout_ms);
+        } else {
+            uint8_t buffer[1 + WIDTH] = {addr};
+            Encode(value, buffer + 1);
+            for (size_t i = 0; i < WIDTH; ++i) dev.InvalidateReg((uint8_t)(addr + i));
+            return dev.WriteBytes(buffer, sizeof(buffer), timeout_ms);
+        }
+    }
+
+    /**
+     * Replace the bits in MASK with the same bits of value, touching only the
+     * bytes MASK covers: whole bytes are written without a read, a part of
+     * one byte is WriteRegBits (one write when shadowed), anything else is a
+     * read and a write of just that byte span. MASK is a template argument so
+     * the choice folds at compile time.
+     */
+    template <value_type MASK>
+    static bool Modify(I2cDevice &dev, uint8_t addr, value_type value, int timeout_ms)
+    {
+        static_assert(MASK != 0, "empty mask");
+        constexpr size_t LOW = LowByte(MASK);
+        constexpr size_t HIGH = HighByte(MASK);
+        constexpr size_t SPAN = HIGH - LOW + 1;
+        constexpr bool WHOLE_BYTES = MASK == SpanMask(LOW, HIGH);
+        // Bytes LOW..HIGH are contiguous on the bus in either byte order
+        constexpr size_t FIRST = ENDIAN == I2cEndian::Big ? HIGH : LOW;
+
+        if constexpr (SPAN == 1 && !WHOLE_BYTES) {
+            return dev.WriteRegBits(ByteAddr(addr, LOW), (uint8_t)(MASK >> (8 * LOW)),
+                                    (uint8_t)(value >> (8 * LOW)), timeout_ms);
+        } else if constexpr (SPAN == 1) {
+            return dev.WriteReg8(ByteAddr(addr, LOW), (uint8_t)(value >> (8 * LOW)), timeout_ms);
+        } else {
+            uint8_t start = ByteAddr(addr, FIRST);
+            uint8_t buffer[1 + SPAN] = {start};
+            if constexpr (!WHOLE_BYTES) {
+                if (!dev.WriteReadBytes(&start, 1, buffer + 1, SPAN, timeout_ms)) return false;
+            }
+            for (size_t i = 0; i < SPAN; ++i) {
+                size_t index = ENDIAN == I2cEndian::Big ? HIGH - i : LOW + i;
+                uint8_t byte_mask = (uint8_t)(MASK >> (8 * index));
+                buffer[1 + i] = (uint8_t)((buffer[1 + i] & ~byte_mask) | ((uint8_t)(value >> (8 * index)) & byte_mask));
+                dev.InvalidateReg((uint8_t)(start + i));
+            }
+            return dev.WriteBytes(buffer, sizeof(buffer), timeout_ms);
+        }
+    }
+
+private:
+    static constexpr size_t LowByte(value_type mask)
+    {
+        size_t index = 0;
+        while (((mask >> (8 * index)) & 0xFF) == 0) ++index;
+        return index;
+    }
+
+    static constexpr value_type SpanMask(size_t low, size_t high)
+    {
+        uint64_t bits = ((uint64_t)1 << (8 * (high - low + 1))) - 1;
+        return (value_type)(bits << (8 * low));
+    }
+
+    static constexpr size_t HighByte(value_type mask)
+    {
+        size_t index = WIDTH - 1;
+        while (((mask >> (8 * index)) & 0xFF) == 0) --index;
+        return index;
+    }
+};
+
+/**
+ * @brief A register described at compile time
+ *
+ *   using ChargerCtl0 = I2cRegister<0x20>;
+ *   using Vbus = I2cRegister<0x30, 2, I2cRegAccess::ReadOnly, I2cEndian::Little>;
+ *
+ *   uint16_t mv;
+ *   Vbus::Read(dev, mv, timeout_ms);
+ *   Vbus::Write(dev, 0, timeout_ms); // does not compile, read-only
+ */
+template <uint8_t ADDR, size_t WIDTH = 1, I2cRegAccess ACCESS = I2cRegAccess::ReadWrite, I2cEndian ENDIAN = I2cEndian::Big>
+struct I2cRegister
+{
+    static_assert(ADDR + WIDTH - 1 <= 0xFF, "register runs past 0xFF");
+    using Io = I2cRegIo<WIDTH, ENDIAN>;
+    using value_type = typename Io::value_type;
+    static constexpr uint8_t addr = ADDR;
+    static constexpr size_t width = WIDTH;
+    static constexpr I2cRegAccess access = ACCESS;
+    static constexpr I2cEndian endian = ENDIAN;
+
+    static bool Read(I2cDevice &dev, value_type &value, int timeout_ms)
+    {
+        static_assert(ACCESS != I2cRegAccess::WriteOnly, "register is write-only");
+        return Io::Read(dev, ADDR, value, timeout_ms);
+    }
+
+    static bool Write(I2cDevice &dev, value_type value, int timeout_ms)
+    {
+        static_assert(ACCESS != I2cRegAccess::ReadOnly, "register is read-only");
+        return Io::Write(dev, ADDR, value, timeout_ms);
+    }
+
+    template <value_type MASK>
+    static bool Modify(I2cDevice &dev, value_type value, int timeout_ms)
+    {
+        static_assert(ACCESS == I2cRegAccess::ReadWrite || (ACCESS == I2cRegAccess::WriteOnly && WIDTH == 1),
+                      "read-modify-write needs a readable register or a one-byte shadowed one");
+        return Io::template Modify<MASK>(dev, ADDR, value, timeout_ms);
+    }
+
+    // Shadow policy entry for I2cDevice::EnableRegCache
+    static constexpr I2cRegRange CacheRange(I2cRegPolicy policy)
+    {
+        return {ADDR, (uint8_t)(ADDR + WIDTH - 1), policy};
+    }
+};
+
+/**
+ * @brief BITS bits at SHIFT of register REG, read and written as T
+ *
+ * T may be an enum, bool or integer. Write only touches the bytes of the
+ * register the field lives in; writing several fields of one register at
+ * once is REG::Modify<A::mask | B::mask>(dev, A::Make(a) | B::Make(b), ...).
+ */
+template <typename REG, unsigned SHIFT, unsigned BITS, typename T = typename REG::value_type>
+struct I2cField
+{
+    using value_type = typename REG::value_type;
+    static_assert(BITS >= 1 && SHIFT + BITS <= 8 * REG::width, "field does not fit its register");
+    static constexpr value_type mask =
+        (value_type)((BITS >= 32 ? 0xFFFFFFFFu : ((1u << BITS) - 1)) << SHIFT);
+
+    static constexpr value_type Make(T value) { return (value_type)(((value_type)value << SHIFT) & mask); }
+    static constexpr T Extract(value_type reg) { return static_cast<T>((reg & mask) >> SHIFT); }
+    static constexpr value_type Insert(value_type reg, T value) { return (value_type)((reg & ~mask) | Make(value)); }
+
+    static bool Read(I2cDevice &dev, T &value, int timeout_ms)
+    {
+        value_type reg;
+        if (!REG::Read(dev, reg, timeout_ms)) return false;
+        value = Extract(reg);
+        return true;
+    }
+
+    static bool Write(I2cDevice &dev, T value, int timeout_ms)
+    {
+        return REG::template Modify<mask>(dev, Make(value), timeout_ms);
+    }
+};
+
+/**
+ * @brief COUNT registers spaced STRIDE bytes apart from BASE, e.g. one per pin or channel
+ *
+ * A constant index gives an I2cRegister (At<3>); a runtime index is bounds
+ * checked and the address is BASE + index * STRIDE, no table lookup.
+ */
+template <uint8_t BASE, size_t COUNT, size_t STRIDE = 1, size_t WIDTH = 1,
+          I2cRegAccess ACCESS = I2cRegAccess::ReadWrite, I2cEndian ENDIAN = I2cEndian::Big>
+struct I2cRegisterArray
+{
+    static_assert(COUNT >= 1 && STRIDE >= WIDTH, "registers overlap");
+    static_assert(BASE + (COUNT - 1) * STRIDE + WIDTH - 1 <= 0xFF, "array runs past 0xFF");
+    using Io = I2cRegIo<WIDTH, ENDIAN>;
+    using value_type = typename Io::value_type;
+    static constexpr size_t count = COUNT;
+
+    template <size_t INDEX>
+    using At = I2cRegister<(uint8_t)(BASE + INDEX * STRIDE), WIDTH, ACCESS, ENDIAN>;
+
+    static constexpr bool Contains(size_t index) { return index < COUNT; }
+    static constexpr uint8_t Addr(size_t index) { return (uint8_t)(BASE + index * STRIDE); }
+
+    static bool Read(I2cDevice &dev, size_t index, value_type &value, int timeout_ms)
+    {
+        static_assert(ACCESS != I2cRegAccess::WriteOnly, "registers are write-only");
+        return Contains(index) && Io::Read(dev, Addr(index), value, timeout_ms);
+    }
+
+    static bool Write(I2cDevice &dev, size_t index, value_type value, int timeout_ms)
+    {
+        static_assert(ACCESS != I2cRegAccess::ReadOnly, "registers are read-only");
+        return Contains(index) && Io::Write(dev, Addr(index), value, timeout_ms);
+    }
+
+    static constexpr I2cRegRange CacheRange(I2cRegPolicy policy)
+    {
+        return {BASE, (uint8_t)(BASE + (COUNT - 1) * STRIDE + WIDTH - 1), policy};
+    }
+};
+
+} // namespace wrapper
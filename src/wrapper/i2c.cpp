@@ -1,7 +1,9 @@
 #include "wrapper/i2c.hpp"
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
 #include <cstring>
+#include <iterator>
 #include <vector>
 
 // --- I2cBus ---
@@ -182,6 +184,7 @@ bool I2cDevice::Init(const I2cBus& bus, const I2cDeviceConfig& config) {
         return false;
     }
 
+    InvalidateRegCache();
     esp_err_t ret = i2c_master_bus_add_device(bus.GetHandle(), &config, &dev_handle_);
     if (ret == ESP_OK) {
         logger_.Info("Device initialized (Addr: 0x%02X)", config.device_address);
@@ -236,6 +239,8 @@ bool I2cDevice::ReadByte(uint8_t& data, int timeout_ms) {
 
 bool I2cDevice::WriteRegBytes(uint8_t reg_addr, const std::vector<uint8_t>& data, int timeout_ms) {
     if (dev_handle_ == nullptr) return false;
+    InvalidateRegs(reg_addr, data.size());
+    CountRegWrite();
     
     // Optimization: Use stack for small data
     size_t total_len = 1 + data.size();
@@ -258,22 +263,51 @@ bool I2cDevice::WriteRegBytes(uint8_t reg_addr, const std::vector<uint8_t>& data
 bool I2cDevice::ReadRegBytes(uint8_t reg_addr, std::vector<uint8_t>& data, size_t len, int timeout_ms) {
     if (dev_handle_ == nullptr) return false;
     data.resize(len);
+    CountRegRead();
     return i2c_master_transmit_receive(dev_handle_, &reg_addr, 1, data.data(), len, timeout_ms) == ESP_OK;
 }
 
 bool I2cDevice::WriteReg8(uint8_t reg_addr, uint8_t data, int timeout_ms) {
     if (dev_handle_ == nullptr) return false;
     uint8_t buffer[2] = {reg_addr, data};
-    return i2c_master_transmit(dev_handle_, buffer, 2, timeout_ms) == ESP_OK;
+    bool ok = i2c_master_transmit(dev_handle_, buffer, 2, timeout_ms) == ESP_OK;
+    CountRegWrite();
+    if (reg_cache_) {
+        if (ok) {
+            StoreReg(reg_addr, data);
+        } else {
+            // The write may or may not have landed
+            InvalidateReg(reg_addr);
+        }
+    }
+    return ok;
 }
 
 bool I2cDevice::ReadReg8(uint8_t reg_addr, uint8_t& data, int timeout_ms) {
     if (dev_handle_ == nullptr) return false;
-    return i2c_master_transmit_receive(dev_handle_, &reg_addr, 1, &data, 1, timeout_ms) == ESP_OK;
+    if (reg_cache_) {
+        I2cRegPolicy policy = reg_cache_->policy[reg_addr];
+        if (IsRegCached(reg_addr)) {
+            reg_cache_->stats.hits++;
+            data = reg_cache_->value[reg_addr];
+            return true;
+        }
+        if (policy == I2cRegPolicy::WriteOnly) {
+            logger_.Error("Register 0x%02X is write-only and has not been written", reg_addr);
+            return false;
+        }
+        if (policy == I2cRegPolicy::Cacheable) reg_cache_->stats.misses++;
+    }
+    CountRegRead();
+    bool ok = i2c_master_transmit_receive(dev_handle_, &reg_addr, 1, &data, 1, timeout_ms) == ESP_OK;
+    if (ok) StoreReg(reg_addr, data);
+    return ok;
 }
 
 bool I2cDevice::WriteReg16(uint8_t reg_addr, uint16_t data, int timeout_ms) {
     if (dev_handle_ == nullptr) return false;
+    InvalidateRegs(reg_addr, 2);
+    CountRegWrite();
     // Big Endian
     uint8_t buffer[3] = {reg_addr, (uint8_t)(data >> 8), (uint8_t)(data & 0xFF)}; 
     return i2c_master_transmit(dev_handle_, buffer, 3, timeout_ms) == ESP_OK;
@@ -282,6 +316,7 @@ bool I2cDevice::WriteReg16(uint8_t reg_addr, uint16_t data, int timeout_ms) {
 bool I2cDevice::ReadReg16(uint8_t reg_addr, uint16_t& data, int timeout_ms) {
     if (dev_handle_ == nullptr) return false;
     uint8_t buffer[2];
+    CountRegRead();
     esp_err_t ret = i2c_master_transmit_receive(dev_handle_, &reg_addr, 1, buffer, 2, timeout_ms);
     if (ret == ESP_OK) {
         data = ((uint16_t)buffer[0] << 8) | buffer[1]; // Big Endian
@@ -292,6 +327,8 @@ bool I2cDevice::ReadReg16(uint8_t reg_addr, uint16_t& data, int timeout_ms) {
 
 bool I2cDevice::WriteReg32(uint8_t reg_addr, uint32_t data, int timeout_ms) {
     if (dev_handle_ == nullptr) return false;
+    InvalidateRegs(reg_addr, 4);
+    CountRegWrite();
     // Big Endian
     uint8_t buffer[5] = {
         reg_addr, 
@@ -306,6 +343,7 @@ bool I2cDevice::WriteReg32(uint8_t reg_addr, uint32_t data, int timeout_ms) {
 bool I2cDevice::ReadReg32(uint8_t reg_addr, uint32_t& data, int timeout_ms) {
     if (dev_handle_ == nullptr) return false;
     uint8_t buffer[4];
+    CountRegRead();
     esp_err_t ret = i2c_master_transmit_receive(dev_handle_, &reg_addr, 1, buffer, 4, timeout_ms);
     if (ret == ESP_OK) {
         data = ((uint32_t)buffer[0] << 24) | 
@@ -336,6 +374,7 @@ bool I2cDevice::ReadRegBit(uint8_t reg_addr, uint8_t bit, bool& value, int timeo
 bool I2cDevice::WriteRegBits(uint8_t reg_addr, uint8_t mask, uint8_t value, int timeout_ms) {
     if (dev_handle_ == nullptr) return false;
     
+    // Served from the shadow for Cacheable/WriteOnly registers, leaving just the write
     uint8_t current_value;
     if (!ReadReg8(reg_addr, current_value, timeout_ms)) return false;
     
@@ -351,3 +390,116 @@ bool I2cDevice::ReadRegBits(uint8_t reg_addr, uint8_t mask, uint8_t& value, int
     }
     return false;
 }
+
+bool I2cDevice::WriteRegSequence(const I2cRegWrite* writes, size_t count, int timeout_ms) {
+    if (dev_handle_ == nullptr) return false;
+
+    uint8_t buffer[1 + REG_BURST_MAX];
+    size_t i = 0;
+    while (i < count) {
+        size_t run = 1;
+        if (reg_auto_increment_) {
+            while (i + run < count && run < REG_BURST_MAX && writes[i + run].reg == writes[i + run - 1].reg + 1) {
+                run++;
+            }
+        }
+        buffer[0] = writes[i].reg;
+        for (size_t j = 0; j < run; ++j) buffer[1 + j] = writes[i + j].value;
+
+        bool ok = i2c_master_transmit(dev_handle_, buffer, 1 + run, timeout_ms) == ESP_OK;
+        CountRegWrite();
+        for (size_t j = 0; j < run; ++j) {
+            if (ok) {
+                StoreReg(writes[i + j].reg, writes[i + j].value);
+            } else {
+                InvalidateReg(writes[i + j].reg);
+            }
+        }
+        if (!ok) {
+            logger_.Error("Failed to write register 0x%02X (entry %d of %d)", writes[i].reg, (int)i + 1, (int)count);
+            return false;
+        }
+        i += run;
+    }
+    return true;
+}
+
+// --- I2cDevice register cache ---
+
+bool I2cDevice::EnableRegCache(std::initializer_list<I2cRegRange> ranges) {
+    return EnableRegCache(ranges.begin(), ranges.size());
+}
+
+bool I2cDevice::EnableRegCache(const I2cRegRange* ranges, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (ranges[i].first > ranges[i].last) {
+            logger_.Error("Invalid register range: 0x%02X - 0x%02X", ranges[i].first, ranges[i].last);
+            return false;
+        }
+    }
+    if (!reg_cache_) reg_cache_.reset(new RegCache());
+    std::fill(std::begin(reg_cache_->policy), std::end(reg_cache_->policy), I2cRegPolicy::Volatile);
+    for (size_t i = 0; i < count; ++i) {
+        for (int reg = ranges[i].first; reg <= ranges[i].last; ++reg) {
+            reg_cache_->policy[reg] = ranges[i].policy;
+        }
+    }
+    InvalidateRegCache();
+    ResetRegCacheStats();
+    return true;
+}
+
+void I2cDevice::DisableRegCache() {
+    reg_cache_.reset();
+}
+
+bool I2cDevice::IsRegCached(uint8_t reg_addr) const {
+    return reg_cache_ && reg_cache_->policy[reg_addr] != I2cRegPolicy::Volatile &&
+           (reg_cache_->valid[reg_addr >> 5] & (1u << (reg_addr & 31)));
+}
+
+void I2cDevice::StoreReg(uint8_t reg_addr, uint8_t value) {
+    if (!reg_cache_ || reg_cache_->policy[reg_addr] == I2cRegPolicy::Volatile) return;
+    reg_cache_->value[reg_addr] = value;
+    reg_cache_->valid[reg_addr >> 5] |= 1u << (reg_addr & 31);
+}
+
+void I2cDevice::InvalidateReg(uint8_t reg_addr) {
+    if (!reg_cache_) return;
+    reg_cache_->valid[reg_addr >> 5] &= ~(1u << (reg_addr & 31));
+}
+
+void I2cDevice::InvalidateRegs(uint8_t reg_addr, size_t count) {
+    if (!reg_cache_) return;
+    for (size_t i = 0; i < count && reg_addr + i < 256; ++i) {
+        InvalidateReg((uint8_t)(reg_addr + i));
+    }
+}
+
+void I2cDevice::InvalidateRegCache() {
+    if (!reg_cache_) return;
+    memset(reg_cache_->valid, 0, sizeof(reg_cache_->valid));
+}
+
+bool I2cDevice::SyncRegCache(int timeout_ms) {
+    if (!reg_cache_) return false;
+    bool ok = true;
+    for (int reg = 0; reg < 256; ++reg) {
+        if (reg_cache_->policy[reg] != I2cRegPolicy::Cacheable) continue;
+        InvalidateReg((uint8_t)reg);
+        uint8_t value;
+        if (!ReadReg8((uint8_t)reg, value, timeout_ms)) {
+            logger_.Warning("Failed to sync register 0x%02X", reg);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+I2cRegCacheStats I2cDevice::GetRegCacheStats() const {
+    return reg_cache_ ? reg_cache_->stats : I2cRegCacheStats();
+}
+
+void I2cDevice::ResetRegCacheStats() {
+    if (reg_cache_) reg_cache_->stats = I2cRegCacheStats();
+}
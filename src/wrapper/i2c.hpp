@@ -1,4 +1,6 @@
 #pragma once
+#include <initializer_list>
+#include <memory>
 #include <vector>
 #include "driver/i2c_master.h"
 #include "wrapper/logger.hpp"
@@ -78,16 +80,63 @@ namespace wrapper
     }
   };
 
+  // How the register shadow treats a register
+  enum class I2cRegPolicy : uint8_t
+  {
+    Volatile,  // changed by the device (status, flags), always read from the bus
+    Cacheable, // only changed by us, reads and read-modify-write use the shadow
+    WriteOnly, // cannot be read back, read-modify-write uses the last written value
+  };
+
+  struct I2cRegRange
+  {
+    uint8_t first;
+    uint8_t last;
+    I2cRegPolicy policy;
+  };
+
+  struct I2cRegCacheStats
+  {
+    uint32_t hits = 0;   // reads served from the shadow
+    uint32_t misses = 0; // reads of a cacheable register that went to the bus
+    uint32_t reads = 0;  // register read transactions (ReadReg*), raw ReadBytes excluded
+    uint32_t writes = 0; // register write transactions (WriteReg*), raw WriteBytes excluded
+  };
+
+  struct I2cRegWrite
+  {
+    uint8_t reg;
+    uint8_t value;
+  };
+
   class I2cDevice
   {
+    struct RegCache
+    {
+      uint8_t value[256];
+      I2cRegPolicy policy[256];
+      uint32_t valid[8];
+      I2cRegCacheStats stats;
+    };
+
+    std::unique_ptr<RegCache> reg_cache_;
+
+    bool IsRegCached(uint8_t reg_addr) const;
+    void StoreReg(uint8_t reg_addr, uint8_t value);
+    void InvalidateRegs(uint8_t reg_addr, size_t count);
+    void CountRegRead() { if (reg_cache_) reg_cache_->stats.reads++; }
+    void CountRegWrite() { if (reg_cache_) reg_cache_->stats.writes++; }
+
   protected:
     Logger &logger_;
     i2c_master_dev_handle_t dev_handle_;
+    bool reg_auto_increment_ = false;
 
   public:
     I2cDevice(Logger &logger);
     ~I2cDevice();
     Logger &GetLogger();
+    i2c_master_dev_handle_t GetHandle() const { return dev_handle_; }
     bool Init(const I2cBus &bus, const I2cDeviceConfig &config);
     bool Deinit();
 
@@ -128,6 +177,47 @@ namespace wrapper
     bool ReadRegBit(uint8_t reg_addr, uint8_t bit, bool &value, int timeout_ms);
     bool WriteRegBits(uint8_t reg_addr, uint8_t mask, uint8_t value, int timeout_ms);
     bool ReadRegBits(uint8_t reg_addr, uint8_t mask, uint8_t &value, int timeout_ms);
+
+    // Set by devices whose register pointer advances after each written byte
+    void SetRegAutoIncrement(bool enable) { reg_auto_increment_ = enable; }
+    bool IsRegAutoIncrement() const { return reg_auto_increment_; }
+
+    /**
+     * Write a table of registers in order, stopping at the first failure.
+     * With auto-increment, runs of consecutive registers go out as one burst
+     * (up to REG_BURST_MAX bytes), otherwise each entry is its own transfer.
+     *
+     *   static constexpr I2cRegWrite init[] = {{0x02, 0x07}, {0x03, 0x8F}, {0x11, 0x10}};
+     *   dev.WriteRegSequence(init, timeout_ms);
+     */
+    static constexpr size_t REG_BURST_MAX = 32;
+    bool WriteRegSequence(const I2cRegWrite *writes, size_t count, int timeout_ms);
+
+    template <size_t N>
+    bool WriteRegSequence(const I2cRegWrite (&writes)[N], int timeout_ms)
+    {
+      return WriteRegSequence(writes, N, timeout_ms);
+    }
+
+    /**
+     * Register shadow cache, off by default. Registers outside the ranges are Volatile.
+     * The shadow starts empty and fills on the first read or write of each register;
+     * ReadReg8/WriteReg8/RegBit(s) go through it. WriteReg16/32 and WriteRegBytes
+     * invalidate the registers they cover, raw WriteBytes is not tracked.
+     */
+    bool EnableRegCache(std::initializer_list<I2cRegRange> ranges);
+    bool EnableRegCache(const I2cRegRange *ranges, size_t count);
+    void DisableRegCache();
+    bool IsRegCacheEnabled() const { return reg_cache_ != nullptr; }
+
+    // Forget shadowed values, e.g. after a device reset
+    void InvalidateRegCache();
+    void InvalidateReg(uint8_t reg_addr);
+    // Reload every Cacheable register from the device
+    bool SyncRegCache(int timeout_ms);
+
+    I2cRegCacheStats GetRegCacheStats() const;
+    void ResetRegCacheStats();
   };
 
 }
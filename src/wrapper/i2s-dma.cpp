@@ -0,0 +1,75 @@
+#include "wrapper/i2s-dma.hpp"
+
+namespace wrapper
+{
+
+bool I2sDmaTuner::Init(I2sBus &i2s_bus, const I2sDmaPlan &plan, uint32_t sample_rate_hz, const I2sDmaTunerConfig &config)
+{
+    if (!plan.valid || sample_rate_hz == 0) {
+        logger_.Error("Invalid DMA plan");
+        return false;
+    }
+    i2s_bus_ = &i2s_bus;
+    plan_ = plan;
+    sample_rate_hz_ = sample_rate_hz;
+    config_ = config;
+    grown_ = 0;
+    tx_ = Direction();
+    rx_ = Direction();
+    CountXruns();
+    tx_.pending = 0;
+    rx_.pending = 0;
+    return true;
+}
+
+uint32_t I2sDmaTuner::Direction::Update(const I2sChannelStats &stats, bool count_timeouts)
+{
+    uint32_t new_bytes = stats.bytes - bytes;
+    uint32_t new_events = stats.dma_events - dma_events;
+    uint32_t new_overflows = stats.queue_overflows - queue_overflows;
+    uint32_t new_timeouts = stats.timeouts - timeouts;
+    bytes = stats.bytes;
+    dma_events = stats.dma_events;
+    queue_overflows = stats.queue_overflows;
+    timeouts = stats.timeouts;
+
+    // One descriptor of slack: the two ISR counters are not read atomically
+    bool streaming = new_bytes > 0 || new_overflows + 1 < new_events;
+    uint32_t xruns = streaming ? pending : 0;
+    pending = streaming ? new_overflows : 0;
+    // A Read timeout is a starved reader, a Write timeout only means the queue is full
+    if (count_timeouts) xruns += new_timeouts;
+    return xruns;
+}
+
+uint32_t I2sDmaTuner::CountXruns()
+{
+    I2sChannelStats tx;
+    I2sChannelStats rx;
+    i2s_bus_->GetTxStats(tx);
+    i2s_bus_->GetRxStats(rx);
+    return tx_.Update(tx, false) + rx_.Update(rx, true);
+}
+
+bool I2sDmaTuner::Poll()
+{
+    if (i2s_bus_ == nullptr) return false;
+    uint32_t delta = CountXruns();
+    if (delta < config_.grow_after_xruns || delta == 0) return false;
+
+    // One more descriptor: same interrupt period, one period more headroom
+    uint64_t latency_us = (uint64_t)(plan_.desc_num + 1) * plan_.frame_num * 1000000 / sample_rate_hz_;
+    if (latency_us > config_.max_latency_us) {
+        logger_.Warning("%u xruns, DMA queue already at %u us (limit %u us)", (unsigned)delta,
+                        (unsigned)plan_.latency_us, (unsigned)config_.max_latency_us);
+        return false;
+    }
+    plan_.desc_num += 1;
+    plan_.latency_us = (uint32_t)latency_us;
+    ++grown_;
+    logger_.Warning("%u xruns, DMA queue should grow to %u x %u frames (%u us)", (unsigned)delta,
+                    (unsigned)plan_.desc_num, (unsigned)plan_.frame_num, (unsigned)plan_.latency_us);
+    return true;
+}
+
+} // namespace wrapper
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "wrapper/i2s.hpp"
+
+namespace wrapper
+{
+
+// One DMA descriptor moves at most 4092 bytes (I2S_DMA_BUFFER_MAX_SIZE in the driver)
+constexpr uint32_t I2S_DMA_MAX_BUFFER_BYTES = 4092;
+// The driver needs at least two descriptors to ping-pong
+constexpr uint32_t I2S_DMA_MIN_DESC_NUM = 2;
+
+constexpr uint32_t I2sDmaFrameBytes(uint32_t slots, uint32_t slot_bits)
+{
+    return slots * ((slot_bits + 7) / 8);
+}
+
+// Largest dma_frame_num whose buffer fits a descriptor and stays word aligned
+constexpr uint32_t I2sDmaMaxFrames(uint32_t slots, uint32_t slot_bits)
+{
+    uint32_t frame_bytes = I2sDmaFrameBytes(slots, slot_bits);
+    if (frame_bytes == 0) return 0;
+    uint32_t frames = I2S_DMA_MAX_BUFFER_BYTES / frame_bytes;
+    while (frames > 0 && (frames * frame_bytes) % 4 != 0) --frames;
+    return frames;
+}
+
+/**
+ * @brief dma_desc_num/dma_frame_num for I2sBusConfig, derived from timing
+ *
+ * latency_us is the whole DMA queue (worst case time from Write to the pin,
+ * and how long the writer may stall before an underrun). period_us is one
+ * descriptor, i.e. how often the DMA interrupt fires and how much a single
+ * Write/Read call can complete at once. For a bus shared by TX and RX, plan
+ * with the direction that has the widest frame.
+ */
+struct I2sDmaPlan
+{
+    uint32_t desc_num = 0;
+    uint32_t frame_num = 0;
+    uint32_t buffer_bytes = 0; // one descriptor
+    uint32_t period_us = 0;    // actual, after rounding
+    uint32_t latency_us = 0;   // actual, desc_num * period_us
+    bool valid = false;
+
+    void Apply(I2sBusConfig &config) const
+    {
+        config.dma_desc_num = desc_num;
+        config.dma_frame_num = frame_num;
+    }
+};
+
+constexpr I2sDmaPlan I2sDmaPlanFor(uint32_t sample_rate_hz, uint32_t slots, uint32_t slot_bits,
+                                   uint32_t latency_us, uint32_t period_us)
+{
+    I2sDmaPlan plan;
+    const uint32_t frame_bytes = I2sDmaFrameBytes(slots, slot_bits);
+    const uint32_t max_frames = I2sDmaMaxFrames(slots, slot_bits);
+    if (sample_rate_hz == 0 || frame_bytes == 0 || max_frames == 0 || period_us == 0) return plan;
+
+    // Nearest whole frame count, then the descriptor limit and word alignment
+    uint64_t frames = ((uint64_t)period_us * sample_rate_hz + 500000) / 1000000;
+    if (frames == 0) frames = 1;
+    if (frames > max_frames) frames = max_frames;
+    while ((frames * frame_bytes) % 4 != 0) ++frames;
+
+    const uint64_t latency_frames = ((uint64_t)latency_us * sample_rate_hz + 500000) / 1000000;
+    uint64_t desc = (latency_frames + frames - 1) / frames;
+    if (desc < I2S_DMA_MIN_DESC_NUM) desc = I2S_DMA_MIN_DESC_NUM;
+
+    plan.desc_num = (uint32_t)desc;
+    plan.frame_num = (uint32_t)frames;
+    plan.buffer_bytes = (uint32_t)(frames * frame_bytes);
+    plan.period_us = (uint32_t)(frames * 1000000 / sample_rate_hz);
+    plan.latency_us = (uint32_t)(desc * frames * 1000000 / sample_rate_hz);
+    plan.valid = true;
+    return plan;
+}
+
+struct I2sDmaTunerConfig
+{
+    uint32_t max_latency_us = 200000; // never grow the queue past this
+    uint32_t grow_after_xruns = 1;    // xruns between two polls that trigger a step
+};
+
+/**
+ * @brief Grows the DMA queue when the xrun counters of an I2sBus fire
+ *
+ * Poll it periodically (e.g. once a second). Counts TX/RX queue overflows
+ * (needs I2sBus::EnableEventCallbacks) and Read timeouts; when they rise,
+ * one descriptor is added to the plan. DMA buffers cannot be resized on a
+ * live channel, so the caller applies GetPlan() the next time it
+ * initializes the bus (e.g. when audio is restarted).
+ *
+ * An enabled channel nobody feeds overflows on every descriptor, so
+ * overflows only count while the direction is streaming: data moved
+ * through I2sBus::Write/Read, or only some of the descriptors overflowed.
+ * They are held for one poll and dropped if the stream has stopped by
+ * then, since the tail of a stream drains the queue as well.
+ */
+class I2sDmaTuner
+{
+    Logger &logger_;
+    I2sBus *i2s_bus_ = nullptr;
+    I2sDmaTunerConfig config_;
+    I2sDmaPlan plan_;
+    uint32_t sample_rate_hz_ = 0;
+    uint32_t grown_ = 0;
+
+    struct Direction
+    {
+        uint32_t bytes = 0;
+        uint32_t dma_events = 0;
+        uint32_t queue_overflows = 0;
+        uint32_t timeouts = 0;
+        uint32_t pending = 0; // overflows of the last poll, confirmed if the stream keeps going
+
+        // Xruns since the last call
+        uint32_t Update(const I2sChannelStats &stats, bool count_timeouts);
+    };
+    Direction tx_;
+    Direction rx_;
+
+    uint32_t CountXruns();
+
+public:
+    I2sDmaTuner(Logger &logger) : logger_(logger) {}
+
+    Logger &GetLogger() const { return logger_; }
+
+    bool Init(I2sBus &i2s_bus, const I2sDmaPlan &plan, uint32_t sample_rate_hz,
+              const I2sDmaTunerConfig &config = I2sDmaTunerConfig());
+
+    // True when the plan has grown since the last call
+    bool Poll();
+
+    const I2sDmaPlan &GetPlan() const { return plan_; }
+    uint32_t GetGrowCount() const { return grown_; }
+};
+
+} // namespace wrapper
@@ -0,0 +1,275 @@
+#include "wrapper/i2s-stream.hpp"
+
+namespace wrapper
+{
+
+static void WaitForStop(TaskHandle_t task_handle, const std::atomic<bool> &running)
+{
+    if (task_handle == nullptr || xTaskGetCurrentTaskHandle() == task_handle) return;
+    const int max_retries = 100;
+    for (int i = 0; i < max_retries && running; ++i) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+// I2sTxStream Implementation
+
+I2sTxStream::~I2sTxStream()
+{
+    Stop();
+}
+
+bool I2sTxStream::Start(I2sBus &i2s_bus, const I2sStreamConfig &config)
+{
+    if (running_) {
+        logger_.Warning("Already running");
+        return false;
+    }
+    if (i2s_bus.GetTxHandle() == NULL) {
+        logger_.Error("TX Channel handle is NULL");
+        return false;
+    }
+    if (!ring_.Init(config.ring_size)) {
+        logger_.Error("Failed to allocate %u byte ring", (unsigned)config.ring_size);
+        return false;
+    }
+
+    i2s_bus_ = &i2s_bus;
+    config_ = config;
+    errors_ = 0;
+    should_stop_ = false;
+
+    BaseType_t ret = xTaskCreatePinnedToCore(
+        TaskWrapper, config_.name, config_.stack_size, this, config_.priority, &task_handle_, config_.core_id);
+    if (ret != pdPASS) {
+        logger_.Error("Failed to create pump task");
+        task_handle_ = nullptr;
+        ring_.Deinit();
+        return false;
+    }
+    // Producers are let in from here on, task_handle_ is valid for their notifications
+    running_ = true;
+    logger_.Info("TX stream started (ring: %u bytes, chunk: %u bytes)",
+                 (unsigned)ring_.Capacity(), (unsigned)config_.chunk_size);
+    return true;
+}
+
+void I2sTxStream::Stop()
+{
+    if (task_handle_ == nullptr) return;
+    should_stop_ = true;
+    xTaskNotifyGive(task_handle_);
+    WaitForStop(task_handle_, running_);
+    if (running_) {
+        logger_.Error("Pump task did not stop, keeping its ring alive");
+        return;
+    }
+    task_handle_ = nullptr;
+    ring_.Deinit();
+}
+
+// Registered before should_stop_ is read, so the pump either waits for us or we see it stopping
+bool I2sTxStream::EnterProducer()
+{
+    producers_.fetch_add(1);
+    if (running_ && !should_stop_) return true;
+    producers_.fetch_sub(1);
+    return false;
+}
+
+size_t I2sTxStream::Write(const void *data, size_t size)
+{
+    if (!EnterProducer()) return 0;
+    size_t written = ring_.Write(data, size);
+    if (written > 0) xTaskNotifyGive(task_handle_);
+    producers_.fetch_sub(1);
+    return written;
+}
+
+RingSpan I2sTxStream::GetWriteSpan()
+{
+    if (!EnterProducer()) return RingSpan{};
+    RingSpan span = ring_.GetWriteSpan();
+    span_held_ = span.size > 0;
+    if (!span_held_) producers_.fetch_sub(1);
+    return span;
+}
+
+void I2sTxStream::CommitWrite(size_t size)
+{
+    // Nothing to commit without a span, Stop may already have freed the ring
+    if (!span_held_) return;
+    span_held_ = false;
+    ring_.CommitWrite(size);
+    if (size > 0) xTaskNotifyGive(task_handle_);
+    producers_.fetch_sub(1);
+}
+
+void I2sTxStream::TaskWrapper(void *param)
+{
+    auto *self = static_cast<I2sTxStream *>(param);
+    self->Run();
+    vTaskDelete(nullptr);
+}
+
+void I2sTxStream::Run()
+{
+    bool streaming = false;
+    while (!should_stop_) {
+        RingSpan span = ring_.GetReadSpan();
+        if (span.size == 0) {
+            // Ran dry while data was flowing: the DMA is about to play silence
+            if (streaming) ring_.MarkUnderrun();
+            streaming = false;
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(config_.timeout_ms));
+            continue;
+        }
+
+        streaming = true;
+        size_t size = span.size < config_.chunk_size ? span.size : config_.chunk_size;
+        size_t written = 0;
+        i2s_bus_->Write(span.data, size, written, config_.timeout_ms);
+        if (written == 0) {
+            // Channel disabled or driver error: back off instead of spinning at pump priority
+            errors_.fetch_add(1, std::memory_order_relaxed);
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(config_.timeout_ms));
+            continue;
+        }
+        ring_.CommitRead(written);
+    }
+    // Producers may still hold the ring or be about to notify this task
+    while (producers_ > 0) vTaskDelay(pdMS_TO_TICKS(1));
+    running_ = false;
+}
+
+// I2sRxStream Implementation
+
+I2sRxStream::~I2sRxStream()
+{
+    Stop();
+}
+
+bool I2sRxStream::Start(I2sBus &i2s_bus, const I2sStreamConfig &config)
+{
+    if (running_) {
+        logger_.Warning("Already running");
+        return false;
+    }
+    if (i2s_bus.GetRxHandle() == NULL) {
+        logger_.Error("RX Channel handle is NULL");
+        return false;
+    }
+    if (!ring_.Init(config.ring_size)) {
+        logger_.Error("Failed to allocate %u byte ring", (unsigned)config.ring_size);
+        return false;
+    }
+    // Overflow sink: keeps draining the DMA while the ring is full
+    discard_ = new (std::nothrow) uint8_t[config.chunk_size];
+    if (discard_ == nullptr) {
+        logger_.Error("Failed to allocate discard buffer");
+        ring_.Deinit();
+        return false;
+    }
+
+    i2s_bus_ = &i2s_bus;
+    config_ = config;
+    errors_ = 0;
+    should_stop_ = false;
+
+    BaseType_t ret = xTaskCreatePinnedToCore(
+        TaskWrapper, config_.name, config_.stack_size, this, config_.priority, &task_handle_, config_.core_id);
+    if (ret != pdPASS) {
+        logger_.Error("Failed to create capture task");
+        task_handle_ = nullptr;
+        delete[] discard_;
+        discard_ = nullptr;
+        ring_.Deinit();
+        return false;
+    }
+    // Consumers are let in from here on
+    running_ = true;
+    logger_.Info("RX stream started (ring: %u bytes, chunk: %u bytes)",
+                 (unsigned)ring_.Capacity(), (unsigned)config_.chunk_size);
+    return true;
+}
+
+void I2sRxStream::Stop()
+{
+    if (task_handle_ == nullptr) return;
+    should_stop_ = true;
+    WaitForStop(task_handle_, running_);
+    if (running_) {
+        logger_.Error("Capture task did not stop, keeping its ring alive");
+        return;
+    }
+    task_handle_ = nullptr;
+    delete[] discard_;
+    discard_ = nullptr;
+    ring_.Deinit();
+}
+
+bool I2sRxStream::EnterConsumer()
+{
+    consumers_.fetch_add(1);
+    if (running_ && !should_stop_) return true;
+    consumers_.fetch_sub(1);
+    return false;
+}
+
+size_t I2sRxStream::Read(void *data, size_t size)
+{
+    if (!EnterConsumer()) return 0;
+    size_t read = ring_.Read(data, size);
+    consumers_.fetch_sub(1);
+    return read;
+}
+
+RingSpan I2sRxStream::GetReadSpan()
+{
+    if (!EnterConsumer()) return RingSpan{};
+    RingSpan span = ring_.GetReadSpan();
+    span_held_ = span.size > 0;
+    if (!span_held_) consumers_.fetch_sub(1);
+    return span;
+}
+
+void I2sRxStream::CommitRead(size_t size)
+{
+    if (!span_held_) return;
+    span_held_ = false;
+    ring_.CommitRead(size);
+    consumers_.fetch_sub(1);
+}
+
+void I2sRxStream::TaskWrapper(void *param)
+{
+    auto *self = static_cast<I2sRxStream *>(param);
+    self->Run();
+    vTaskDelete(nullptr);
+}
+
+void I2sRxStream::Run()
+{
+    while (!should_stop_) {
+        RingSpan span = ring_.GetWriteSpan();
+        size_t bytes_read = 0;
+        if (span.size == 0) {
+            // Consumer fell behind: drop this chunk rather than stall the DMA
+            ring_.MarkOverrun();
+            i2s_bus_->Read(discard_, config_.chunk_size, bytes_read, config_.timeout_ms);
+        } else {
+            size_t size = span.size < config_.chunk_size ? span.size : config_.chunk_size;
+            i2s_bus_->Read(span.data, size, bytes_read, config_.timeout_ms);
+            ring_.CommitWrite(bytes_read);
+        }
+        if (bytes_read == 0) {
+            // Same as TX: a failing channel must not spin the capture task
+            errors_.fetch_add(1, std::memory_order_relaxed);
+            vTaskDelay(pdMS_TO_TICKS(config_.timeout_ms));
+        }
+    }
+    while (consumers_ > 0) vTaskDelay(pdMS_TO_TICKS(1));
+    running_ = false;
+}
+
+} // namespace wrapper
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "wrapper/logger.hpp"
+#include "wrapper/i2s.hpp"
+#include "wrapper/ring-buffer.hpp"
+
+namespace wrapper
+{
+
+struct I2sStreamConfig
+{
+    const char *name = "I2sStream";
+    uint32_t stack_size = 4096;
+    UBaseType_t priority = 10;
+    BaseType_t core_id = tskNO_AFFINITY;
+    size_t ring_size = 8192;   // bytes, rounded up to a power of two
+    size_t chunk_size = 1024;  // max bytes per I2sBus::Write/Read call
+    uint32_t timeout_ms = 100; // I2sBus timeout and idle wait of the pump
+};
+
+/**
+ * @brief Decouples producers from I2S TX: callers fill a lock-free ring,
+ * a dedicated pump task drains it into I2sBus::Write.
+ *
+ * Exactly one producer task may call Write/GetWriteSpan/CommitWrite. Stop
+ * may run on another task: it waits for a Write in progress, and for a
+ * non-empty write span until its CommitWrite, before freeing the ring.
+ */
+class I2sTxStream
+{
+    Logger &logger_;
+    I2sBus *i2s_bus_ = nullptr;
+    I2sStreamConfig config_;
+    SpscRingBuffer ring_;
+    TaskHandle_t task_handle_ = nullptr;
+    std::atomic<bool> should_stop_{false};
+    std::atomic<bool> running_{false};
+    std::atomic<uint32_t> errors_{0};
+    std::atomic<uint32_t> producers_{0}; // inside Write or holding a write span, the pump outlives them
+    bool span_held_ = false;             // producer side only
+
+    static void TaskWrapper(void *param);
+    void Run();
+    bool EnterProducer();
+
+public:
+    I2sTxStream(Logger &logger) : logger_(logger) {}
+    ~I2sTxStream();
+
+    I2sTxStream(const I2sTxStream &) = delete;
+    I2sTxStream &operator=(const I2sTxStream &) = delete;
+
+    Logger &GetLogger() const { return logger_; }
+    SpscRingBuffer &GetRing() { return ring_; }
+
+    bool Start(I2sBus &i2s_bus, const I2sStreamConfig &config);
+    void Stop();
+    bool IsRunning() const { return running_; }
+
+    // Non-blocking, returns the number of bytes queued
+    size_t Write(const void *data, size_t size);
+
+    // Zero-copy producer access: a non-empty span must be committed (0 if nothing was written)
+    RingSpan GetWriteSpan();
+    void CommitWrite(size_t size);
+
+    size_t GetQueuedBytes() const { return ring_.Available(); }
+    uint32_t GetUnderruns() const { return ring_.GetUnderruns(); }
+    uint32_t GetOverruns() const { return ring_.GetOverruns(); }
+    // Pump calls that moved no data (timeout, disabled channel or driver error)
+    uint32_t GetErrors() const { return errors_; }
+};
+
+/**
+ * @brief Continuous I2S RX capture: a pump task reads I2sBus::Read straight
+ * into a lock-free ring, consumers drain it at their own pace.
+ *
+ * Exactly one consumer task may call Read/GetReadSpan/CommitRead. Stop
+ * may run on another task: it waits for a Read in progress, and for a
+ * non-empty read span until its CommitRead, before freeing the ring.
+ */
+class I2sRxStream
+{
+    Logger &logger_;
+    I2sBus *i2s_bus_ = nullptr;
+    I2sStreamConfig config_;
+    SpscRingBuffer ring_;
+    uint8_t *discard_ = nullptr;
+    TaskHandle_t task_handle_ = nullptr;
+    std::atomic<bool> should_stop_{false};
+    std::atomic<bool> running_{false};
+    std::atomic<uint32_t> errors_{0};
+    std::atomic<uint32_t> consumers_{0}; // inside Read or holding a read span, the capture task outlives them
+    bool span_held_ = false;             // consumer side only
+
+    static void TaskWrapper(void *param);
+    void Run();
+    bool EnterConsumer();
+
+public:
+    I2sRxStream(Logger &logger) : logger_(logger) {}
+    ~I2sRxStream();
+
+    I2sRxStream(const I2sRxStream &) = delete;
+    I2sRxStream &operator=(const I2sRxStream &) = delete;
+
+    Logger &GetLogger() const { return logger_; }
+    SpscRingBuffer &GetRing() { return ring_; }
+
+    bool Start(I2sBus &i2s_bus, const I2sStreamConfig &config);
+    void Stop();
+    bool IsRunning() const { return running_; }
+
+    // Non-blocking, returns the number of bytes copied
+    size_t Read(void *data, size_t size);
+
+    // Zero-copy consumer access: a non-empty span must be committed (0 if nothing was consumed)
+    RingSpan GetReadSpan();
+    void CommitRead(size_t size);
+
+    size_t GetAvailableBytes() const { return ring_.Available(); }
+    uint32_t GetUnderruns() const { return ring_.GetUnderruns(); }
+    uint32_t GetOverruns() const { return ring_.GetOverruns(); }
+    // Pump calls that moved no data (timeout, disabled channel or driver error)
+    uint32_t GetErrors() const { return errors_; }
+};
+
+} // namespace wrapper
@@ -1,7 +1,101 @@
+#include <esp_attr.h>
+#include <esp_timer.h>
 #include "wrapper/i2s.hpp"
+#include "dsp/tdm.hpp"
 
 using namespace wrapper;
 
+// I2sHistogram Implementation
+
+uint32_t I2sHistogram::Total() const
+{
+    uint32_t total = 0;
+    for (uint32_t value : count) total += value;
+    return total;
+}
+
+uint32_t I2sHistogram::Percentile(float fraction) const
+{
+    uint32_t total = Total();
+    if (total == 0) return 0;
+    uint32_t target = (uint32_t)(fraction * total + 0.5f);
+    uint32_t sum = 0;
+    for (size_t b = 0; b < BUCKETS; ++b) {
+        sum += count[b];
+        if (sum >= target) return b == 0 ? 0 : 1u << b;
+    }
+    return 1u << (BUCKETS - 1);
+}
+
+// I2sChannelMonitor Implementation
+
+static void UpdateMax(std::atomic<uint32_t> &max, uint32_t value)
+{
+    if (value > max.load(std::memory_order_relaxed)) max.store(value, std::memory_order_relaxed);
+}
+
+void I2sChannelMonitor::Record(int64_t start_us, int64_t end_us, size_t size, size_t done, esp_err_t err)
+{
+    uint32_t call_us = (uint32_t)(end_us - start_us);
+    calls_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add((uint32_t)done, std::memory_order_relaxed);
+    if (done < size) partial_.fetch_add(1, std::memory_order_relaxed);
+    if (err == ESP_ERR_TIMEOUT) {
+        timeouts_.fetch_add(1, std::memory_order_relaxed);
+    } else if (err != ESP_OK) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+    }
+    UpdateMax(max_call_us_, call_us);
+    call_us_[I2sHistogram::Bucket(call_us)].fetch_add(1, std::memory_order_relaxed);
+    call_bytes_[I2sHistogram::Bucket((uint32_t)done)].fetch_add(1, std::memory_order_relaxed);
+
+    int64_t last_start_us = last_start_us_.exchange(start_us, std::memory_order_relaxed);
+    if (last_start_us != 0) {
+        uint32_t interval_us = (uint32_t)(start_us - last_start_us);
+        UpdateMax(max_interval_us_, interval_us);
+        interval_us_[I2sHistogram::Bucket(interval_us)].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void I2sChannelMonitor::Snapshot(I2sChannelStats &stats) const
+{
+    stats.calls = calls_.load(std::memory_order_relaxed);
+    stats.bytes = bytes_.load(std::memory_order_relaxed);
+    stats.partial = partial_.load(std::memory_order_relaxed);
+    stats.timeouts = timeouts_.load(std::memory_order_relaxed);
+    stats.errors = errors_.load(std::memory_order_relaxed);
+    stats.max_call_us = max_call_us_.load(std::memory_order_relaxed);
+    stats.max_interval_us = max_interval_us_.load(std::memory_order_relaxed);
+    stats.dma_events = dma_events_.load(std::memory_order_relaxed);
+    stats.queue_overflows = queue_overflows_.load(std::memory_order_relaxed);
+    for (size_t b = 0; b < I2sHistogram::BUCKETS; ++b) {
+        stats.call_us.count[b] = call_us_[b].load(std::memory_order_relaxed);
+        stats.call_bytes.count[b] = call_bytes_[b].load(std::memory_order_relaxed);
+        stats.interval_us.count[b] = interval_us_[b].load(std::memory_order_relaxed);
+    }
+}
+
+void I2sChannelMonitor::Reset()
+{
+    calls_ = 0;
+    bytes_ = 0;
+    partial_ = 0;
+    timeouts_ = 0;
+    errors_ = 0;
+    max_call_us_ = 0;
+    max_interval_us_ = 0;
+    dma_events_ = 0;
+    queue_overflows_ = 0;
+    for (size_t b = 0; b < I2sHistogram::BUCKETS; ++b) {
+        call_us_[b] = 0;
+        call_bytes_[b] = 0;
+        interval_us_[b] = 0;
+    }
+    last_start_us_ = 0;
+}
+
+// I2sBus Implementation
+
 I2sBus::~I2sBus()
 {
     Deinit();
@@ -33,6 +127,9 @@ bool I2sBus::Init(I2sBusConfig& bus_config)
     esp_err_t ret = i2s_new_channel(&bus_config, &tx_chan_handle_, &rx_chan_handle_);
     if (ret == ESP_OK) {
         port_ = bus_config.id;
+        dma_desc_num_ = bus_config.dma_desc_num;
+        dma_frame_num_ = bus_config.dma_frame_num;
+        ResetStats();
         logger_.Info("Initialized (Port: %d, Role: %d)", bus_config.id, bus_config.role);
         port_ = bus_config.id;
         return true;
@@ -57,6 +154,7 @@ bool I2sBus::ConfigureTxChannel(I2sChanStdConfig& chan_config)
     }
 
     tx_sample_rate_hz_ = chan_config.clk_cfg.sample_rate_hz;
+    tx_slot_count_ = chan_config.slot_cfg.slot_mode == I2S_SLOT_MODE_MONO ? 1 : 2;
     return true;
 }
 
@@ -74,6 +172,7 @@ bool I2sBus::ConfigureTxChannel(I2SChanTdmConfig& chan_config)
     }
 
     tx_sample_rate_hz_ = chan_config.clk_cfg.sample_rate_hz;
+    tx_slot_count_ = TdmSlotCount((uint32_t)chan_config.slot_cfg.slot_mask);
     return true;
 }
 
@@ -143,6 +242,9 @@ bool I2sBus::ConfigureRxChannel(I2sChanStdConfig& chan_config)
     }
 
     rx_sample_rate_hz_ = chan_config.clk_cfg.sample_rate_hz;
+    // Stereo always captures both slots, the mask only picks the mono slot
+    rx_slot_mask_ = chan_config.slot_cfg.slot_mode == I2S_SLOT_MODE_MONO ? (uint32_t)chan_config.slot_cfg.slot_mask : 0x3;
+    rx_slot_count_ = TdmSlotCount(rx_slot_mask_);
     return true;
 }
 
@@ -160,6 +262,8 @@ bool I2sBus::ConfigureRxChannel(I2SChanTdmConfig& chan_config)
     }
 
     rx_sample_rate_hz_ = chan_config.clk_cfg.sample_rate_hz;
+    rx_slot_mask_ = (uint32_t)chan_config.slot_cfg.slot_mask;
+    rx_slot_count_ = TdmSlotCount(rx_slot_mask_);
     return true;
 }
 
@@ -177,6 +281,8 @@ bool I2sBus::ConfigureRxChannel(I2sChanPdmRxConfig& chan_config)
     }
 
     rx_sample_rate_hz_ = chan_config.clk_cfg.sample_rate_hz;
+    rx_slot_mask_ = (uint32_t)chan_config.slot_cfg.slot_mask;
+    rx_slot_count_ = chan_config.slot_cfg.slot_mode == I2S_SLOT_MODE_MONO ? 1 : TdmSlotCount(rx_slot_mask_);
     return true;
 }
 
@@ -194,6 +300,7 @@ bool I2sBus::ConfigureTxChannel(I2sChanPdmTxConfig& chan_config)
     }
 
     tx_sample_rate_hz_ = chan_config.clk_cfg.sample_rate_hz;
+    tx_slot_count_ = chan_config.slot_cfg.slot_mode == I2S_SLOT_MODE_MONO ? 1 : 2;
     return true;
 }
 
@@ -203,7 +310,9 @@ bool I2sBus::Write(const void *src, size_t size, size_t &bytes_written, uint32_t
         logger_.Error("TX Channel handle is NULL.");
         return false;
     }
+    int64_t start_us = esp_timer_get_time();
     esp_err_t ret = i2s_channel_write(tx_chan_handle_, src, size, &bytes_written, timeout_ms);
+    tx_monitor_.Record(start_us, esp_timer_get_time(), size, bytes_written, ret);
     if (ret != ESP_OK) {
         logger_.Error("I2S Write Failed: %s", esp_err_to_name(ret));
         return false;
@@ -217,7 +326,9 @@ bool I2sBus::Read(void *dest, size_t size, size_t &bytes_read, uint32_t timeout_
         logger_.Error("RX Channel handle is NULL.");
         return false;
     }
+    int64_t start_us = esp_timer_get_time();
     esp_err_t ret = i2s_channel_read(rx_chan_handle_, dest, size, &bytes_read, timeout_ms);
+    rx_monitor_.Record(start_us, esp_timer_get_time(), size, bytes_read, ret);
     if (ret != ESP_OK) {
         logger_.Error("I2S Read Failed: %s", esp_err_to_name(ret));
         return false;
@@ -225,6 +336,107 @@ bool I2sBus::Read(void *dest, size_t size, size_t &bytes_read, uint32_t timeout_
     return true;
 }
 
+bool IRAM_ATTR I2sBus::OnSent(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx)
+{
+    auto *self = static_cast<I2sBus *>(user_ctx);
+    self->tx_monitor_.RecordDmaEvent();
+    auto callback = self->tx_monitor_.user_callbacks.on_sent;
+    return callback != nullptr && callback(handle, event, self->tx_monitor_.user_ctx);
+}
+
+bool IRAM_ATTR I2sBus::OnSendQueueOverflow(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx)
+{
+    auto *self = static_cast<I2sBus *>(user_ctx);
+    self->tx_monitor_.RecordQueueOverflow();
+    auto callback = self->tx_monitor_.user_callbacks.on_send_q_ovf;
+    return callback != nullptr && callback(handle, event, self->tx_monitor_.user_ctx);
+}
+
+bool IRAM_ATTR I2sBus::OnRecv(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx)
+{
+    auto *self = static_cast<I2sBus *>(user_ctx);
+    self->rx_monitor_.RecordDmaEvent();
+    auto callback = self->rx_monitor_.user_callbacks.on_recv;
+    return callback != nullptr && callback(handle, event, self->rx_monitor_.user_ctx);
+}
+
+bool IRAM_ATTR I2sBus::OnRecvQueueOverflow(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx)
+{
+    auto *self = static_cast<I2sBus *>(user_ctx);
+    self->rx_monitor_.RecordQueueOverflow();
+    auto callback = self->rx_monitor_.user_callbacks.on_recv_q_ovf;
+    return callback != nullptr && callback(handle, event, self->rx_monitor_.user_ctx);
+}
+
+bool I2sBus::EnableEventCallbacks(const i2s_event_callbacks_t *tx_user, const i2s_event_callbacks_t *rx_user, void *user_ctx)
+{
+    if (tx_chan_handle_ == NULL && rx_chan_handle_ == NULL) {
+        logger_.Error("No channel to register callbacks on. Call Init first.");
+        return false;
+    }
+    bool ok = true;
+    if (tx_chan_handle_ != NULL) {
+        tx_monitor_.user_callbacks = tx_user != nullptr ? *tx_user : i2s_event_callbacks_t{};
+        tx_monitor_.user_ctx = user_ctx;
+        i2s_event_callbacks_t callbacks = {};
+        callbacks.on_sent = OnSent;
+        callbacks.on_send_q_ovf = OnSendQueueOverflow;
+        esp_err_t ret = i2s_channel_register_event_callback(tx_chan_handle_, &callbacks, this);
+        if (ret != ESP_OK) {
+            logger_.Error("Failed to register TX callbacks: %s", esp_err_to_name(ret));
+            ok = false;
+        }
+    }
+    if (rx_chan_handle_ != NULL) {
+        rx_monitor_.user_callbacks = rx_user != nullptr ? *rx_user : i2s_event_callbacks_t{};
+        rx_monitor_.user_ctx = user_ctx;
+        i2s_event_callbacks_t callbacks = {};
+        callbacks.on_recv = OnRecv;
+        callbacks.on_recv_q_ovf = OnRecvQueueOverflow;
+        esp_err_t ret = i2s_channel_register_event_callback(rx_chan_handle_, &callbacks, this);
+        if (ret != ESP_OK) {
+            logger_.Error("Failed to register RX callbacks: %s", esp_err_to_name(ret));
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+void I2sBus::ResetStats()
+{
+    tx_monitor_.Reset();
+    rx_monitor_.Reset();
+}
+
+void I2sBus::LogChannelStats(const char *direction, const I2sChannelStats &stats, uint32_t sample_rate_hz) const
+{
+    // Time the whole DMA queue covers: the longest gap between calls must stay below it
+    uint32_t queue_us = sample_rate_hz == 0 ? 0 : (uint32_t)((uint64_t)dma_desc_num_ * dma_frame_num_ * 1000000 / sample_rate_hz);
+    logger_.Info("%s: %u calls, %u partial, %u timeouts, %u errors, %u DMA events, %u queue overflows", direction,
+                 (unsigned)stats.calls, (unsigned)stats.partial, (unsigned)stats.timeouts, (unsigned)stats.errors,
+                 (unsigned)stats.dma_events, (unsigned)stats.queue_overflows);
+    logger_.Info("%s: call us p50 <%u p99 <%u max %u, bytes p50 <%u max <%u", direction,
+                 (unsigned)stats.call_us.Percentile(0.5f), (unsigned)stats.call_us.Percentile(0.99f),
+                 (unsigned)stats.max_call_us, (unsigned)stats.call_bytes.Percentile(0.5f),
+                 (unsigned)stats.call_bytes.Percentile(1.0f));
+    logger_.Info("%s: interval us p50 <%u p99 <%u max %u, DMA queue %u x %u frames = %u us", direction,
+                 (unsigned)stats.interval_us.Percentile(0.5f), (unsigned)stats.interval_us.Percentile(0.99f),
+                 (unsigned)stats.max_interval_us, (unsigned)dma_desc_num_, (unsigned)dma_frame_num_, (unsigned)queue_us);
+}
+
+void I2sBus::LogStats() const
+{
+    I2sChannelStats stats;
+    if (tx_chan_handle_ != NULL) {
+        GetTxStats(stats);
+        LogChannelStats("TX", stats, tx_sample_rate_hz_);
+    }
+    if (rx_chan_handle_ != NULL) {
+        GetRxStats(stats);
+        LogChannelStats("RX", stats, rx_sample_rate_hz_);
+    }
+}
+
 bool I2sBus::Write(const std::vector<uint8_t>& data, uint32_t timeout_ms)
 {
     size_t bytes_written = 0;
@@ -4,6 +4,7 @@
 #include "driver/i2s_tdm.h"
 #include "driver/i2s_pdm.h"
 #include "wrapper/logger.hpp"
+#include <atomic>
 #include <vector>
 
 namespace wrapper
@@ -218,6 +219,71 @@ struct I2sChanPdmTxConfig : public i2s_pdm_tx_config_t
     }
 };
 
+/**
+ * @brief Log2 histogram: bucket 0 counts zeros, bucket b counts [2^(b-1), 2^b),
+ * the last bucket also takes everything larger
+ */
+struct I2sHistogram
+{
+    static constexpr size_t BUCKETS = 20;
+    uint32_t count[BUCKETS] = {};
+
+    static size_t Bucket(uint32_t value)
+    {
+        size_t bucket = value == 0 ? 0 : 32 - __builtin_clz(value);
+        return bucket < BUCKETS ? bucket : BUCKETS - 1;
+    }
+
+    uint32_t Total() const;
+    // Upper bound of the bucket holding the given fraction (0..1) of the samples
+    uint32_t Percentile(float fraction) const;
+};
+
+// Snapshot of one direction, see I2sBus::GetTxStats/GetRxStats
+struct I2sChannelStats
+{
+    uint32_t calls = 0;
+    uint32_t bytes = 0;           // wraps
+    uint32_t partial = 0;         // fewer bytes transferred than asked
+    uint32_t timeouts = 0;
+    uint32_t errors = 0;          // other driver errors
+    uint32_t max_call_us = 0;
+    uint32_t max_interval_us = 0; // longest gap between two call starts
+    uint32_t dma_events = 0;      // on_sent/on_recv, with event callbacks enabled
+    uint32_t queue_overflows = 0; // TX: DMA ran out of data, RX: captured data was dropped
+    I2sHistogram call_us;
+    I2sHistogram call_bytes;
+    I2sHistogram interval_us;
+};
+
+// Live counters, updated lock-free by Write/Read and the DMA ISR
+class I2sChannelMonitor
+{
+    std::atomic<uint32_t> calls_{0};
+    std::atomic<uint32_t> bytes_{0};
+    std::atomic<uint32_t> partial_{0};
+    std::atomic<uint32_t> timeouts_{0};
+    std::atomic<uint32_t> errors_{0};
+    std::atomic<uint32_t> max_call_us_{0};
+    std::atomic<uint32_t> max_interval_us_{0};
+    std::atomic<uint32_t> dma_events_{0};
+    std::atomic<uint32_t> queue_overflows_{0};
+    std::atomic<uint32_t> call_us_[I2sHistogram::BUCKETS] = {};
+    std::atomic<uint32_t> call_bytes_[I2sHistogram::BUCKETS] = {};
+    std::atomic<uint32_t> interval_us_[I2sHistogram::BUCKETS] = {};
+    std::atomic<int64_t> last_start_us_{0}; // Reset may run on another task than Record
+
+public:
+    i2s_event_callbacks_t user_callbacks = {};
+    void *user_ctx = nullptr;
+
+    void Record(int64_t start_us, int64_t end_us, size_t size, size_t done, esp_err_t err);
+    void RecordDmaEvent() { dma_events_.fetch_add(1, std::memory_order_relaxed); }
+    void RecordQueueOverflow() { queue_overflows_.fetch_add(1, std::memory_order_relaxed); }
+    void Snapshot(I2sChannelStats &stats) const;
+    void Reset();
+};
+
 class I2sBus
 {
     Logger& logger_;
@@ -226,6 +292,19 @@ class I2sBus
     i2s_chan_handle_t rx_chan_handle_ = NULL;
     uint32_t tx_sample_rate_hz_ = 0;
     uint32_t rx_sample_rate_hz_ = 0;
+    size_t tx_slot_count_ = 0;
+    uint32_t rx_slot_mask_ = 0;
+    size_t rx_slot_count_ = 0;
+    uint32_t dma_desc_num_ = 0;
+    uint32_t dma_frame_num_ = 0;
+    I2sChannelMonitor tx_monitor_;
+    I2sChannelMonitor rx_monitor_;
+
+    static bool OnSent(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx);
+    static bool OnSendQueueOverflow(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx);
+    static bool OnRecv(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx);
+    static bool OnRecvQueueOverflow(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx);
+    void LogChannelStats(const char *direction, const I2sChannelStats &stats, uint32_t sample_rate_hz) const;
 public:
     I2sBus(Logger& logger) : logger_(logger) {}
     ~I2sBus();
@@ -255,6 +334,30 @@ public:
     i2s_chan_handle_t GetRxHandle() const { return rx_chan_handle_; }
     uint32_t GetTxSampleRate() const { return tx_sample_rate_hz_; }
     uint32_t GetRxSampleRate() const { return rx_sample_rate_hz_; }
+    // Slots present in each RX frame, for TdmRoute/TdmDeinterleave
+    uint32_t GetRxSlotMask() const { return rx_slot_mask_; }
+    size_t GetRxSlotCount() const { return rx_slot_count_; }
+    // Samples per TX frame, for playback processing
+    size_t GetTxSlotCount() const { return tx_slot_count_; }
+    uint32_t GetDmaDescNum() const { return dma_desc_num_; }
+    uint32_t GetDmaFrameNum() const { return dma_frame_num_; }
+
+    /**
+     * @brief Counts DMA completions and queue overflows (xruns) from the I2S ISR
+     *
+     * Must be called after Init and before the channels are enabled. The driver
+     * takes one set of callbacks per channel, so user callbacks are passed here
+     * and chained after the counters. They run in ISR context.
+     */
+    bool EnableEventCallbacks(const i2s_event_callbacks_t *tx_user = nullptr,
+                              const i2s_event_callbacks_t *rx_user = nullptr, void *user_ctx = nullptr);
+
+    // Write/Read statistics, always collected (two timer reads and a few atomic adds per call)
+    void GetTxStats(I2sChannelStats &stats) const { tx_monitor_.Snapshot(stats); }
+    void GetRxStats(I2sChannelStats &stats) const { rx_monitor_.Snapshot(stats); }
+    void ResetStats();
+    // Logs both directions next to the DMA queue length, to size dma_desc_num/dma_frame_num
+    void LogStats() const;
 };
 
 }; // namespace wrapper
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+namespace wrapper
+{
+
+/**
+ * @brief Contiguous region inside a ring buffer
+ */
+struct RingSpan
+{
+    uint8_t *data = nullptr;
+    size_t size = 0;
+};
+
+/**
+ * @brief Lock-free single-producer / single-consumer byte ring
+ *
+ * Capacity is rounded up to a power of two. Head and tail are free-running
+ * counters: the producer publishes with a release store on head_, the consumer
+ * with a release store on tail_, and each side reads the other's index with
+ * acquire. Exactly one task may write and exactly one task may read.
+ *
+ * Zero-copy use: GetWriteSpan()/CommitWrite() on the producer side,
+ * GetReadSpan()/CommitRead() on the consumer side.
+ */
+class SpscRingBuffer
+{
+    uint8_t *buffer_ = nullptr;
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+    bool owns_buffer_ = false;
+
+    alignas(4) std::atomic<size_t> head_{0};
+    alignas(4) std::atomic<size_t> tail_{0};
+
+    std::atomic<uint32_t> overruns_{0};
+    std::atomic<uint32_t> underruns_{0};
+
+    static size_t RoundUpPow2(size_t value)
+    {
+        size_t pow2 = 1;
+        while (pow2 < value) pow2 <<= 1;
+        return pow2;
+    }
+
+public:
+    SpscRingBuffer() = default;
+    ~SpscRingBuffer() { Deinit(); }
+
+    SpscRingBuffer(const SpscRingBuffer &) = delete;
+    SpscRingBuffer &operator=(const SpscRingBuffer &) = delete;
+
+    // Allocates max(capacity, 2) rounded up to a power of two
+    bool Init(size_t capacity)
+    {
+        Deinit();
+        capacity = RoundUpPow2(capacity < 2 ? 2 : capacity);
+        buffer_ = new (std::nothrow) uint8_t[capacity];
+        if (buffer_ == nullptr) return false;
+        owns_buffer_ = true;
+        capacity_ = capacity;
+        mask_ = capacity - 1;
+        Reset();
+        return true;
+    }
+
+    // Uses caller storage (e.g. PSRAM or a static array), capacity must be a power of two
+    bool Init(uint8_t *storage, size_t capacity)
+    {
+        Deinit();
+        if (storage == nullptr || capacity < 2 || (capacity & (capacity - 1)) != 0) return false;
+        buffer_ = storage;
+        owns_buffer_ = false;
+        capacity_ = capacity;
+        mask_ = capacity - 1;
+        Reset();
+        return true;
+    }
+
+    void Deinit()
+    {
+        if (owns_buffer_) delete[] buffer_;
+        buffer_ = nullptr;
+        owns_buffer_ = false;
+        capacity_ = 0;
+        mask_ = 0;
+    }
+
+    // Only safe while neither side is active
+    void Reset()
+    {
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+        overruns_.store(0, std::memory_order_relaxed);
+        underruns_.store(0, std::memory_order_relaxed);
+    }
+
+    bool IsValid() const { return buffer_ != nullptr; }
+    size_t Capacity() const { return capacity_; }
+
+    // Bytes ready for the consumer
+    size_t Available() const
+    {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    // Bytes the producer may still write
+    size_t Free() const { return capacity_ - Available(); }
+
+    // Producer side
+
+    RingSpan GetWriteSpan() const
+    {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        size_t free = capacity_ - (head - tail);
+        size_t offset = head & mask_;
+        size_t contiguous = capacity_ - offset;
+        return RingSpan{buffer_ + offset, free < contiguous ? free : contiguous};
+    }
+
+    void CommitWrite(size_t size)
+    {
+        head_.store(head_.load(std::memory_order_relaxed) + size, std::memory_order_release);
+    }
+
+    // Copies as much as fits, counts an overrun if data had to be dropped
+    size_t Write(const void *data, size_t size)
+    {
+        const uint8_t *src = static_cast<const uint8_t *>(data);
+        size_t written = 0;
+        while (written < size) {
+            RingSpan span = GetWriteSpan();
+            if (span.size == 0) break;
+            size_t chunk = size - written < span.size ? size - written : span.size;
+            memcpy(span.data, src + written, chunk);
+            CommitWrite(chunk);
+            written += chunk;
+        }
+        if (written < size) MarkOverrun();
+        return written;
+    }
+
+    // Consumer side
+
+    RingSpan GetReadSpan() const
+    {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t available = head - tail;
+        size_t offset = tail & mask_;
+        size_t contiguous = capacity_ - offset;
+        return RingSpan{buffer_ + offset, available < contiguous ? available : contiguous};
+    }
+
+    void CommitRead(size_t size)
+    {
+        tail_.store(tail_.load(std::memory_order_relaxed) + size, std::memory_order_release);
+    }
+
+    // Copies up to size bytes, counts an underrun if fewer were available
+    size_t Read(void *data, size_t size)
+    {
+        uint8_t *dst = static_cast<uint8_t *>(data);
+        size_t read = 0;
+        while (read < size) {
+            RingSpan span = GetReadSpan();
+            if (span.size == 0) break;
+            size_t chunk = size - read < span.size ? size - read : span.size;
+            memcpy(dst + read, span.data, chunk);
+            CommitRead(chunk);
+            read += chunk;
+        }
+        if (read < size) MarkUnderrun();
+        return read;
+    }
+
+    // Copies up to size bytes without consuming them (e.g. a packet header)
+    size_t Peek(void *data, size_t size) const
+    {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t available = head_.load(std::memory_order_acquire) - tail;
+        if (size > available) size = available;
+        size_t offset = tail & mask_;
+        size_t first = capacity_ - offset < size ? capacity_ - offset : size;
+        memcpy(data, buffer_ + offset, first);
+        memcpy(static_cast<uint8_t *>(data) + first, buffer_, size - first);
+        return size;
+    }
+
+    // Counters, also bumped by span users that detect the condition themselves
+    void MarkOverrun() { overruns_.fetch_add(1, std::memory_order_relaxed); }
+    void MarkUnderrun() { underruns_.fetch_add(1, std::memory_order_relaxed); }
+    uint32_t GetOverruns() const { return overruns_.load(std::memory_order_relaxed); }
+    uint32_t GetUnderruns() const { return underruns_.load(std::memory_order_relaxed); }
+};
+
+} // namespace wrapper
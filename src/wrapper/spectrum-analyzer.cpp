@@ -0,0 +1,44 @@
+#include <esp_timer.h>
+#include "wrapper/spectrum-analyzer.hpp"
+
+namespace wrapper
+{
+
+bool SpectrumAnalyzer::Init(uint32_t sample_rate, size_t fft_size, bool fixed_point)
+{
+    if (IsRunning()) {
+        logger_.Error("Cannot re-init while running");
+        return false;
+    }
+    if (!spectrum_.Init(sample_rate, fft_size, fixed_point)) {
+        logger_.Error("Invalid spectrum config (%u Hz, %u points)", (unsigned)sample_rate, (unsigned)fft_size);
+        return false;
+    }
+    logger_.Info("Spectrum analyzer: %u points at %u Hz (%s)", (unsigned)fft_size, (unsigned)sample_rate,
+                 fixed_point ? "fixed point" : "float");
+    return true;
+}
+
+SpectrumResult SpectrumAnalyzer::Process(const SpectrumRequest &req)
+{
+    SpectrumResult result;
+    if (req.samples == nullptr || req.channels == 0 || req.channel >= req.channels || spectrum_.GetSize() == 0) {
+        return result;
+    }
+
+    int64_t start = esp_timer_get_time();
+    spectrum_.Analyze(req.samples + req.channel, req.channels, req.frames);
+    result.process_us = (uint32_t)(esp_timer_get_time() - start);
+
+    result.valid = true;
+    result.peak_hz = spectrum_.GetPeakHz();
+    result.peak_db = spectrum_.GetPeakDb();
+    result.rms_db = spectrum_.GetRmsDb();
+    result.band_count = spectrum_.GetBandCount();
+    for (size_t i = 0; i < result.band_count; ++i) result.bands_db[i] = spectrum_.GetBandDb(i);
+    result.magnitudes = spectrum_.GetMagnitudes();
+    result.bin_count = spectrum_.GetBinCount();
+    return result;
+}
+
+} // namespace wrapper
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "wrapper/logger.hpp"
+#include "wrapper/freertos.hpp"
+#include "dsp/spectrum.hpp"
+
+namespace wrapper
+{
+
+// Samples stay owned by the caller until the matching result arrives
+struct SpectrumRequest
+{
+    const int16_t *samples = nullptr;
+    size_t frames = 0;
+    size_t channels = 1;
+    size_t channel = 0;
+};
+
+struct SpectrumResult
+{
+    bool valid = false;
+    float peak_hz = 0.0f;
+    float peak_db = -120.0f;
+    float rms_db = -120.0f;
+    size_t band_count = 0;
+    float bands_db[Spectrum::MAX_BANDS] = {};
+    const float *magnitudes = nullptr; // owned by the analyser, valid until the next request is processed
+    size_t bin_count = 0;
+    uint32_t process_us = 0;
+};
+
+/**
+ * @brief Spectrum analysis on its own task, e.g. for display meters
+ *
+ * Init before Start; requests carry a pointer to captured frames and each
+ * produces one SpectrumResult.
+ */
+class SpectrumAnalyzer : public Service<SpectrumRequest, SpectrumResult>
+{
+    Logger &logger_;
+    Spectrum spectrum_;
+
+protected:
+    SpectrumResult Process(const SpectrumRequest &req) override;
+
+public:
+    SpectrumAnalyzer(Logger &logger) : logger_(logger) {}
+
+    Logger &GetLogger() const { return logger_; }
+
+    bool Init(uint32_t sample_rate, size_t fft_size, bool fixed_point = false);
+
+    // Only while stopped
+    Spectrum &GetSpectrum() { return spectrum_; }
+};
+
+} // namespace wrapper
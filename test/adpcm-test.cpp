@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "test.hpp"
+#include "dsp/adpcm.hpp"
+
+using namespace wrapper;
+
+static constexpr uint32_t RATE = 16000;
+
+static_assert(ImaAdpcm::BlockSize(1, 505) == 256 && ImaAdpcm::FrameSamples(1, 256) == 505, "mono 256 byte block");
+static_assert(ImaAdpcm::BlockSize(2, 249) == 256 && ImaAdpcm::FrameSamples(2, 256) == 249, "stereo 256 byte block");
+
+// Speech-band tones per channel, left and right distinct
+static std::vector<int16_t> Tones(size_t frames, size_t channels, float amplitude)
+{
+    std::vector<int16_t> pcm(frames * channels);
+    for (size_t f = 0; f < frames; ++f) {
+        for (size_t ch = 0; ch < channels; ++ch) {
+            float f0 = ch == 0 ? 440.0f : 1250.0f;
+            float t = (float)f / RATE;
+            float v = 0.6f * sinf(2.0f * (float)M_PI * f0 * t) + 0.3f * sinf(2.0f * (float)M_PI * 2.7f * f0 * t);
+            pcm[f * channels + ch] = (int16_t)lrintf(amplitude * v);
+        }
+    }
+    return pcm;
+}
+
+static double SnrDb(const std::vector<int16_t> &ref, const std::vector<int16_t> &out, size_t channels, size_t ch)
+{
+    double signal = 0, noise = 0;
+    for (size_t i = ch; i < ref.size(); i += channels) {
+        signal += (double)ref[i] * ref[i];
+        noise += (double)(out[i] - ref[i]) * (out[i] - ref[i]);
+    }
+    return 10.0 * log10(signal / noise);
+}
+
+// Encodes whole blocks and decodes them back, one packet at a time
+static std::vector<int16_t> RoundTrip(const std::vector<int16_t> &pcm, size_t channels, size_t frame_samples)
+{
+    ImaAdpcmEncoder encoder;
+    ImaAdpcmDecoder decoder;
+    CHECK(encoder.Init(channels, frame_samples));
+    CHECK(decoder.Init(channels, frame_samples));
+    const size_t block_size = encoder.GetMaxPacketSize();
+    std::vector<uint8_t> packet(block_size);
+    std::vector<int16_t> out(pcm.size());
+    for (size_t i = 0; i + frame_samples * channels <= pcm.size(); i += frame_samples * channels) {
+        CHECK_EQ(encoder.Encode(&pcm[i], packet.data(), packet.size()), block_size);
+        CHECK_EQ(decoder.Decode(packet.data(), block_size, &out[i], frame_samples), frame_samples);
+    }
+    return out;
+}
+
+static void TestRoundTripSnr()
+{
+    for (size_t channels : {1, 2}) {
+        const size_t frame_samples = ImaAdpcm::FrameSamples(channels, 256);
+        const size_t frames = frame_samples * 64;
+        for (float amplitude : {20000.0f, 1000.0f}) {
+            std::vector<int16_t> pcm = Tones(frames, channels, amplitude);
+            std::vector<int16_t> out = RoundTrip(pcm, channels, frame_samples);
+            for (size_t ch = 0; ch < channels; ++ch) {
+                double snr = SnrDb(pcm, out, channels, ch);
+                printf("%zu ch, amplitude %.0f, channel %zu: SNR %.1f dB\n", channels, amplitude, ch, snr);
+                // About 6 dB per bit of a 4 bit quantiser that tracks the signal's slope
+                CHECK(snr > 20.0);
+            }
+        }
+    }
+
+    // Digital silence stays exact: the smallest step rounds to a zero difference
+    std::vector<int16_t> silence(505 * 4, 0);
+    CHECK(RoundTrip(silence, 1, 505) == silence);
+}
+
+// Reference layout from the Microsoft IMA spec: per channel header, then 4 byte groups of 8 samples
+// taking turns between channels, low nibble first
+static void TestBlockLayout()
+{
+    for (size_t channels : {1, 2}) {
+        const size_t frame_samples = ImaAdpcm::FrameSamples(channels, 256);
+        std::vector<int16_t> pcm = Tones(frame_samples * 2, channels, 12000.0f);
+        ImaAdpcmEncoder encoder;
+        CHECK(encoder.Init(channels, frame_samples));
+        CHECK_EQ(encoder.GetMaxPacketSize(), 256);
+
+        ImaAdpcmState state[ImaAdpcm::MAX_CHANNELS];
+        for (size_t block = 0; block < 2; ++block) {
+            const int16_t *in = &pcm[block * frame_samples * channels];
+            std::vector<uint8_t> packet(256);
+            CHECK_EQ(encoder.Encode(in, packet.data(), packet.size()), 256);
+
+            std::vector<uint8_t> expected;
+            for (size_t ch = 0; ch < channels; ++ch) {
+                // The step index carries over from the previous block
+                state[ch].predictor = in[ch];
+                expected.push_back((uint8_t)(in[ch] & 0xFF));
+                expected.push_back((uint8_t)((uint16_t)in[ch] >> 8));
+                expected.push_back((uint8_t)state[ch].index);
+                expected.push_back(0);
+            }
+            CHECK(block == 0 || state[0].index > 0);
+            for (size_t group = 0; group < (frame_samples - 1) / 8; ++group) {
+                for (size_t ch = 0; ch < channels; ++ch) {
+                    for (size_t i = 0; i < 8; i += 2) {
+                        size_t frame = 1 + group * 8 + i;
+                        uint8_t lo = ImaAdpcm::EncodeSample(state[ch], in[frame * channels + ch]);
+                        uint8_t hi = ImaAdpcm::EncodeSample(state[ch], in[(frame + 1) * channels + ch]);
+                        expected.push_back((uint8_t)(lo | hi << 4));
+                    }
+                }
+            }
+            CHECK(packet == expected);
+
+            // And the decoder reads the same layout back
+            ImaAdpcmDecoder decoder;
+            CHECK(decoder.Init(channels, frame_samples));
+            std::vector<int16_t> out(frame_samples * channels);
+            CHECK_EQ(decoder.Decode(packet.data(), packet.size(), out.data(), frame_samples), frame_samples);
+            for (size_t ch = 0; ch < channels; ++ch) {
+                CHECK_EQ(out[ch], in[ch]);
+                ImaAdpcmState replay;
+                replay.predictor = in[ch];
+                replay.index = packet[ch * 4 + 2];
+                for (size_t frame = 1; frame < frame_samples; ++frame) {
+                    size_t group = (frame - 1) / 8, i = (frame - 1) % 8;
+                    uint8_t byte = packet[4 * channels + (group * channels + ch) * 4 + i / 2];
+                    CHECK_EQ(out[frame * channels + ch], ImaAdpcm::DecodeSample(replay, i % 2 ? byte >> 4 : byte & 0x0F));
+                }
+            }
+        }
+    }
+}
+
+// A WAV file's last block may be cut after any whole group: it decodes as the prefix of the full block
+static void TestShortFinalBlock()
+{
+    for (size_t channels : {1, 2}) {
+        const size_t frame_samples = ImaAdpcm::FrameSamples(channels, 256);
+        std::vector<int16_t> pcm = Tones(frame_samples, channels, 12000.0f);
+        ImaAdpcmEncoder encoder;
+        ImaAdpcmDecoder decoder;
+        CHECK(encoder.Init(channels, frame_samples));
+        CHECK(decoder.Init(channels, frame_samples));
+        std::vector<uint8_t> packet(256);
+        CHECK_EQ(encoder.Encode(pcm.data(), packet.data(), packet.size()), 256);
+        std::vector<int16_t> full(frame_samples * channels);
+        CHECK_EQ(decoder.Decode(packet.data(), 256, full.data(), frame_samples), frame_samples);
+
+        for (size_t groups = 0; groups < (frame_samples - 1) / 8; ++groups) {
+            const size_t size = 4 * channels * (groups + 1);
+            const size_t frames = 1 + groups * 8;
+            std::vector<int16_t> out(frame_samples * channels, 0x5555);
+            CHECK_EQ(decoder.Decode(packet.data(), size, out.data(), frames), frames);
+            CHECK(std::equal(out.begin(), out.begin() + frames * channels, full.begin()));
+            CHECK_EQ(out[frames * channels], 0x5555);
+            // No room for the whole block: nothing is written
+            CHECK_EQ(decoder.Decode(packet.data(), size, out.data(), frames - 1), 0);
+        }
+
+        // Partial groups, a missing header or an oversized packet are malformed
+        CHECK_EQ(decoder.Decode(packet.data(), 4 * channels - 1, full.data(), frame_samples), 0);
+        CHECK_EQ(decoder.Decode(packet.data(), 4 * channels + 2, full.data(), frame_samples), 0);
+        packet.resize(256 + 4 * channels);
+        CHECK_EQ(decoder.Decode(packet.data(), packet.size(), full.data(), 2 * frame_samples), 0);
+    }
+}
+
+static void TestInit()
+{
+    ImaAdpcmEncoder encoder;
+    ImaAdpcmDecoder decoder;
+    CHECK(!encoder.Init(0));
+    CHECK(!encoder.Init(3));
+    CHECK(!encoder.Init(1, 504));
+    CHECK(!decoder.Init(2, 1));
+    CHECK(encoder.Init(2, 9));
+    CHECK_EQ(encoder.GetMaxPacketSize(), 16);
+    int16_t pcm[18] = {};
+    uint8_t packet[16];
+    CHECK_EQ(encoder.Encode(pcm, packet, 15), 0);
+    CHECK_EQ(encoder.Encode(pcm, packet, 16), 16);
+}
+
+int main()
+{
+    RUN(TestRoundTripSnr);
+    RUN(TestBlockLayout);
+    RUN(TestShortFinalBlock);
+    RUN(TestInit);
+    return 0;
+}
@@ -0,0 +1,202 @@
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "test.hpp"
+#include "dsp/aec.hpp"
+#include "dsp/pcm.hpp"
+
+using namespace wrapper;
+
+static constexpr uint32_t RATE = 16000;
+static constexpr size_t BLOCK = 160; // 10 ms
+
+// Deterministic white noise in [-1, 1)
+struct Noise
+{
+    uint32_t state;
+    explicit Noise(uint32_t seed) : state(seed) {}
+    float Next()
+    {
+        state = state * 1664525u + 1013904223u;
+        return (float)(int32_t)state / 2147483648.0f;
+    }
+};
+
+// Room-like echo path: bulk delay, then a decaying random tail, -12 dB overall
+static std::vector<float> EchoPath(size_t delay, size_t tail)
+{
+    Noise noise(7);
+    std::vector<float> h(delay + tail, 0.0f);
+    float energy = 0.0f;
+    for (size_t k = 0; k < tail; ++k) {
+        h[delay + k] = noise.Next() * expf(-4.0f * k / tail);
+        energy += h[delay + k] * h[delay + k];
+    }
+    for (float &tap : h) tap *= 0.25f / sqrtf(energy);
+    return h;
+}
+
+// Far end through the echo path, plus optional near-end noise
+static std::vector<int16_t> Echo(const std::vector<int16_t> &far, const std::vector<float> &h, float near_rms)
+{
+    Noise noise(99);
+    std::vector<int16_t> mic(far.size());
+    for (size_t i = 0; i < far.size(); ++i) {
+        float acc = near_rms * 1.7320508f * noise.Next();
+        for (size_t k = 0; k < h.size() && k <= i; ++k) acc += h[k] * far[i - k];
+        mic[i] = (int16_t)lrintf(acc);
+    }
+    return mic;
+}
+
+static std::vector<int16_t> FarEnd(size_t count, float rms)
+{
+    Noise noise(1);
+    std::vector<int16_t> far(count);
+    for (int16_t &s : far) s = (int16_t)lrintf(rms * 1.7320508f * noise.Next());
+    return far;
+}
+
+static double EnergyDb(const std::vector<int16_t> &a, const std::vector<int16_t> &b, size_t from, size_t to)
+{
+    double ea = 0, eb = 0;
+    for (size_t i = from; i < to; ++i) {
+        ea += (double)a[i] * a[i];
+        eb += (double)b[i] * b[i];
+    }
+    return 10.0 * log10(ea / eb);
+}
+
+// After two seconds of far-end noise the echo must be well below the microphone level
+static void TestErleAfterConvergence()
+{
+    const size_t count = RATE * 3;
+    std::vector<float> h = EchoPath(24, 200);
+    std::vector<int16_t> far = FarEnd(count, 3000);
+    std::vector<int16_t> mic = Echo(far, h, 3.0f);
+
+    Aec aec;
+    CHECK(aec.Init(AecConfig(256)));
+    std::vector<int16_t> out(count);
+    for (size_t i = 0; i < count; i += BLOCK) aec.ProcessMono(&mic[i], &far[i], &out[i], BLOCK);
+
+    double first = EnergyDb(mic, out, 0, RATE / 10);
+    double last = EnergyDb(mic, out, count - RATE, count);
+    printf("ERLE: first 100 ms %.1f dB, last second %.1f dB, reported %.1f dB\n", first, last, aec.GetErleDb());
+    CHECK(last > 25.0);
+    CHECK(last > first + 10.0);
+    CHECK(fabs(aec.GetErleDb() - last) < 6.0);
+    CHECK_EQ(aec.GetDoubleTalkSamples(), 0);
+}
+
+// A path longer than the taps is reached through the bulk delay
+static void TestBulkDelay()
+{
+    const size_t count = RATE * 3;
+    std::vector<float> h = EchoPath(300, 120);
+    std::vector<int16_t> far = FarEnd(count, 3000);
+    std::vector<int16_t> mic = Echo(far, h, 3.0f);
+
+    double erle[2];
+    for (size_t delay : {0, 280}) {
+        Aec aec;
+        CHECK(aec.Init(AecConfig(160, delay)));
+        std::vector<int16_t> out(count);
+        for (size_t i = 0; i < count; i += BLOCK) aec.ProcessMono(&mic[i], &far[i], &out[i], BLOCK);
+        erle[delay > 0] = EnergyDb(mic, out, count - RATE, count);
+    }
+    printf("300 sample delay, 160 taps: ERLE %.1f dB without bulk delay, %.1f dB with\n", erle[0], erle[1]);
+    CHECK(erle[0] < 3.0);
+    CHECK(erle[1] > 25.0);
+}
+
+// Near-end speech freezes adaptation, so it is passed through and the filter keeps its echo estimate
+static void TestDoubleTalkFreezes()
+{
+    const size_t count = RATE * 4;
+    std::vector<float> h = EchoPath(24, 200);
+    std::vector<int16_t> far = FarEnd(count, 3000);
+    std::vector<int16_t> mic = Echo(far, h, 3.0f);
+    std::vector<int16_t> near(count, 0);
+    Noise noise(5);
+    const size_t talk_from = RATE * 2, talk_to = RATE * 3;
+    for (size_t i = talk_from; i < talk_to; ++i) {
+        near[i] = (int16_t)lrintf(9000.0f * sinf(2.0f * (float)M_PI * 300.0f * i / RATE) + 2000.0f * noise.Next());
+        mic[i] = PcmSaturate16(mic[i] + near[i]);
+    }
+
+    Aec aec;
+    CHECK(aec.Init(AecConfig(256)));
+    std::vector<int16_t> out(count);
+    for (size_t i = 0; i < count; i += BLOCK) aec.ProcessMono(&mic[i], &far[i], &out[i], BLOCK);
+    CHECK(aec.GetDoubleTalkSamples() >= talk_to - talk_from);
+
+    // Near end survives: what is left after cancellation is mostly the talker
+    std::vector<int16_t> residual(count);
+    for (size_t i = 0; i < count; ++i) residual[i] = (int16_t)(out[i] - near[i]);
+    double near_to_residual = EnergyDb(near, residual, talk_from, talk_to);
+    // And the echo estimate was not wrecked by adapting on it
+    double after = EnergyDb(mic, out, talk_to + RATE / 2, count);
+    printf("double talk: near-end to residual %.1f dB, ERLE after %.1f dB\n", near_to_residual, after);
+    CHECK(near_to_residual > 20.0);
+    CHECK(after > 20.0);
+}
+
+// Reference through Observe (stereo playback), capture through Process on stereo frames
+static void TestMonitorAndProcessor()
+{
+    const size_t count = RATE * 3;
+    std::vector<float> h = EchoPath(24, 200);
+    std::vector<int16_t> far = FarEnd(count, 3000);
+    std::vector<int16_t> mic = Echo(far, h, 3.0f);
+
+    Aec aec;
+    CHECK(aec.Init(AecConfig(256)));
+    std::vector<int16_t> playback(BLOCK * 2), capture(BLOCK * 2), out(count);
+    for (size_t i = 0; i < count; i += BLOCK) {
+        for (size_t j = 0; j < BLOCK; ++j) {
+            playback[j * 2] = playback[j * 2 + 1] = far[i + j];
+            capture[j * 2] = mic[i + j];
+            capture[j * 2 + 1] = 1234;
+        }
+        aec.Observe(playback.data(), BLOCK, 2);
+        aec.Process(capture.data(), BLOCK, 2);
+        for (size_t j = 0; j < BLOCK; ++j) {
+            CHECK_EQ(capture[j * 2 + 1], capture[j * 2]);
+            out[i + j] = capture[j * 2];
+        }
+    }
+    double erle = EnergyDb(mic, out, count - RATE, count);
+    printf("through Observe/Process: ERLE %.1f dB\n", erle);
+    CHECK(erle > 25.0);
+    CHECK_EQ(aec.GetReferenceUnderruns(), 0);
+    CHECK_EQ(aec.GetBacklogDrops(), 0);
+}
+
+static void BenchProcess()
+{
+    const size_t count = RATE * 4;
+    std::vector<int16_t> far = FarEnd(count, 3000);
+    std::vector<int16_t> mic = Echo(far, EchoPath(24, 200), 3.0f);
+    for (size_t taps : {128, 256, 512}) {
+        Aec aec;
+        CHECK(aec.Init(AecConfig(taps)));
+        std::vector<int16_t> out(count);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; i += BLOCK) aec.ProcessMono(&mic[i], &far[i], &out[i], BLOCK);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("%zu taps: %.1f us per 10 ms block, %.0fx realtime\n", taps, elapsed * 1e6 / (count / BLOCK),
+               (double)count / RATE / elapsed);
+        CHECK((double)count / RATE / elapsed > 5.0);
+    }
+}
+
+int main()
+{
+    RUN(TestErleAfterConvergence);
+    RUN(TestBulkDelay);
+    RUN(TestDoubleTalkFreezes);
+    RUN(TestMonitorAndProcessor);
+    RUN(BenchProcess);
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include <cmath>
+#include <vector>
+#include "test.hpp"
+#include "dsp/agc.hpp"
+
+using namespace wrapper;
+
+static constexpr uint32_t RATE = 48000;
+static constexpr size_t CHANNELS = 2;
+static constexpr size_t BLOCK = 480;
+
+// Stereo sine whose RMS is rms_dbfs, continuing the phase across calls
+struct Tone
+{
+    double phase = 0;
+    void Fill(int16_t *block, size_t frames, float rms_dbfs)
+    {
+        double amplitude = 32768.0 * pow(10.0, (rms_dbfs + 3.0103) / 20.0);
+        for (size_t i = 0; i < frames; ++i) {
+            int16_t v = (int16_t)lrint(amplitude * sin(phase));
+            block[i * CHANNELS] = v;
+            block[i * CHANNELS + 1] = v;
+            phase += 2.0 * M_PI * 1000.0 / RATE;
+        }
+    }
+};
+
+static float RmsDb(const std::vector<int16_t> &samples)
+{
+    double sum = 0;
+    for (int16_t s : samples) sum += (double)s * s;
+    return (float)(10.0 * log10(sum / samples.size() / (32768.0 * 32768.0)));
+}
+
+// Runs seconds of tone through the AGC, returns the output of the last second
+static std::vector<int16_t> Run(Agc &agc, Tone &tone, float rms_dbfs, float seconds, int16_t *peak = nullptr)
+{
+    int16_t block[BLOCK * CHANNELS];
+    std::vector<int16_t> last;
+    size_t blocks = (size_t)(seconds * RATE / BLOCK);
+    size_t keep_from = blocks > RATE / BLOCK ? blocks - RATE / BLOCK : 0;
+    for (size_t b = 0; b < blocks; ++b) {
+        tone.Fill(block, BLOCK, rms_dbfs);
+        agc.Process(block, BLOCK, CHANNELS);
+        for (int16_t s : block) {
+            int16_t a = s < 0 ? (int16_t)-s : s;
+            if (peak != nullptr && a > *peak) *peak = a;
+            if (b >= keep_from) last.push_back(s);
+        }
+    }
+    return last;
+}
+
+static void TestGainConverges()
+{
+    AgcConfig config;
+    config.target_dbfs = -20.0f;
+    for (float input : {-20.0f, -35.0f, -12.0f}) {
+        Agc agc;
+        CHECK(agc.Init(RATE, config));
+        Tone tone;
+        std::vector<int16_t> out = Run(agc, tone, input, 8.0f);
+        float level = RmsDb(out);
+        CHECK(fabsf(level - config.target_dbfs) < 0.5f);
+        CHECK(fabsf(agc.GetGainDb() - (config.target_dbfs - input)) < 0.5f);
+    }
+}
+
+static void TestGainLimits()
+{
+    AgcConfig config;
+    config.target_dbfs = -20.0f;
+    config.max_gain_db = 12.0f;
+    Agc agc;
+    CHECK(agc.Init(RATE, config));
+    Tone tone;
+    Run(agc, tone, -45.0f, 8.0f);
+    CHECK(fabsf(agc.GetGainDb() - 12.0f) < 0.1f);
+}
+
+static void TestAttackFasterThanRelease()
+{
+    AgcConfig config;
+    config.target_dbfs = -20.0f;
+    Agc agc;
+    CHECK(agc.Init(RATE, config));
+    Tone tone;
+    Run(agc, tone, -30.0f, 8.0f); // settles at +10 dB
+
+    // 20 ms attack: a 20 dB louder input is mostly corrected within 100 ms
+    Run(agc, tone, -10.0f, 0.1f);
+    CHECK(agc.GetGainDb() < -8.0f);
+    // 800 ms release: 100 ms after dropping back, the gain has only partly recovered
+    Run(agc, tone, -30.0f, 0.1f);
+    float gain = agc.GetGainDb();
+    CHECK(gain > -10.0f && gain < 5.0f);
+}
+
+static void TestStepDoesNotClip()
+{
+    // A quiet talker at full gain, then a shout: the limiter must catch the first loud frames
+    AgcConfig config;
+    Agc agc;
+    CHECK(agc.Init(RATE, config));
+    Tone tone;
+    int16_t peak = 0;
+    Run(agc, tone, -45.0f, 4.0f, &peak);
+    CHECK(agc.GetGainDb() > 25.0f);
+    Run(agc, tone, -6.0f, 2.0f, &peak);
+
+    const int16_t ceiling = (int16_t)(32768.0f * powf(10.0f, config.limit_dbfs / 20.0f));
+    CHECK(peak <= ceiling);
+    CHECK(peak < 32767);
+}
+
+static void TestGateFreezesGain()
+{
+    AgcConfig config;
+    config.target_dbfs = -20.0f;
+    Agc agc;
+    CHECK(agc.Init(RATE, config));
+    Tone tone;
+    Run(agc, tone, -30.0f, 8.0f);
+    float speech_gain = agc.GetGainDb();
+    CHECK(agc.IsGateOpen());
+
+    // Noise floor under the gate: the AGC part of the gain stays put, the gate attenuates on top
+    Run(agc, tone, -70.0f, 3.0f);
+    CHECK(!agc.IsGateOpen());
+    float gated = agc.GetGainDb();
+    CHECK(fabsf(gated - (speech_gain - config.gate_range_db)) < 0.5f);
+
+    // Speech again reopens the gate at the old gain
+    Run(agc, tone, -30.0f, 0.2f);
+    CHECK(agc.IsGateOpen());
+    CHECK(fabsf(agc.GetGainDb() - speech_gain) < 1.0f);
+}
+
+static void TestDelayKeepsOrder()
+{
+    // 5 ms at 48 kHz is a 240 frame window, not a power of two
+    AgcConfig config;
+    config.max_gain_db = 0.0f;
+    config.min_gain_db = 0.0f;
+    Agc agc;
+    CHECK(agc.Init(RATE, config));
+    CHECK_EQ(agc.GetLatencyFrames(), 240);
+
+    // A ramp comes out as the same ramp, window frames late, across many window wraps
+    int16_t block[BLOCK * CHANNELS];
+    int16_t next_in = 0;
+    int16_t next_out = -240;
+    for (int b = 0; b < 50; ++b) {
+        for (size_t i = 0; i < BLOCK; ++i) {
+            block[i * CHANNELS] = next_in;
+            block[i * CHANNELS + 1] = (int16_t)-next_in;
+            next_in = (int16_t)((next_in + 1) % 1000);
+        }
+        agc.Process(block, BLOCK, CHANNELS);
+        for (size_t i = 0; i < BLOCK; ++i) {
+            int16_t expected = next_out < 0 ? 0 : next_out;
+            CHECK_EQ(block[i * CHANNELS], expected);
+            CHECK_EQ(block[i * CHANNELS + 1], -expected);
+            next_out = next_out < 0 ? (int16_t)(next_out + 1) : (int16_t)((next_out + 1) % 1000);
+        }
+    }
+}
+
+int main()
+{
+    RUN(TestGainConverges);
+    RUN(TestGainLimits);
+    RUN(TestAttackFasterThanRelease);
+    RUN(TestStepDoesNotClip);
+    RUN(TestGateFreezesGain);
+    RUN(TestDelayKeepsOrder);
+    return 0;
+}
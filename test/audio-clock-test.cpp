@@ -0,0 +1,182 @@
+#include <cmath>
+#include <esp_timer.h>
+#include "test.hpp"
+#include "fake-i2s.hpp"
+#include "fake-timer.hpp"
+#include "wrapper/audio-clock.hpp"
+
+using namespace wrapper;
+
+static constexpr uint32_t RATE = 48000;
+static constexpr uint32_t DESC_FRAMES = 256;
+static constexpr uint32_t DESC_NUM = 4;
+
+// Microseconds of n frames at the nominal rate, truncated like the clock's own conversion
+static int64_t FramesUs(int64_t frames)
+{
+    return (int64_t)((double)frames * 1e6 / RATE);
+}
+
+struct Fixture
+{
+    Logger logger{"Test"};
+    I2sBus bus{logger};
+    AudioClock clock{logger};
+
+    explicit Fixture(const AudioClockConfig &config)
+    {
+        FakeTimerSet(1000000);
+        I2sBusConfig bus_config(I2S_NUM_0, I2S_ROLE_MASTER, DESC_NUM, DESC_FRAMES, true, false, 0);
+        CHECK(bus.Init(bus_config));
+        I2sChanStdConfig tx_config(RATE, I2S_CLK_SRC_DEFAULT, 0, I2S_MCLK_MULTIPLE_256, 1, I2S_DATA_BIT_WIDTH_16BIT,
+                                   I2S_SLOT_BIT_WIDTH_AUTO, I2S_SLOT_MODE_STEREO, I2S_STD_SLOT_BOTH,
+                                   I2S_DATA_BIT_WIDTH_16BIT, false, true, true, false, false, GPIO_NUM_NC,
+                                   GPIO_NUM_NC, GPIO_NUM_NC, GPIO_NUM_NC, GPIO_NUM_NC);
+        CHECK(bus.ConfigureTxChannel(tx_config));
+        CHECK(clock.Start(bus, config));
+    }
+    ~Fixture() { FakeTimerRelease(); }
+
+    // One finished descriptor, stamped by the ISR at the current fake time
+    void Descriptor(uint32_t count = 1) { FakeI2sDmaEvents(bus.GetTxHandle(), count); }
+};
+
+// Without DMA events a returned blocking write means the queue is full: its last frame is queue_frames out
+static void TestWriteCompletionEstimate()
+{
+    AudioClockConfig config;
+    config.use_dma_events = false;
+    config.output_latency_us = 700;
+    Fixture f(config);
+    CHECK(!f.clock.HasDmaTimestamps());
+    const int64_t t0 = 1000000;
+
+    // The first 512 frames fill half the queue: they start playing now
+    AudioBlockTime block = f.clock.OnWrite(512, t0);
+    CHECK_EQ(block.frame, 0);
+    CHECK_EQ(block.frames, 512);
+    CHECK_EQ(block.enqueue_us, t0);
+    CHECK_EQ(block.presentation_us, t0 + 700);
+
+    // The next 512 fill the queue, behind the first
+    FakeTimerAdvance(3000);
+    block = f.clock.OnWrite(512, t0 + 100);
+    CHECK_EQ(block.frame, 512);
+    CHECK_EQ(block.presentation_us, t0 + 3000 + FramesUs(512) + 700);
+
+    // From now on each write returns once 512 frames have drained: 1024 frames queued ahead of the block
+    for (int i = 2; i < 6; ++i) {
+        FakeTimerAdvance(FramesUs(512));
+        const int64_t now = esp_timer_get_time();
+        block = f.clock.OnWrite(512, now - FramesUs(512));
+        CHECK_EQ(block.frame, 512u * i);
+        CHECK_EQ(block.presentation_us, now + FramesUs(1024 - 512) + 700);
+        CHECK_EQ(f.clock.GetPresentationTime(block.frame), block.presentation_us);
+    }
+    CHECK_EQ(f.clock.GetFramesWritten(), 512 * 6);
+    CHECK_EQ(f.clock.GetLastBlock().frame, block.frame);
+    // No DMA stamps, no drift estimate
+    CHECK_EQ(f.clock.GetMeasuredRate(), (float)RATE);
+    CHECK_EQ(f.clock.GetDriftPpm(), 0.0f);
+}
+
+// With DMA stamps a frame plays at the last stamp plus its distance from the play position
+static void TestDmaPosition()
+{
+    Fixture f(AudioClockConfig{});
+    CHECK(f.clock.HasDmaTimestamps());
+    const int64_t t0 = 1000000;
+
+    // Before the first descriptor finishes the stream starts now
+    AudioBlockTime block = f.clock.OnWrite(DESC_FRAMES * DESC_NUM, t0);
+    CHECK_EQ(block.presentation_us, t0);
+    CHECK_EQ(f.clock.GetFrameAt(t0), 0);
+
+    FakeTimerSet(t0 + 5333);
+    f.Descriptor();
+    FakeTimerSet(t0 + 6000);
+    block = f.clock.OnWrite(DESC_FRAMES, t0 + 1000);
+    CHECK_EQ(block.frame, DESC_FRAMES * DESC_NUM);
+    CHECK_EQ(block.presentation_us, t0 + 5333 + FramesUs(DESC_FRAMES * (DESC_NUM - 1)));
+
+    // Frame <-> time round trips through the same anchor
+    for (uint64_t frame : {0ull, 100ull, 256ull, 1000ull, 1279ull}) {
+        int64_t at = f.clock.GetPresentationTime(frame);
+        CHECK_EQ(at, t0 + 5333 + FramesUs((int64_t)frame - DESC_FRAMES));
+        uint64_t back = f.clock.GetFrameAt(at + 1);
+        CHECK(back == frame || back == frame + 1);
+    }
+}
+
+// The DMA ran past the stream: the next block is re-anchored after the descriptor in flight
+static void TestUnderrunOffset()
+{
+    AudioClockConfig config;
+    config.output_latency_us = 250;
+    Fixture f(config);
+    const int64_t t0 = 1000000;
+    f.clock.OnWrite(1280, t0);
+
+    // 8 descriptors = 2048 frames went out while only 1280 were written
+    FakeTimerSet(t0 + 50000);
+    f.Descriptor(8);
+    AudioBlockTime block = f.clock.OnWrite(256, t0 + 50000);
+    CHECK_EQ(block.frame, 1280);
+    // Offset 2048 + 256 - 1280 = 1024 frames of inserted silence: one descriptor after the play position
+    CHECK_EQ(block.presentation_us, t0 + 50000 + FramesUs(DESC_FRAMES) + 250);
+    CHECK_EQ(f.clock.GetPresentationTime(1280), block.presentation_us);
+    CHECK_EQ(f.clock.GetFrameAt(block.presentation_us + 1), 1280);
+    // Times before the stream resumed map to frame 0 rather than wrapping
+    CHECK_EQ(f.clock.GetFrameAt(t0), 0);
+
+    // Writes that keep up keep the offset
+    FakeTimerSet(t0 + 50000 + FramesUs(256));
+    f.Descriptor();
+    block = f.clock.OnWrite(256, t0 + 55000);
+    CHECK_EQ(block.frame, 1536);
+    CHECK_EQ(block.presentation_us, t0 + 50000 + FramesUs(256) + FramesUs(256) + 250);
+}
+
+// The DMA runs ppm fast or slow against esp_timer: one window sets the estimate, later ones smooth it
+static void TestDrift()
+{
+    for (double ppm : {120.0, -250.0}) {
+        AudioClockConfig config;
+        config.drift_window_ms = 1000;
+        Fixture f(config);
+        const int64_t t0 = 1000000;
+        const double rate = RATE * (1.0 + ppm * 1e-6);
+        f.clock.OnWrite(DESC_FRAMES * DESC_NUM, t0);
+
+        uint64_t frames = 0;
+        float first_window = 0;
+        for (int n = 1; n <= 48000 * 5 / (int)DESC_FRAMES; ++n) {
+            frames += DESC_FRAMES;
+            FakeTimerSet(t0 + (int64_t)llround(frames * 1e6 / rate));
+            f.Descriptor();
+            f.clock.OnWrite(DESC_FRAMES, esp_timer_get_time());
+            if (first_window == 0 && f.clock.GetDriftPpm() != 0) first_window = f.clock.GetDriftPpm();
+        }
+        printf("%.0f ppm: first window %.1f ppm, after 5 s %.1f ppm, rate %.2f Hz\n", ppm, first_window,
+               f.clock.GetDriftPpm(), f.clock.GetMeasuredRate());
+        // 1 us of stamp rounding over a 1 s window is 1 ppm
+        CHECK(fabs(first_window - ppm) < 3.0);
+        CHECK(fabs(f.clock.GetDriftPpm() - ppm) < 3.0);
+        CHECK(fabs(f.clock.GetMeasuredRate() - rate) < 0.2);
+
+        // Presentation follows the measured rate, not the nominal one
+        const uint64_t ahead = 48000;
+        int64_t at = f.clock.GetPresentationTime(frames + ahead);
+        int64_t expected = esp_timer_get_time() + (int64_t)(ahead * 1e6 / rate);
+        CHECK(llabs(at - expected) <= 5);
+    }
+}
+
+int main()
+{
+    RUN(TestWriteCompletionEstimate);
+    RUN(TestDmaPosition);
+    RUN(TestUnderrunOffset);
+    RUN(TestDrift);
+    return 0;
+}
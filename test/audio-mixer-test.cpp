@@ -0,0 +1,234 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "test.hpp"
+#include "fake-codec.hpp"
+#include "wrapper/audio-mixer.hpp"
+
+using namespace wrapper;
+
+static constexpr size_t CHANNELS = 2;
+static constexpr size_t FRAMES = 64;
+static constexpr size_t SAMPLES = FRAMES * CHANNELS;
+static constexpr size_t BLOCK_BYTES = SAMPLES * sizeof(int16_t);
+
+static MixBusConfig BusConfig()
+{
+    MixBusConfig config;
+    config.channels = CHANNELS;
+    config.block_frames = FRAMES;
+    config.duck_gain = 0.25f;
+    config.ramp_blocks = 4;
+    return config;
+}
+
+// Full scale ramp over the block, both extremes included
+static std::vector<int16_t> Ramp(bool rising)
+{
+    std::vector<int16_t> samples(SAMPLES);
+    for (size_t i = 0; i < SAMPLES; ++i) {
+        int32_t v = INT16_MIN + (int32_t)(i * 65535 / (SAMPLES - 1));
+        samples[rising ? i : SAMPLES - 1 - i] = (int16_t)v;
+    }
+    return samples;
+}
+
+static int32_t Scale(int16_t sample, float gain)
+{
+    return (sample * PcmGainToQ15(gain) + (1 << 14)) >> 15;
+}
+
+static int16_t Saturate(int32_t value)
+{
+    return (int16_t)(value > INT16_MAX ? INT16_MAX : value < INT16_MIN ? INT16_MIN : value);
+}
+
+// Equal priorities: every stream is scaled by its own gain, summed in int32 and saturated once
+static void TestGainsSumThenSaturate()
+{
+    MixBus bus;
+    int a = bus.AddStream(BLOCK_BYTES, 0, 1.5f);
+    int b = bus.AddStream(BLOCK_BYTES, 0, 1.0f);
+    int c = bus.AddStream(BLOCK_BYTES, 0, 2.0f);
+    CHECK(bus.Init(BusConfig()));
+
+    std::vector<int16_t> rising = Ramp(true), falling = Ramp(false), out(SAMPLES);
+    for (float c_gain : {2.0f, 0.5f}) {
+        CHECK(bus.SetStreamGain(c, c_gain));
+        CHECK_EQ(bus.Write(a, rising.data(), BLOCK_BYTES), BLOCK_BYTES);
+        CHECK_EQ(bus.Write(b, rising.data(), BLOCK_BYTES), BLOCK_BYTES);
+        CHECK_EQ(bus.Write(c, falling.data(), BLOCK_BYTES), BLOCK_BYTES);
+        CHECK_EQ(bus.MixBlock(out.data()), 3);
+
+        int partial_clips = 0, clips = 0;
+        for (size_t i = 0; i < SAMPLES; ++i) {
+            int32_t partial = Scale(rising[i], 1.5f) + Scale(rising[i], 1.0f);
+            int32_t sum = partial + Scale(falling[i], c_gain);
+            CHECK_EQ(out[i], Saturate(sum));
+            partial_clips += partial != Saturate(partial);
+            clips += sum != Saturate(sum);
+        }
+        CHECK(partial_clips > 0);
+        // With c at 2.0 it cancels what the first two add past full scale, at 0.5 the total clips
+        CHECK(c_gain == 2.0f ? clips == 0 : clips > 0);
+    }
+
+    // Nothing queued: silence and no contributors
+    CHECK_EQ(bus.MixBlock(out.data()), 0);
+    for (int16_t sample : out) CHECK_EQ(sample, 0);
+
+    CHECK(bus.SetStreamGain(a, 2.0f));
+    CHECK(!bus.SetStreamGain(3, 1.0f));
+    CHECK_EQ(bus.Write(a, falling.data(), BLOCK_BYTES), BLOCK_BYTES);
+    CHECK_EQ(bus.MixBlock(out.data()), 1);
+    for (size_t i = 0; i < SAMPLES; ++i) CHECK_EQ(out[i], Saturate(Scale(falling[i], 2.0f)));
+}
+
+// A higher priority stream ramps the others down to duck_gain and back, one step per block
+static void TestDuckingRamps()
+{
+    MixBus bus;
+    int music = bus.AddStream(BLOCK_BYTES * 16, 0);
+    int voice = bus.AddStream(BLOCK_BYTES * 16, 1);
+    CHECK(bus.Init(BusConfig()));
+
+    std::vector<int16_t> level(SAMPLES, 16000), silence(SAMPLES, 0), out(SAMPLES);
+    std::vector<int16_t> firsts, lasts;
+    for (int block = 0; block < 12; ++block) {
+        CHECK_EQ(bus.Write(music, level.data(), BLOCK_BYTES), BLOCK_BYTES);
+        if (block >= 2 && block < 7) CHECK_EQ(bus.Write(voice, silence.data(), BLOCK_BYTES), BLOCK_BYTES);
+        bus.MixBlock(out.data());
+        firsts.push_back(out[0]);
+        lasts.push_back(out[SAMPLES - 1]);
+    }
+    // Unducked, ramping down over 4 blocks while the voice plays, then back up. A block's ramp
+    // ends one frame short of its target, the next block starts on it
+    const int frame_step = 16000 * 3 / 4 / 4 / (int)FRAMES + 1;
+    CHECK_EQ(firsts[0], 16000);
+    CHECK_EQ(lasts[1], 16000);
+    for (int block = 2; block < 6; ++block) CHECK(lasts[block] < firsts[block]);
+    CHECK(lasts[5] - 4000 <= frame_step);
+    CHECK_EQ(firsts[6], 4000);
+    CHECK_EQ(lasts[6], 4000);
+    for (int block = 7; block < 11; ++block) CHECK(lasts[block] > firsts[block]);
+    CHECK(16000 - lasts[10] <= frame_step);
+    CHECK_EQ(firsts[11], 16000);
+    // Each block continues where the previous one ended, no zipper steps
+    for (int block = 1; block < 12; ++block) CHECK(abs(firsts[block] - lasts[block - 1]) <= frame_step);
+}
+
+// A stream that runs dry mid-block is padded with silence and counted once it was playing
+static void TestPartialBlockAndUnderruns()
+{
+    MixBus bus;
+    int id = bus.AddStream(BLOCK_BYTES);
+    CHECK(bus.Init(BusConfig()));
+    std::vector<int16_t> level(SAMPLES, 1000), out(SAMPLES);
+
+    CHECK_EQ(bus.Write(id, level.data(), BLOCK_BYTES / 2 + 1), BLOCK_BYTES / 2 + 1);
+    bool full = true, partial = false;
+    bus.GetPending(full, partial);
+    CHECK(!full && partial);
+    CHECK_EQ(bus.MixBlock(out.data()), 1);
+    CHECK_EQ(out[SAMPLES / 2 - 1], 1000);
+    CHECK_EQ(out[SAMPLES / 2], 0);
+    // The odd byte is not a whole frame, it stays queued
+    MixBus::StreamStats stats;
+    CHECK(bus.GetStreamStats(id, stats));
+    CHECK_EQ(stats.queued_bytes, 1);
+    CHECK_EQ(stats.underruns, 0);
+
+    CHECK_EQ(bus.Write(id, level.data(), BLOCK_BYTES - 1), BLOCK_BYTES - 1);
+    CHECK_EQ(bus.MixBlock(out.data()), 1);
+    bus.MixBlock(out.data());
+    CHECK(bus.GetStreamStats(id, stats));
+    CHECK_EQ(stats.underruns, 1);
+    CHECK_EQ(bus.Write(id, level.data(), BLOCK_BYTES + 2), BLOCK_BYTES);
+    CHECK(bus.GetStreamStats(id, stats));
+    CHECK_EQ(stats.overruns, 1);
+
+    // Streams are fixed once the buffers exist
+    CHECK_EQ(bus.AddStream(BLOCK_BYTES), MixBus::INVALID_STREAM);
+    bus.Deinit();
+    CHECK_EQ(bus.Write(id, level.data(), 4), 0);
+}
+
+struct Fixture
+{
+    Logger logger{"Test"};
+    AudioCodec codec{logger};
+    esp_codec_dev_handle_t device = FakeCodecNew();
+
+    Fixture() { codec.SetSpeakerCodecDeviceHandle(device); }
+    ~Fixture() { FakeCodecDelete(device); }
+};
+
+static AudioMixerConfig MixerConfig()
+{
+    AudioMixerConfig config;
+    config.block_frames = FRAMES;
+    config.idle_wait_ms = 2;
+    return config;
+}
+
+static void TestMixerWritesCodec()
+{
+    Fixture f;
+    AudioMixer mixer(f.logger);
+    int id = mixer.AddStream(BLOCK_BYTES * 4);
+    CHECK(id != AudioMixer::INVALID_STREAM);
+
+    // The codec is always stereo, a mono mix would play at twice the speed
+    AudioMixerConfig config = MixerConfig();
+    config.channels = 1;
+    CHECK(!mixer.Start(f.codec, config));
+    CHECK(mixer.Start(f.codec, MixerConfig()));
+    CHECK_EQ(mixer.AddStream(BLOCK_BYTES), AudioMixer::INVALID_STREAM);
+
+    std::vector<int16_t> in = Ramp(true);
+    for (int i = 0; i < 3; ++i) {
+        while (mixer.Write(id, in.data(), BLOCK_BYTES) == 0) std::this_thread::yield();
+    }
+    while (mixer.GetBlocksWritten() < 3) std::this_thread::yield();
+    mixer.Stop();
+    CHECK(!mixer.IsRunning());
+    CHECK_EQ(mixer.Write(id, in.data(), BLOCK_BYTES), 0);
+
+    std::vector<int16_t> written = FakeCodecWritten(f.device);
+    CHECK_EQ(written.size(), 3 * SAMPLES);
+    for (size_t i = 0; i < written.size(); ++i) CHECK_EQ(written[i], in[i % SAMPLES]);
+}
+
+// Producers still inside Write while Stop frees the rings must back out first
+static void TestStopRacesWriters()
+{
+    Fixture f;
+    for (int round = 0; round < 20; ++round) {
+        AudioMixer mixer(f.logger);
+        int ids[2] = {mixer.AddStream(BLOCK_BYTES), mixer.AddStream(BLOCK_BYTES, 1)};
+        CHECK(mixer.Start(f.codec, MixerConfig()));
+        std::atomic<bool> done{false};
+        std::vector<std::thread> writers;
+        for (int id : ids) {
+            writers.emplace_back([&, id] {
+                int16_t block[37 * CHANNELS] = {};
+                while (!done) mixer.Write(id, block, sizeof(block));
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(300 * (round % 4)));
+        mixer.Stop();
+        CHECK(!mixer.IsRunning());
+        done = true;
+        for (auto &writer : writers) writer.join();
+    }
+}
+
+int main()
+{
+    RUN(TestGainsSumThenSaturate);
+    RUN(TestDuckingRamps);
+    RUN(TestPartialBlockAndUnderruns);
+    RUN(TestMixerWritesCodec);
+    RUN(TestStopRacesWriters);
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <cstring>
+#include <vector>
+#include "test.hpp"
+#include "fake-i2s.hpp"
+#include "wrapper/audio.hpp"
+
+using namespace wrapper;
+
+struct Fixture
+{
+    Logger logger{"Test"};
+    I2sBus bus{logger};
+    Speaker speaker{logger};
+
+    Fixture()
+    {
+        I2sBusConfig config(I2S_NUM_0, I2S_ROLE_MASTER, 4, 256, true, false, 0);
+        CHECK(bus.Init(config));
+        CHECK(speaker.Init(bus));
+    }
+
+    std::vector<int16_t> Written() const
+    {
+        const std::vector<uint8_t> &bytes = bus.GetTxHandle()->written;
+        std::vector<int16_t> samples(bytes.size() / sizeof(int16_t));
+        memcpy(samples.data(), bytes.data(), samples.size() * sizeof(int16_t));
+        return samples;
+    }
+};
+
+// Full scale ramp with both extremes, longer than the scratch buffer and not a multiple of it
+static std::vector<int16_t> Ramp(size_t count)
+{
+    std::vector<int16_t> samples(count);
+    for (size_t i = 0; i < count; ++i) samples[i] = (int16_t)(INT16_MIN + (int32_t)(i * 65535 / (count - 1)));
+    return samples;
+}
+
+static void TestUnityPassesThrough()
+{
+    Fixture f;
+    std::vector<int16_t> in = Ramp(1001);
+    CHECK(f.speaker.Write(in));
+    CHECK(f.Written() == in);
+}
+
+static void TestChunkedGainMatchesScalar()
+{
+    for (float volume : {0.5f, 0.3f, 1.7f, 4.0f}) {
+        Fixture f;
+        CHECK(f.speaker.SetSoftVolume(volume));
+        std::vector<int16_t> in = Ramp(1001);
+        CHECK(f.speaker.Write(in));
+
+        std::vector<int16_t> expected(in.size());
+        PcmApplyGainScalar(expected.data(), in.data(), in.size(), PcmGainToQ15(volume));
+        CHECK(f.Written() == expected);
+    }
+    // Above the Q15 ceiling the gain is capped at ~+6 dB and the output saturates
+    Fixture f;
+    CHECK(f.speaker.SetSoftVolume(4.0f));
+    int16_t loud[2] = {20000, -20000};
+    CHECK(f.speaker.Write(loud, sizeof(loud)));
+    std::vector<int16_t> out = f.Written();
+    CHECK_EQ(out[0], INT16_MAX);
+    CHECK_EQ(out[1], INT16_MIN);
+}
+
+static void TestMuteWritesSilence()
+{
+    Fixture f;
+    CHECK(f.speaker.SetMute(true));
+    std::vector<int16_t> in = Ramp(600);
+    CHECK(f.speaker.Write(in));
+    std::vector<int16_t> out = f.Written();
+    CHECK_EQ(out.size(), in.size());
+    for (int16_t sample : out) CHECK_EQ(sample, 0);
+}
+
+static void TestOddSizeRejected()
+{
+    Fixture f;
+    CHECK(f.speaker.SetSoftVolume(0.5f));
+    int16_t samples[4] = {1, 2, 3, 4};
+    CHECK(!f.speaker.Write(samples, 7));
+    CHECK(f.Written().empty());
+}
+
+int main()
+{
+    RUN(TestUnityPassesThrough);
+    RUN(TestChunkedGainMatchesScalar);
+    RUN(TestMuteWritesSilence);
+    RUN(TestOddSizeRejected);
+    return 0;
+}
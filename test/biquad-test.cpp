@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "test.hpp"
+#include "dsp/biquad.hpp"
+
+using namespace wrapper;
+
+static constexpr double RATE = 16000;
+
+// Designed by the compiler, as the boards do
+static constexpr auto HIGH_PASS = ButterworthHighPass<4>(RATE, 80);
+static_assert(HIGH_PASS.size() == 2 && HIGH_PASS[0].b_shift == 0 && HIGH_PASS[1].b_shift == 0, "no boost, no shift");
+
+// Bilinear Butterworth: the analog magnitude at the prewarped frequency
+static double ButterworthHighPassDb(size_t order, double corner, double freq)
+{
+    double ratio = tan(M_PI * corner / RATE) / tan(M_PI * freq / RATE);
+    return -10.0 * log10(1.0 + pow(ratio, 2.0 * order));
+}
+
+static void TestButterworthResponse()
+{
+    BiquadFilter<2> filter(HIGH_PASS);
+    CHECK(fabs(filter.ResponseDb(RATE, 80) - (-3.0103)) < 0.01);
+    // 24 dB per octave below the corner, flat above it
+    for (double freq : {10.0, 20.0, 40.0, 60.0, 80.0, 100.0, 160.0, 300.0, 1000.0, 4000.0, 7900.0}) {
+        double db = filter.ResponseDb(RATE, freq);
+        double expected = ButterworthHighPassDb(4, 80, freq);
+        // The gap grows where the response is far down and Q30 rounding of a1/a2 starts to show
+        CHECK(fabs(db - expected) < (expected < -40 ? 0.1 : 0.01));
+    }
+    CHECK(filter.ResponseDb(RATE, 40) < -23.5);
+    CHECK(filter.ResponseDb(RATE, 20) < -47.5);
+    CHECK(fabs(filter.ResponseDb(RATE, 1000)) < 0.001);
+
+    // Each section alone is a second order high pass at the same corner, with Q 0.54 and 1.31
+    CHECK(fabs(BiquadResponseDb(HIGH_PASS[0], RATE, 80) - 20.0 * log10(1.0 / (2.0 * cos(M_PI / 8)))) < 0.01);
+    CHECK(fabs(BiquadResponseDb(HIGH_PASS[1], RATE, 80) - 20.0 * log10(1.0 / (2.0 * cos(3 * M_PI / 8)))) < 0.01);
+}
+
+// A tone through the int16 processor lands where ResponseDb says
+static void TestMeasuredResponse()
+{
+    for (double freq : {40.0, 80.0, 200.0, 1000.0}) {
+        BiquadFilter<2> filter(HIGH_PASS);
+        const size_t count = (size_t)RATE * 2;
+        std::vector<int16_t> pcm(count);
+        for (size_t i = 0; i < count; ++i) pcm[i] = (int16_t)lrint(16000.0 * sin(2.0 * M_PI * freq * i / RATE));
+        filter.Process(pcm.data(), count, 1);
+        // Fit amplitude over the second half, after the transient
+        double s = 0, c = 0;
+        for (size_t i = count / 2; i < count; ++i) {
+            s += pcm[i] * sin(2.0 * M_PI * freq * i / RATE);
+            c += pcm[i] * cos(2.0 * M_PI * freq * i / RATE);
+        }
+        double amplitude = 2.0 * sqrt(s * s + c * c) / (count / 2);
+        double db = 20.0 * log10(amplitude / 16000.0);
+        printf("%4.0f Hz: measured %.3f dB, designed %.3f dB\n", freq, db, filter.ResponseDb(RATE, freq));
+        CHECK(fabs(db - filter.ResponseDb(RATE, freq)) < 0.05);
+    }
+}
+
+// Direct form I in double with the same quantised coefficients
+struct Reference
+{
+    double b0, b1, b2, a1, a2;
+    double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+
+    explicit Reference(const BiquadCoeffs &c)
+    {
+        const double scale = (double)(1 << c.b_shift) / (double)(1 << BIQUAD_Q);
+        b0 = c.b0 * scale;
+        b1 = c.b1 * scale;
+        b2 = c.b2 * scale;
+        a1 = c.a1 / (double)(1 << BIQUAD_Q);
+        a2 = c.a2 / (double)(1 << BIQUAD_Q);
+    }
+
+    double Run(double x)
+    {
+        double y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+        x2 = x1;
+        x1 = x;
+        y2 = y1;
+        y1 = y;
+        return y;
+    }
+};
+
+// Two tones plus noise, loud enough to exercise the top bits without clipping after a boost
+static std::vector<int16_t> TestSignal(size_t count, double peak)
+{
+    std::vector<int16_t> pcm(count);
+    uint32_t state = 1;
+    for (size_t i = 0; i < count; ++i) {
+        state = state * 1664525u + 1013904223u;
+        double noise = (double)(int32_t)state / 2147483648.0;
+        double v = 0.5 * sin(2.0 * M_PI * 60.0 * i / RATE) + 0.3 * sin(2.0 * M_PI * 1234.5 * i / RATE) + 0.2 * noise;
+        pcm[i] = (int16_t)lrint(peak * v);
+    }
+    return pcm;
+}
+
+template <size_t SECTIONS>
+static void CompareToDouble(const std::array<BiquadCoeffs, SECTIONS> &coeffs, double peak, double max_lsb,
+                            double rms_lsb, const char *name)
+{
+    const size_t count = (size_t)RATE * 2;
+    std::vector<int16_t> pcm = TestSignal(count, peak);
+    std::vector<Reference> reference(coeffs.begin(), coeffs.end());
+    std::vector<double> expected(count);
+    for (size_t i = 0; i < count; ++i) {
+        double y = pcm[i];
+        for (auto &section : reference) y = section.Run(y);
+        expected[i] = y;
+    }
+
+    // Odd block sizes through the processor, so section state carries across calls
+    BiquadFilter<SECTIONS> filter(coeffs);
+    for (size_t done = 0, block = 1; done < count; done += block, block = block % 150 + 7) {
+        filter.Process(&pcm[done], std::min(block, count - done), 1);
+    }
+
+    double max_error = 0, sum_squares = 0, sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(fabs(expected[i]) < 32000);
+        double error = pcm[i] - expected[i];
+        max_error = fmax(max_error, fabs(error));
+        sum_squares += error * error;
+        sum += error;
+    }
+    double rms = sqrt(sum_squares / count);
+    printf("%s: max error %.2f LSB, rms %.3f LSB, mean %.3f LSB\n", name, max_error, rms, sum / count);
+    // Truncation to int32 per section with error feedback, one rounding to int16 at the end
+    CHECK(max_error < max_lsb);
+    CHECK(rms < rms_lsb);
+    // The error feedback keeps truncation from building up a DC offset
+    CHECK(fabs(sum / count) < 0.05);
+}
+
+static void TestFixedPointMatchesDouble()
+{
+    CompareToDouble(HIGH_PASS, 20000, 2.0, 0.6, "high pass 4th order");
+    CompareToDouble(ButterworthLowPass<2>(RATE, 3000), 20000, 2.0, 0.6, "low pass 2nd order");
+    // Boost sections store b shifted down: the shift has to come back exactly
+    constexpr std::array<BiquadCoeffs, 2> boost = {BiquadHighShelf(RATE, 3000, 12), BiquadPeaking(RATE, 500, 9, 1.0)};
+    static_assert(boost[0].b_shift > 0, "shelf needs the shift");
+    // The later section's gain lifts the earlier one's truncation noise
+    CompareToDouble(boost, 4000, 3.0, 1.0, "high shelf +12 dB, peak +9 dB");
+}
+
+static void BenchProcess()
+{
+    const size_t frames = 64 * 250;
+    std::vector<int16_t> stereo(frames * 2);
+    std::vector<int16_t> mono = TestSignal(frames, 20000);
+    for (size_t i = 0; i < frames; ++i) stereo[i * 2] = stereo[i * 2 + 1] = mono[i];
+
+    BiquadFilter<2, 2> filter(HIGH_PASS);
+    const int rounds = 40;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t done = 0; done < frames; done += 64) filter.Process(&stereo[done * 2], 64, 2);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double blocks = (double)rounds * frames / 64;
+    const double audio_s = (double)rounds * frames / RATE;
+    printf("4th order, stereo: %.0f ns per 64 frame block, %.0fx realtime at 16 kHz\n", elapsed * 1e9 / blocks,
+           audio_s / elapsed);
+    CHECK(audio_s / elapsed > 20.0);
+}
+
+int main()
+{
+    RUN(TestButterworthResponse);
+    RUN(TestMeasuredResponse);
+    RUN(TestFixedPointMatchesDouble);
+    RUN(BenchProcess);
+    return 0;
+}
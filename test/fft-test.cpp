@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "test.hpp"
+#include "dsp/fft.hpp"
+
+using namespace wrapper;
+
+struct Random
+{
+    uint32_t state = 12345;
+    int16_t Next()
+    {
+        state = state * 1664525u + 1013904223u;
+        return (int16_t)(state >> 16);
+    }
+};
+
+// X[k] for 0 <= k <= N/2 in double, straight from the definition
+static void NaiveDft(const std::vector<int16_t> &in, std::vector<double> &re, std::vector<double> &im)
+{
+    const size_t n = in.size();
+    re.assign(n / 2 + 1, 0.0);
+    im.assign(n / 2 + 1, 0.0);
+    for (size_t k = 0; k <= n / 2; ++k) {
+        for (size_t t = 0; t < n; ++t) {
+            // Reduce k t mod N first, the angle stays exact
+            double angle = 2.0 * M_PI * (double)((k * t) % n) / (double)n;
+            re[k] += in[t] * cos(angle);
+            im[k] -= in[t] * sin(angle);
+        }
+    }
+}
+
+// RMS of the error over the RMS of the reference spectrum, in the packed output layout
+template <typename T>
+static double RelativeError(const T *packed, const std::vector<double> &re, const std::vector<double> &im, size_t n)
+{
+    double error = 0, power = 0;
+    auto add = [&](double got, double want) {
+        error += (got - want) * (got - want);
+        power += want * want;
+    };
+    add(packed[0], re[0]);
+    add(packed[1], re[n / 2]);
+    for (size_t k = 1; k < n / 2; ++k) {
+        add(packed[2 * k], re[k]);
+        add(packed[2 * k + 1], im[k]);
+    }
+    return sqrt(error / power);
+}
+
+static void TestMatchesNaiveDft()
+{
+    Random random;
+    for (size_t n = Fft::MIN_SIZE; n <= Fft::MAX_SIZE; n <<= 1) {
+        Fft fft;
+        CHECK(fft.Init(n));
+        std::vector<int16_t> in(n);
+        for (int16_t &s : in) s = random.Next();
+        std::vector<double> re, im;
+        NaiveDft(in, re, im);
+
+        std::vector<float> f(in.begin(), in.end());
+        fft.RealForward(f.data());
+        std::vector<int32_t> q(in.begin(), in.end());
+        fft.RealForward(q.data());
+
+        double float_error = RelativeError(f.data(), re, im, n);
+        double q15_error = RelativeError(q.data(), re, im, n);
+        printf("N = %4zu: float error %.1e, Q15 error %.1e\n", n, float_error, q15_error);
+        CHECK(float_error < 1e-5);
+        // Twiddles are 16 bit and every stage rounds, so the error grows with log2 N
+        CHECK(q15_error < 2e-4);
+    }
+}
+
+// Full-scale tone on a bin: all energy lands there, and the fixed-point output stays in range
+static void TestToneOnBin()
+{
+    for (size_t n : {16, 256, 4096}) {
+        Fft fft;
+        CHECK(fft.Init(n));
+        const size_t bin = n / 8 + 1;
+        std::vector<int32_t> q(n);
+        std::vector<float> f(n);
+        for (size_t t = 0; t < n; ++t) {
+            q[t] = (int32_t)lrint(32767.0 * cos(2.0 * M_PI * bin * t / n));
+            f[t] = (float)q[t];
+        }
+        fft.RealForward(q.data());
+        fft.RealForward(f.data());
+        const double expected = 32767.0 * n / 2;
+        CHECK(fabs(q[2 * bin] - expected) < expected * 1e-3);
+        CHECK(fabs(f[2 * bin] - expected) < expected * 1e-5);
+        for (size_t k = 1; k < n / 2; ++k) {
+            if (k == bin) continue;
+            CHECK(fabs((double)q[2 * k]) + fabs((double)q[2 * k + 1]) < expected * 1e-3);
+        }
+    }
+}
+
+static void TestInitRejectsSizes()
+{
+    Fft fft;
+    CHECK(!fft.Init(0));
+    CHECK(!fft.Init(8));
+    CHECK(!fft.Init(100));
+    CHECK(!fft.Init(8192));
+    CHECK(fft.Init(16));
+}
+
+static void TestHannWindow()
+{
+    const size_t n = 64;
+    Fft fft;
+    CHECK(fft.Init(n));
+    // Stride 2 picks the left channel, the last 8 samples are zero padded
+    std::vector<int16_t> stereo(2 * n);
+    for (size_t t = 0; t < n; ++t) {
+        stereo[2 * t] = 20000;
+        stereo[2 * t + 1] = -1;
+    }
+    std::vector<float> f(n);
+    std::vector<int32_t> q(n);
+    fft.WindowHann(stereo.data(), 2, n - 8, f.data());
+    fft.WindowHann(stereo.data(), 2, n - 8, q.data());
+    for (size_t t = 0; t < n; ++t) {
+        double w = t < n - 8 ? 20000.0 * (0.5 - 0.5 * cos(2.0 * M_PI * t / n)) : 0.0;
+        CHECK(fabs(f[t] - w) < 0.01);
+        CHECK(fabs(q[t] - w) <= 1.0);
+    }
+}
+
+static void BenchRealForward()
+{
+    Random random;
+    for (size_t n : {256, 512, 4096}) {
+        Fft fft;
+        CHECK(fft.Init(n));
+        std::vector<int16_t> in(n);
+        for (int16_t &s : in) s = random.Next();
+        std::vector<float> f(n);
+        std::vector<int32_t> q(n);
+        const int rounds = (int)(4000000 / n);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            std::copy(in.begin(), in.end(), f.begin());
+            fft.RealForward(f.data());
+        }
+        double float_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            std::copy(in.begin(), in.end(), q.begin());
+            fft.RealForward(q.data());
+        }
+        double q15_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("N = %4zu: float %.2f us, Q15 %.2f us per transform\n", n, float_s * 1e6 / rounds,
+               q15_s * 1e6 / rounds);
+    }
+
+    // Against the definition, to show what the FFT buys
+    std::vector<int16_t> in(512);
+    for (int16_t &s : in) s = random.Next();
+    std::vector<double> re, im;
+    auto start = std::chrono::steady_clock::now();
+    NaiveDft(in, re, im);
+    double naive_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("N =  512: naive DFT %.0f us\n", naive_s * 1e6);
+}
+
+int main()
+{
+    RUN(TestMatchesNaiveDft);
+    RUN(TestToneOnBin);
+    RUN(TestInitRejectsSizes);
+    RUN(TestHannWindow);
+    RUN(BenchRealForward);
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "test.hpp"
+#include "fake-i2c.hpp"
+#include "wrapper/i2c-async.hpp"
+
+using namespace wrapper;
+
+// Tab5-like bus at 400 kHz: GT911 touch, IMU, two IO expanders and a codec being configured
+struct Fixture
+{
+    Logger logger{"Test"};
+    I2cBus bus{logger};
+    I2cDevice touch{logger};
+    I2cDevice imu{logger};
+    I2cDevice io1{logger};
+    I2cDevice io2{logger};
+    I2cDevice codec{logger};
+
+    Fixture()
+    {
+        FakeI2cReset();
+        FakeI2cSimulateTiming(true);
+        I2cBusConfig config(I2C_NUM_0, GPIO_NUM_0, GPIO_NUM_0, I2C_CLK_SRC_DEFAULT, 7, 0, 0, true, false);
+        CHECK(bus.Init(config));
+        CHECK(touch.Init(bus, I2cDeviceConfig(0x14, 400000)));
+        CHECK(imu.Init(bus, I2cDeviceConfig(0x68, 400000)));
+        CHECK(io1.Init(bus, I2cDeviceConfig(0x43, 400000)));
+        CHECK(io2.Init(bus, I2cDeviceConfig(0x44, 400000)));
+        CHECK(codec.Init(bus, I2cDeviceConfig(0x10, 400000)));
+    }
+};
+
+struct SimResult
+{
+    std::vector<int64_t> touch_us; // submit to done, from the transaction's own timing
+    I2cAsyncStats stats;
+};
+
+static int64_t Percentile(std::vector<int64_t> samples, size_t percent)
+{
+    std::sort(samples.begin(), samples.end());
+    return samples[(samples.size() - 1) * percent / 100];
+}
+
+// Submits one batch per period until stop, records the latency of each transaction
+template <typename Batch>
+static void RunClient(I2cAsync &async, std::atomic<bool> &stop, int period_us, Batch batch,
+                      std::vector<int64_t> *latency_us)
+{
+    auto next = std::chrono::steady_clock::now();
+    while (!stop) {
+        for (I2cTransaction *transaction : batch) CHECK(async.Submit(*transaction, -1));
+        for (I2cTransaction *transaction : batch) {
+            async.Wait(*transaction, -1);
+            CHECK(transaction->IsOk());
+            if (latency_us != nullptr) latency_us->push_back(transaction->queue_us + transaction->transfer_us);
+        }
+        next += std::chrono::microseconds(period_us);
+        std::this_thread::sleep_until(next);
+    }
+}
+
+static SimResult Simulate(bool scheduled, int duration_ms)
+{
+    Fixture f;
+    I2cAsync async(f.logger);
+    if (scheduled) {
+        CHECK(async.SetDeviceClass(f.touch, I2cPriority::Realtime, 2000));
+        CHECK(async.SetDeviceClass(f.imu, I2cPriority::High));
+        CHECK(async.SetDeviceClass(f.io1, I2cPriority::Normal));
+        CHECK(async.SetDeviceClass(f.io2, I2cPriority::Normal));
+        CHECK(async.SetDeviceClass(f.codec, I2cPriority::Background));
+    }
+    CHECK(async.Start());
+
+    uint8_t touch_buf[41], imu_buf[12], io1_buf[1], io2_buf[1];
+    uint8_t codec_data[8][32] = {};
+    I2cTransaction touch, imu, io1, io2, codec[8];
+    touch.ReadReg(f.touch, 0x4E, touch_buf, sizeof(touch_buf));
+    imu.ReadReg(f.imu, 0x3B, imu_buf, sizeof(imu_buf));
+    io1.ReadReg(f.io1, 0x0F, io1_buf, sizeof(io1_buf));
+    io2.ReadReg(f.io2, 0x0F, io2_buf, sizeof(io2_buf));
+    std::vector<I2cTransaction *> codec_burst;
+    for (int i = 0; i < 8; ++i) {
+        codec_data[i][0] = (uint8_t)(i * 31);
+        codec[i].Write(f.codec, codec_data[i], sizeof(codec_data[i]));
+        codec_burst.push_back(&codec[i]);
+    }
+
+    SimResult result;
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> clients;
+    clients.emplace_back([&] { RunClient(async, stop, 5000, std::vector<I2cTransaction *>{&touch}, &result.touch_us); });
+    clients.emplace_back([&] { RunClient(async, stop, 2000, std::vector<I2cTransaction *>{&imu}, nullptr); });
+    clients.emplace_back([&] { RunClient(async, stop, 3000, std::vector<I2cTransaction *>{&io1}, nullptr); });
+    clients.emplace_back([&] { RunClient(async, stop, 3000, std::vector<I2cTransaction *>{&io2}, nullptr); });
+    clients.emplace_back([&] { RunClient(async, stop, 20000, codec_burst, nullptr); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+    stop = true;
+    for (auto &client : clients) client.join();
+    async.GetStats(result.stats);
+    async.Stop();
+    return result;
+}
+
+// Same clients with and without classes: the touch deadline must cut its tail latency
+static void TestSchedulerImprovesTouchP99()
+{
+    const int duration_ms = 1500;
+    SimResult fifo = Simulate(false, duration_ms);
+    SimResult sched = Simulate(true, duration_ms);
+
+    for (const SimResult *r : {&fifo, &sched}) {
+        printf("%s: touch p50 %lld / p99 %lld / max %lld us over %zu reads\n", r == &fifo ? "unclassed" : "scheduled",
+               (long long)Percentile(r->touch_us, 50), (long long)Percentile(r->touch_us, 99),
+               (long long)Percentile(r->touch_us, 100), r->touch_us.size());
+    }
+    const I2cClassStats &background = sched.stats.classes[(size_t)I2cPriority::Background];
+    printf("scheduled codec: max wait %u us, promoted %u\n", (unsigned)background.max_wait_us,
+           (unsigned)background.promoted);
+    CHECK(fifo.touch_us.size() > 100);
+    CHECK(sched.touch_us.size() > 100);
+    CHECK(Percentile(sched.touch_us, 99) < Percentile(fifo.touch_us, 99));
+
+    // Background still drains, and every class only completes what was submitted
+    CHECK(background.completed > 0);
+    CHECK(sched.stats.classes[(size_t)I2cPriority::Realtime].completed == sched.touch_us.size());
+    CHECK_EQ(sched.stats.completed, sched.stats.submitted);
+    CHECK_EQ(sched.stats.failed, 0);
+}
+
+int main()
+{
+    RUN(TestSchedulerImprovesTouchP99);
+    return 0;
+}
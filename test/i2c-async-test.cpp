@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "test.hpp"
+#include "esp_timer.h"
+#include "fake-i2c.hpp"
+#include "wrapper/i2c-async.hpp"
+
+using namespace wrapper;
+
+static constexpr int TIMEOUT_MS = 100;
+
+struct Fixture
+{
+    Logger logger{"Test"};
+    I2cBus bus{logger};
+    I2cDevice touch{logger};
+    I2cDevice pmic{logger};
+    I2cDevice io{logger};
+
+    Fixture()
+    {
+        FakeI2cReset();
+        I2cBusConfig config(I2C_NUM_0, GPIO_NUM_0, GPIO_NUM_0, I2C_CLK_SRC_DEFAULT, 7, 0, 0, true, false);
+        CHECK(bus.Init(config));
+        CHECK(touch.Init(bus, I2cDeviceConfig(0x38, 400000)));
+        CHECK(pmic.Init(bus, I2cDeviceConfig(0x34, 400000)));
+        CHECK(io.Init(bus, I2cDeviceConfig(0x58, 400000)));
+    }
+};
+
+static void CountCompletions(I2cTransaction &transaction, void *arg)
+{
+    ++*static_cast<int *>(arg);
+}
+
+static void TestReadWriteAndCallback()
+{
+    Fixture f;
+    FakeI2cRegs(0x38)[0x02] = 0xA5;
+    FakeI2cRegs(0x38)[0x03] = 0x5A;
+    I2cAsync async(f.logger);
+    CHECK(async.Start());
+
+    I2cTransaction write, read;
+    write.WriteReg8(f.pmic, 0x10, 0x42);
+    CHECK(async.Submit(write));
+    uint8_t buf[2] = {};
+    read.ReadReg(f.touch, 0x02, buf, sizeof(buf));
+    CHECK(async.Submit(read));
+    CHECK(async.Wait(write, TIMEOUT_MS));
+    CHECK(async.Wait(read, TIMEOUT_MS));
+    CHECK_EQ(FakeI2cRegs(0x34)[0x10], 0x42);
+    CHECK_EQ(buf[0], 0xA5);
+    CHECK_EQ(buf[1], 0x5A);
+
+    int calls = 0;
+    I2cTransaction with_callback;
+    with_callback.ReadReg(f.io, 0x00, buf, 1);
+    with_callback.SetCallback(CountCompletions, &calls);
+    CHECK(async.Submit(with_callback));
+    while (!with_callback.IsDone()) std::this_thread::yield();
+    CHECK_EQ(calls, 1);
+    CHECK(with_callback.IsOk());
+
+    // A failed transfer reports its error and counts as completed
+    FakeI2cFailTransfer(1);
+    CHECK(async.Submit(read));
+    CHECK(!async.Wait(read, TIMEOUT_MS));
+    CHECK(read.IsDone());
+    CHECK_EQ(read.result, ESP_FAIL);
+
+    I2cAsyncStats stats;
+    async.GetStats(stats);
+    CHECK_EQ(stats.submitted, 4);
+    CHECK_EQ(stats.completed, 4);
+    CHECK_EQ(stats.failed, 1);
+    async.Stop();
+}
+
+// Wait has its own signal, notifications meant for the caller's loop survive it
+static void TestWaitLeavesTaskNotificationAlone()
+{
+    Fixture f;
+    I2cAsync async(f.logger);
+    CHECK(async.Start());
+
+    xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+    uint8_t value = 0;
+    I2cTransaction read;
+    read.ReadReg(f.pmic, 0x00, &value, 1);
+    for (int i = 0; i < 3; ++i) {
+        CHECK(async.Submit(read));
+        CHECK(async.Wait(read, TIMEOUT_MS));
+    }
+    CHECK_EQ(ulTaskNotifyTake(pdTRUE, 0), 1);
+
+    // And any task may wait, not just the submitter
+    CHECK(async.Submit(read));
+    bool ok = false;
+    std::thread waiter([&] { ok = async.Wait(read, TIMEOUT_MS); });
+    waiter.join();
+    CHECK(ok);
+    async.Stop();
+}
+
+static void TestStopCompletesQueued()
+{
+    Fixture f;
+    FakeI2cSimulateTiming(true);
+    I2cAsync async(f.logger);
+    I2cAsyncConfig config;
+    config.queue_depth = 8;
+    CHECK(async.Start(config));
+
+    uint8_t buf[41];
+    I2cTransaction reads[8];
+    for (auto &read : reads) {
+        read.ReadReg(f.touch, 0x00, buf, sizeof(buf));
+        CHECK(async.Submit(read));
+    }
+    async.Stop();
+    CHECK(!async.IsRunning());
+    int cancelled = 0;
+    for (auto &read : reads) {
+        CHECK(read.IsDone());
+        if (read.result == ESP_ERR_INVALID_STATE) ++cancelled;
+    }
+    CHECK(cancelled > 0);
+
+    I2cTransaction late;
+    late.ReadReg(f.touch, 0x00, buf, 1);
+    CHECK(!async.Submit(late));
+}
+
+// Submitters blocked on a full queue while Stop runs must back out before the queue is freed
+static void TestStopRacesSubmitters()
+{
+    Fixture f;
+    FakeI2cSimulateTiming(true);
+    for (int round = 0; round < 20; ++round) {
+        I2cAsync async(f.logger);
+        I2cAsyncConfig config;
+        config.queue_depth = 2;
+        CHECK(async.Start(config));
+
+        std::vector<std::thread> submitters;
+        for (int i = 0; i < 4; ++i) {
+            submitters.emplace_back([&] {
+                uint8_t buf[8];
+                I2cTransaction read;
+                read.ReadReg(f.io, 0x00, buf, sizeof(buf));
+                while (async.Submit(read, -1)) {
+                    async.Wait(read, -1);
+                    CHECK(read.IsDone());
+                }
+                CHECK(read.IsDone());
+            });
+        }
+        vTaskDelay(pdMS_TO_TICKS(2 + round % 3));
+        async.Stop();
+        for (auto &thread : submitters) thread.join();
+
+        I2cAsyncStats stats;
+        async.GetStats(stats);
+        CHECK_EQ(stats.completed, stats.submitted);
+        CHECK_EQ(stats.queue_depth, 0);
+    }
+}
+
+static int64_t Percentile(std::vector<int64_t> samples, size_t percent)
+{
+    std::sort(samples.begin(), samples.end());
+    return samples[(samples.size() - 1) * percent / 100];
+}
+
+// A UI frame reads touch(5) + PMIC(1) + IO(2) registers at 400 kHz bit timing
+static void BenchFrameReads()
+{
+    Fixture f;
+    FakeI2cSimulateTiming(true);
+    const int frames = 1000;
+    uint8_t touch_buf[5], pmic_buf[1], io_buf[2];
+
+    int64_t sync_blocked = 0;
+    std::vector<uint8_t> data;
+    for (int i = 0; i < frames; ++i) {
+        int64_t start = esp_timer_get_time();
+        CHECK(f.touch.ReadRegBytes(0x02, data, sizeof(touch_buf), TIMEOUT_MS));
+        CHECK(f.pmic.ReadRegBytes(0xA4, data, sizeof(pmic_buf), TIMEOUT_MS));
+        CHECK(f.io.ReadRegBytes(0x00, data, sizeof(io_buf), TIMEOUT_MS));
+        sync_blocked += esp_timer_get_time() - start;
+    }
+
+    I2cAsync async(f.logger);
+    CHECK(async.Start());
+    I2cTransaction touch, pmic, io;
+    touch.ReadReg(f.touch, 0x02, touch_buf, sizeof(touch_buf));
+    pmic.ReadReg(f.pmic, 0xA4, pmic_buf, sizeof(pmic_buf));
+    io.ReadReg(f.io, 0x00, io_buf, sizeof(io_buf));
+    int64_t async_blocked = 0;
+    std::vector<int64_t> frame_us;
+    for (int i = 0; i < frames; ++i) {
+        int64_t start = esp_timer_get_time();
+        CHECK(async.Submit(touch));
+        CHECK(async.Submit(pmic));
+        CHECK(async.Submit(io));
+        async_blocked += esp_timer_get_time() - start;
+        CHECK(async.Wait(touch, TIMEOUT_MS));
+        CHECK(async.Wait(pmic, TIMEOUT_MS));
+        CHECK(async.Wait(io, TIMEOUT_MS));
+        frame_us.push_back(esp_timer_get_time() - start);
+    }
+    I2cAsyncStats stats;
+    async.GetStats(stats);
+    async.Stop();
+
+    printf("frame reads: sync blocks %lld us, async Submit blocks %.1f us, all done p50 %lld / p99 %lld us, "
+           "max queue depth %u\n",
+           (long long)(sync_blocked / frames), (double)async_blocked / frames, (long long)Percentile(frame_us, 50),
+           (long long)Percentile(frame_us, 99), (unsigned)stats.max_queue_depth);
+    CHECK_EQ(stats.completed, 3 * frames);
+    CHECK(stats.max_queue_depth >= 1 && stats.max_queue_depth <= 3);
+    // Submit must not wait for the bus, on one host core it still pays the switches to the worker
+    CHECK(async_blocked * 2 < sync_blocked);
+}
+
+int main()
+{
+    RUN(TestReadWriteAndCallback);
+    RUN(TestWaitLeavesTaskNotificationAlone);
+    RUN(TestStopCompletesQueued);
+    RUN(TestStopRacesSubmitters);
+    RUN(BenchFrameReads);
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include "test.hpp"
+#include "fake-i2c.hpp"
+#include "device/ip5306.hpp"
+
+using namespace wrapper;
+
+static constexpr int TIMEOUT_MS = 100;
+
+struct Fixture
+{
+    Logger logger{"Test"};
+    I2cBus bus{logger};
+
+    Fixture()
+    {
+        FakeI2cReset();
+        I2cBusConfig config(I2C_NUM_0, GPIO_NUM_0, GPIO_NUM_0, I2C_CLK_SRC_DEFAULT, 7, 0, 0, true, false);
+        CHECK(bus.Init(config));
+    }
+};
+
+static size_t CountTransfers(char kind)
+{
+    size_t count = 0;
+    for (const FakeI2cTransfer &t : FakeI2cLog()) {
+        bool read = t.read_size > 0;
+        if ((kind == 'R') == read) ++count;
+    }
+    return count;
+}
+
+static void TestIp5306ShadowsControlRegisters()
+{
+    Fixture f;
+    Ip5306 pmic(f.logger);
+    CHECK(pmic.Init(f.bus));
+    FakeI2cRegs(Ip5306::I2C_ADDR_DEFAULT)[0x20] = 0xA6;
+
+    // Only the first read-modify-write reads the register
+    for (int i = 0; i < 10; ++i) {
+        CHECK(pmic.SetChargerVoltage(i % 2 ? Ip5306::ChargerVoltage::V_4_2_4_305_4_35_4_395
+                                           : Ip5306::ChargerVoltage::V_4_17_4_275_4_32_4_365));
+    }
+    CHECK_EQ(CountTransfers('R'), 1);
+    CHECK_EQ(CountTransfers('W'), 10);
+    CHECK_EQ(FakeI2cRegs(Ip5306::I2C_ADDR_DEFAULT)[0x20], 0xA7); // upper bits kept
+
+    FakeI2cClearLog();
+    CHECK(pmic.GetChargerVoltage() == Ip5306::ChargerVoltage::V_4_2_4_305_4_35_4_395);
+    CHECK_EQ(FakeI2cLog().size(), 0);
+
+    // READ1 is live status, every read goes to the bus
+    FakeI2cRegs(Ip5306::I2C_ADDR_DEFAULT)[0x71] = 0x08;
+    CHECK(pmic.GetChargingStatus());
+    FakeI2cRegs(Ip5306::I2C_ADDR_DEFAULT)[0x71] = 0x00;
+    CHECK(!pmic.GetChargingStatus());
+    CHECK_EQ(FakeI2cLog().size(), 2);
+
+    I2cRegCacheStats stats = pmic.GetRegCacheStats();
+    CHECK_EQ(stats.hits, 10); // 9 read-modify-writes and the Get
+    CHECK_EQ(stats.misses, 1);
+    CHECK_EQ(stats.reads, 3);
+    CHECK_EQ(stats.writes, 10);
+
+    // SYS_CTL0-2 and CHARGER_CTL0..CHG_DIG_CTL0
+    FakeI2cClearLog();
+    CHECK(pmic.SyncRegCache(TIMEOUT_MS));
+    CHECK_EQ(CountTransfers('R'), 8);
+    CHECK_EQ(CountTransfers('W'), 0);
+}
+
+static void TestWriteOnlyRegister()
+{
+    Fixture f;
+    I2cDevice dev(f.logger);
+    CHECK(dev.Init(f.bus, I2cDeviceConfig(0x40, 400000)));
+    CHECK(dev.EnableRegCache({{0x10, 0x13, I2cRegPolicy::WriteOnly}}));
+
+    // Nothing to modify yet, and the bus is never asked
+    CHECK(!dev.WriteRegBits(0x10, 0x0F, 0x05, TIMEOUT_MS));
+    CHECK_EQ(FakeI2cLog().size(), 0);
+
+    CHECK(dev.WriteReg8(0x10, 0xA0, TIMEOUT_MS));
+    CHECK(dev.WriteRegBits(0x10, 0x0F, 0x05, TIMEOUT_MS));
+    CHECK_EQ(CountTransfers('R'), 0);
+    CHECK_EQ(CountTransfers('W'), 2);
+    CHECK_EQ(FakeI2cRegs(0x40)[0x10], 0xA5);
+
+    // A 16 bit write covers 0x10 and 0x11, their shadow is gone
+    CHECK(dev.WriteReg16(0x10, 0x1234, TIMEOUT_MS));
+    CHECK(!dev.WriteRegBit(0x11, 0, true, TIMEOUT_MS));
+}
+
+static void TestFailedWriteInvalidates()
+{
+    Fixture f;
+    I2cDevice dev(f.logger);
+    CHECK(dev.Init(f.bus, I2cDeviceConfig(0x40, 400000)));
+    CHECK(dev.EnableRegCache({{0x00, 0x0F, I2cRegPolicy::Cacheable}}));
+
+    CHECK(dev.WriteReg8(0x02, 0x11, TIMEOUT_MS));
+    FakeI2cFailTransfer(1);
+    CHECK(!dev.WriteReg8(0x02, 0x22, TIMEOUT_MS));
+
+    // The failed write may have landed, so the next read asks the device
+    FakeI2cClearLog();
+    uint8_t value = 0;
+    CHECK(dev.ReadReg8(0x02, value, TIMEOUT_MS));
+    CHECK_EQ(value, 0x11);
+    CHECK_EQ(CountTransfers('R'), 1);
+}
+
+static void TestUncachedDevice()
+{
+    Fixture f;
+    I2cDevice dev(f.logger);
+    CHECK(dev.Init(f.bus, I2cDeviceConfig(0x40, 400000)));
+    for (int i = 0; i < 5; ++i) CHECK(dev.WriteRegBit(0x03, (uint8_t)i, true, TIMEOUT_MS));
+    CHECK_EQ(CountTransfers('R'), 5);
+    CHECK_EQ(CountTransfers('W'), 5);
+    CHECK_EQ(FakeI2cRegs(0x40)[0x03], 0x1F);
+    CHECK_EQ(dev.GetRegCacheStats().reads, 0);
+}
+
+static void TestStatsCountWideAccess()
+{
+    Fixture f;
+    I2cDevice dev(f.logger);
+    CHECK(dev.Init(f.bus, I2cDeviceConfig(0x40, 400000)));
+    CHECK(dev.EnableRegCache({{0x00, 0x0F, I2cRegPolicy::Cacheable}}));
+
+    uint16_t v16 = 0;
+    uint32_t v32 = 0;
+    std::vector<uint8_t> bytes;
+    CHECK(dev.WriteReg16(0x00, 0x0102, TIMEOUT_MS));
+    CHECK(dev.WriteReg32(0x04, 0x03040506, TIMEOUT_MS));
+    CHECK(dev.WriteRegBytes(0x08, {7, 8, 9}, TIMEOUT_MS));
+    CHECK(dev.ReadReg16(0x00, v16, TIMEOUT_MS));
+    CHECK(dev.ReadReg32(0x04, v32, TIMEOUT_MS));
+    CHECK(dev.ReadRegBytes(0x08, bytes, 3, TIMEOUT_MS));
+    CHECK_EQ(v16, 0x0102);
+    CHECK_EQ(v32, 0x03040506);
+    CHECK(bytes == std::vector<uint8_t>({7, 8, 9}));
+
+    // Raw transfers are not register transactions
+    CHECK(dev.WriteByte(0x00, TIMEOUT_MS));
+
+    I2cRegCacheStats stats = dev.GetRegCacheStats();
+    CHECK_EQ(stats.writes, 3);
+    CHECK_EQ(stats.reads, 3);
+    CHECK_EQ(FakeI2cLog().size(), 7);
+}
+
+int main()
+{
+    RUN(TestIp5306ShadowsControlRegisters);
+    RUN(TestWriteOnlyRegister);
+    RUN(TestFailedWriteInvalidates);
+    RUN(TestUncachedDevice);
+    RUN(TestStatsCountWideAccess);
+    return 0;
+}
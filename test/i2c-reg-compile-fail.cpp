@@ -0,0 +1,44 @@
+// Register descriptions that must not compile. CMakeLists.txt builds this once per case with the case
+// defined and expects the compiler to fail with that case's static_assert message; with no case defined
+// it has to compile, so a broken include path cannot pass as a rejected description
+#include "wrapper/i2c-reg.hpp"
+
+using namespace wrapper;
+
+using Ctrl = I2cRegister<0x10>;
+using Wide = I2cRegister<0x12, 2>;
+using Status = I2cRegister<0x14, 1, I2cRegAccess::ReadOnly>;
+using Command = I2cRegister<0x15, 1, I2cRegAccess::WriteOnly>;
+
+#if defined(FIELD_PAST_BYTE)
+uint8_t mask = I2cField<Ctrl, 6, 3>::mask;
+#elif defined(FIELD_PAST_WORD)
+uint16_t mask = I2cField<Wide, 12, 5>::mask;
+#elif defined(FIELD_EMPTY)
+uint8_t mask = I2cField<Ctrl, 0, 0>::mask;
+#elif defined(FIELD_SHIFT_PAST_REGISTER)
+uint8_t mask = I2cField<Ctrl, 8, 1>::mask;
+#elif defined(REGISTER_PAST_FF)
+uint8_t addr = I2cRegister<0xFE, 4>::addr;
+#elif defined(REGISTER_TOO_WIDE)
+size_t width = I2cRegister<0x10, 5>::width;
+#elif defined(ARRAY_PAST_FF)
+size_t count = I2cRegisterArray<0xF0, 9, 2>::count;
+#elif defined(ARRAY_OVERLAP)
+size_t count = I2cRegisterArray<0x20, 4, 1, 2>::count;
+#elif defined(EMPTY_MASK)
+bool Apply(I2cDevice &dev) { return Wide::Modify<0>(dev, 0, 10); }
+#elif defined(WRITE_READ_ONLY)
+bool Apply(I2cDevice &dev) { return Status::Write(dev, 0, 10); }
+#elif defined(READ_WRITE_ONLY)
+bool Apply(I2cDevice &dev)
+{
+    uint8_t value;
+    return Command::Read(dev, value, 10);
+}
+#elif defined(FIELD_OF_READ_ONLY)
+bool Apply(I2cDevice &dev) { return I2cField<Status, 0, 1, bool>::Write(dev, true, 10); }
+#else
+uint16_t mask = I2cField<Ctrl, 7, 1>::mask | I2cField<Wide, 12, 4>::mask;
+bool Apply(I2cDevice &dev) { return I2cField<Command, 0, 1, bool>::Write(dev, true, 10); }
+#endif
@@ -0,0 +1,235 @@
+#include <algorithm>
+#include "test.hpp"
+#include "fake-i2c.hpp"
+#include "wrapper/i2c-reg.hpp"
+
+using namespace wrapper;
+
+static constexpr int TIMEOUT_MS = 100;
+static constexpr uint16_t ADDR = 0x40;
+
+using Ctrl = I2cRegister<0x10>;
+using Wide = I2cRegister<0x12, 2>;
+using Be32 = I2cRegister<0x20, 4>;
+using Le32 = I2cRegister<0x30, 4, I2cRegAccess::ReadWrite, I2cEndian::Little>;
+using Le24 = I2cRegister<0x38, 3, I2cRegAccess::ReadWrite, I2cEndian::Little>;
+using Status = I2cRegister<0x3F, 1, I2cRegAccess::ReadOnly>;
+using Gains = I2cRegisterArray<0x60, 8, 2, 2, I2cRegAccess::ReadWrite, I2cEndian::Little>;
+
+enum class Mode : uint8_t
+{
+    Off,
+    Standby,
+    Run,
+    Boost,
+};
+
+using CtrlEnable = I2cField<Ctrl, 0, 1, bool>;
+using CtrlMode = I2cField<Ctrl, 4, 2, Mode>;
+// Straddles the two bytes of Wide: bits 6..9
+using WideMid = I2cField<Wide, 6, 4>;
+using WideHigh = I2cField<Wide, 12, 4>;
+using WideLow = I2cField<Wide, 0, 4>;
+using Le32High = I2cField<Le32, 16, 16>;
+using Be32All = I2cField<Be32, 0, 32>;
+
+// Masks, packing and byte order fold at compile time
+static_assert(CtrlMode::mask == 0x30 && WideMid::mask == 0x03C0 && Be32All::mask == 0xFFFFFFFFu, "field masks");
+static_assert(CtrlMode::Make(Mode::Boost) == 0x30 && CtrlMode::Extract(0xE5) == Mode::Run, "enum fields");
+static_assert(CtrlEnable::Make(true) == 0x01 && !CtrlEnable::Extract(0xFE), "bool fields");
+static_assert(CtrlMode::Insert(0xFF, Mode::Standby) == 0xDF, "insert keeps the other bits");
+// A value wider than the field is cut to it, never spills into the neighbours
+static_assert(WideMid::Make(0x1F) == 0x03C0 && WideMid::Extract(0xFFFF) == 0x0F, "field overflow");
+static_assert(Be32::Io::ByteAddr(0x20, 0) == 0x23 && Le32::Io::ByteAddr(0x30, 0) == 0x30, "byte order");
+static_assert(Gains::At<3>::addr == 0x66 && Gains::Addr(7) == 0x6E && !Gains::Contains(8), "array addressing");
+static_assert(Gains::CacheRange(I2cRegPolicy::Cacheable).last == 0x6F, "array cache range");
+
+struct Fixture
+{
+    Logger logger{"Test"};
+    I2cBus bus{logger};
+    I2cDevice dev{logger};
+    uint8_t *regs;
+
+    Fixture()
+    {
+        FakeI2cReset();
+        I2cBusConfig config(I2C_NUM_0, GPIO_NUM_0, GPIO_NUM_0, I2C_CLK_SRC_DEFAULT, 7, 0, 0, true, false);
+        CHECK(bus.Init(config));
+        CHECK(dev.Init(bus, I2cDeviceConfig(ADDR, 400000)));
+        regs = FakeI2cRegs(ADDR);
+    }
+};
+
+static size_t CountTransfers(char kind)
+{
+    size_t count = 0;
+    for (const FakeI2cTransfer &t : FakeI2cLog()) {
+        bool read = t.read_size > 0;
+        if ((kind == 'R') == read) ++count;
+    }
+    return count;
+}
+
+// Each width and byte order is one burst on the bus, with the bytes where the datasheet puts them
+static void TestWideRegisters()
+{
+    Fixture f;
+    CHECK(Wide::Write(f.dev, 0x1234, TIMEOUT_MS));
+    CHECK(Be32::Write(f.dev, 0x01020304, TIMEOUT_MS));
+    CHECK(Le32::Write(f.dev, 0x01020304, TIMEOUT_MS));
+    CHECK(Le24::Write(f.dev, 0xABCDEF, TIMEOUT_MS));
+    const uint8_t expected[] = {0x12, 0x34};
+    CHECK(std::equal(expected, expected + 2, f.regs + 0x12));
+    const uint8_t be[] = {0x01, 0x02, 0x03, 0x04}, le[] = {0x04, 0x03, 0x02, 0x01}, le24[] = {0xEF, 0xCD, 0xAB};
+    CHECK(std::equal(be, be + 4, f.regs + 0x20));
+    CHECK(std::equal(le, le + 4, f.regs + 0x30));
+    CHECK(std::equal(le24, le24 + 3, f.regs + 0x38));
+    CHECK_EQ(f.regs[0x3B], 0);
+    CHECK_EQ(CountTransfers('W'), 4);
+    CHECK_EQ(FakeI2cLog()[1].reg, 0x20);
+    CHECK_EQ(FakeI2cLog()[1].write_size, 5);
+
+    FakeI2cClearLog();
+    uint16_t v16 = 0;
+    uint32_t v32 = 0, v24 = 0;
+    CHECK(Wide::Read(f.dev, v16, TIMEOUT_MS));
+    CHECK_EQ(v16, 0x1234);
+    CHECK(Be32::Read(f.dev, v32, TIMEOUT_MS));
+    CHECK_EQ(v32, 0x01020304);
+    CHECK(Le32::Read(f.dev, v32, TIMEOUT_MS));
+    CHECK_EQ(v32, 0x01020304);
+    CHECK(Le24::Read(f.dev, v24, TIMEOUT_MS));
+    CHECK_EQ(v24, 0xABCDEF);
+    CHECK_EQ(CountTransfers('R'), 4);
+    CHECK_EQ(FakeI2cLog()[3].read_size, 3);
+}
+
+// Runs REG::Modify<MASK> on a known register and checks the result and the transfers it took
+template <typename REG, typename REG::value_type MASK>
+static void CheckModify(typename REG::value_type value, size_t reads, size_t write_size)
+{
+    Fixture f;
+    using T = typename REG::value_type;
+    // Only as many bytes as the register has
+    const T before = (T)(0xA5C3E18Bu & (((uint64_t)1 << (8 * REG::width)) - 1));
+    CHECK(REG::Write(f.dev, before, TIMEOUT_MS));
+    FakeI2cClearLog();
+    CHECK(REG::template Modify<MASK>(f.dev, value, TIMEOUT_MS));
+    CHECK_EQ(CountTransfers('R'), reads);
+    CHECK_EQ(CountTransfers('W'), 1);
+    CHECK_EQ(FakeI2cLog().back().write_size, write_size);
+    T after = 0;
+    CHECK(REG::Read(f.dev, after, TIMEOUT_MS));
+    CHECK_EQ(after, (T)((before & ~MASK) | (value & MASK)));
+}
+
+// Whole bytes are written blind, partial ones read first, and only the bytes under the mask go out
+static void TestModifySpans()
+{
+    CheckModify<Be32, 0x0000FF00>(0x12345678, 0, 2);
+    CheckModify<Be32, 0x00FFFF00>(0x12345678, 0, 3);
+    CheckModify<Be32, 0x000FF000>(0x12345678, 1, 3);
+    CheckModify<Be32, 0xF000000F>(0x12345678, 1, 5);
+    CheckModify<Be32, 0x00000030>(0xFFFFFFFF, 1, 2);
+    CheckModify<Le32, 0x00FFFF00>(0x12345678, 0, 3);
+    CheckModify<Le32, 0x0FF00000>(0x12345678, 1, 3);
+    CheckModify<Le24, 0x00FFFFFF>(0x00123456, 0, 4);
+    CheckModify<Wide, 0x03C0>(0xFFFF, 1, 3);
+
+    // The partial span reads and writes at its first bus address
+    Fixture f;
+    CHECK(WideHigh::Write(f.dev, 0x9, TIMEOUT_MS));
+    CHECK_EQ(FakeI2cLog().back().reg, 0x12);
+    CHECK_EQ(f.regs[0x12], 0x90);
+    CHECK(Le32High::Write(f.dev, 0xBEEF, TIMEOUT_MS));
+    CHECK_EQ(FakeI2cLog().back().reg, 0x32);
+    CHECK_EQ(f.regs[0x32], 0xEF);
+    CHECK_EQ(f.regs[0x33], 0xBE);
+}
+
+// Fields of a shadowed register cost one write each after the first read
+static void TestShadowedFields()
+{
+    Fixture f;
+    CHECK(f.dev.EnableRegCache({Ctrl::CacheRange(I2cRegPolicy::Cacheable), Wide::CacheRange(I2cRegPolicy::Cacheable)}));
+    f.regs[0x10] = 0x8C;
+    for (int i = 0; i < 8; ++i) {
+        CHECK(CtrlMode::Write(f.dev, (Mode)(i % 4), TIMEOUT_MS));
+        CHECK(CtrlEnable::Write(f.dev, i % 2, TIMEOUT_MS));
+    }
+    CHECK_EQ(CountTransfers('R'), 1);
+    CHECK_EQ(CountTransfers('W'), 16);
+    CHECK_EQ(f.regs[0x10], 0xBD);
+
+    FakeI2cClearLog();
+    Mode mode = Mode::Off;
+    bool enable = false;
+    CHECK(CtrlMode::Read(f.dev, mode, TIMEOUT_MS));
+    CHECK(CtrlEnable::Read(f.dev, enable, TIMEOUT_MS));
+    CHECK(mode == Mode::Boost && enable);
+    CHECK_EQ(FakeI2cLog().size(), 0);
+
+    // A wide write invalidates the bytes it covers, so the next field write reads them again
+    CHECK(WideMid::Write(f.dev, 0x5, TIMEOUT_MS));
+    CHECK(Wide::Write(f.dev, 0xFFFF, TIMEOUT_MS));
+    FakeI2cClearLog();
+    CHECK(WideLow::Write(f.dev, 0x0, TIMEOUT_MS));
+    CHECK_EQ(CountTransfers('R'), 1);
+    CHECK_EQ(f.regs[0x13], 0xF0);
+
+    // Read-only status is never shadowed by accident
+    FakeI2cClearLog();
+    uint8_t status = 0;
+    f.regs[0x3F] = 0x42;
+    CHECK(Status::Read(f.dev, status, TIMEOUT_MS));
+    CHECK_EQ(status, 0x42);
+    CHECK_EQ(CountTransfers('R'), 1);
+}
+
+static void TestRegisterArray()
+{
+    Fixture f;
+    CHECK(Gains::Write(f.dev, 3, 0xBEEF, TIMEOUT_MS));
+    CHECK_EQ(f.regs[0x66], 0xEF);
+    CHECK_EQ(f.regs[0x67], 0xBE);
+    uint16_t value = 0;
+    CHECK(Gains::At<3>::Read(f.dev, value, TIMEOUT_MS));
+    CHECK_EQ(value, 0xBEEF);
+
+    // Out of range indexes never reach the bus and leave the output alone
+    FakeI2cClearLog();
+    CHECK(!Gains::Write(f.dev, 8, 0x1234, TIMEOUT_MS));
+    CHECK(!Gains::Read(f.dev, 100, value, TIMEOUT_MS));
+    CHECK_EQ(value, 0xBEEF);
+    CHECK_EQ(FakeI2cLog().size(), 0);
+    CHECK_EQ(f.regs[0x70], 0);
+}
+
+static void TestBusErrors()
+{
+    Fixture f;
+    CHECK(Be32::Write(f.dev, 0x11223344, TIMEOUT_MS));
+    uint32_t value = 7;
+    FakeI2cFailTransfer(1);
+    CHECK(!Be32::Read(f.dev, value, TIMEOUT_MS));
+    CHECK_EQ(value, 7);
+
+    // A failed read of a partial span writes nothing back
+    FakeI2cClearLog();
+    FakeI2cFailTransfer(1);
+    CHECK(!(Be32::Modify<0x000FF000>(f.dev, 0, TIMEOUT_MS)));
+    CHECK_EQ(FakeI2cLog().size(), 1);
+    CHECK(Be32::Read(f.dev, value, TIMEOUT_MS));
+    CHECK_EQ(value, 0x11223344);
+}
+
+int main()
+{
+    RUN(TestWideRegisters);
+    RUN(TestModifySpans);
+    RUN(TestShadowedFields);
+    RUN(TestRegisterArray);
+    RUN(TestBusErrors);
+    return 0;
+}
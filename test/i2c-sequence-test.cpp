@@ -0,0 +1,127 @@
+#include "test.hpp"
+#include "fake-i2c.hpp"
+#include "device/aw9523.hpp"
+
+using namespace wrapper;
+
+static constexpr int TIMEOUT_MS = 100;
+
+// As in M5StackCoreS3::InitDevice
+static constexpr I2cRegWrite aw_cmds[] = {
+    {0x02, 0b00000111},
+    {0x03, 0b10001111},
+    {0x04, 0b00011000},
+    {0x05, 0b00001100},
+    {0x11, 0b00010000},
+    {0x12, 0b11111111},
+    {0x13, 0b11111111},
+};
+
+struct Fixture
+{
+    Logger logger{"Test"};
+    I2cBus bus{logger};
+
+    Fixture()
+    {
+        FakeI2cReset();
+        I2cBusConfig config(I2C_NUM_0, GPIO_NUM_0, GPIO_NUM_0, I2C_CLK_SRC_DEFAULT, 7, 0, 0, true, false);
+        CHECK(bus.Init(config));
+    }
+};
+
+static void TestAw9523TableIsTwoBursts()
+{
+    Fixture f;
+    Aw9523 aw(f.logger);
+    CHECK(aw.Init(f.bus, I2cDeviceConfig(Aw9523::DEFAULT_ADDR, Aw9523::DEFAULT_SPEED)));
+    CHECK(aw.WriteRegSequence(aw_cmds, TIMEOUT_MS));
+
+    std::vector<FakeI2cTransfer> log = FakeI2cLog();
+    CHECK_EQ(log.size(), 2);
+    CHECK_EQ(log[0].reg, 0x02);
+    CHECK_EQ(log[0].write_size, 1 + 4);
+    CHECK_EQ(log[1].reg, 0x11);
+    CHECK_EQ(log[1].write_size, 1 + 3);
+
+    const uint8_t *regs = FakeI2cRegs(Aw9523::DEFAULT_ADDR);
+    for (const I2cRegWrite &w : aw_cmds) CHECK_EQ(regs[w.reg], w.value);
+}
+
+static void TestNoMergeWithoutAutoIncrement()
+{
+    Fixture f;
+    I2cDevice dev(f.logger);
+    CHECK(dev.Init(f.bus, I2cDeviceConfig(0x40, 400000)));
+    CHECK(dev.WriteRegSequence(aw_cmds, TIMEOUT_MS));
+    std::vector<FakeI2cTransfer> log = FakeI2cLog();
+    CHECK_EQ(log.size(), 7);
+    for (const FakeI2cTransfer &t : log) CHECK_EQ(t.write_size, 2);
+}
+
+static void TestBurstSplits()
+{
+    Fixture f;
+    Aw9523 aw(f.logger);
+    CHECK(aw.Init(f.bus, I2cDeviceConfig(Aw9523::DEFAULT_ADDR, Aw9523::DEFAULT_SPEED)));
+
+    // 40 registers from 0xF0: the run must not wrap past 0xFF into 0x00
+    I2cRegWrite wrap[40];
+    for (int i = 0; i < 40; ++i) wrap[i] = {(uint8_t)(0xF0 + i), (uint8_t)i};
+    CHECK(aw.WriteRegSequence(wrap, TIMEOUT_MS));
+    std::vector<FakeI2cTransfer> log = FakeI2cLog();
+    CHECK_EQ(log.size(), 2);
+    CHECK_EQ(log[0].reg, 0xF0);
+    CHECK_EQ(log[0].write_size, 1 + 16);
+    CHECK_EQ(log[1].reg, 0x00);
+    CHECK_EQ(log[1].write_size, 1 + 24);
+    CHECK_EQ(FakeI2cRegs(Aw9523::DEFAULT_ADDR)[0xFF], 15);
+    CHECK_EQ(FakeI2cRegs(Aw9523::DEFAULT_ADDR)[0x00], 16);
+
+    // A long run is cut at REG_BURST_MAX
+    FakeI2cClearLog();
+    I2cRegWrite run[40];
+    for (int i = 0; i < 40; ++i) run[i] = {(uint8_t)(0x20 + i), (uint8_t)i};
+    CHECK(aw.WriteRegSequence(run, TIMEOUT_MS));
+    log = FakeI2cLog();
+    CHECK_EQ(log.size(), 2);
+    CHECK_EQ(log[0].write_size, 1 + I2cDevice::REG_BURST_MAX);
+    CHECK_EQ(log[1].reg, 0x20 + I2cDevice::REG_BURST_MAX);
+    CHECK_EQ(log[1].write_size, 1 + 40 - I2cDevice::REG_BURST_MAX);
+}
+
+static void TestFailedBurstInvalidates()
+{
+    Fixture f;
+    Aw9523 aw(f.logger);
+    CHECK(aw.Init(f.bus, I2cDeviceConfig(Aw9523::DEFAULT_ADDR, Aw9523::DEFAULT_SPEED)));
+    CHECK(aw.EnableRegCache({{0x00, 0x1F, I2cRegPolicy::Cacheable}}));
+
+    // Stale shadow for the second burst, which then fails
+    CHECK(aw.WriteReg8(0x12, 0x55, TIMEOUT_MS));
+    FakeI2cClearLog();
+    FakeI2cFailTransfer(2);
+    CHECK(!aw.WriteRegSequence(aw_cmds, TIMEOUT_MS));
+    CHECK_EQ(FakeI2cLog().size(), 2); // stopped at the failure
+
+    // First burst landed and stays shadowed
+    FakeI2cClearLog();
+    uint8_t value = 0;
+    CHECK(aw.ReadReg8(0x03, value, TIMEOUT_MS));
+    CHECK_EQ(value, 0b10001111);
+    CHECK_EQ(FakeI2cLog().size(), 0);
+
+    // Every entry of the failed burst goes back to the device
+    for (uint8_t reg : {0x11, 0x12, 0x13}) CHECK(aw.ReadReg8(reg, value, TIMEOUT_MS));
+    CHECK_EQ(value, 0x00);
+    CHECK_EQ(FakeI2cLog().size(), 3);
+}
+
+int main()
+{
+    RUN(TestAw9523TableIsTwoBursts);
+    RUN(TestNoMergeWithoutAutoIncrement);
+    RUN(TestBurstSplits);
+    RUN(TestFailedBurstInvalidates);
+    return 0;
+}
@@ -0,0 +1,219 @@
+#include "test.hpp"
+#include "fake-i2s.hpp"
+#include "wrapper/i2s-dma.hpp"
+
+using namespace wrapper;
+
+static void TestFrameBytes()
+{
+    // Mono, stereo and 4-slot TDM at 16 bit, 24 bit slots take 3 bytes
+    static_assert(I2sDmaFrameBytes(1, 16) == 2, "");
+    static_assert(I2sDmaFrameBytes(2, 16) == 4, "");
+    static_assert(I2sDmaFrameBytes(4, 16) == 8, "");
+    static_assert(I2sDmaFrameBytes(2, 24) == 6, "");
+    static_assert(I2sDmaFrameBytes(8, 32) == 32, "");
+}
+
+static void TestDescriptorLimit()
+{
+    // Largest word aligned buffer that fits in 4092 bytes
+    CHECK_EQ(I2sDmaMaxFrames(1, 16), 2046);
+    CHECK_EQ(I2sDmaMaxFrames(2, 32), 511);
+    CHECK_EQ(I2sDmaMaxFrames(3, 24), 452); // 9 byte frames: 454 and 453 are not word aligned
+
+    // A period longer than one descriptor is capped, the queue still covers the latency
+    I2sDmaPlan plan = I2sDmaPlanFor(48000, 2, 32, 100000, 100000);
+    CHECK(plan.valid);
+    CHECK_EQ(plan.frame_num, 511);
+    CHECK_EQ(plan.buffer_bytes, 4088);
+    CHECK(plan.buffer_bytes <= I2S_DMA_MAX_BUFFER_BYTES);
+    CHECK_EQ(plan.desc_num, 10); // 4800 frames in 511 frame descriptors
+    CHECK(plan.latency_us >= 100000);
+}
+
+static void TestPeriodRounding()
+{
+    // 5333 us at 48 kHz is 255.98 frames: nearest is 256, reported back as 5333 us
+    I2sDmaPlan plan = I2sDmaPlanFor(48000, 1, 16, 32000, 5333);
+    CHECK(plan.valid);
+    CHECK_EQ(plan.frame_num, 256);
+    CHECK_EQ(plan.period_us, 5333);
+    CHECK_EQ(plan.desc_num, 6);
+    CHECK_EQ(plan.latency_us, 32000);
+
+    // 1062 us at 16 kHz rounds to 17 frames, mono 16 bit needs an even count for word alignment
+    plan = I2sDmaPlanFor(16000, 1, 16, 10000, 1062);
+    CHECK(plan.valid);
+    CHECK_EQ(plan.frame_num, 18);
+    CHECK_EQ(plan.buffer_bytes, 36);
+    CHECK_EQ(plan.period_us, 1125);
+
+    // A period under one frame still moves a frame (two, for alignment)
+    plan = I2sDmaPlanFor(8000, 1, 16, 0, 10);
+    CHECK(plan.valid);
+    CHECK_EQ(plan.frame_num, 2);
+    CHECK_EQ(plan.desc_num, I2S_DMA_MIN_DESC_NUM);
+}
+
+static void TestSlotCounts()
+{
+    // Same timing, buffer grows with the frame
+    I2sDmaPlan mono = I2sDmaPlanFor(16000, 1, 16, 90000, 15000);
+    I2sDmaPlan stereo = I2sDmaPlanFor(16000, 2, 16, 90000, 15000);
+    I2sDmaPlan tdm = I2sDmaPlanFor(16000, 4, 16, 90000, 15000);
+    CHECK(mono.valid && stereo.valid && tdm.valid);
+    CHECK_EQ(mono.frame_num, 240);
+    CHECK_EQ(stereo.frame_num, 240);
+    CHECK_EQ(tdm.frame_num, 240);
+    CHECK_EQ(mono.buffer_bytes, 480);
+    CHECK_EQ(stereo.buffer_bytes, 960);
+    CHECK_EQ(tdm.buffer_bytes, 1920);
+    CHECK_EQ(tdm.desc_num, 6);
+    CHECK_EQ(tdm.latency_us, 90000);
+
+    // 8 slots of 32 bit: 32 byte frames, the descriptor limit binds at 127 frames
+    I2sDmaPlan wide = I2sDmaPlanFor(48000, 8, 32, 20000, 5000);
+    CHECK(wide.valid);
+    CHECK_EQ(wide.frame_num, 127);
+    CHECK_EQ(wide.buffer_bytes, 4064);
+}
+
+static void TestInvalid()
+{
+    CHECK(!I2sDmaPlanFor(0, 2, 16, 20000, 5000).valid);
+    CHECK(!I2sDmaPlanFor(48000, 0, 16, 20000, 5000).valid);
+    CHECK(!I2sDmaPlanFor(48000, 2, 0, 20000, 5000).valid);
+    CHECK(!I2sDmaPlanFor(48000, 2, 16, 20000, 0).valid);
+    // One frame does not fit a descriptor
+    CHECK(!I2sDmaPlanFor(48000, 1024, 32, 20000, 5000).valid);
+
+    I2sDmaPlan plan = I2sDmaPlanFor(48000, 2, 16, 20000, 0);
+    CHECK_EQ(plan.desc_num, 0);
+    CHECK_EQ(plan.frame_num, 0);
+}
+
+struct TunerFixture
+{
+    Logger logger{"Test"};
+    I2sBus bus{logger};
+    I2sDmaTuner tuner{logger};
+    uint8_t data[64] = {};
+
+    TunerFixture()
+    {
+        I2sBusConfig config(I2S_NUM_0, I2S_ROLE_MASTER, 4, 256, true, false, 0);
+        CHECK(bus.Init(config));
+        CHECK(bus.EnableEventCallbacks());
+        CHECK(tuner.Init(bus, I2sDmaPlanFor(48000, 1, 16, 21333, 5333), 48000));
+        CHECK_EQ(tuner.GetPlan().desc_num, 4);
+    }
+
+    void Write()
+    {
+        size_t written = 0;
+        bus.Write(data, sizeof(data), written, 10);
+    }
+
+    void Read()
+    {
+        size_t read = 0;
+        bus.Read(data, sizeof(data), read, 10);
+    }
+};
+
+static void TestTunerIgnoresIdleChannels()
+{
+    // Enabled but unfed: every descriptor overflows, in both directions
+    TunerFixture f;
+    for (int poll = 0; poll < 10; ++poll) {
+        FakeI2sDmaEvents(f.bus.GetTxHandle(), 188);
+        FakeI2sQueueOverflows(f.bus.GetTxHandle(), 188);
+        FakeI2sDmaEvents(f.bus.GetRxHandle(), 188);
+        FakeI2sQueueOverflows(f.bus.GetRxHandle(), 188);
+        CHECK(!f.tuner.Poll());
+    }
+    CHECK_EQ(f.tuner.GetGrowCount(), 0);
+    CHECK_EQ(f.tuner.GetPlan().desc_num, 4);
+}
+
+static void TestTunerGrowsOnStreamingUnderrun()
+{
+    TunerFixture f;
+    // Streaming with a few starved descriptors: held until the stream is seen to continue
+    f.Write();
+    FakeI2sDmaEvents(f.bus.GetTxHandle(), 188);
+    FakeI2sQueueOverflows(f.bus.GetTxHandle(), 3);
+    CHECK(!f.tuner.Poll());
+    f.Write();
+    FakeI2sDmaEvents(f.bus.GetTxHandle(), 188);
+    CHECK(f.tuner.Poll());
+    CHECK_EQ(f.tuner.GetGrowCount(), 1);
+    CHECK_EQ(f.tuner.GetPlan().desc_num, 5);
+    CHECK_EQ(f.tuner.GetPlan().latency_us, 26666);
+
+    // Without I2sBus writes (e.g. a codec writing the handle directly) partial overflows still count
+    FakeI2sDmaEvents(f.bus.GetTxHandle(), 188);
+    FakeI2sQueueOverflows(f.bus.GetTxHandle(), 2);
+    CHECK(!f.tuner.Poll());
+    FakeI2sDmaEvents(f.bus.GetTxHandle(), 188);
+    CHECK(f.tuner.Poll());
+    CHECK_EQ(f.tuner.GetPlan().desc_num, 6);
+}
+
+static void TestTunerIgnoresStreamEnd()
+{
+    TunerFixture f;
+    // The queue drains after the last write of a stream, then the channel idles
+    f.Write();
+    FakeI2sDmaEvents(f.bus.GetTxHandle(), 188);
+    FakeI2sQueueOverflows(f.bus.GetTxHandle(), 120);
+    CHECK(!f.tuner.Poll());
+    FakeI2sDmaEvents(f.bus.GetTxHandle(), 188);
+    FakeI2sQueueOverflows(f.bus.GetTxHandle(), 188);
+    CHECK(!f.tuner.Poll());
+    CHECK_EQ(f.tuner.GetGrowCount(), 0);
+}
+
+static void TestTunerTimeouts()
+{
+    TunerFixture f;
+    // A TX timeout means the queue is full, not starved
+    f.bus.GetTxHandle()->result = ESP_ERR_TIMEOUT;
+    for (int i = 0; i < 5; ++i) f.Write();
+    CHECK(!f.tuner.Poll());
+
+    // An RX timeout is a starved reader
+    f.bus.GetRxHandle()->result = ESP_ERR_TIMEOUT;
+    f.Read();
+    CHECK(f.tuner.Poll());
+    CHECK_EQ(f.tuner.GetGrowCount(), 1);
+}
+
+static void TestTunerLatencyLimit()
+{
+    TunerFixture f;
+    I2sDmaTunerConfig config;
+    config.max_latency_us = 27000;
+    CHECK(f.tuner.Init(f.bus, I2sDmaPlanFor(48000, 1, 16, 21333, 5333), 48000, config));
+    f.bus.GetRxHandle()->result = ESP_ERR_TIMEOUT;
+    f.Read();
+    CHECK(f.tuner.Poll()); // 5 descriptors, 26666 us
+    f.Read();
+    CHECK(!f.tuner.Poll()); // 6 would exceed the limit
+    CHECK_EQ(f.tuner.GetPlan().desc_num, 5);
+}
+
+int main()
+{
+    RUN(TestFrameBytes);
+    RUN(TestDescriptorLimit);
+    RUN(TestPeriodRounding);
+    RUN(TestSlotCounts);
+    RUN(TestInvalid);
+    RUN(TestTunerIgnoresIdleChannels);
+    RUN(TestTunerGrowsOnStreamingUnderrun);
+    RUN(TestTunerIgnoresStreamEnd);
+    RUN(TestTunerTimeouts);
+    RUN(TestTunerLatencyLimit);
+    return 0;
+}
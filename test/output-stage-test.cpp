@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "test.hpp"
+#include "dsp/output-stage.hpp"
+
+using namespace wrapper;
+
+static constexpr uint32_t RATE = 48000;
+
+// A sine that swells from quiet to far over full scale once the volume is up, in stereo
+static std::vector<int16_t> Swell(size_t frames, double hz)
+{
+    std::vector<int16_t> pcm(frames * 2);
+    for (size_t f = 0; f < frames; ++f) {
+        double level = 32767.0 * std::min(1.0, 0.05 + 2.0 * f / frames);
+        double v = level * sin(2.0 * M_PI * hz * f / RATE);
+        pcm[f * 2] = (int16_t)lrint(v);
+        pcm[f * 2 + 1] = (int16_t)lrint(-0.7 * v);
+    }
+    return pcm;
+}
+
+// Odd block sizes, so limiter and ramp state carry across Process calls and partial blocks
+static void Run(OutputStage &stage, std::vector<int16_t> &pcm, size_t channels)
+{
+    const size_t frames = pcm.size() / channels;
+    for (size_t done = 0, block = 5; done < frames; done += block, block = block % 200 + 37) {
+        stage.Process(&pcm[done * channels], std::min(block, frames - done), channels);
+    }
+}
+
+static void TestLimiterCeiling()
+{
+    for (float limit : {-1.0f, -6.0f, -12.0f}) {
+        for (float knee : {0.0f, 6.0f}) {
+            for (float volume : {0.0f, 6.0f}) {
+                OutputStageConfig config;
+                config.limit_dbfs = limit;
+                config.knee_db = knee;
+                config.volume_db = volume;
+                OutputStage stage;
+                CHECK(stage.Init(RATE, config));
+                std::vector<int16_t> pcm = Swell(RATE, 997);
+                Run(stage, pcm, 2);
+
+                // Attack is instant, so no sample gets past the ceiling, not even at a block start
+                const double ceiling = 32768.0 * pow(10.0, limit / 20.0);
+                int peak = 0;
+                for (int16_t s : pcm) peak = std::max(peak, abs(s));
+                printf("limit %.0f dBFS, knee %.0f dB, volume %+.0f dB: peak %d, ceiling %.1f, reduction %.1f dB\n",
+                       limit, knee, volume, peak, ceiling, stage.GetLimiterGainDb());
+                // Q16 gain rounding is worth a fraction of an LSB
+                CHECK(peak <= ceiling + 1.0);
+                // And the limiter holds the level there rather than pumping far below it
+                CHECK(peak > ceiling * 0.95);
+                CHECK(stage.GetLimiterGainDb() < -volume);
+            }
+        }
+    }
+}
+
+// After a loud burst the gain recovers, upwards only and without jumps
+static void TestLimiterRelease()
+{
+    OutputStageConfig config;
+    config.limit_dbfs = -6.0f;
+    config.limit_release_ms = 50.0f;
+    OutputStage stage;
+    CHECK(stage.Init(RATE, config));
+    std::vector<int16_t> loud(OutputStage::BLOCK * 8, 30000);
+    stage.Process(loud.data(), loud.size(), 1);
+    CHECK(stage.GetLimiterGainDb() < -5.0f);
+
+    std::vector<int16_t> quiet(RATE / 2, 4000);
+    Run(stage, quiet, 1);
+    for (size_t i = 1; i < quiet.size(); ++i) {
+        CHECK(quiet[i] >= quiet[i - 1]);
+        CHECK(quiet[i] - quiet[i - 1] <= 8);
+    }
+    CHECK(quiet.back() == 4000);
+    CHECK(stage.GetLimiterGainDb() == 0.0f);
+}
+
+// Holds a DC level, changes the volume, returns the output so the ramp can be inspected
+static std::vector<int16_t> Ramp(OutputStage &stage, int16_t level, size_t frames, size_t channels)
+{
+    std::vector<int16_t> pcm(frames * channels, level);
+    Run(stage, pcm, channels);
+    for (size_t f = 0; f < frames; ++f) {
+        for (size_t ch = 1; ch < channels; ++ch) CHECK_EQ(pcm[f * channels + ch], pcm[f * channels]);
+    }
+    std::vector<int16_t> mono(frames);
+    for (size_t f = 0; f < frames; ++f) mono[f] = pcm[f * channels];
+    return mono;
+}
+
+// A zipper shows up as steps at block edges: the largest step has to stay near the steepest slope of the
+// one-pole, which at 30 ms and 48 kHz moves 0.07 % of the gap per sample
+static void CheckRamp(const std::vector<int16_t> &out, int from, int to, const char *name)
+{
+    const double max_step = fabs((double)(to - from)) * (1.0 - exp(-1.0 / (RATE * 0.030))) + 2.0;
+    double largest = 0;
+    for (size_t i = 1; i < out.size(); ++i) {
+        int step = out[i] - out[i - 1];
+        CHECK(to > from ? step >= 0 : step <= 0);
+        largest = fmax(largest, abs(step));
+    }
+    printf("%s: %d -> %d, largest step %.0f LSB, allowed %.1f\n", name, out.front(), out.back(), largest, max_step);
+    CHECK(largest <= max_step);
+    CHECK_EQ(out.back(), to);
+}
+
+static void TestVolumeRamps()
+{
+    for (size_t channels : {1, 2}) {
+        OutputStage stage;
+        CHECK(stage.Init(RATE));
+        const int16_t level = 20000;
+        CHECK_EQ(Ramp(stage, level, 256, channels).back(), level);
+
+        // Down 20 dB, back up, mute and unmute: each settles within 15 time constants
+        stage.SetVolumeDb(-20.0f);
+        CheckRamp(Ramp(stage, level, RATE * 15 * 30 / 1000, channels), level, 2000, "down 20 dB");
+        stage.SetVolumeDb(0.0f);
+        CheckRamp(Ramp(stage, level, RATE * 15 * 30 / 1000, channels), 2000, level, "up 20 dB");
+        stage.SetMute(true);
+        CheckRamp(Ramp(stage, level, RATE * 15 * 30 / 1000, channels), level, 0, "mute");
+        stage.SetMute(false);
+        CheckRamp(Ramp(stage, level, RATE * 15 * 30 / 1000, channels), 0, level, "unmute");
+
+        // A change mid ramp turns it around without a step
+        stage.SetVolumeDb(-30.0f);
+        std::vector<int16_t> out = Ramp(stage, level, RATE * 10 / 1000, channels);
+        CHECK(out.back() < level && out.back() > 632);
+        stage.SetVolumeDb(0.0f);
+        std::vector<int16_t> back = Ramp(stage, level, RATE * 15 * 30 / 1000, channels);
+        CHECK(abs(back.front() - out.back()) <= 60);
+        CheckRamp(back, out.back(), level, "reversed");
+    }
+}
+
+static void TestVolumeMapping()
+{
+    OutputStage stage;
+    CHECK(stage.Init(RATE));
+    stage.SetVolumeDb(20.0f);
+    CHECK_EQ(stage.GetVolumeDb(), 6.0f);
+    stage.SetVolumePercent(50);
+    CHECK_EQ(stage.GetVolumeDb(), -30.0f);
+    stage.SetVolumePercent(0);
+    CHECK_EQ(stage.GetVolumeDb(), -60.0f);
+
+    // The floor is silence, not -60 dB
+    stage.Reset();
+    std::vector<int16_t> pcm(OutputStage::BLOCK * 3, 32767);
+    stage.Process(pcm.data(), pcm.size(), 1);
+    for (int16_t s : pcm) CHECK_EQ(s, 0);
+
+    OutputStageConfig config;
+    config.max_volume_db = 30.0f;
+    CHECK(!stage.Init(RATE, config));
+    CHECK(!stage.Init(0));
+}
+
+int main()
+{
+    RUN(TestLimiterCeiling);
+    RUN(TestLimiterRelease);
+    RUN(TestVolumeRamps);
+    RUN(TestVolumeMapping);
+    return 0;
+}
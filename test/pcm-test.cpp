@@ -0,0 +1,144 @@
+#include <chrono>
+#include <random>
+#include <vector>
+#include "test.hpp"
+#include "dsp/pcm.hpp"
+
+using namespace wrapper;
+
+static std::mt19937 rng(12345);
+
+static std::vector<int16_t> RandomSamples(size_t count)
+{
+    std::uniform_int_distribution<int> dist(INT16_MIN, INT16_MAX);
+    std::vector<int16_t> samples(count);
+    for (auto &sample : samples) sample = (int16_t)dist(rng);
+    // Both rails, the worst case for rounding and saturation
+    if (count > 0) samples[0] = INT16_MIN;
+    if (count > 1) samples[count - 1] = INT16_MAX;
+    return samples;
+}
+
+static std::vector<int32_t> Gains()
+{
+    std::vector<int32_t> gains = {1, 0x4000, 0x7FFF, PCM_Q15_UNITY + 1, 0xC000, PCM_Q15_GAIN_MAX};
+    std::uniform_int_distribution<int32_t> dist(1, PCM_Q15_GAIN_MAX);
+    for (int i = 0; i < 20; ++i) gains.push_back(dist(rng));
+    return gains;
+}
+
+// Vector/unrolled body and scalar tail must agree with the reference for every length
+static void TestApplyGainBitExact()
+{
+    std::vector<size_t> lengths = {1001, 4096};
+    for (size_t n = 0; n <= 67; ++n) lengths.push_back(n);
+    for (int32_t gain : Gains()) {
+        for (size_t n : lengths) {
+            std::vector<int16_t> src = RandomSamples(n);
+            std::vector<int16_t> expected(n), out(n);
+            PcmApplyGainScalar(expected.data(), src.data(), n, gain);
+            PcmApplyGain(out.data(), src.data(), n, gain);
+            CHECK(out == expected);
+            // In place, and from an odd offset so loads are unaligned
+            std::vector<int16_t> in_place(src);
+            PcmApplyGain(in_place.data(), in_place.data(), n, gain);
+            CHECK(in_place == expected);
+            if (n > 1) {
+                std::vector<int16_t> shifted(n - 1);
+                PcmApplyGain(shifted.data(), src.data() + 1, n - 1, gain);
+                CHECK(std::equal(shifted.begin(), shifted.end(), expected.begin() + 1));
+            }
+        }
+    }
+}
+
+static void TestApplyGainEdges()
+{
+    std::vector<int16_t> src = RandomSamples(37), out(37);
+    PcmApplyGain(out.data(), src.data(), src.size(), PCM_Q15_UNITY);
+    CHECK(out == src);
+    PcmApplyGain(out.data(), src.data(), src.size(), 0);
+    for (int16_t sample : out) CHECK_EQ(sample, 0);
+    PcmApplyGain(out.data(), src.data(), src.size(), -5);
+    for (int16_t sample : out) CHECK_EQ(sample, 0);
+
+    // Above the ceiling behaves as the ceiling
+    std::vector<int16_t> capped(37);
+    PcmApplyGain(out.data(), src.data(), src.size(), 0x30000);
+    PcmApplyGainScalar(capped.data(), src.data(), src.size(), PCM_Q15_GAIN_MAX);
+    CHECK(out == capped);
+}
+
+static void TestMixAccumulate()
+{
+    for (int32_t gain : Gains()) {
+        std::vector<int16_t> a = RandomSamples(131), b = RandomSamples(131);
+        std::vector<int32_t> acc(131, 0);
+        PcmMixAccumulate(acc.data(), a.data(), a.size(), gain);
+        PcmMixAccumulate(acc.data(), b.data(), b.size(), PCM_Q15_UNITY);
+        for (size_t i = 0; i < acc.size(); ++i) {
+            int32_t expected = ((a[i] * gain + (1 << 14)) >> 15) + b[i];
+            CHECK_EQ(acc[i], expected);
+        }
+    }
+
+    // Gains past the ceiling are clamped instead of overflowing int16 * gain
+    std::vector<int16_t> loud(8, INT16_MIN);
+    std::vector<int32_t> capped(8, 0), at_max(8, 0);
+    PcmMixAccumulate(capped.data(), loud.data(), loud.size(), 0x7FFFFFFF);
+    PcmMixAccumulate(at_max.data(), loud.data(), loud.size(), PCM_Q15_GAIN_MAX);
+    CHECK(capped == at_max);
+    PcmMixAccumulateRamp(capped.data(), loud.data(), 4, 2, 0x40000, 0x40000);
+    PcmMixAccumulate(at_max.data(), loud.data(), loud.size(), PCM_Q15_GAIN_MAX);
+    CHECK(capped == at_max);
+
+    std::vector<int32_t> untouched(8, 7);
+    PcmMixAccumulate(untouched.data(), loud.data(), loud.size(), -1);
+    for (int32_t value : untouched) CHECK_EQ(value, 7);
+
+    std::vector<int16_t> saturated(8);
+    PcmSaturateBlock(saturated.data(), capped.data(), capped.size());
+    for (int16_t sample : saturated) CHECK_EQ(sample, INT16_MIN);
+}
+
+static void TestMixRampEndpoints()
+{
+    // Stereo ramp from silence to unity: first frame silent, gain rises monotonically
+    const size_t frames = 64;
+    std::vector<int16_t> src(frames * 2, 10000);
+    std::vector<int32_t> acc(frames * 2, 0);
+    PcmMixAccumulateRamp(acc.data(), src.data(), frames, 2, 0, PCM_Q15_UNITY);
+    CHECK_EQ(acc[0], 0);
+    CHECK_EQ(acc[1], 0);
+    for (size_t f = 1; f < frames; ++f) {
+        CHECK(acc[2 * f] >= acc[2 * (f - 1)]);
+        CHECK_EQ(acc[2 * f], acc[2 * f + 1]);
+    }
+    CHECK(acc[2 * (frames - 1)] < 10000);
+}
+
+static void BenchApplyGain()
+{
+    const size_t block = 480;
+    const int blocks = 20000;
+    std::vector<int16_t> src = RandomSamples(block), dst(block);
+    auto run = [&](void (*fn)(int16_t *, const int16_t *, size_t, int32_t)) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < blocks; ++i) fn(dst.data(), src.data(), block, 0x5A82 + (i & 1));
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    double scalar = run(PcmApplyGainScalar);
+    double fast = run(PcmApplyGain);
+    printf("PcmApplyGain (%s): %.0f Msamples/s, scalar %.0f Msamples/s\n", WRAPPER_PCM_SIMD ? "vector" : "unrolled",
+           block * blocks / fast / 1e6, block * blocks / scalar / 1e6);
+}
+
+int main()
+{
+    RUN(TestApplyGainBitExact);
+    RUN(TestApplyGainEdges);
+    RUN(TestMixAccumulate);
+    RUN(TestMixRampEndpoints);
+    RUN(BenchApplyGain);
+    return 0;
+}
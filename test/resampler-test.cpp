@@ -0,0 +1,146 @@
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "test.hpp"
+#include "dsp/resampler.hpp"
+
+using namespace wrapper;
+
+static constexpr double TONE_HZ = 1000.0;
+
+// Interleaved tone at -6 dBFS peak, same on every channel
+static std::vector<int16_t> Tone(uint32_t rate, size_t frames, size_t channels)
+{
+    std::vector<int16_t> samples(frames * channels);
+    for (size_t i = 0; i < frames; ++i) {
+        int16_t v = (int16_t)lrint(16384.0 * sin(2.0 * M_PI * TONE_HZ * i / rate));
+        for (size_t ch = 0; ch < channels; ++ch) samples[i * channels + ch] = v;
+    }
+    return samples;
+}
+
+// Streams through the resampler in uneven blocks, as a player would
+static std::vector<int16_t> Convert(Resampler &resampler, const std::vector<int16_t> &in)
+{
+    const size_t channels = resampler.GetChannels();
+    const size_t in_frames = in.size() / channels;
+    std::vector<int16_t> out(resampler.GetMaxOutputFrames(in_frames) * channels * 2);
+    size_t in_pos = 0, out_pos = 0, block = 0;
+    while (in_pos < in_frames) {
+        size_t frames = std::min(in_frames - in_pos, 61 + (block++ * 97) % 450);
+        size_t consumed = 0;
+        size_t room = resampler.GetMaxOutputFrames(frames);
+        CHECK(out_pos + room <= out.size() / channels);
+        size_t produced = resampler.Process(&in[in_pos * channels], frames, consumed, &out[out_pos * channels], room);
+        CHECK(consumed == frames); // room for the whole call was promised by GetMaxOutputFrames
+        out_pos += produced;
+        in_pos += consumed;
+    }
+    out.resize(out_pos * channels);
+    return out;
+}
+
+// Least-squares fit of DC + the tone, everything left over is THD+N
+static double ThdNDb(const std::vector<int16_t> &samples, size_t channels, size_t channel, uint32_t rate)
+{
+    // Skip the filter warm-up
+    const size_t start = 256;
+    const size_t frames = samples.size() / channels - start;
+    double ss = 0, cc = 0, sc = 0, s1 = 0, c1 = 0, ys = 0, yc = 0, y1 = 0;
+    for (size_t i = 0; i < frames; ++i) {
+        double w = 2.0 * M_PI * TONE_HZ * (start + i) / rate;
+        double s = sin(w), c = cos(w), y = samples[(start + i) * channels + channel];
+        ss += s * s; cc += c * c; sc += s * c; s1 += s; c1 += c;
+        ys += y * s; yc += y * c; y1 += y;
+    }
+    // Solve the 3x3 normal equations for [a b d] in y = a sin + b cos + d
+    double m[3][4] = {{ss, sc, s1, ys}, {sc, cc, c1, yc}, {s1, c1, (double)frames, y1}};
+    for (int k = 0; k < 3; ++k) {
+        for (int r = k + 1; r < 3; ++r) {
+            double f = m[r][k] / m[k][k];
+            for (int j = k; j < 4; ++j) m[r][j] -= f * m[k][j];
+        }
+    }
+    double x[3];
+    for (int k = 2; k >= 0; --k) {
+        x[k] = m[k][3];
+        for (int j = k + 1; j < 3; ++j) x[k] -= m[k][j] * x[j];
+        x[k] /= m[k][k];
+    }
+    double signal = 0, residual = 0;
+    for (size_t i = 0; i < frames; ++i) {
+        double w = 2.0 * M_PI * TONE_HZ * (start + i) / rate;
+        double fit = x[0] * sin(w) + x[1] * cos(w);
+        double r = samples[(start + i) * channels + channel] - fit - x[2];
+        signal += fit * fit;
+        residual += r * r;
+    }
+    return 10.0 * log10(residual / signal);
+}
+
+static void CheckConversion(uint32_t in_rate, uint32_t out_rate, size_t channels, double max_thdn_db)
+{
+    Resampler resampler;
+    CHECK(resampler.Init(in_rate, out_rate, channels));
+    const size_t in_frames = in_rate; // one second
+    std::vector<int16_t> out = Convert(resampler, Tone(in_rate, in_frames, channels));
+
+    // Frame count follows the ratio, give or take the primed first frame and the pending position
+    size_t expected = (size_t)((uint64_t)in_frames * out_rate / in_rate);
+    CHECK(out.size() / channels + 1 >= expected && out.size() / channels <= expected + 2);
+    for (size_t ch = 0; ch < channels; ++ch) {
+        double thdn = ThdNDb(out, channels, ch, out_rate);
+        printf("%u -> %u Hz, %zu ch, channel %zu: THD+N %.1f dB\n", (unsigned)in_rate, (unsigned)out_rate, channels,
+               ch, thdn);
+        CHECK(thdn < max_thdn_db);
+    }
+}
+
+static void TestThdN()
+{
+    CheckConversion(44100, 48000, 1, -60.0);
+    CheckConversion(44100, 48000, 2, -60.0);
+    CheckConversion(48000, 16000, 1, -60.0);
+    CheckConversion(48000, 16000, 2, -60.0);
+}
+
+// Above the output Nyquist a tone must be filtered, not folded back into the band. With 16 taps
+// the transition band is wide and 12 kHz is only 4 kHz past the 8 kHz edge
+static void TestDownsampleRejectsAlias()
+{
+    Resampler resampler;
+    CHECK(resampler.Init(48000, 16000, 1));
+    std::vector<int16_t> in(48000);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = (int16_t)lrint(16384.0 * sin(2.0 * M_PI * 12000.0 * i / 48000));
+    std::vector<int16_t> out = Convert(resampler, in);
+    double sum = 0;
+    for (size_t i = 256; i < out.size(); ++i) sum += (double)out[i] * out[i];
+    double db = 10.0 * log10(sum / (out.size() - 256) / (16384.0 * 16384.0 / 2));
+    printf("12 kHz at 48 -> 16 kHz: %.1f dB\n", db);
+    CHECK(db < -25.0);
+}
+
+static void BenchThroughput()
+{
+    for (auto rates : {std::make_pair(44100u, 48000u), std::make_pair(48000u, 16000u)}) {
+        Resampler resampler;
+        CHECK(resampler.Init(rates.first, rates.second, 2));
+        std::vector<int16_t> in = Tone(rates.first, rates.first, 2);
+        const int seconds = 10;
+        size_t produced = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < seconds; ++i) produced += Convert(resampler, in).size();
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("%u -> %u Hz stereo: %.1f Msamples/s out, %.0fx realtime\n", rates.first, rates.second,
+               produced / elapsed / 1e6, seconds / elapsed);
+        CHECK(seconds / elapsed > 10.0);
+    }
+}
+
+int main()
+{
+    RUN(TestThdN);
+    RUN(TestDownsampleRejectsAlias);
+    RUN(BenchThroughput);
+    return 0;
+}
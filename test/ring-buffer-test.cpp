@@ -0,0 +1,139 @@
+#include <thread>
+#include <vector>
+#include "test.hpp"
+#include "wrapper/ring-buffer.hpp"
+
+using namespace wrapper;
+
+static constexpr size_t STREAM_BYTES = 8 * 1024 * 1024;
+
+// Byte i of the stream, period is not a power of two so it never lines up with the ring
+static uint8_t Expected(size_t i)
+{
+    return (uint8_t)((i % 251) ^ (i >> 11));
+}
+
+static void TestSingleThreadWrap()
+{
+    SpscRingBuffer ring;
+    CHECK(ring.Init(5));
+    CHECK_EQ(ring.Capacity(), 8);
+
+    uint8_t in[6] = {1, 2, 3, 4, 5, 6}, out[8] = {};
+    CHECK_EQ(ring.Write(in, 6), 6);
+    CHECK_EQ(ring.Read(out, 4), 4);
+    CHECK_EQ(ring.Write(in, 6), 6); // wraps
+    CHECK_EQ(ring.Write(in, 1), 0);
+    CHECK_EQ(ring.GetOverruns(), 1);
+    CHECK_EQ(ring.Peek(out, 8), 8);
+    CHECK_EQ(out[0], 5);
+    CHECK_EQ(out[2], 1);
+    CHECK_EQ(out[7], 6);
+    CHECK_EQ(ring.Read(out, 8), 8);
+    CHECK_EQ(ring.Read(out, 1), 0);
+    CHECK_EQ(ring.GetUnderruns(), 1);
+
+    uint8_t storage[12];
+    CHECK(!ring.Init(storage, 12));
+    CHECK(ring.Init(storage, 8));
+}
+
+// Producer and consumer on their own threads, checks every byte across thousands of wraps
+template <typename Produce, typename Consume>
+static void RunStream(size_t capacity, Produce produce, Consume consume)
+{
+    SpscRingBuffer ring;
+    CHECK(ring.Init(capacity));
+    std::thread producer([&] {
+        size_t sent = 0, step = 0;
+        while (sent < STREAM_BYTES) {
+            size_t size = std::min(STREAM_BYTES - sent, 1 + (step++ * 37) % (capacity + 3));
+            size_t done = produce(ring, sent, size);
+            sent += done;
+            if (done == 0) std::this_thread::yield();
+        }
+    });
+    size_t received = 0, step = 0;
+    while (received < STREAM_BYTES) {
+        size_t size = 1 + (step++ * 53) % (capacity + 5);
+        size_t done = consume(ring, received, size);
+        received += done;
+        if (done == 0) std::this_thread::yield();
+    }
+    producer.join();
+    CHECK_EQ(received, STREAM_BYTES);
+    CHECK_EQ(ring.Available(), 0);
+}
+
+static size_t CopyIn(SpscRingBuffer &ring, size_t offset, size_t size)
+{
+    uint8_t block[512];
+    size = std::min(size, sizeof(block));
+    for (size_t i = 0; i < size; ++i) block[i] = Expected(offset + i);
+    return ring.Write(block, size);
+}
+
+static size_t CopyOut(SpscRingBuffer &ring, size_t offset, size_t size)
+{
+    uint8_t block[512];
+    size = std::min(size, sizeof(block));
+    size_t read = ring.Read(block, size);
+    for (size_t i = 0; i < read; ++i) {
+        if (block[i] != Expected(offset + i)) {
+            printf("byte %zu: got %u, expected %u\n", offset + i, block[i], Expected(offset + i));
+            CHECK(false);
+        }
+    }
+    return read;
+}
+
+static size_t SpanIn(SpscRingBuffer &ring, size_t offset, size_t size)
+{
+    RingSpan span = ring.GetWriteSpan();
+    size = std::min(size, span.size);
+    for (size_t i = 0; i < size; ++i) span.data[i] = Expected(offset + i);
+    ring.CommitWrite(size);
+    return size;
+}
+
+static size_t SpanOut(SpscRingBuffer &ring, size_t offset, size_t size)
+{
+    RingSpan span = ring.GetReadSpan();
+    size = std::min(size, span.size);
+    for (size_t i = 0; i < size; ++i) {
+        if (span.data[i] != Expected(offset + i)) {
+            printf("byte %zu: got %u, expected %u\n", offset + i, span.data[i], Expected(offset + i));
+            CHECK(false);
+        }
+    }
+    ring.CommitRead(size);
+    return size;
+}
+
+static void TestCopyStream()
+{
+    RunStream(64, CopyIn, CopyOut);
+    RunStream(4096, CopyIn, CopyOut);
+}
+
+static void TestSpanStream()
+{
+    RunStream(64, SpanIn, SpanOut);
+    RunStream(4096, SpanIn, SpanOut);
+}
+
+// Either side may use either API, they share the same indices
+static void TestMixedStream()
+{
+    RunStream(256, SpanIn, CopyOut);
+    RunStream(256, CopyIn, SpanOut);
+}
+
+int main()
+{
+    RUN(TestSingleThreadWrap);
+    RUN(TestCopyStream);
+    RUN(TestSpanStream);
+    RUN(TestMixedStream);
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "test.hpp"
+#include "dsp/signal-generator.hpp"
+
+using namespace wrapper;
+
+// Q15 reference, saturated like the table entries
+static double ReferenceSine(uint32_t phase)
+{
+    double v = 32768.0 * sin(2.0 * M_PI * (double)phase / 4294967296.0);
+    return v > 32767.0 ? 32767.0 : v;
+}
+
+// The header promises 2 LSB: table rounding, interpolation curvature and the truncating shift
+static void TestDdsSineError()
+{
+    double max_error = 0, sum_error = 0;
+    size_t count = 0;
+    uint32_t random = 1;
+    for (uint64_t i = 0; i < (1u << 20); ++i) {
+        // A regular grid that hits every table entry and interpolation point, then random phases
+        uint32_t phase = (uint32_t)(i << 12);
+        random = random * 1664525u + 1013904223u;
+        for (uint32_t p : {phase, random}) {
+            double error = DdsSine(p) - ReferenceSine(p);
+            max_error = fmax(max_error, fabs(error));
+            sum_error += error;
+            ++count;
+        }
+    }
+    printf("DdsSine: max error %.3f LSB, mean %.3f LSB\n", max_error, sum_error / count);
+    CHECK(max_error <= 2.0);
+    // The shift floors, so the error leans negative, but by less than an LSB
+    CHECK(fabs(sum_error / count) < 1.0);
+
+    CHECK_EQ(DdsSine(0), 0);
+    CHECK_EQ(DdsSine(0x40000000u), 32767);
+    CHECK(DdsSine(0xC0000000u) <= -32767);
+    CHECK_EQ(DdsPhaseStep(1000, 48000), 89478485);
+    CHECK_EQ(DdsPhaseStep(30000, 48000), 0x80000000u);
+    CHECK_EQ(DdsPhaseStep(0, 48000), 0);
+}
+
+// Upward zero crossings in [from, to): one per cycle
+static size_t Crossings(const std::vector<int16_t> &mono, size_t from, size_t to)
+{
+    size_t count = 0;
+    for (size_t i = from + 1; i < to; ++i) count += mono[i - 1] < 0 && mono[i] >= 0;
+    return count;
+}
+
+static std::vector<int16_t> Drain(SignalGenerator &generator, size_t block)
+{
+    std::vector<int16_t> mono, buffer(block * generator.GetChannels());
+    while (!generator.AtEnd()) {
+        size_t frames = generator.ReadFrames(buffer.data(), block);
+        CHECK(frames > 0 && frames <= block);
+        for (size_t f = 0; f < frames; ++f) mono.push_back(buffer[f * generator.GetChannels()]);
+    }
+    CHECK_EQ(generator.ReadFrames(buffer.data(), block), 0);
+    return mono;
+}
+
+static void TestSine()
+{
+    SineGenerator sine;
+    CHECK(sine.Init(48000, 1000, 0.5f));
+    sine.SetChannels(2);
+    sine.SetDuration(1000);
+    std::vector<int16_t> stereo(48000 * 2);
+    CHECK_EQ(sine.ReadFrames(stereo.data(), 48000), 48000);
+    CHECK(sine.AtEnd());
+    std::vector<int16_t> mono(48000);
+    int16_t peak = 0;
+    for (size_t f = 0; f < 48000; ++f) {
+        CHECK_EQ(stereo[f * 2], stereo[f * 2 + 1]);
+        mono[f] = stereo[f * 2];
+        peak = std::max(peak, mono[f]);
+    }
+    CHECK(abs(peak - 16384) <= 2);
+    CHECK(abs((int)Crossings(mono, 0, mono.size()) - 1000) <= 1);
+}
+
+static void TestSweepFrames()
+{
+    // Durations that do not divide into whole frames are truncated, blocks never overshoot
+    struct Case
+    {
+        uint32_t rate, ms;
+        size_t frames;
+    } cases[] = {{48000, 250, 12000}, {44100, 333, 14685}, {16000, 1, 16}, {8000, 2000, 16000}};
+    for (const Case &c : cases) {
+        for (size_t block : {1, 97, 512}) {
+            SweepGenerator sweep;
+            CHECK(sweep.Init(c.rate, 100, 3000, c.ms));
+            CHECK_EQ(Drain(sweep, block).size(), c.frames);
+            sweep.Restart();
+            CHECK(!sweep.AtEnd());
+            CHECK_EQ(Drain(sweep, block).size(), c.frames);
+        }
+    }
+    SweepGenerator sweep;
+    CHECK(!sweep.Init(48000, 0, 1000, 100));
+    CHECK(!sweep.Init(48000, 100, 1000, 0));
+}
+
+// Instantaneous frequency from the crossings of a 50 ms window, at the start, middle and end
+static void TestSweepTrajectory()
+{
+    const uint32_t rate = 48000;
+    for (bool exponential : {true, false}) {
+        SweepGenerator sweep;
+        CHECK(sweep.Init(rate, 200, 3200, 2000, 0.5f, exponential));
+        std::vector<int16_t> mono = Drain(sweep, 256);
+        const size_t window = rate / 20;
+        auto hz_at = [&](size_t center) {
+            size_t from = center < window / 2 ? 0 : center - window / 2;
+            size_t to = std::min(from + window, mono.size());
+            return Crossings(mono, from, to) * (double)rate / (to - from);
+        };
+        auto expected_hz = [&](size_t center) {
+            double t = (double)center / mono.size();
+            return exponential ? 200.0 * pow(16.0, t) : 200.0 + 3000.0 * t;
+        };
+        for (size_t center : {window / 2, mono.size() / 2, mono.size() - window / 2}) {
+            printf("%s sweep at %zu: %.0f Hz, expected %.0f Hz\n", exponential ? "exponential" : "linear", center,
+                   hz_at(center), expected_hz(center));
+            // One crossing more or less in the window is 20 Hz
+            CHECK(fabs(hz_at(center) - expected_hz(center)) < std::max(40.0, expected_hz(center) * 0.03));
+        }
+    }
+}
+
+// Power of one frequency over a segment, normalised to the squared amplitude
+static double Goertzel(const int16_t *x, size_t n, double hz, uint32_t rate)
+{
+    double coeff = 2.0 * cos(2.0 * M_PI * hz / rate), s1 = 0, s2 = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double s = x[i] + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s;
+    }
+    double power = s1 * s1 + s2 * s2 - coeff * s1 * s2;
+    return 4.0 * power / ((double)n * n);
+}
+
+static void TestDtmf()
+{
+    struct Case
+    {
+        uint32_t rate, tone_ms, gap_ms;
+        size_t tone, gap;
+    } cases[] = {{8000, 100, 50, 800, 400}, {44100, 70, 30, 3087, 1323}, {16000, 40, 0, 640, 0}};
+    const char *digits = "1,#D";
+    const double low[] = {697, 0, 941, 941}, high[] = {1209, 0, 1477, 1633};
+    for (const Case &c : cases) {
+        DtmfGenerator dtmf;
+        CHECK(dtmf.Init(c.rate, digits, c.tone_ms, c.gap_ms, 0.8f));
+        std::vector<int16_t> mono = Drain(dtmf, 61);
+        const size_t slot = c.tone + c.gap;
+        CHECK_EQ(mono.size(), 4 * slot);
+
+        for (size_t d = 0; d < 4; ++d) {
+            const int16_t *tone = &mono[d * slot];
+            // Gaps and the pause are digital silence
+            for (size_t i = c.tone; i < slot; ++i) CHECK_EQ(tone[i], 0);
+            if (low[d] == 0) {
+                for (size_t i = 0; i < c.tone; ++i) CHECK_EQ(tone[i], 0);
+                continue;
+            }
+            // Each tone at half the amplitude: 0.4 full scale
+            const double expected = 0.4 * 32768 * 0.4 * 32768;
+            CHECK(fabs(Goertzel(tone, c.tone, low[d], c.rate) / expected - 1.0) < 0.1);
+            CHECK(fabs(Goertzel(tone, c.tone, high[d], c.rate) / expected - 1.0) < 0.1);
+            // And not the neighbouring column
+            CHECK(Goertzel(tone, c.tone, high[d] == 1477 ? 1336 : 1477, c.rate) < expected * 0.05);
+        }
+    }
+
+    DtmfGenerator empty;
+    CHECK(empty.Init(8000, ""));
+    CHECK(empty.AtEnd());
+    CHECK(!empty.Init(8000, "1", 0));
+}
+
+static void TestClickFrames()
+{
+    ClickGenerator click;
+    CHECK(click.Init(48000, 120, 3, 15));
+    click.SetFrames(48000 * 3);
+    std::vector<int16_t> mono = Drain(click, 333);
+    CHECK_EQ(mono.size(), 48000 * 3);
+    // A click every 24000 frames, 720 frames long, silence after
+    for (size_t beat = 0; beat < 6; ++beat) {
+        const int16_t *start = &mono[beat * 24000];
+        int16_t peak = 0;
+        for (size_t i = 0; i < 720; ++i) peak = std::max<int16_t>(peak, abs(start[i]));
+        CHECK(peak > 8000);
+        for (size_t i = 720; i < 24000; ++i) CHECK_EQ(start[i], 0);
+    }
+}
+
+int main()
+{
+    RUN(TestDdsSineError);
+    RUN(TestSine);
+    RUN(TestSweepFrames);
+    RUN(TestSweepTrajectory);
+    RUN(TestDtmf);
+    RUN(TestClickFrames);
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include "test.hpp"
+#include "board/m5stack/speaker-eq.hpp"
+
+using namespace wrapper;
+
+// The boards design these at compile time, so do the tests
+static constexpr auto CORE_S3 = EqDesign(M5STACK_CORE_S3_SPEAKER_RATE, M5STACK_CORE_S3_SPEAKER_EQ);
+static constexpr auto TAB5 = EqDesign(M5STACK_TAB5_SPEAKER_RATE, M5STACK_TAB5_SPEAKER_EQ);
+
+// RBJ cookbook in double with libm, independent of the constexpr math the designs use
+static double BandDb(const EqBand &band, double rate, double freq)
+{
+    const double a = pow(10.0, band.gain_db / 40.0);
+    const double w0 = 2.0 * M_PI * band.freq / rate;
+    const double c = cos(w0), alpha = sin(w0) / (2.0 * band.q), beta = 2.0 * sqrt(a) * alpha;
+    double b[3], d[3];
+    switch (band.type) {
+    case EqType::HighPass:
+        b[0] = b[2] = (1.0 + c) / 2.0, b[1] = -(1.0 + c), d[0] = 1.0 + alpha, d[1] = -2.0 * c, d[2] = 1.0 - alpha;
+        break;
+    case EqType::LowPass:
+        b[0] = b[2] = (1.0 - c) / 2.0, b[1] = 1.0 - c, d[0] = 1.0 + alpha, d[1] = -2.0 * c, d[2] = 1.0 - alpha;
+        break;
+    case EqType::HighShelf:
+        b[0] = a * ((a + 1) + (a - 1) * c + beta), b[1] = -2 * a * ((a - 1) + (a + 1) * c);
+        b[2] = a * ((a + 1) + (a - 1) * c - beta);
+        d[0] = (a + 1) - (a - 1) * c + beta, d[1] = 2 * ((a - 1) - (a + 1) * c), d[2] = (a + 1) - (a - 1) * c - beta;
+        break;
+    case EqType::LowShelf:
+        b[0] = a * ((a + 1) - (a - 1) * c + beta), b[1] = 2 * a * ((a - 1) - (a + 1) * c);
+        b[2] = a * ((a + 1) - (a - 1) * c - beta);
+        d[0] = (a + 1) + (a - 1) * c + beta, d[1] = -2 * ((a - 1) + (a + 1) * c), d[2] = (a + 1) + (a - 1) * c - beta;
+        break;
+    case EqType::Peaking:
+    default:
+        b[0] = 1 + alpha * a, b[1] = -2 * c, b[2] = 1 - alpha * a;
+        d[0] = 1 + alpha / a, d[1] = -2 * c, d[2] = 1 - alpha / a;
+        break;
+    }
+    const std::complex<double> z1 = std::polar(1.0, -2.0 * M_PI * freq / rate), z2 = z1 * z1;
+    return 20.0 * log10(std::abs((b[0] + b[1] * z1 + b[2] * z2) / (d[0] + d[1] * z1 + d[2] * z2)));
+}
+
+template <size_t BANDS>
+static double SpecDb(const EqSpec<BANDS> &spec, double rate, double freq)
+{
+    double db = spec.preamp_db;
+    for (const EqBand &band : spec.bands) db += BandDb(band, rate, freq);
+    return db;
+}
+
+// BiquadResponseDb over the quantised sections against the double design, 20 Hz to just below Nyquist
+template <size_t BANDS>
+static void CheckResponse(const std::array<BiquadCoeffs, BANDS> &sections, const EqSpec<BANDS> &spec, double rate,
+                          const char *name)
+{
+    double worst = 0, max_db = -100;
+    for (double freq = 20.0; freq < rate * 0.49; freq *= 1.02) {
+        double db = 0;
+        for (const BiquadCoeffs &section : sections) db += BiquadResponseDb(section, rate, freq);
+        worst = fmax(worst, fabs(db - SpecDb(spec, rate, freq)));
+        max_db = fmax(max_db, db);
+        // The Equalizer reports the same thing
+        CHECK(fabs(Equalizer<BANDS>(rate, sections).Response(freq) - db) < 1e-9);
+    }
+    printf("%s: worst deviation %.5f dB, max gain %+.2f dB\n", name, worst, max_db);
+    // Q30 coefficients: the gap only shows deep in the high pass stop band
+    CHECK(worst < 0.01);
+    // The preamp leaves headroom for the boosts, so the EQ never pushes a full scale tone into clipping
+    CHECK(max_db <= 0.0);
+}
+
+static void TestCoreS3()
+{
+    CheckResponse(CORE_S3, M5STACK_CORE_S3_SPEAKER_EQ, M5STACK_CORE_S3_SPEAKER_RATE, "CoreS3");
+    const double rate = M5STACK_CORE_S3_SPEAKER_RATE;
+    Equalizer<4> eq(rate, CORE_S3);
+    // The high pass keeps the small driver out of its excursion limit
+    CHECK(eq.Response(100) < eq.Response(600) - 15.0);
+    CHECK(eq.Response(2800) < eq.Response(1500));
+}
+
+static void TestTab5()
+{
+    CheckResponse(TAB5, M5STACK_TAB5_SPEAKER_EQ, M5STACK_TAB5_SPEAKER_RATE, "Tab5");
+    Equalizer<4> eq(M5STACK_TAB5_SPEAKER_RATE, TAB5);
+    CHECK(eq.Response(50) < eq.Response(300) - 15.0);
+    CHECK(eq.Response(15000) > eq.Response(5000));
+}
+
+int main()
+{
+    RUN(TestCoreS3);
+    RUN(TestTab5);
+    return 0;
+}
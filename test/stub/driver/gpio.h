@@ -0,0 +1,4 @@
+// Host stand-in for the ESP-IDF header of the same name, for test/ only
+#pragma once
+
+typedef enum { GPIO_NUM_NC = -1, GPIO_NUM_0 = 0 } gpio_num_t;
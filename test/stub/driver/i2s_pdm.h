@@ -0,0 +1,56 @@
+// Host stand-in for the ESP-IDF header of the same name, for test/ only
+#pragma once
+
+#include "driver/i2s_types.h"
+
+typedef enum { I2S_PDM_DSR_8S, I2S_PDM_DSR_16S } i2s_pdm_dsr_t;
+typedef enum { I2S_PDM_SLOT_LEFT = 1, I2S_PDM_SLOT_RIGHT = 2, I2S_PDM_SLOT_BOTH = 3 } i2s_pdm_slot_mask_t;
+
+typedef struct {
+    struct {
+        uint32_t sample_rate_hz;
+        i2s_clock_src_t clk_src;
+        i2s_mclk_multiple_t mclk_multiple;
+        i2s_pdm_dsr_t dn_sample_mode;
+        uint32_t bclk_div;
+    } clk_cfg;
+    struct {
+        i2s_data_bit_width_t data_bit_width;
+        i2s_slot_bit_width_t slot_bit_width;
+        i2s_slot_mode_t slot_mode;
+        i2s_pdm_slot_mask_t slot_mask;
+    } slot_cfg;
+    struct {
+        gpio_num_t clk;
+        gpio_num_t din;
+        struct {
+            uint32_t clk_inv : 1;
+        } invert_flags;
+    } gpio_cfg;
+} i2s_pdm_rx_config_t;
+
+typedef struct {
+    struct {
+        uint32_t sample_rate_hz;
+        i2s_clock_src_t clk_src;
+        i2s_mclk_multiple_t mclk_multiple;
+        uint32_t up_sample_fp;
+        uint32_t up_sample_fs;
+        uint32_t bclk_div;
+    } clk_cfg;
+    struct {
+        i2s_data_bit_width_t data_bit_width;
+        i2s_slot_bit_width_t slot_bit_width;
+        i2s_slot_mode_t slot_mode;
+    } slot_cfg;
+    struct {
+        gpio_num_t clk;
+        gpio_num_t dout;
+        struct {
+            uint32_t clk_inv : 1;
+        } invert_flags;
+    } gpio_cfg;
+} i2s_pdm_tx_config_t;
+
+esp_err_t i2s_channel_init_pdm_rx_mode(i2s_chan_handle_t handle, const i2s_pdm_rx_config_t *pdm_rx_cfg);
+esp_err_t i2s_channel_init_pdm_tx_mode(i2s_chan_handle_t handle, const i2s_pdm_tx_config_t *pdm_tx_cfg);
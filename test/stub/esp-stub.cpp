@@ -0,0 +1,61 @@
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "fake-timer.hpp"
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK: return "ESP_OK";
+    case ESP_FAIL: return "ESP_FAIL";
+    case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+    default: return "UNKNOWN ERROR";
+    }
+}
+
+static std::atomic<bool> fake_timer{false};
+static std::atomic<int64_t> fake_timer_us{0};
+
+int64_t esp_timer_get_time(void)
+{
+    if (fake_timer) return fake_timer_us;
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void FakeTimerSet(int64_t us)
+{
+    fake_timer_us = us;
+    fake_timer = true;
+}
+
+void FakeTimerAdvance(int64_t us)
+{
+    fake_timer_us += us;
+}
+
+void FakeTimerRelease()
+{
+    fake_timer = false;
+}
+
+void esp_log_stub(char level, const char *tag, const char *format, ...)
+{
+    if (level != 'E' && level != 'W') return;
+    fprintf(stderr, "%c %s: ", level, tag);
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
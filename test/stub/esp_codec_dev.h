@@ -0,0 +1,29 @@
+// Host stand-in for the esp_codec_dev header of the same name, for test/ only
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef struct fake_codec_dev_t *esp_codec_dev_handle_t;
+
+typedef struct
+{
+    uint8_t bits_per_sample;
+    uint8_t channel;
+    uint16_t channel_mask;
+    uint32_t sample_rate;
+    int mclk_multiple;
+} esp_codec_dev_sample_info_t;
+
+int esp_codec_dev_open(esp_codec_dev_handle_t codec, esp_codec_dev_sample_info_t *fs);
+int esp_codec_dev_close(esp_codec_dev_handle_t codec);
+int esp_codec_dev_read(esp_codec_dev_handle_t codec, void *data, int len);
+int esp_codec_dev_write(esp_codec_dev_handle_t codec, void *data, int len);
+int esp_codec_dev_set_out_vol(esp_codec_dev_handle_t codec, int volume);
+int esp_codec_dev_get_out_vol(esp_codec_dev_handle_t codec, int *volume);
+int esp_codec_dev_set_out_mute(esp_codec_dev_handle_t codec, bool mute);
+int esp_codec_dev_get_out_mute(esp_codec_dev_handle_t codec, bool *muted);
+int esp_codec_dev_set_in_gain(esp_codec_dev_handle_t codec, float db_value);
+int esp_codec_dev_get_in_gain(esp_codec_dev_handle_t codec, float *db_value);
+int esp_codec_dev_set_in_mute(esp_codec_dev_handle_t codec, bool mute);
+int esp_codec_dev_get_in_mute(esp_codec_dev_handle_t codec, bool *muted);
@@ -0,0 +1,29 @@
+// Host stand-in for the esp_codec_dev header of the same name, for test/ only
+#pragma once
+
+#include <stdint.h>
+#include "driver/i2s_types.h"
+
+typedef struct audio_codec_if_t audio_codec_if_t;
+typedef struct audio_codec_ctrl_if_t audio_codec_ctrl_if_t;
+typedef struct audio_codec_data_if_t audio_codec_data_if_t;
+typedef struct audio_codec_gpio_if_t audio_codec_gpio_if_t;
+
+typedef struct
+{
+    uint8_t port;
+    uint8_t addr;
+    void *bus_handle;
+} audio_codec_i2c_cfg_t;
+
+typedef struct
+{
+    uint8_t port;
+    void *rx_handle;
+    void *tx_handle;
+    i2s_clock_src_t clk_src;
+} audio_codec_i2s_cfg_t;
+
+const audio_codec_gpio_if_t *audio_codec_new_gpio(void);
+const audio_codec_ctrl_if_t *audio_codec_new_i2c_ctrl(audio_codec_i2c_cfg_t *cfg);
+const audio_codec_data_if_t *audio_codec_new_i2s_data(audio_codec_i2s_cfg_t *cfg);
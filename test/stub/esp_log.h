@@ -0,0 +1,11 @@
+// Host stand-in for the ESP-IDF header of the same name, for test/ only
+#pragma once
+
+// Errors and warnings go to stderr, the rest is dropped
+void esp_log_stub(char level, const char *tag, const char *format, ...);
+
+#define ESP_LOGE(tag, format, ...) esp_log_stub('E', tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) esp_log_stub('W', tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) esp_log_stub('I', tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) esp_log_stub('D', tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) esp_log_stub('V', tag, format, ##__VA_ARGS__)
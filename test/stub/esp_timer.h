@@ -0,0 +1,7 @@
+// Host stand-in for the ESP-IDF header of the same name, for test/ only
+#pragma once
+
+#include <stdint.h>
+
+// Microseconds of a monotonic clock
+int64_t esp_timer_get_time(void);
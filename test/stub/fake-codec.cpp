@@ -0,0 +1,136 @@
+#include <cstring>
+#include "fake-codec.hpp"
+#include "esp_codec_dev_defaults.h"
+
+struct audio_codec_ctrl_if_t
+{
+    int unused;
+};
+
+struct audio_codec_data_if_t
+{
+    int unused;
+};
+
+struct audio_codec_gpio_if_t
+{
+    int unused;
+};
+
+esp_codec_dev_handle_t FakeCodecNew()
+{
+    return new fake_codec_dev_t;
+}
+
+void FakeCodecDelete(esp_codec_dev_handle_t codec)
+{
+    delete codec;
+}
+
+std::vector<int16_t> FakeCodecWritten(esp_codec_dev_handle_t codec)
+{
+    std::lock_guard<std::mutex> lock(codec->mutex);
+    return codec->written;
+}
+
+const audio_codec_gpio_if_t *audio_codec_new_gpio(void)
+{
+    static audio_codec_gpio_if_t gpio_if;
+    return &gpio_if;
+}
+
+const audio_codec_ctrl_if_t *audio_codec_new_i2c_ctrl(audio_codec_i2c_cfg_t *)
+{
+    static audio_codec_ctrl_if_t ctrl_if;
+    return &ctrl_if;
+}
+
+const audio_codec_data_if_t *audio_codec_new_i2s_data(audio_codec_i2s_cfg_t *)
+{
+    static audio_codec_data_if_t data_if;
+    return &data_if;
+}
+
+int esp_codec_dev_open(esp_codec_dev_handle_t codec, esp_codec_dev_sample_info_t *)
+{
+    if (codec == nullptr) return ESP_ERR_INVALID_ARG;
+    codec->open = true;
+    return ESP_OK;
+}
+
+int esp_codec_dev_close(esp_codec_dev_handle_t codec)
+{
+    if (codec == nullptr) return ESP_ERR_INVALID_ARG;
+    codec->open = false;
+    return ESP_OK;
+}
+
+int esp_codec_dev_read(esp_codec_dev_handle_t codec, void *data, int len)
+{
+    if (codec == nullptr) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lock(codec->mutex);
+    if (codec->result != ESP_OK) return codec->result;
+    int16_t *samples = static_cast<int16_t *>(data);
+    for (size_t i = 0; i < (size_t)len / sizeof(int16_t); ++i) {
+        samples[i] = codec->read_pos < codec->to_read.size() ? codec->to_read[codec->read_pos++] : 0;
+    }
+    return ESP_OK;
+}
+
+int esp_codec_dev_write(esp_codec_dev_handle_t codec, void *data, int len)
+{
+    if (codec == nullptr) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lock(codec->mutex);
+    if (codec->result != ESP_OK) return codec->result;
+    const int16_t *samples = static_cast<const int16_t *>(data);
+    codec->written.insert(codec->written.end(), samples, samples + len / sizeof(int16_t));
+    return ESP_OK;
+}
+
+int esp_codec_dev_set_out_vol(esp_codec_dev_handle_t codec, int volume)
+{
+    codec->volume = volume;
+    return ESP_OK;
+}
+
+int esp_codec_dev_get_out_vol(esp_codec_dev_handle_t codec, int *volume)
+{
+    *volume = codec->volume;
+    return ESP_OK;
+}
+
+int esp_codec_dev_set_out_mute(esp_codec_dev_handle_t codec, bool mute)
+{
+    codec->out_mute = mute;
+    return ESP_OK;
+}
+
+int esp_codec_dev_get_out_mute(esp_codec_dev_handle_t codec, bool *muted)
+{
+    *muted = codec->out_mute;
+    return ESP_OK;
+}
+
+int esp_codec_dev_set_in_gain(esp_codec_dev_handle_t codec, float db_value)
+{
+    codec->in_gain = db_value;
+    return ESP_OK;
+}
+
+int esp_codec_dev_get_in_gain(esp_codec_dev_handle_t codec, float *db_value)
+{
+    *db_value = codec->in_gain;
+    return ESP_OK;
+}
+
+int esp_codec_dev_set_in_mute(esp_codec_dev_handle_t codec, bool mute)
+{
+    codec->in_mute = mute;
+    return ESP_OK;
+}
+
+int esp_codec_dev_get_in_mute(esp_codec_dev_handle_t codec, bool *muted)
+{
+    *muted = codec->in_mute;
+    return ESP_OK;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "esp_codec_dev.h"
+
+/**
+ * A codec device that keeps every sample written to it and plays back
+ * whatever the test queued for reads (silence once that runs out).
+ */
+struct fake_codec_dev_t
+{
+    std::mutex mutex;
+    bool open = false;
+    int result = ESP_OK; // returned by read/write, nothing moves unless ESP_OK
+    std::vector<int16_t> written;
+    std::vector<int16_t> to_read;
+    size_t read_pos = 0;
+    int volume = 0;
+    bool out_mute = false;
+    float in_gain = 0.0f;
+    bool in_mute = false;
+};
+
+esp_codec_dev_handle_t FakeCodecNew();
+void FakeCodecDelete(esp_codec_dev_handle_t codec);
+// Copy of the samples written so far
+std::vector<int16_t> FakeCodecWritten(esp_codec_dev_handle_t codec);
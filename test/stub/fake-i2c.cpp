@@ -0,0 +1,174 @@
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "fake-i2c.hpp"
+
+struct i2c_master_bus_t
+{
+    int unused = 0;
+};
+
+struct i2c_master_dev_t
+{
+    uint16_t addr;
+    uint32_t speed_hz;
+};
+
+namespace
+{
+
+struct FakeBus
+{
+    std::mutex mutex;
+    std::map<uint16_t, std::unique_ptr<uint8_t[]>> regs;
+    std::map<uint16_t, uint8_t> pointer;
+    std::vector<FakeI2cTransfer> log;
+    int fail_in = 0;
+    bool timing = false;
+
+    uint8_t *Regs(uint16_t addr)
+    {
+        auto &regs_of = regs[addr];
+        if (!regs_of) {
+            regs_of.reset(new uint8_t[256]);
+            memset(regs_of.get(), 0, 256);
+        }
+        return regs_of.get();
+    }
+
+    bool NextFails()
+    {
+        return fail_in > 0 && --fail_in == 0;
+    }
+};
+
+FakeBus &Bus()
+{
+    static FakeBus bus;
+    return bus;
+}
+
+// Start, address byte and a bit per data bit plus ACK, a repeated start re-sends the address
+void WaitBitTime(const i2c_master_dev_t *dev, size_t write_size, size_t read_size)
+{
+    size_t bytes = 1 + write_size + read_size + (write_size > 0 && read_size > 0 ? 1 : 0);
+    std::this_thread::sleep_for(std::chrono::nanoseconds((uint64_t)bytes * 9 * 1000000000ull / dev->speed_hz));
+}
+
+esp_err_t Transfer(i2c_master_dev_handle_t dev, const uint8_t *write_buffer, size_t write_size, uint8_t *read_buffer,
+                   size_t read_size)
+{
+    FakeBus &bus = Bus();
+    std::lock_guard<std::mutex> lock(bus.mutex);
+    if (bus.timing) WaitBitTime(dev, write_size, read_size);
+
+    bool ok = !bus.NextFails();
+    uint8_t *regs = bus.Regs(dev->addr);
+    uint8_t &pointer = bus.pointer[dev->addr];
+    if (ok) {
+        if (write_size > 0) pointer = write_buffer[0];
+        for (size_t i = 1; i < write_size; ++i) regs[pointer++] = write_buffer[i];
+        for (size_t i = 0; i < read_size; ++i) read_buffer[i] = regs[pointer++];
+    }
+    bus.log.push_back({dev->addr, write_size > 0 ? write_buffer[0] : (uint8_t)0, write_size, read_size, ok});
+    return ok ? ESP_OK : ESP_FAIL;
+}
+
+} // namespace
+
+void FakeI2cReset()
+{
+    FakeBus &bus = Bus();
+    std::lock_guard<std::mutex> lock(bus.mutex);
+    bus.regs.clear();
+    bus.pointer.clear();
+    bus.log.clear();
+    bus.fail_in = 0;
+    bus.timing = false;
+}
+
+std::vector<FakeI2cTransfer> FakeI2cLog()
+{
+    std::lock_guard<std::mutex> lock(Bus().mutex);
+    return Bus().log;
+}
+
+void FakeI2cClearLog()
+{
+    std::lock_guard<std::mutex> lock(Bus().mutex);
+    Bus().log.clear();
+}
+
+void FakeI2cFailTransfer(int count)
+{
+    std::lock_guard<std::mutex> lock(Bus().mutex);
+    Bus().fail_in = count;
+}
+
+void FakeI2cSimulateTiming(bool enable)
+{
+    std::lock_guard<std::mutex> lock(Bus().mutex);
+    Bus().timing = enable;
+}
+
+uint8_t *FakeI2cRegs(uint16_t addr)
+{
+    std::lock_guard<std::mutex> lock(Bus().mutex);
+    return Bus().Regs(addr);
+}
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *, i2c_master_bus_handle_t *ret_bus_handle)
+{
+    *ret_bus_handle = new i2c_master_bus_t;
+    return ESP_OK;
+}
+
+esp_err_t i2c_del_master_bus(i2c_master_bus_handle_t bus_handle)
+{
+    delete bus_handle;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_reset(i2c_master_bus_handle_t)
+{
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_probe(i2c_master_bus_handle_t, uint16_t address, int)
+{
+    std::lock_guard<std::mutex> lock(Bus().mutex);
+    return Bus().regs.count(address) ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t, const i2c_device_config_t *dev_config,
+                                    i2c_master_dev_handle_t *ret_handle)
+{
+    *ret_handle = new i2c_master_dev_t{dev_config->device_address, dev_config->scl_speed_hz};
+    FakeI2cRegs(dev_config->device_address);
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t handle)
+{
+    delete handle;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer, size_t write_size, int)
+{
+    return Transfer(i2c_dev, write_buffer, write_size, nullptr, 0);
+}
+
+esp_err_t i2c_master_receive(i2c_master_dev_handle_t i2c_dev, uint8_t *read_buffer, size_t read_size, int)
+{
+    return Transfer(i2c_dev, nullptr, 0, read_buffer, read_size);
+}
+
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer,
+                                      size_t write_size, uint8_t *read_buffer, size_t read_size, int)
+{
+    return Transfer(i2c_dev, write_buffer, write_size, read_buffer, read_size);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "driver/i2c_master.h"
+
+// One bus transfer as the device saw it: reg is the first written byte (0 for a plain read)
+struct FakeI2cTransfer
+{
+    uint16_t addr;
+    uint8_t reg;
+    size_t write_size; // register byte included
+    size_t read_size;
+    bool ok;
+};
+
+/**
+ * Every device added to a fake bus is a 256 byte register file whose pointer
+ * advances per byte. All transfers are logged; the bus is one mutex, so
+ * transfers from several threads serialize like on the wire.
+ */
+void FakeI2cReset();
+std::vector<FakeI2cTransfer> FakeI2cLog();
+void FakeI2cClearLog();
+// The count-th transfer from now (1 is the next one) fails with ESP_FAIL
+void FakeI2cFailTransfer(int count);
+// Block the caller for the bit time of every transfer at the device's scl_speed_hz,
+// sleeping like the interrupt driven driver does so other threads get the CPU
+void FakeI2cSimulateTiming(bool enable);
+// Register file of the device at addr, created on first use
+uint8_t *FakeI2cRegs(uint16_t addr);
@@ -0,0 +1,77 @@
+#include <cstring>
+#include "fake-i2s.hpp"
+#include "driver/i2s_std.h"
+#include "driver/i2s_tdm.h"
+#include "driver/i2s_pdm.h"
+
+esp_err_t i2s_new_channel(const i2s_chan_config_t *, i2s_chan_handle_t *ret_tx_handle, i2s_chan_handle_t *ret_rx_handle)
+{
+    if (ret_tx_handle != nullptr) {
+        *ret_tx_handle = new i2s_channel_obj_t;
+        (*ret_tx_handle)->tx = true;
+    }
+    if (ret_rx_handle != nullptr) *ret_rx_handle = new i2s_channel_obj_t;
+    return ESP_OK;
+}
+
+esp_err_t i2s_del_channel(i2s_chan_handle_t handle)
+{
+    delete handle;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_enable(i2s_chan_handle_t handle)
+{
+    handle->enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_disable(i2s_chan_handle_t handle)
+{
+    handle->enabled = false;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_write(i2s_chan_handle_t handle, const void *src, size_t size, size_t *bytes_written, uint32_t)
+{
+    if (handle->result == ESP_OK) {
+        const uint8_t *bytes = static_cast<const uint8_t *>(src);
+        handle->written.insert(handle->written.end(), bytes, bytes + size);
+    }
+    *bytes_written = handle->result == ESP_OK ? size : 0;
+    return handle->result;
+}
+
+esp_err_t i2s_channel_read(i2s_chan_handle_t handle, void *dest, size_t size, size_t *bytes_read, uint32_t)
+{
+    if (handle->result == ESP_OK) memset(dest, 0, size);
+    *bytes_read = handle->result == ESP_OK ? size : 0;
+    return handle->result;
+}
+
+esp_err_t i2s_channel_register_event_callback(i2s_chan_handle_t handle, const i2s_event_callbacks_t *callbacks,
+                                              void *user_data)
+{
+    handle->callbacks = *callbacks;
+    handle->user_ctx = user_data;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_init_std_mode(i2s_chan_handle_t, const i2s_std_config_t *) { return ESP_OK; }
+esp_err_t i2s_channel_init_tdm_mode(i2s_chan_handle_t, const i2s_tdm_config_t *) { return ESP_OK; }
+esp_err_t i2s_channel_init_pdm_rx_mode(i2s_chan_handle_t, const i2s_pdm_rx_config_t *) { return ESP_OK; }
+esp_err_t i2s_channel_init_pdm_tx_mode(i2s_chan_handle_t, const i2s_pdm_tx_config_t *) { return ESP_OK; }
+
+void FakeI2sDmaEvents(i2s_chan_handle_t handle, uint32_t count)
+{
+    i2s_isr_callback_t callback = handle->tx ? handle->callbacks.on_sent : handle->callbacks.on_recv;
+    i2s_event_data_t event = {};
+    for (uint32_t i = 0; i < count && callback != nullptr; ++i) callback(handle, &event, handle->user_ctx);
+}
+
+void FakeI2sQueueOverflows(i2s_chan_handle_t handle, uint32_t count)
+{
+    i2s_isr_callback_t callback = handle->tx ? handle->callbacks.on_send_q_ovf : handle->callbacks.on_recv_q_ovf;
+    i2s_event_data_t event = {};
+    for (uint32_t i = 0; i < count && callback != nullptr; ++i) callback(handle, &event, handle->user_ctx);
+}
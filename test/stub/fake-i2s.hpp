@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "driver/i2s_types.h"
+
+// Drives the ISR callbacks of a channel from a test, as the I2S DMA would
+struct i2s_channel_obj_t
+{
+    bool tx = false;
+    bool enabled = false;
+    esp_err_t result = ESP_OK; // returned by write/read, nothing moves unless ESP_OK
+    std::vector<uint8_t> written; // every byte a successful write moved
+    i2s_event_callbacks_t callbacks = {};
+    void *user_ctx = nullptr;
+};
+
+void FakeI2sDmaEvents(i2s_chan_handle_t handle, uint32_t count);
+void FakeI2sQueueOverflows(i2s_chan_handle_t handle, uint32_t count);
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+// Pins esp_timer_get_time to a test controlled value; FakeTimerRelease goes back to the real clock
+void FakeTimerSet(int64_t us);
+void FakeTimerAdvance(int64_t us);
+void FakeTimerRelease();
@@ -0,0 +1,149 @@
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+struct StubTask
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t notify_count = 0;
+};
+
+struct StubSemaphore
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    UBaseType_t count;
+    UBaseType_t max_count;
+    bool is_static;
+
+    StubSemaphore(UBaseType_t max, UBaseType_t initial, bool static_storage)
+        : count(initial), max_count(max), is_static(static_storage)
+    {
+    }
+};
+
+static_assert(sizeof(StubSemaphore) <= sizeof(StaticSemaphore_t), "grow StaticSemaphore_t");
+
+namespace
+{
+
+thread_local StubTask *current_task = nullptr;
+
+// Waits on cv until ready() or the ticks run out, portMAX_DELAY waits forever
+template <typename Ready>
+bool WaitTicks(std::unique_lock<std::mutex> &lock, std::condition_variable &cv, TickType_t ticks, Ready ready)
+{
+    if (ticks == portMAX_DELAY) {
+        cv.wait(lock, ready);
+        return true;
+    }
+    return cv.wait_for(lock, std::chrono::milliseconds(ticks * 1000 / configTICK_RATE_HZ), ready);
+}
+
+} // namespace
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stack_size, void *param,
+                                   UBaseType_t priority, TaskHandle_t *created, BaseType_t core_id)
+{
+    StubTask *task = new StubTask;
+    if (created != nullptr) *created = task;
+    std::thread([task, function, param] {
+        current_task = task;
+        function(param);
+    }).detach();
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks * 1000 / configTICK_RATE_HZ));
+}
+
+void taskYIELD(void)
+{
+    std::this_thread::yield();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    if (current_task == nullptr) current_task = new StubTask;
+    return current_task;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    std::lock_guard<std::mutex> lock(task->mutex);
+    ++task->notify_count;
+    task->cv.notify_all();
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks)
+{
+    StubTask *task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> lock(task->mutex);
+    WaitTicks(lock, task->cv, ticks, [task] { return task->notify_count > 0; });
+    uint32_t value = task->notify_count;
+    if (value > 0) task->notify_count = clear_on_exit ? 0 : value - 1;
+    return value;
+}
+
+void vTaskSuspendAll(void)
+{
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+    return pdFALSE;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return new StubSemaphore(1, 1, false);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count)
+{
+    return new StubSemaphore(max_count, initial_count, false);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *buffer)
+{
+    return new (buffer->storage) StubSemaphore(1, 0, true);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks)
+{
+    std::unique_lock<std::mutex> lock(semaphore->mutex);
+    if (!WaitTicks(lock, semaphore->cv, ticks, [semaphore] { return semaphore->count > 0; })) return pdFALSE;
+    --semaphore->count;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    std::lock_guard<std::mutex> lock(semaphore->mutex);
+    if (semaphore->count >= semaphore->max_count) return pdFALSE;
+    ++semaphore->count;
+    semaphore->cv.notify_all();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    if (semaphore->is_static) {
+        semaphore->~StubSemaphore();
+    } else {
+        delete semaphore;
+    }
+}
@@ -0,0 +1,14 @@
+// Host stand-in for the FreeRTOS header of the same name, for test/ only
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct StubSemaphore *SemaphoreHandle_t;
+
+// A mutex is a binary semaphore given once, there is no priority inheritance
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count);
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *buffer);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
@@ -0,0 +1,21 @@
+// Host stand-in for the FreeRTOS header of the same name, for test/ only
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+// Tasks are threads; priorities and cores are ignored and handles live until exit
+typedef struct StubTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stack_size, void *param,
+                                   UBaseType_t priority, TaskHandle_t *created, BaseType_t core_id);
+// Only for the calling task, which must return right after
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+void taskYIELD(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+// No scheduler to hold off, threads keep running
+void vTaskSuspendAll(void);
+BaseType_t xTaskResumeAll(void);
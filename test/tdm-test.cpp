@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "test.hpp"
+#include "dsp/tdm.hpp"
+
+using namespace wrapper;
+
+static_assert(TdmSlotCount(0x0) == 0 && TdmSlotCount(0xB) == 3 && TdmSlotCount(0xFFFF) == 16, "slot count");
+static_assert(TdmSlotIndex(0xB, 0) == 0 && TdmSlotIndex(0xB, 1) == 1 && TdmSlotIndex(0xB, 3) == 2, "slot index");
+static_assert(TdmSlotIndex(0xB, 2) == -1 && TdmSlotIndex(0xB, 32) == -1, "slot not captured");
+
+// Every sample tells its frame and position apart
+static std::vector<int16_t> Frames(size_t frames, size_t channels)
+{
+    std::vector<int16_t> samples(frames * channels);
+    for (size_t i = 0; i < samples.size(); ++i) samples[i] = (int16_t)(i * 40503u ^ (i >> 3));
+    return samples;
+}
+
+// Reference: the frame holds the enabled slots in ascending order
+static int NaiveSlotIndex(uint32_t mask, uint32_t slot)
+{
+    int index = 0;
+    for (uint32_t s = 0; s < 32; ++s) {
+        if ((mask & (1u << s)) == 0) continue;
+        if (s == slot) return index;
+        ++index;
+    }
+    return -1;
+}
+
+static void TestDeinterleaveMatchesNaive()
+{
+    for (size_t channels = 1; channels <= 8; ++channels) {
+        for (size_t frames : {0, 1, 7, 8, 9, 15, 16, 17, 37, 1000}) {
+            std::vector<int16_t> in = Frames(frames, channels);
+            // Offset planes by one sample so the vector stores are unaligned
+            std::vector<std::vector<int16_t>> planes(channels, std::vector<int16_t>(frames + 1, 0x7777));
+            std::vector<int16_t *> pointers;
+            for (auto &plane : planes) pointers.push_back(plane.data() + 1);
+            TdmDeinterleave(in.data(), frames, channels, pointers.data());
+            for (size_t ch = 0; ch < channels; ++ch) {
+                CHECK_EQ(planes[ch][0], 0x7777);
+                for (size_t f = 0; f < frames; ++f) CHECK_EQ(planes[ch][f + 1], in[f * channels + ch]);
+            }
+
+            std::vector<const int16_t *> sources(pointers.begin(), pointers.end());
+            std::vector<int16_t> out(frames * channels + 1, 0x7777);
+            TdmInterleave(sources.data(), frames, channels, out.data());
+            CHECK(std::equal(in.begin(), in.end(), out.begin()));
+            CHECK_EQ(out[frames * channels], 0x7777);
+        }
+    }
+}
+
+// Every slot mask of a 4 slot frame, every ordered pick of 1-3 captured slots
+static void TestRouteMatchesNaive()
+{
+    const size_t frames = 41;
+    size_t routes = 0;
+    for (uint32_t mask = 1; mask < 16; ++mask) {
+        const size_t in_channels = TdmSlotCount(mask);
+        std::vector<int16_t> in = Frames(frames, in_channels);
+        for (uint32_t pick = 0; pick < 4 * 4 * 4; ++pick) {
+            for (size_t count = 1; count <= 3; ++count) {
+                uint8_t slots[3] = {(uint8_t)(pick % 4), (uint8_t)(pick / 4 % 4), (uint8_t)(pick / 16)};
+                bool valid = true;
+                for (size_t i = 0; i < count; ++i) valid &= NaiveSlotIndex(mask, slots[i]) >= 0;
+
+                TdmRoute route;
+                CHECK_EQ(route.Init(mask, slots, count), valid);
+                if (!valid) continue;
+                ++routes;
+                CHECK_EQ(route.in_channels, in_channels);
+                CHECK_EQ(route.out_channels, count);
+
+                std::vector<int16_t> expected(frames * count);
+                for (size_t f = 0; f < frames; ++f) {
+                    for (size_t ch = 0; ch < count; ++ch) {
+                        expected[f * count + ch] = in[f * in_channels + NaiveSlotIndex(mask, slots[ch])];
+                    }
+                }
+
+                std::vector<int16_t> out(frames * count);
+                route.Apply(in.data(), frames, out.data());
+                CHECK(out == expected);
+
+                // In place, the route narrows (or keeps) the frame
+                if (count <= in_channels) {
+                    std::vector<int16_t> inplace = in;
+                    route.Apply(inplace.data(), frames, inplace.data());
+                    CHECK(std::equal(expected.begin(), expected.end(), inplace.begin()));
+                }
+
+                std::vector<std::vector<int16_t>> planes(count, std::vector<int16_t>(frames));
+                std::vector<int16_t *> pointers;
+                for (auto &plane : planes) pointers.push_back(plane.data());
+                route.Apply(in.data(), frames, pointers.data());
+                for (size_t ch = 0; ch < count; ++ch) {
+                    for (size_t f = 0; f < frames; ++f) CHECK_EQ(planes[ch][f], expected[f * count + ch]);
+                }
+            }
+        }
+    }
+    CHECK(routes > 100);
+
+    // Sparse 8 slot mask, e.g. mic on slot 5 and reference on slot 1
+    const uint8_t slots[2] = {5, 1};
+    TdmRoute route;
+    CHECK(route.Init(0xA6, slots, 2));
+    CHECK_EQ(route.in_channels, 4);
+    CHECK_EQ(route.map[0], 2);
+    CHECK_EQ(route.map[1], 0);
+    CHECK(!route.Init(0xA6, slots, 0));
+    const uint8_t missing[1] = {3};
+    CHECK(!route.Init(0xA6, missing, 1));
+}
+
+static void BenchDeinterleave()
+{
+    const size_t frames = 512;
+    const int rounds = 20000;
+    for (size_t channels : {2, 4}) {
+        std::vector<int16_t> in = Frames(frames, channels);
+        std::vector<std::vector<int16_t>> planes(channels, std::vector<int16_t>(frames));
+        std::vector<int16_t *> pointers;
+        for (auto &plane : planes) pointers.push_back(plane.data());
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            in[0] = (int16_t)r;
+            TdmDeinterleave(in.data(), frames, channels, pointers.data());
+        }
+        double fast = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            in[0] = (int16_t)r;
+            volatile int16_t *const *sink = (volatile int16_t *const *)pointers.data();
+            for (size_t ch = 0; ch < channels; ++ch) {
+                for (size_t f = 0; f < frames; ++f) sink[ch][f] = in[f * channels + ch];
+            }
+        }
+        double naive = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double samples = (double)frames * channels * rounds;
+        printf("deinterleave %zu ch: %.0f Msamples/s, naive %.0f Msamples/s\n", channels, samples / fast / 1e6,
+               samples / naive / 1e6);
+        CHECK(planes[0][0] == (int16_t)(rounds - 1));
+    }
+}
+
+int main()
+{
+    RUN(TestDeinterleaveMatchesNaive);
+    RUN(TestRouteMatchesNaive);
+    RUN(BenchDeinterleave);
+    return 0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// Minimal host test helpers: a failed check reports and exits non-zero
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);  \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                                            \
+    do {                                                                                          \
+        long long va_ = (long long)(a);                                                           \
+        long long vb_ = (long long)(b);                                                           \
+        if (va_ != vb_) {                                                                         \
+            fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, \
+                    #a, #b, va_, vb_);                                                            \
+            exit(1);                                                                              \
+        }                                                                                         \
+    } while (0)
+
+#define RUN(test)                       \
+    do {                                \
+        test();                         \
+        printf("ok %s\n", #test);       \
+    } while (0)
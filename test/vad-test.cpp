@@ -0,0 +1,195 @@
+#include <cmath>
+#include <vector>
+#include "test.hpp"
+#include "dsp/vad.hpp"
+
+using namespace wrapper;
+
+static constexpr uint32_t RATE = 16000;
+static constexpr size_t FRAME = RATE / 100; // 10 ms
+
+// Builds a mono timeline of background noise with signals added over frame ranges
+struct Timeline
+{
+    std::vector<float> samples;
+    uint32_t state = 1;
+
+    Timeline(size_t frames, float noise_dbfs) : samples(frames * FRAME)
+    {
+        for (float &s : samples) s = Noise() * Amplitude(noise_dbfs) * 1.7320508f;
+    }
+
+    static float Amplitude(float dbfs) { return 32768.0f * powf(10.0f, dbfs / 20.0f); }
+
+    float Noise()
+    {
+        state = state * 1664525u + 1013904223u;
+        return (float)(int32_t)state / 2147483648.0f;
+    }
+
+    // Voiced vowel: 140 Hz pitch, harmonics shaped by formants at 700 and 1200 Hz
+    void AddVowel(size_t from, size_t to, float rms_dbfs)
+    {
+        const float f0 = 140.0f;
+        float weights[24], power = 0;
+        for (int h = 1; h <= 24; ++h) {
+            float f = f0 * h;
+            weights[h - 1] = 1.0f / (1.0f + powf((f - 700.0f) / 300.0f, 2)) + 0.5f / (1.0f + powf((f - 1200.0f) / 300.0f, 2));
+            power += weights[h - 1] * weights[h - 1] / 2;
+        }
+        float scale = Amplitude(rms_dbfs) / sqrtf(power);
+        for (size_t i = from * FRAME; i < to * FRAME; ++i) {
+            float v = 0;
+            for (int h = 1; h <= 24; ++h) v += weights[h - 1] * sinf(2.0f * (float)M_PI * f0 * h * i / RATE);
+            samples[i] += scale * v;
+        }
+    }
+
+    void AddNoise(size_t from, size_t to, float rms_dbfs)
+    {
+        for (size_t i = from * FRAME; i < to * FRAME; ++i) samples[i] += Noise() * Amplitude(rms_dbfs) * 1.7320508f;
+    }
+
+    std::vector<int16_t> Pcm() const
+    {
+        std::vector<int16_t> pcm(samples.size());
+        for (size_t i = 0; i < pcm.size(); ++i) pcm[i] = (int16_t)lrintf(fmaxf(-32768.0f, fminf(32767.0f, samples[i])));
+        return pcm;
+    }
+};
+
+struct Event
+{
+    VadEvent event;
+    uint32_t frame; // 1-based frame that completed the decision
+};
+
+static std::vector<Event> Run(Vad &vad, const std::vector<int16_t> &pcm, size_t block = 97)
+{
+    std::vector<Event> events;
+    vad.SetCallback([&](VadEvent event) { events.push_back({event, vad.GetFrames()}); });
+    for (size_t i = 0; i < pcm.size(); i += block) vad.Analyze(&pcm[i], std::min(block, pcm.size() - i));
+    return events;
+}
+
+// Onset fires on the onset_frames-th speech frame, hangover on the hangover_frames-th silent one
+static void TestOnsetAndHangover()
+{
+    Timeline timeline(300, -60.0f);
+    timeline.AddVowel(100, 150, -25.0f);
+    // A gap shorter than the hangover does not end the utterance
+    timeline.AddVowel(170, 200, -25.0f);
+    Vad vad;
+    VadConfig config;
+    CHECK(vad.Init(RATE, config));
+    std::vector<Event> events = Run(vad, timeline.Pcm());
+
+    CHECK_EQ(events.size(), 2);
+    CHECK(events[0].event == VadEvent::SpeechStart);
+    CHECK_EQ(events[0].frame, 100 + config.onset_frames);
+    CHECK(events[1].event == VadEvent::SpeechStop);
+    CHECK_EQ(events[1].frame, 200 + config.hangover_frames);
+    CHECK(!vad.IsSpeech());
+    CHECK_EQ(vad.GetSpeechFrames(), 80);
+    CHECK(fabsf(vad.GetNoiseFloorDb() - (-60.0f + 90.3f)) < 3.0f);
+}
+
+// Bursts shorter than the onset are clicks, not speech
+static void TestShortBurstIgnored()
+{
+    Timeline timeline(200, -60.0f);
+    timeline.AddVowel(100, 102, -20.0f);
+    timeline.AddVowel(150, 152, -20.0f);
+    Vad vad;
+    CHECK(vad.Init(RATE));
+    CHECK(Run(vad, timeline.Pcm()).empty());
+    CHECK_EQ(vad.GetSpeechFrames(), 4);
+}
+
+// White noise rising 15 dB crosses zero too often to be speech, and the floor follows it
+static void TestNoiseStepRejected()
+{
+    Timeline timeline(800, -60.0f);
+    timeline.AddNoise(100, 800, -45.0f);
+    Vad vad;
+    CHECK(vad.Init(RATE));
+    CHECK(Run(vad, timeline.Pcm()).empty());
+    printf("noise step: zcr %.2f, floor %.1f dB, energy %.1f dB\n", vad.GetZeroCrossingRate(), vad.GetNoiseFloorDb(),
+           vad.GetEnergyDb());
+    CHECK(vad.GetZeroCrossingRate() > 0.4f);
+    CHECK(fabsf(vad.GetNoiseFloorDb() - vad.GetEnergyDb()) < 3.0f);
+
+    // Speech on top of the new floor is still found
+    timeline.AddVowel(700, 760, -20.0f);
+    Vad again;
+    CHECK(again.Init(RATE));
+    std::vector<Event> events = Run(again, timeline.Pcm());
+    CHECK(!events.empty());
+    CHECK(events[0].event == VadEvent::SpeechStart);
+    CHECK_EQ(events[0].frame, 700 + VadConfig().onset_frames);
+}
+
+// With the ZCR check off, spectral flatness alone tells a vowel from white noise 12 dB over the floor
+static void TestFlatnessRejectsNoise()
+{
+    VadConfig config;
+    config.zcr_max = 1.0f;
+    config.strong_db = 40.0f;
+
+    Timeline noise(300, -60.0f);
+    noise.AddNoise(100, 200, -48.0f);
+    std::vector<int16_t> pcm = noise.Pcm();
+    Vad plain;
+    CHECK(plain.Init(RATE, config));
+    CHECK(!Run(plain, pcm).empty());
+
+    config.use_flatness = true;
+    Vad flat;
+    CHECK(flat.Init(RATE, config));
+    CHECK(Run(flat, pcm).empty());
+    // Single frames may still pass, never enough of them in a row
+    CHECK(flat.GetSpeechFrames() < 10);
+
+    Timeline vowel(300, -60.0f);
+    vowel.AddVowel(100, 200, -48.0f);
+    Vad voiced;
+    CHECK(voiced.Init(RATE, config));
+    std::vector<Event> events = Run(voiced, vowel.Pcm());
+    CHECK_EQ(events.size(), 2);
+    CHECK_EQ(events[0].frame, 100 + config.onset_frames);
+    CHECK_EQ(events[1].frame, 200 + config.hangover_frames);
+}
+
+// As a processor on stereo frames it reads config.channel and leaves the data alone
+static void TestProcessorChannel()
+{
+    Timeline timeline(200, -60.0f);
+    timeline.AddVowel(50, 100, -25.0f);
+    std::vector<int16_t> mono = timeline.Pcm();
+    std::vector<int16_t> stereo(mono.size() * 2);
+    for (size_t i = 0; i < mono.size(); ++i) {
+        stereo[i * 2] = 0;
+        stereo[i * 2 + 1] = mono[i];
+    }
+    const std::vector<int16_t> original = stereo;
+
+    VadConfig config;
+    config.channel = 1;
+    Vad vad;
+    CHECK(vad.Init(RATE, config));
+    int starts = 0;
+    vad.SetCallback([&](VadEvent event) { starts += event == VadEvent::SpeechStart; });
+    vad.Process(stereo.data(), mono.size(), 2);
+    CHECK_EQ(starts, 1);
+    CHECK(stereo == original);
+}
+
+int main()
+{
+    RUN(TestOnsetAndHangover);
+    RUN(TestShortBurstIgnored);
+    RUN(TestNoiseStepRejected);
+    RUN(TestFlatnessRejectsNoise);
+    RUN(TestProcessorChannel);
+    return 0;
+}
@@ -0,0 +1,372 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "test.hpp"
+#include "dsp/wav.hpp"
+
+using namespace wrapper;
+
+static constexpr uint32_t RATE = 16000;
+
+// In-memory stream that hands out at most `chunk` bytes per Read and only the first
+// `available` bytes until Finish, like a download arriving in pieces
+struct TrickleReader : AudioReader
+{
+    std::vector<uint8_t> bytes;
+    size_t chunk;
+    size_t available;
+    size_t pos = 0;
+
+    TrickleReader(std::vector<uint8_t> data, size_t chunk = SIZE_MAX)
+        : bytes(std::move(data)), chunk(chunk), available(bytes.size())
+    {
+    }
+
+    size_t Read(void *data, size_t size) override
+    {
+        size_t left = available - pos;
+        if (size > left) size = left;
+        if (size > chunk) size = chunk;
+        memcpy(data, bytes.data() + pos, size);
+        pos += size;
+        return size;
+    }
+    bool AtEnd() const override { return available == bytes.size() && pos >= bytes.size(); }
+    void Finish() { available = bytes.size(); }
+};
+
+// RIFF writer for the fixtures
+struct WavFile
+{
+    std::vector<uint8_t> bytes;
+
+    WavFile() { Append("RIFF\0\0\0\0WAVE", 12); }
+
+    void Append(const void *data, size_t size)
+    {
+        const uint8_t *p = static_cast<const uint8_t *>(data);
+        bytes.insert(bytes.end(), p, p + size);
+    }
+    void Le16(uint16_t v) { Append(&v, 2); }
+    void Le32(uint32_t v) { Append(&v, 4); }
+
+    // Chunk with its pad byte when the size is odd; size_field overrides the header only
+    void Chunk(const char *id, const std::vector<uint8_t> &payload, uint32_t size_field)
+    {
+        Append(id, 4);
+        Le32(size_field);
+        Append(payload.data(), payload.size());
+        if (payload.size() & 1) bytes.push_back(0);
+    }
+    void Chunk(const char *id, const std::vector<uint8_t> &payload) { Chunk(id, payload, (uint32_t)payload.size()); }
+
+    void Format(uint16_t tag, uint16_t channels, uint16_t block_align, uint16_t bits, size_t extra = 0)
+    {
+        WavFile fmt;
+        fmt.bytes.clear();
+        fmt.Le16(tag);
+        fmt.Le16(channels);
+        fmt.Le32(RATE);
+        fmt.Le32(RATE * block_align);
+        fmt.Le16(block_align);
+        fmt.Le16(bits);
+        for (size_t i = 0; i < extra; ++i) fmt.bytes.push_back(0);
+        Chunk("fmt ", fmt.bytes);
+    }
+
+    // WAVEFORMATEXTENSIBLE: cbSize 22, valid bits, channel mask, sub-format GUID
+    void ExtensibleFormat(uint16_t sub_tag, uint16_t channels, uint16_t block_align, uint16_t bits)
+    {
+        WavFile fmt;
+        fmt.bytes.clear();
+        fmt.Le16((uint16_t)WavFormat::Extensible);
+        fmt.Le16(channels);
+        fmt.Le32(RATE);
+        fmt.Le32(RATE * block_align);
+        fmt.Le16(block_align);
+        fmt.Le16(bits);
+        fmt.Le16(22);
+        fmt.Le16(bits);
+        fmt.Le32(channels == 1 ? 0x4 : 0x3);
+        fmt.Le16(sub_tag);
+        static const uint8_t guid_tail[14] = {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80,
+                                              0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+        fmt.Append(guid_tail, sizeof(guid_tail));
+        Chunk("fmt ", fmt.bytes);
+    }
+
+    void List(size_t size) { Chunk("LIST", std::vector<uint8_t>(size, 'x')); }
+};
+
+static std::vector<int16_t> Tone(size_t frames, size_t channels)
+{
+    std::vector<int16_t> pcm(frames * channels);
+    for (size_t i = 0; i < pcm.size(); ++i) {
+        size_t f = i / channels, ch = i % channels;
+        pcm[i] = (int16_t)lrintf(12000.0f * sinf(2.0f * (float)M_PI * (ch ? 700.0f : 440.0f) * f / RATE));
+    }
+    return pcm;
+}
+
+static std::vector<uint8_t> Bytes(const std::vector<int16_t> &pcm)
+{
+    std::vector<uint8_t> bytes(pcm.size() * 2);
+    memcpy(bytes.data(), pcm.data(), bytes.size());
+    return bytes;
+}
+
+// Drains the decoder with an odd read size until it reports the end
+static std::vector<int16_t> ReadAll(WavDecoder &decoder, size_t read_frames = 37)
+{
+    std::vector<int16_t> out, buffer(read_frames * decoder.GetChannels());
+    int idle = 0;
+    while (!decoder.AtEnd()) {
+        size_t frames = decoder.ReadFrames(buffer.data(), read_frames);
+        out.insert(out.end(), buffer.begin(), buffer.begin() + frames * decoder.GetChannels());
+        CHECK(++idle < 100000);
+    }
+    CHECK_EQ(decoder.ReadFrames(buffer.data(), read_frames), 0);
+    return out;
+}
+
+static void TestPcm()
+{
+    for (uint16_t channels : {1, 2}) {
+        std::vector<int16_t> pcm = Tone(1001, channels);
+        WavFile wav;
+        wav.Format((uint16_t)WavFormat::Pcm, channels, 2 * channels, 16);
+        wav.Chunk("data", Bytes(pcm));
+        // A trailing chunk after sized data is not audio
+        wav.List(9);
+
+        // Whole file at once, then 3 bytes per read: frames split across reads come out intact
+        for (size_t chunk : {SIZE_MAX, (size_t)3}) {
+            TrickleReader reader(wav.bytes, chunk);
+            WavDecoder decoder;
+            CHECK(decoder.Open(reader));
+            CHECK(decoder.GetInfo().format == WavFormat::Pcm);
+            CHECK_EQ(decoder.GetChannels(), channels);
+            CHECK_EQ(decoder.GetSampleRate(), RATE);
+            CHECK_EQ(decoder.GetInfo().data_size, pcm.size() * 2);
+            CHECK(ReadAll(decoder) == pcm);
+        }
+    }
+}
+
+static void TestImaAdpcm()
+{
+    for (uint16_t channels : {1, 2}) {
+        const size_t frame_samples = ImaAdpcm::FrameSamples(channels, 256);
+        std::vector<int16_t> pcm = Tone(frame_samples * 3, channels);
+        ImaAdpcmEncoder encoder;
+        CHECK(encoder.Init(channels, frame_samples));
+        std::vector<uint8_t> data(256 * 3);
+        for (size_t b = 0; b < 3; ++b) {
+            CHECK_EQ(encoder.Encode(&pcm[b * frame_samples * channels], &data[b * 256], 256), 256);
+        }
+        // The short last block: header and two 8 sample groups per channel
+        data.resize(256 * 2 + 4 * channels * 3);
+
+        ImaAdpcmDecoder reference;
+        CHECK(reference.Init(channels, frame_samples));
+        std::vector<int16_t> expected(frame_samples * 3 * channels);
+        size_t frames = 0;
+        for (size_t offset = 0; offset < data.size(); offset += 256) {
+            size_t size = std::min<size_t>(256, data.size() - offset);
+            frames += reference.Decode(&data[offset], size, &expected[frames * channels], frame_samples);
+        }
+        CHECK_EQ(frames, 2 * frame_samples + 17);
+        expected.resize(frames * channels);
+
+        // fmt with cbSize and nSamplesPerBlock, as most writers emit it
+        WavFile wav;
+        wav.Format((uint16_t)WavFormat::ImaAdpcm, channels, 256, 4, 4);
+        wav.Chunk("fact", {0, 0, 0, 0});
+        wav.Chunk("data", data);
+        for (size_t chunk : {SIZE_MAX, (size_t)5}) {
+            TrickleReader reader(wav.bytes, chunk);
+            WavDecoder decoder;
+            CHECK(decoder.Open(reader));
+            CHECK(decoder.GetInfo().format == WavFormat::ImaAdpcm);
+            CHECK_EQ(decoder.GetInfo().samples_per_block, frame_samples);
+            CHECK(ReadAll(decoder) == expected);
+        }
+    }
+
+    // A block size that is not header plus whole groups is rejected
+    WavFile wav;
+    wav.Format((uint16_t)WavFormat::ImaAdpcm, 1, 258, 4);
+    wav.Chunk("data", std::vector<uint8_t>(258));
+    TrickleReader reader(wav.bytes);
+    WavDecoder decoder;
+    CHECK(!decoder.Open(reader));
+}
+
+static void TestExtensible()
+{
+    std::vector<int16_t> pcm = Tone(300, 2);
+    WavFile wav;
+    wav.ExtensibleFormat((uint16_t)WavFormat::Pcm, 2, 4, 16);
+    wav.Chunk("data", Bytes(pcm));
+    TrickleReader reader(wav.bytes);
+    WavDecoder decoder;
+    CHECK(decoder.Open(reader));
+    CHECK(decoder.GetInfo().format == WavFormat::Pcm);
+    CHECK(ReadAll(decoder) == pcm);
+
+    // Sub-format the decoder does not handle (IEEE float)
+    WavFile float_wav;
+    float_wav.ExtensibleFormat(0x0003, 2, 8, 32);
+    float_wav.Chunk("data", std::vector<uint8_t>(64));
+    TrickleReader float_reader(float_wav.bytes);
+    CHECK(!decoder.Open(float_reader));
+
+    // Extensible tag on a plain 16 byte fmt chunk
+    WavFile short_wav;
+    short_wav.Format((uint16_t)WavFormat::Extensible, 2, 4, 16);
+    short_wav.Chunk("data", Bytes(pcm));
+    TrickleReader short_reader(short_wav.bytes);
+    CHECK(!decoder.Open(short_reader));
+}
+
+// Odd sized chunks are followed by a pad byte that is not part of the next header
+static void TestOddChunks()
+{
+    std::vector<int16_t> pcm = Tone(100, 1);
+    for (size_t size : {0, 1, 5, 6, 127}) {
+        WavFile wav;
+        wav.List(size);
+        wav.Format((uint16_t)WavFormat::Pcm, 1, 2, 16, 2);
+        wav.List(size + 2);
+        wav.Chunk("data", Bytes(pcm));
+        TrickleReader reader(wav.bytes, 7);
+        WavDecoder decoder;
+        CHECK(decoder.Open(reader));
+        CHECK(ReadAll(decoder) == pcm);
+    }
+
+    // Chunks out of order: data before fmt
+    WavFile wav;
+    wav.Chunk("data", Bytes(pcm));
+    wav.Format((uint16_t)WavFormat::Pcm, 1, 2, 16);
+    TrickleReader reader(wav.bytes);
+    WavDecoder decoder;
+    CHECK(!decoder.Open(reader));
+}
+
+// Streaming writers leave the data size at 0 or 0xFFFFFFFF: read until the reader ends
+static void TestStreamedData()
+{
+    std::vector<int16_t> pcm = Tone(2000, 2);
+    for (uint32_t size_field : {0u, 0xFFFFFFFFu}) {
+        WavFile wav;
+        wav.Format((uint16_t)WavFormat::Pcm, 2, 4, 16);
+        wav.Chunk("data", Bytes(pcm), size_field);
+        const size_t header = wav.bytes.size() - pcm.size() * 2;
+
+        TrickleReader reader(wav.bytes, 11);
+        // Only the header and a partial frame have arrived
+        reader.available = header + 3;
+        WavDecoder decoder;
+        CHECK(decoder.Open(reader));
+        CHECK_EQ(decoder.GetInfo().data_size, 0);
+        std::vector<int16_t> out(pcm.size());
+        CHECK_EQ(decoder.ReadFrames(out.data(), 2000), 0);
+        CHECK(!decoder.AtEnd());
+
+        // The rest arrives: the kept partial frame is completed
+        reader.Finish();
+        size_t frames = 0;
+        while (!decoder.AtEnd()) frames += decoder.ReadFrames(&out[frames * 2], 2000 - frames);
+        CHECK_EQ(frames, 2000);
+        CHECK(out == pcm);
+    }
+}
+
+static void TestTruncated()
+{
+    // Header cut anywhere before the data chunk: Open fails
+    std::vector<int16_t> pcm = Tone(500, 2);
+    WavFile wav;
+    wav.Format((uint16_t)WavFormat::Pcm, 2, 4, 16);
+    wav.List(3);
+    wav.Chunk("data", Bytes(pcm));
+    const size_t header = wav.bytes.size() - pcm.size() * 2;
+    for (size_t size = 0; size < header; ++size) {
+        TrickleReader reader(std::vector<uint8_t>(wav.bytes.begin(), wav.bytes.begin() + size));
+        WavDecoder decoder;
+        CHECK(!decoder.Open(reader));
+        CHECK(!decoder.IsOpen());
+        CHECK(decoder.AtEnd());
+    }
+
+    // Data cut mid-frame: the whole frames play, the torn one is dropped and the decoder ends
+    TrickleReader reader(std::vector<uint8_t>(wav.bytes.begin(), wav.bytes.begin() + header + 301 * 4 + 3));
+    WavDecoder decoder;
+    CHECK(decoder.Open(reader));
+    CHECK_EQ(decoder.GetInfo().data_size, 500 * 4);
+    std::vector<int16_t> out = ReadAll(decoder);
+    CHECK(out == std::vector<int16_t>(pcm.begin(), pcm.begin() + 301 * 2));
+
+    // ADPCM cut inside a group of the second block: its whole groups still decode
+    const size_t frame_samples = ImaAdpcm::FrameSamples(1, 256);
+    std::vector<int16_t> mono = Tone(frame_samples * 2, 1);
+    ImaAdpcmEncoder encoder;
+    CHECK(encoder.Init(1, frame_samples));
+    std::vector<uint8_t> data(512);
+    encoder.Encode(mono.data(), data.data(), 256);
+    encoder.Encode(&mono[frame_samples], &data[256], 256);
+    WavFile adpcm;
+    adpcm.Format((uint16_t)WavFormat::ImaAdpcm, 1, 256, 4);
+    adpcm.Chunk("data", data);
+    adpcm.bytes.resize(adpcm.bytes.size() - 256 + 4 + 4 * 5 + 2);
+    TrickleReader adpcm_reader(adpcm.bytes);
+    CHECK(decoder.Open(adpcm_reader));
+    CHECK_EQ(ReadAll(decoder).size(), frame_samples + 1 + 8 * 5);
+}
+
+static void TestRejectsFormats()
+{
+    struct Case
+    {
+        uint16_t tag, channels, block_align, bits;
+    } cases[] = {
+        {(uint16_t)WavFormat::Pcm, 1, 1, 8},   // 8 bit
+        {(uint16_t)WavFormat::Pcm, 2, 6, 24},  // 24 bit
+        {(uint16_t)WavFormat::Pcm, 3, 6, 16},  // more channels than the codec takes
+        {(uint16_t)WavFormat::Pcm, 0, 0, 16},
+        {(uint16_t)WavFormat::Pcm, 2, 2, 16},  // block_align does not match the frame
+        {0x0055, 2, 1, 0},                     // MP3
+    };
+    for (const Case &c : cases) {
+        WavFile wav;
+        wav.Format(c.tag, c.channels, c.block_align, c.bits);
+        wav.Chunk("data", std::vector<uint8_t>(64));
+        TrickleReader reader(wav.bytes);
+        WavDecoder decoder;
+        CHECK(!decoder.Open(reader));
+    }
+
+    // Not RIFF/WAVE at all
+    WavFile wav;
+    memcpy(wav.bytes.data() + 8, "AVI ", 4);
+    wav.Format((uint16_t)WavFormat::Pcm, 1, 2, 16);
+    wav.Chunk("data", std::vector<uint8_t>(64));
+    TrickleReader reader(wav.bytes);
+    WavDecoder decoder;
+    CHECK(!decoder.Open(reader));
+}
+
+int main()
+{
+    RUN(TestPcm);
+    RUN(TestImaAdpcm);
+    RUN(TestExtensible);
+    RUN(TestOddChunks);
+    RUN(TestStreamedData);
+    RUN(TestTruncated);
+    RUN(TestRejectsFormats);
+    return 0;
+}